@@ -0,0 +1,155 @@
+// Compares the compile-time StaticSignature matchers used by
+// FindFunctionPrologs and FindCallInstructions with the runtime matchers and
+// the byte loop they replaced. Scans are run over the files given on the
+// command line (x86-64 binaries are the intended input), concatenated into
+// one buffer, and each variant reports the best of several runs.
+//
+//     static_signature_bench /usr/bin/cmake /usr/lib/x86_64-linux-gnu/libc.so.6
+#include "pattern_matcher.h"
+#include "multi_pattern_scanner.h"
+#include "static_signature.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+const int RUNS = 15;
+
+// Keeps the displacement loads of the call scans from being optimised away
+volatile uint32_t g_sink;
+
+std::vector<uint8_t> LoadInput(int argc, char** argv) {
+    std::vector<uint8_t> data;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", argv[i]);
+            continue;
+        }
+        data.insert(data.end(), std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    return data;
+}
+
+// Runs scan RUNS times and returns the fastest time in milliseconds. The
+// result count is printed so every variant can be checked for agreement.
+double Measure(const char* name, const std::function<size_t()>& scan) {
+    double best = 1e30;
+    size_t found = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        found = scan();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    std::printf("  %-34s %8.2f ms  %zu matches\n", name, best, found);
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <binary>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> input = LoadInput(argc, argv);
+    if (input.empty()) return EXIT_FAILURE;
+    const uint8_t* data = input.data();
+    const size_t size = input.size();
+    std::printf("%.1f MB of input, best of %d runs\n", size / 1048576.0, RUNS);
+
+    // The prologue set from FindFunctionPrologs
+    const std::vector<std::vector<uint8_t>> prologs = {
+        {0x55, 0x8B, 0xEC},
+        {0x48, 0x89, 0x5C, 0x24},
+        {0x48, 0x83, 0xEC},
+        {0x55, 0x48, 0x89, 0xE5}
+    };
+    using PushEbpMovEbpEsp = StaticSignature<0x55, 0x8B, 0xEC>;
+    using MovRbxToStack    = StaticSignature<0x48, 0x89, 0x5C, 0x24>;
+    using SubRsp           = StaticSignature<0x48, 0x83, 0xEC>;
+    using PushRbpMovRbpRsp = StaticSignature<0x55, 0x48, 0x89, 0xE5>;
+    using RelativeCall     = StaticSignature<0xE8, StaticSignatureAny, StaticSignatureAny,
+                                             StaticSignatureAny, StaticSignatureAny>;
+
+    std::printf("prologue set (4 signatures):\n");
+    MultiPatternScanner scanner;
+    for (const auto& pattern : prologs) {
+        scanner.AddPattern(pattern, std::vector<bool>(pattern.size(), true));
+    }
+    Measure("runtime MultiPatternScanner", [&] {
+        std::vector<MultiPatternHit> hits;
+        scanner.FindAll(data, size, hits);
+        size_t unique = 0;
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (i == 0 || hits[i].offset != hits[i - 1].offset) unique++;
+        }
+        return unique;
+    });
+    Measure("StaticSignature", [&] {
+        std::vector<size_t> offsets;
+        PushEbpMovEbpEsp::FindAll(data, size, offsets);
+        MovRbxToStack::FindAll(data, size, offsets);
+        SubRsp::FindAll(data, size, offsets);
+        PushRbpMovRbpRsp::FindAll(data, size, offsets);
+        std::sort(offsets.begin(), offsets.end());
+        return static_cast<size_t>(std::unique(offsets.begin(), offsets.end()) - offsets.begin());
+    });
+
+    std::printf("48 89 5C 24 alone:\n");
+    PatternMatcher movRbx(prologs[1], std::vector<bool>(prologs[1].size(), true));
+    Measure("runtime PatternMatcher", [&] {
+        std::vector<size_t> offsets;
+        return movRbx.FindAll(data, size, offsets);
+    });
+    Measure("StaticSignature", [&] {
+        std::vector<size_t> offsets;
+        return MovRbxToStack::FindAll(data, size, offsets);
+    });
+
+    // Counting every E8 xx xx xx xx; FindCallInstructions then filters on the target
+    std::printf("E8 call scan:\n");
+    Measure("byte loop (previous code)", [&] {
+        size_t count = 0;
+        uint32_t sum = 0;
+        for (size_t i = 0; i + 5 <= size; ++i) {
+            if (data[i] == 0xE8) {
+                int32_t offset;
+                memcpy(&offset, data + i + 1, sizeof(offset));
+                sum += static_cast<uint32_t>(offset);
+                count++;
+            }
+        }
+        g_sink = sum;
+        return count;
+    });
+    PatternMatcher call({0xE8, 0, 0, 0, 0}, std::vector<bool>{true, false, false, false, false});
+    Measure("runtime PatternMatcher", [&] {
+        std::vector<size_t> offsets;
+        return call.FindAll(data, size, offsets);
+    });
+    Measure("StaticSignature", [&] {
+        size_t count = 0;
+        uint32_t sum = 0;
+        RelativeCall::ForEachMatch(data, size, [&](size_t i) {
+            int32_t offset;
+            memcpy(&offset, data + i + 1, sizeof(offset));
+            sum += static_cast<uint32_t>(offset);
+            count++;
+            return true;
+        });
+        g_sink = sum;
+        return count;
+    });
+
+    return EXIT_SUCCESS;
+}
@@ -8,7 +8,30 @@
         "src/native/memory_scanner.cpp",
         "src/native/error_handler.cpp",
         "src/native/memory_helpers.cpp",
-        "src/native/automation_helpers.cpp"
+        "src/native/automation_helpers.cpp",
+        "src/native/pattern_matcher.cpp",
+        "src/native/multi_pattern_scanner.cpp",
+        "src/native/region_reader.cpp",
+        "src/native/scan_executor.cpp",
+        "src/native/signature.cpp",
+        "src/native/byte_regex.cpp",
+        "src/native/string_searcher.cpp",
+        "src/native/string_extractor.cpp",
+        "src/native/scan_session.cpp",
+        "src/native/candidate_store.cpp",
+        "src/native/mapped_file.cpp",
+        "src/native/pointer_map.cpp",
+        "src/native/pointer_path.cpp",
+        "src/native/pointer_path_set.cpp",
+        "src/native/pointer_reader.cpp",
+        "src/native/module_map.cpp",
+        "src/native/address_space.cpp",
+        "src/native/chain_resolver.cpp",
+        "src/native/instruction_decoder.cpp",
+        "src/native/xref_sweep.cpp",
+        "src/native/xref_index.cpp",
+        "src/native/value_scanner.cpp",
+        "src/native/group_scanner.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
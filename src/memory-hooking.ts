@@ -16,12 +16,45 @@ import {
   ScanResult,
   PointerResult,
   PatternMatch,
+  MultiPatternMatch,
+  StringMatch,
+  ExtractedString,
+  StringExtractionStats,
+  StringExtractionOptions,
+  SignatureHandle,
   NumericMatch,
+  ScanValueType,
+  ScanCompare,
+  ValueSearchQuery,
+  ValueMatch,
+  GroupSearchQuery,
+  GroupMatch,
+  ScanSessionHandle,
+  ScanSessionMatch,
+  ScanSessionOptions,
+  ScanSessionStats,
+  ScanFilterOptions,
   MemoryRegionEx,
   PatternSearchOptions,
   StringSearchOptions,
   NumericSearchOptions,
   PointerSearchOptions,
+  PointerMapHandle,
+  PointerMapOptions,
+  PointerMapStats,
+  PointerPath,
+  PointerPathOptions,
+  PointerPathScanResult,
+  PointerPathSetHandle,
+  StoredPointerPath,
+  ChainSetHandle,
+  ChainSetStats,
+  ModuleAddress,
+  ModuleSections,
+  XrefIndexHandle,
+  Xref,
+  XrefSearchOptions,
+  XrefIndexStats,
   RegionFilterOptions,
   MousePosition,
   ScreenshotData,
@@ -43,6 +76,17 @@ export class MemoryHooking implements IMemoryHooking {
     this.nativeInstance = new NativeMemoryHooking();
   }
 
+  // "game.exe+0x1A2B40 → +0x18 → +0x230"
+  private describePointerPath(
+    path: Pick<PointerPath, "module" | "moduleOffset" | "offsets">
+  ): string {
+    const hex = (value: number) => `0x${value.toString(16).toUpperCase()}`;
+    return [
+      `${path.module}+${hex(path.moduleOffset)}`,
+      ...path.offsets.map((offset) => `+${hex(offset)}`),
+    ].join(" → ");
+  }
+
   private executeWithErrorHandling<T>(
     operation: () => SafeOperationResult<T>
   ): SafeOperationResult<T> {
@@ -539,6 +583,66 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
+  // Patterns may be signature strings ("48 8B ?? ??") or byte arrays with a
+  // matching entry in masks; each match carries the index of its pattern
+  searchMultiplePatterns = (
+    patterns: Array<number[] | string>,
+    masks: boolean[][] = [],
+    options: Partial<PatternSearchOptions> = {}
+  ): SafeOperationResult<MultiPatternMatch[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.searchMultiplePatterns(
+        patterns,
+        masks,
+        options.searchStart,
+        options.searchEnd
+      );
+      return {
+        success: true,
+        data: results,
+        scanStats: {
+          totalScanned: 0,
+          matchesFound: results.length,
+          timeElapsed: 0,
+        },
+      };
+    });
+  };
+
+  // Parses a signature such as "48 8B 0D ?? ?? ?? ?? 4? 8B" once; "4?" fixes
+  // only the high nibble. The handle can be passed to searchSignature repeatedly
+  compileSignature = (signature: string): SafeOperationResult<SignatureHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const handle = this.nativeInstance.compileSignature(signature);
+      return {
+        success: true,
+        data: handle,
+      };
+    });
+  };
+
+  searchSignature = (
+    signature: SignatureHandle,
+    options: Partial<PatternSearchOptions> = {}
+  ): SafeOperationResult<PatternMatch[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.searchSignature(
+        signature,
+        options.searchStart,
+        options.searchEnd
+      );
+      return {
+        success: true,
+        data: results,
+        scanStats: {
+          totalScanned: 0,
+          matchesFound: results.length,
+          timeElapsed: 0,
+        },
+      };
+    });
+  };
+
   searchStringPattern = (
     pattern: string,
     options: Partial<StringSearchOptions> = {}
@@ -563,6 +667,32 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
+  // Finds the text as UTF-8 and UTF-16LE (or options.encodings) in one pass;
+  // each match is tagged with the encoding it was found in
+  searchString = (
+    text: string,
+    options: Partial<StringSearchOptions> = {}
+  ): SafeOperationResult<StringMatch[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.searchString(
+        text,
+        options.encodings ?? ["utf8", "utf16le"],
+        options.caseSensitive ?? true,
+        options.searchStart,
+        options.searchEnd
+      );
+      return {
+        success: true,
+        data: results,
+        scanStats: {
+          totalScanned: 0,
+          matchesFound: results.length,
+          timeElapsed: 0,
+        },
+      };
+    });
+  };
+
   searchRegexPattern = (
     regexPattern: string,
     options: Partial<PatternSearchOptions> = {}
@@ -585,18 +715,47 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
-  // Memory Helpers - Numeric Searching
-  searchInt32 = (
-    value: number,
-    options: Partial<NumericSearchOptions> = {}
-  ): SafeOperationResult<NumericMatch[]> => {
+  // Streams every printable ASCII and UTF-16LE run (or options.encodings) of
+  // at least options.minLength characters to onBatch, in address order
+  extractStrings = (
+    onBatch: (batch: ExtractedString[]) => boolean | void,
+    options: Partial<StringExtractionOptions> = {}
+  ): SafeOperationResult<StringExtractionStats> => {
     return this.executeWithErrorHandling(() => {
-      const results = this.nativeInstance.searchInt32(
-        value,
+      const stats = this.nativeInstance.extractStrings(
+        onBatch,
+        options.minLength ?? 4,
+        options.encodings ?? ["utf8", "utf16le"],
         options.searchStart,
         options.searchEnd,
-        options.aligned ?? false
+        options.batchSize
+      );
+      return { success: true, data: stats };
+    });
+  };
+
+  // Writes one "address<TAB>encoding<TAB>text" line per string to path
+  extractStringsToFile = (
+    path: string,
+    options: Partial<StringExtractionOptions> = {}
+  ): SafeOperationResult<StringExtractionStats> => {
+    return this.executeWithErrorHandling(() => {
+      const stats = this.nativeInstance.extractStringsToFile(
+        path,
+        options.minLength ?? 4,
+        options.encodings ?? ["utf8", "utf16le"],
+        options.searchStart,
+        options.searchEnd
       );
+      return { success: true, data: stats };
+    });
+  };
+
+  // Memory Helpers - Numeric Searching
+  // One native kernel covers every type, alignment and predicate
+  searchValue = (query: ValueSearchQuery): SafeOperationResult<ValueMatch[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.searchValue(query);
       return {
         success: true,
         data: results,
@@ -609,17 +768,11 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
-  searchInt64 = (
-    value: number,
-    options: Partial<NumericSearchOptions> = {}
-  ): SafeOperationResult<NumericMatch[]> => {
+  // Finds several values close together (e.g. the fields of one struct) in a
+  // single native pass instead of one scan per value joined in JS
+  searchGroup = (query: GroupSearchQuery): SafeOperationResult<GroupMatch[]> => {
     return this.executeWithErrorHandling(() => {
-      const results = this.nativeInstance.searchInt64(
-        value,
-        options.searchStart,
-        options.searchEnd,
-        options.aligned ?? false
-      );
+      const results = this.nativeInstance.searchGroup(query);
       return {
         success: true,
         data: results,
@@ -632,16 +785,93 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
+  searchInt32 = (
+    value: number,
+    options: Partial<NumericSearchOptions> = {}
+  ): SafeOperationResult<NumericMatch[]> => {
+    return this.searchValue({
+      type: "int32",
+      value,
+      searchStart: options.searchStart,
+      searchEnd: options.searchEnd,
+      aligned: options.aligned ?? false,
+    });
+  };
+
+  searchInt64 = (
+    value: number | bigint,
+    options: Partial<NumericSearchOptions> = {}
+  ): SafeOperationResult<NumericMatch[]> => {
+    return this.searchValue({
+      type: "int64",
+      value,
+      searchStart: options.searchStart,
+      searchEnd: options.searchEnd,
+      aligned: options.aligned ?? false,
+    });
+  };
+
   searchFloat = (
     value: number,
     options: Partial<NumericSearchOptions> = {}
   ): SafeOperationResult<NumericMatch[]> => {
+    return this.searchValue({
+      type: "float",
+      op: "near",
+      value,
+      tolerance: options.tolerance ?? 0.001,
+      searchStart: options.searchStart,
+      searchEnd: options.searchEnd,
+      aligned: options.aligned ?? true,
+    });
+  };
+
+  searchDouble = (
+    value: number,
+    options: Partial<NumericSearchOptions> = {}
+  ): SafeOperationResult<NumericMatch[]> => {
+    return this.searchValue({
+      type: "double",
+      op: "near",
+      value,
+      tolerance: options.tolerance ?? 0.001,
+      searchStart: options.searchStart,
+      searchEnd: options.searchEnd,
+      aligned: options.aligned ?? true,
+    });
+  };
+
+  // Memory Helpers - Pointer Maps
+  // Reads every pointer in the target once and indexes it by the address it
+  // points to; by default only writable regions are searched
+  buildPointerMap = (
+    options: Partial<PointerMapOptions> = {}
+  ): SafeOperationResult<PointerMapHandle> => {
     return this.executeWithErrorHandling(() => {
-      const results = this.nativeInstance.searchFloat(
-        value,
-        options.tolerance ?? 0.001,
+      const map = this.nativeInstance.buildPointerMap(
         options.searchStart,
-        options.searchEnd
+        options.searchEnd,
+        options.writableOnly ?? true,
+        options.moduleImagesOnly ?? false
+      );
+      return {
+        success: true,
+        data: map,
+      };
+    });
+  };
+
+  // Like findPointersTo, but answered from the map without reading the target
+  findPointersInMap = (
+    map: PointerMapHandle,
+    targetAddress: number,
+    maxResults: number = 10000
+  ): SafeOperationResult<PointerResult[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.pointerMapFind(
+        map,
+        targetAddress,
+        maxResults
       );
       return {
         success: true,
@@ -655,29 +885,423 @@ export class MemoryHooking implements IMemoryHooking {
     });
   };
 
-  searchDouble = (
-    value: number,
-    options: Partial<NumericSearchOptions> = {}
-  ): SafeOperationResult<NumericMatch[]> => {
+  getPointerMapStats = (map: PointerMapHandle): PointerMapStats => {
+    return this.nativeInstance.pointerMapStats(map);
+  };
+
+  savePointerMap = (
+    map: PointerMapHandle,
+    path: string
+  ): SafeOperationResult<boolean> => {
     return this.executeWithErrorHandling(() => {
-      const results = this.nativeInstance.searchDouble(
-        value,
-        options.tolerance ?? 0.001,
-        options.searchStart,
-        options.searchEnd
+      this.nativeInstance.savePointerMap(map, path);
+      return {
+        success: true,
+        data: true,
+      };
+    });
+  };
+
+  // Maps a saved pointer map; fails unless the attached process is the same
+  // instance the map was built from
+  loadPointerMap = (path: string): SafeOperationResult<PointerMapHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const map = this.nativeInstance.loadPointerMap(path);
+      return {
+        success: true,
+        data: map,
+      };
+    });
+  };
+
+  // Pointer paths from static bases in module images to targetAddress,
+  // shortest first; found with lookups in the map only
+  scanPointerPaths = (
+    map: PointerMapHandle,
+    targetAddress: number,
+    options: PointerPathOptions = {}
+  ): SafeOperationResult<PointerPathScanResult> => {
+    return this.executeWithErrorHandling(() => {
+      const result = this.nativeInstance.scanPointerPaths(
+        map,
+        targetAddress,
+        options.maxDepth,
+        options.maxOffset,
+        options.maxPaths
+      );
+      const paths: PointerPath[] = result.paths.map(
+        (path: Omit<PointerPath, "expression">) => ({
+          ...path,
+          expression: this.describePointerPath(path),
+        })
       );
       return {
         success: true,
-        data: results,
+        data: { paths, nodes: result.nodes, truncated: result.truncated },
         scanStats: {
-          totalScanned: 0,
-          matchesFound: results.length,
+          totalScanned: result.nodes,
+          matchesFound: paths.length,
           timeElapsed: 0,
         },
       };
     });
   };
 
+  // Memory Helpers - Pointer Path Sets
+  // Keeps pointer paths by module name and offset so they can be checked
+  // against later runs of the target
+  createPointerPathSet = (
+    paths: Pick<PointerPath, "module" | "moduleOffset" | "offsets">[]
+  ): SafeOperationResult<PointerPathSetHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const set = this.nativeInstance.createPointerPathSet(paths);
+      return {
+        success: true,
+        data: set,
+      };
+    });
+  };
+
+  getPointerPathSetPaths = (
+    set: PointerPathSetHandle,
+    maxResults: number = 10000
+  ): SafeOperationResult<StoredPointerPath[]> => {
+    return this.executeWithErrorHandling(() => {
+      const paths = this.nativeInstance
+        .pointerPathSetPaths(set, maxResults)
+        .map((path: Omit<StoredPointerPath, "expression">) => ({
+          ...path,
+          expression: this.describePointerPath(path),
+        }));
+      return {
+        success: true,
+        data: paths,
+      };
+    });
+  };
+
+  getPointerPathSetCount = (set: PointerPathSetHandle): number => {
+    return this.nativeInstance.pointerPathSetCount(set);
+  };
+
+  // Keeps the paths that lead to targetAddress in the attached process,
+  // resolving every path with one batch of reads per level; returns how many
+  // remain
+  validatePointerPathSet = (
+    set: PointerPathSetHandle,
+    targetAddress: number
+  ): SafeOperationResult<number> => {
+    return this.executeWithErrorHandling(() => {
+      const remaining = this.nativeInstance.validatePointerPathSet(
+        set,
+        targetAddress
+      );
+      return {
+        success: true,
+        data: remaining,
+      };
+    });
+  };
+
+  // Keeps the paths of set that other holds too, e.g. a new run's scan;
+  // returns how many remain
+  intersectPointerPathSets = (
+    set: PointerPathSetHandle,
+    other: PointerPathSetHandle
+  ): SafeOperationResult<number> => {
+    return this.executeWithErrorHandling(() => {
+      const remaining = this.nativeInstance.intersectPointerPathSets(
+        set,
+        other
+      );
+      return {
+        success: true,
+        data: remaining,
+      };
+    });
+  };
+
+  savePointerPathSet = (
+    set: PointerPathSetHandle,
+    path: string
+  ): SafeOperationResult<boolean> => {
+    return this.executeWithErrorHandling(() => {
+      this.nativeInstance.savePointerPathSet(set, path);
+      return {
+        success: true,
+        data: true,
+      };
+    });
+  };
+
+  loadPointerPathSet = (
+    path: string
+  ): SafeOperationResult<PointerPathSetHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const set = this.nativeInstance.loadPointerPathSet(path);
+      return {
+        success: true,
+        data: set,
+      };
+    });
+  };
+
+  // Memory Helpers - Pointer Chains
+  // Compiles expressions such as "[[game.exe+0x1234]+0x10]+8" once; chains
+  // sharing a prefix read it only once per resolve
+  compileChains = (
+    expressions: string[]
+  ): SafeOperationResult<ChainSetHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const chains = this.nativeInstance.compileChains(expressions);
+      return {
+        success: true,
+        data: chains,
+      };
+    });
+  };
+
+  // Final address of every chain in expression order, 0 where a chain is
+  // broken; each depth is read in one batch
+  resolveChains = (
+    chains: ChainSetHandle
+  ): SafeOperationResult<Float64Array> => {
+    return this.executeWithErrorHandling(() => {
+      const addresses = this.nativeInstance.resolveChains(chains);
+      return {
+        success: true,
+        data: addresses,
+      };
+    });
+  };
+
+  getChainSetStats = (chains: ChainSetHandle): ChainSetStats => {
+    return this.nativeInstance.chainSetStats(chains);
+  };
+
+  // Memory Helpers - Address Space
+  // Module images of the target with their sections, sorted by base
+  getModuleSections = (): SafeOperationResult<ModuleSections[]> => {
+    return this.executeWithErrorHandling(() => {
+      const modules = this.nativeInstance.getModuleSections();
+      return {
+        success: true,
+        data: modules,
+      };
+    });
+  };
+
+  // Module, section and module offset of each address, so that scan results
+  // can be kept across runs; null for addresses outside module images
+  locateAddresses = (
+    addresses: number[]
+  ): SafeOperationResult<(ModuleAddress | null)[]> => {
+    return this.executeWithErrorHandling(() => {
+      const locations = this.nativeInstance.locateAddresses(addresses);
+      return {
+        success: true,
+        data: locations,
+      };
+    });
+  };
+
+  // Memory Helpers - Cross References
+  // Decodes the target's executable memory once and indexes every direct
+  // call, jump and RIP-relative operand by the address it references
+  buildXrefIndex = (
+    options: Partial<PatternSearchOptions> = {}
+  ): SafeOperationResult<XrefIndexHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const index = this.nativeInstance.buildXrefIndex(
+        options.searchStart,
+        options.searchEnd
+      );
+      return {
+        success: true,
+        data: index,
+      };
+    });
+  };
+
+  // "Who calls X" / "who references Y", answered from the index without
+  // reading the target
+  findXrefs = (
+    index: XrefIndexHandle,
+    target: number,
+    options: XrefSearchOptions = {}
+  ): SafeOperationResult<Xref[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.xrefIndexFind(
+        index,
+        target,
+        options.rangeEnd ?? target,
+        options.kind,
+        options.maxResults ?? 10000
+      );
+      return {
+        success: true,
+        data: results,
+      };
+    });
+  };
+
+  getXrefIndexStats = (index: XrefIndexHandle): XrefIndexStats => {
+    return this.nativeInstance.xrefIndexStats(index);
+  };
+
+  saveXrefIndex = (
+    index: XrefIndexHandle,
+    path: string
+  ): SafeOperationResult<boolean> => {
+    return this.executeWithErrorHandling(() => {
+      this.nativeInstance.saveXrefIndex(index, path);
+      return {
+        success: true,
+        data: true,
+      };
+    });
+  };
+
+  // Maps a saved index; fails unless the attached process is the same
+  // instance the index was built from
+  loadXrefIndex = (path: string): SafeOperationResult<XrefIndexHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const index = this.nativeInstance.loadXrefIndex(path);
+      return {
+        success: true,
+        data: index,
+      };
+    });
+  };
+
+  // Memory Helpers - Scan Sessions
+  // Creates a native candidate set for iterative value scans; by default only
+  // aligned addresses in writable regions are considered
+  createScanSession = (
+    type: ScanValueType,
+    options: Partial<ScanSessionOptions> = {}
+  ): SafeOperationResult<ScanSessionHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const session = this.nativeInstance.createScanSession(
+        type,
+        options.aligned ?? true,
+        options.writableOnly ?? true,
+        options.searchStart,
+        options.searchEnd,
+        options.memoryLimit,
+        options.moduleImagesOnly ?? false
+      );
+      return {
+        success: true,
+        data: session,
+      };
+    });
+  };
+
+  // Scans memory and replaces the session's candidates; returns how many were found.
+  // "unknown" keeps every address as a snapshot for later changed/unchanged passes
+  firstScan = (
+    session: ScanSessionHandle,
+    compare: ScanCompare,
+    options: ScanFilterOptions = {}
+  ): SafeOperationResult<number> => {
+    return this.executeWithErrorHandling(() => {
+      const count = this.nativeInstance.scanSessionFirst(
+        session,
+        compare,
+        options.value,
+        options.value2,
+        options.tolerance,
+        options.decimals,
+        options.ulps
+      );
+      return {
+        success: true,
+        data: count,
+      };
+    });
+  };
+
+  // Re-reads only the remaining candidates and keeps those that pass
+  nextScan = (
+    session: ScanSessionHandle,
+    compare: ScanCompare,
+    options: ScanFilterOptions = {}
+  ): SafeOperationResult<number> => {
+    return this.executeWithErrorHandling(() => {
+      const count = this.nativeInstance.scanSessionNext(
+        session,
+        compare,
+        options.value,
+        options.value2,
+        options.tolerance,
+        options.decimals,
+        options.ulps
+      );
+      return {
+        success: true,
+        data: count,
+      };
+    });
+  };
+
+  getScanSessionCount = (session: ScanSessionHandle): number => {
+    return this.nativeInstance.scanSessionCount(session);
+  };
+
+  // Candidate count and where the candidates are held
+  getScanSessionStats = (session: ScanSessionHandle): ScanSessionStats => {
+    return this.nativeInstance.scanSessionStats(session);
+  };
+
+  // Writes the session to a file so that it survives a restart of this tool
+  saveScanSession = (
+    session: ScanSessionHandle,
+    path: string
+  ): SafeOperationResult<boolean> => {
+    return this.executeWithErrorHandling(() => {
+      this.nativeInstance.saveScanSession(session, path);
+      return {
+        success: true,
+        data: true,
+      };
+    });
+  };
+
+  // Reopens a saved session; fails unless the attached process is the same
+  // instance (process id and start time) the session was saved from
+  loadScanSession = (
+    path: string,
+    options: Pick<ScanSessionOptions, "memoryLimit"> = {}
+  ): SafeOperationResult<ScanSessionHandle> => {
+    return this.executeWithErrorHandling(() => {
+      const session = this.nativeInstance.loadScanSession(
+        path,
+        options.memoryLimit
+      );
+      return {
+        success: true,
+        data: session,
+      };
+    });
+  };
+
+  getScanSessionResults = (
+    session: ScanSessionHandle,
+    maxResults: number = 10000
+  ): SafeOperationResult<ScanSessionMatch[]> => {
+    return this.executeWithErrorHandling(() => {
+      const results = this.nativeInstance.scanSessionResults(
+        session,
+        maxResults
+      );
+      return {
+        success: true,
+        data: results,
+      };
+    });
+  };
+
   // Memory Helpers - Region Analysis
   getMemoryRegionsEx = (
     options: Partial<RegionFilterOptions> = {}
@@ -895,6 +1519,24 @@ export class MemoryHooking implements IMemoryHooking {
     return this.nativeInstance.getAlignment(address);
   };
 
+  // Caps the read buffer each scan holds; large regions are streamed through it
+  setScanMemoryBudget = (bytes: number): number => {
+    return this.nativeInstance.setScanMemoryBudget(bytes);
+  };
+
+  getScanMemoryBudget = (): number => {
+    return this.nativeInstance.getScanMemoryBudget();
+  };
+
+  // Number of threads region scans are spread across; 0 uses every core
+  setScanParallelism = (threads: number): number => {
+    return this.nativeInstance.setScanParallelism(threads);
+  };
+
+  getScanParallelism = (): number => {
+    return this.nativeInstance.getScanParallelism();
+  };
+
   // Convenience methods that combine multiple helpers
   searchForValue = (
     value: any,
@@ -0,0 +1,83 @@
+#include "include/address_space.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// The PE headers, section table included, fit in the first page of an image
+const size_t HEADER_PAGE = 4096;
+
+// Section headers of the image at module.base, read from the target. An
+// image whose headers cannot be read or parsed keeps no sections.
+void ReadSections(HANDLE processHandle, AddressModule& module) {
+    std::vector<uint8_t> page(std::min(HEADER_PAGE, module.size));
+    SIZE_T bytesRead = 0;
+    if (!ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(module.base), page.data(), page.size(), &bytesRead) ||
+        bytesRead < sizeof(IMAGE_DOS_HEADER)) {
+        return;
+    }
+
+    IMAGE_DOS_HEADER dos;
+    memcpy(&dos, page.data(), sizeof(dos));
+    if (dos.e_magic != IMAGE_DOS_SIGNATURE || dos.e_lfanew < 0) return;
+
+    size_t fileHeaderAt = static_cast<size_t>(dos.e_lfanew) + sizeof(DWORD);
+    if (fileHeaderAt + sizeof(IMAGE_FILE_HEADER) > bytesRead) return;
+
+    DWORD signature;
+    IMAGE_FILE_HEADER fileHeader;
+    memcpy(&signature, page.data() + dos.e_lfanew, sizeof(signature));
+    memcpy(&fileHeader, page.data() + fileHeaderAt, sizeof(fileHeader));
+    if (signature != IMAGE_NT_SIGNATURE) return;
+
+    size_t sectionAt = fileHeaderAt + sizeof(IMAGE_FILE_HEADER) + fileHeader.SizeOfOptionalHeader;
+    for (WORD i = 0; i < fileHeader.NumberOfSections; ++i, sectionAt += sizeof(IMAGE_SECTION_HEADER)) {
+        if (sectionAt + sizeof(IMAGE_SECTION_HEADER) > bytesRead) break;
+
+        IMAGE_SECTION_HEADER header;
+        memcpy(&header, page.data() + sectionAt, sizeof(header));
+        size_t size = header.Misc.VirtualSize ? header.Misc.VirtualSize : header.SizeOfRawData;
+        if (header.VirtualAddress >= module.size || size == 0) continue;
+
+        const char* name = reinterpret_cast<const char*>(header.Name);
+        module.sections.push_back({ std::string(name, strnlen(name, IMAGE_SIZEOF_SHORT_NAME)), header.VirtualAddress,
+                                    std::min(size, module.size - header.VirtualAddress) });
+    }
+
+    std::sort(module.sections.begin(), module.sections.end(),
+              [](const ModuleSection& a, const ModuleSection& b) { return a.offset < b.offset; });
+}
+
+} // namespace
+
+AddressSpace::AddressSpace() {
+}
+
+std::unique_ptr<AddressSpace> AddressSpace::Capture(HANDLE processHandle) {
+    std::unique_ptr<AddressSpace> space(new AddressSpace());
+    for (const ModuleImage& image : MemoryHelpers::GetModuleImages(processHandle)) {
+        AddressModule module = { image.name, image.base, image.size, {} };
+        ReadSections(processHandle, module);
+        space->m_modules.push_back(std::move(module));
+    }
+    return space;
+}
+
+std::vector<ModuleImage> AddressSpace::Images() const {
+    std::vector<ModuleImage> images;
+    images.reserve(m_modules.size());
+    for (const AddressModule& module : m_modules) images.push_back({ module.name, module.base, module.size });
+    return images;
+}
+
+void AddressSpace::ImageRanges(uintptr_t start, uintptr_t end, std::vector<ScanRange>& ranges) const {
+    auto module = std::upper_bound(m_modules.begin(), m_modules.end(), start,
+                                   [](uintptr_t value, const AddressModule& module) { return value < module.base; });
+    if (module != m_modules.begin()) --module;
+
+    for (; module != m_modules.end() && module->base < end; ++module) {
+        uintptr_t from = std::max(start, module->base);
+        uintptr_t to = std::min(end, module->base + module->size);
+        if (from < to) ranges.push_back({ from, static_cast<size_t>(to - from), 0 });
+    }
+}
@@ -0,0 +1,688 @@
+#include "include/byte_regex.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Parses a pattern into a small syntax tree, then emits Thompson NFA states
+// into the ByteRegex back to front, so every fragment already knows its
+// continuation and no patching is needed.
+class RegexParser {
+public:
+    RegexParser(const std::string& pattern, ByteRegex& regex)
+        : m_pattern(pattern), m_pos(0), m_depth(0), m_regex(regex) {}
+
+    bool Parse(std::string& error);
+
+private:
+    static constexpr size_t INFINITE = SIZE_MAX;
+    static constexpr int MAX_DEPTH = 256;
+
+    struct Node {
+        enum Kind { Set, Concat, Alt, Repeat } kind;
+        int set;
+        size_t min;
+        size_t max;
+        std::vector<int> children;
+    };
+
+    int ParseAlternation();
+    int ParseConcat();
+    int ParseRepeat();
+    int ParseAtom();
+    bool ParseClass(std::bitset<256>& set);
+    bool ParseEscape(std::bitset<256>& set, int& single);
+    bool ParseCount(size_t& value);
+    bool ParseBraces(size_t& min, size_t& max);
+
+    int AddNode(Node::Kind kind, int set = -1, size_t min = 0, size_t max = 0) {
+        m_nodes.push_back(Node{ kind, set, min, max, {} });
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+    int AddSet(const std::bitset<256>& set) {
+        m_regex.m_sets.push_back(set);
+        return AddNode(Node::Set, static_cast<int>(m_regex.m_sets.size() - 1));
+    }
+    int Fail(const std::string& message) {
+        if (m_error.empty()) m_error = message + " at offset " + std::to_string(m_pos);
+        return -1;
+    }
+
+    void Measure(int node, size_t& minLength, size_t& maxLength) const;
+    int Emit(int node, int next);
+    int NewState(ByteRegex::NfaState::Type type, int set, int out, int out1);
+
+    bool AtEnd() const { return m_pos >= m_pattern.size(); }
+    char Peek() const { return m_pattern[m_pos]; }
+
+    const std::string& m_pattern;
+    size_t m_pos;
+    int m_depth;
+    std::string m_error;
+    std::vector<Node> m_nodes;
+    ByteRegex& m_regex;
+};
+
+namespace {
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::bitset<256> RangeSet(int low, int high) {
+    std::bitset<256> set;
+    for (int b = low; b <= high; ++b) set.set(static_cast<size_t>(b));
+    return set;
+}
+
+size_t SaturatingAdd(size_t a, size_t b) {
+    return a > SIZE_MAX - b ? SIZE_MAX : a + b;
+}
+
+size_t SaturatingMul(size_t a, size_t b) {
+    if (a == 0 || b == 0) return 0;
+    return a > SIZE_MAX / b ? SIZE_MAX : a * b;
+}
+
+} // namespace
+
+bool RegexParser::Parse(std::string& error) {
+    if (m_pattern.empty()) {
+        error = "Empty pattern";
+        return false;
+    }
+
+    int root = ParseAlternation();
+    if (root >= 0 && !AtEnd()) root = Fail("Unmatched ')'");
+    if (root < 0) {
+        error = m_error;
+        return false;
+    }
+
+    size_t minLength = 0;
+    size_t maxLength = 0;
+    Measure(root, minLength, maxLength);
+
+    if (minLength == 0) {
+        error = "Pattern can match the empty string";
+        return false;
+    }
+    if (minLength > ByteRegex::MAX_MATCH_LENGTH) {
+        error = "Pattern matches more than " + std::to_string(ByteRegex::MAX_MATCH_LENGTH) + " bytes";
+        return false;
+    }
+
+    m_regex.m_unbounded = maxLength > ByteRegex::MAX_MATCH_LENGTH;
+    m_regex.m_maxLength = std::min(maxLength, ByteRegex::MAX_MATCH_LENGTH);
+
+    int match = NewState(ByteRegex::NfaState::Match, -1, -1, -1);
+    m_regex.m_start = Emit(root, match);
+    if (m_regex.m_start < 0) {
+        error = "Pattern is too large (more than " + std::to_string(ByteRegex::MAX_NFA_STATES) + " states)";
+        return false;
+    }
+
+    return true;
+}
+
+int RegexParser::ParseAlternation() {
+    int first = ParseConcat();
+    if (first < 0 || AtEnd() || Peek() != '|') return first;
+
+    int alt = AddNode(Node::Alt);
+    m_nodes[alt].children.push_back(first);
+    while (!AtEnd() && Peek() == '|') {
+        m_pos++;
+        int branch = ParseConcat();
+        if (branch < 0) return -1;
+        m_nodes[alt].children.push_back(branch);
+    }
+    return alt;
+}
+
+int RegexParser::ParseConcat() {
+    int concat = AddNode(Node::Concat);
+    while (!AtEnd() && Peek() != '|' && Peek() != ')') {
+        int item = ParseRepeat();
+        if (item < 0) return -1;
+        m_nodes[concat].children.push_back(item);
+    }
+    return concat;
+}
+
+int RegexParser::ParseRepeat() {
+    int atom = ParseAtom();
+    if (atom < 0) return -1;
+
+    while (!AtEnd()) {
+        size_t min = 0;
+        size_t max = 0;
+        char c = Peek();
+
+        if (c == '*') {
+            min = 0; max = INFINITE; m_pos++;
+        } else if (c == '+') {
+            min = 1; max = INFINITE; m_pos++;
+        } else if (c == '?') {
+            min = 0; max = 1; m_pos++;
+        } else if (c == '{') {
+            size_t save = m_pos;
+            if (!ParseBraces(min, max)) {
+                if (!m_error.empty()) return -1;
+                m_pos = save; // Not a quantifier; '{' is read as a literal next time round
+                break;
+            }
+        } else {
+            break;
+        }
+
+        // Lazy quantifiers describe the same language; matches are always longest
+        if (!AtEnd() && Peek() == '?') m_pos++;
+
+        int repeat = AddNode(Node::Repeat, -1, min, max);
+        m_nodes[repeat].children.push_back(atom);
+        atom = repeat;
+    }
+    return atom;
+}
+
+int RegexParser::ParseAtom() {
+    char c = Peek();
+    std::bitset<256> set;
+
+    switch (c) {
+    case '(': {
+        if (++m_depth > MAX_DEPTH) return Fail("Groups nested too deeply");
+        m_pos++;
+        if (m_pattern.compare(m_pos, 2, "?:") == 0) {
+            m_pos += 2;
+        } else if (!AtEnd() && Peek() == '?') {
+            return Fail("Lookaround and named groups are not supported");
+        }
+        int inner = ParseAlternation();
+        if (inner < 0) return -1;
+        if (AtEnd() || Peek() != ')') return Fail("Missing ')'");
+        m_pos++;
+        m_depth--;
+        return inner;
+    }
+    case '[':
+        m_pos++;
+        if (!ParseClass(set)) return -1;
+        return AddSet(set);
+    case '.':
+        m_pos++;
+        set.set();
+        set.reset('\n');
+        set.reset('\r');
+        return AddSet(set);
+    case '\\': {
+        m_pos++;
+        int single = -1;
+        if (!ParseEscape(set, single)) return -1;
+        return AddSet(set);
+    }
+    case '^':
+    case '$':
+        return Fail("Anchors are not supported");
+    case '*':
+    case '+':
+    case '?':
+        return Fail("Nothing to repeat");
+    default:
+        m_pos++;
+        set.set(static_cast<uint8_t>(c));
+        return AddSet(set);
+    }
+}
+
+bool RegexParser::ParseClass(std::bitset<256>& set) {
+    bool negate = !AtEnd() && Peek() == '^';
+    if (negate) m_pos++;
+
+    bool first = true;
+    while (true) {
+        if (AtEnd()) {
+            Fail("Missing ']'");
+            return false;
+        }
+        if (Peek() == ']' && !first) {
+            m_pos++;
+            break;
+        }
+        first = false;
+
+        // A class member is either a single byte, which may start a range, or
+        // a shorthand class such as \d
+        std::bitset<256> member;
+        int low = -1;
+        if (Peek() == '\\') {
+            m_pos++;
+            if (!ParseEscape(member, low)) return false;
+        } else {
+            low = static_cast<uint8_t>(Peek());
+            m_pos++;
+        }
+
+        bool range = low >= 0 && m_pos + 1 < m_pattern.size() && Peek() == '-' && m_pattern[m_pos + 1] != ']';
+        if (!range) {
+            if (low >= 0) member.set(static_cast<size_t>(low));
+            set |= member;
+            continue;
+        }
+
+        m_pos++;
+        int high = -1;
+        if (Peek() == '\\') {
+            m_pos++;
+            std::bitset<256> ignored;
+            if (!ParseEscape(ignored, high)) return false;
+            if (high < 0) {
+                Fail("Invalid class range");
+                return false;
+            }
+        } else {
+            high = static_cast<uint8_t>(Peek());
+            m_pos++;
+        }
+        if (high < low) {
+            Fail("Class range out of order");
+            return false;
+        }
+        set |= RangeSet(low, high);
+    }
+
+    if (negate) set.flip();
+    return true;
+}
+
+// Reads the escape after a backslash. single is the byte for escapes that
+// stand for one byte and -1 for shorthand classes.
+bool RegexParser::ParseEscape(std::bitset<256>& set, int& single) {
+    if (AtEnd()) {
+        Fail("Trailing backslash");
+        return false;
+    }
+
+    char c = Peek();
+    m_pos++;
+    single = -1;
+
+    switch (c) {
+    case 'd': set = RangeSet('0', '9'); return true;
+    case 'w': set = RangeSet('0', '9') | RangeSet('A', 'Z') | RangeSet('a', 'z'); set.set('_'); return true;
+    case 's': set = RangeSet('\t', '\r'); set.set(' '); return true;
+    case 'D': set = ~RangeSet('0', '9'); return true;
+    case 'W': set = ~(RangeSet('0', '9') | RangeSet('A', 'Z') | RangeSet('a', 'z')); set.reset('_'); return true;
+    case 'S': set = RangeSet('\t', '\r'); set.set(' '); set.flip(); return true;
+    case 'n': single = '\n'; break;
+    case 'r': single = '\r'; break;
+    case 't': single = '\t'; break;
+    case 'f': single = '\f'; break;
+    case 'v': single = '\v'; break;
+    case '0': single = 0; break;
+    case 'x': {
+        int high = m_pos < m_pattern.size() ? HexValue(m_pattern[m_pos]) : -1;
+        int low = m_pos + 1 < m_pattern.size() ? HexValue(m_pattern[m_pos + 1]) : -1;
+        if (high < 0 || low < 0) {
+            Fail("\\x needs two hex digits");
+            return false;
+        }
+        m_pos += 2;
+        single = (high << 4) | low;
+        break;
+    }
+    default:
+        if (c >= '1' && c <= '9') {
+            Fail("Backreferences are not supported");
+            return false;
+        }
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            Fail(std::string("Unknown escape \\") + c);
+            return false;
+        }
+        single = static_cast<uint8_t>(c);
+        break;
+    }
+
+    set.reset();
+    set.set(static_cast<size_t>(single));
+    return true;
+}
+
+bool RegexParser::ParseCount(size_t& value) {
+    size_t start = m_pos;
+    value = 0;
+    while (!AtEnd() && Peek() >= '0' && Peek() <= '9') {
+        value = std::min<size_t>(value * 10 + static_cast<size_t>(Peek() - '0'), ByteRegex::MAX_REPEAT + 1);
+        m_pos++;
+    }
+    return m_pos > start;
+}
+
+// {n}, {n,} or {n,m}. Returns false without an error when the braces do not
+// form a quantifier, so they can be read as literals.
+bool RegexParser::ParseBraces(size_t& min, size_t& max) {
+    m_pos++;
+    if (!ParseCount(min)) return false;
+
+    if (!AtEnd() && Peek() == ',') {
+        m_pos++;
+        if (!ParseCount(max)) max = INFINITE;
+    } else {
+        max = min;
+    }
+
+    if (AtEnd() || Peek() != '}') return false;
+    m_pos++;
+
+    if (min > ByteRegex::MAX_REPEAT || (max != INFINITE && max > ByteRegex::MAX_REPEAT)) {
+        Fail("Repeat count above " + std::to_string(ByteRegex::MAX_REPEAT));
+        return false;
+    }
+    if (max < min) {
+        Fail("Repeat range out of order");
+        return false;
+    }
+    return true;
+}
+
+void RegexParser::Measure(int node, size_t& minLength, size_t& maxLength) const {
+    const Node& n = m_nodes[node];
+
+    switch (n.kind) {
+    case Node::Set:
+        minLength = maxLength = 1;
+        return;
+    case Node::Concat:
+        minLength = maxLength = 0;
+        for (int child : n.children) {
+            size_t childMin, childMax;
+            Measure(child, childMin, childMax);
+            minLength = SaturatingAdd(minLength, childMin);
+            maxLength = SaturatingAdd(maxLength, childMax);
+        }
+        return;
+    case Node::Alt:
+        minLength = SIZE_MAX;
+        maxLength = 0;
+        for (int child : n.children) {
+            size_t childMin, childMax;
+            Measure(child, childMin, childMax);
+            minLength = std::min(minLength, childMin);
+            maxLength = std::max(maxLength, childMax);
+        }
+        return;
+    case Node::Repeat: {
+        size_t childMin, childMax;
+        Measure(n.children[0], childMin, childMax);
+        minLength = SaturatingMul(childMin, n.min);
+        maxLength = n.max == INFINITE ? (childMax ? SIZE_MAX : 0) : SaturatingMul(childMax, n.max);
+        return;
+    }
+    }
+}
+
+int RegexParser::NewState(ByteRegex::NfaState::Type type, int set, int out, int out1) {
+    if (m_regex.m_states.size() >= ByteRegex::MAX_NFA_STATES) return -1;
+    m_regex.m_states.push_back(ByteRegex::NfaState{ type, set, out, out1 });
+    return static_cast<int>(m_regex.m_states.size() - 1);
+}
+
+// Emits the states for node followed by next and returns the entry state,
+// or -1 once the state limit is reached
+int RegexParser::Emit(int node, int next) {
+    if (next < 0) return -1;
+    const Node& n = m_nodes[node];
+
+    switch (n.kind) {
+    case Node::Set:
+        return NewState(ByteRegex::NfaState::Byte, n.set, next, -1);
+
+    case Node::Concat:
+        for (size_t i = n.children.size(); i-- > 0 && next >= 0;) {
+            next = Emit(n.children[i], next);
+        }
+        return next;
+
+    case Node::Alt: {
+        int entry = Emit(n.children.back(), next);
+        for (size_t i = n.children.size() - 1; i-- > 0 && entry >= 0;) {
+            int branch = Emit(n.children[i], next);
+            entry = branch < 0 ? -1 : NewState(ByteRegex::NfaState::Split, -1, branch, entry);
+        }
+        return entry;
+    }
+
+    case Node::Repeat: {
+        int child = n.children[0];
+
+        if (n.max == INFINITE) {
+            int loop = NewState(ByteRegex::NfaState::Split, -1, -1, next);
+            int body = Emit(child, loop);
+            if (body < 0) return -1;
+            m_regex.m_states[loop].out = body;
+            next = loop;
+        } else {
+            for (size_t i = n.min; i < n.max && next >= 0; ++i) {
+                int body = Emit(child, next);
+                next = body < 0 ? -1 : NewState(ByteRegex::NfaState::Split, -1, body, next);
+            }
+        }
+
+        for (size_t i = 0; i < n.min && next >= 0; ++i) {
+            next = Emit(child, next);
+        }
+        return next;
+    }
+    }
+    return -1;
+}
+
+std::unique_ptr<ByteRegex> ByteRegex::Compile(const std::string& pattern, std::string& error) {
+    std::unique_ptr<ByteRegex> regex(new ByteRegex());
+
+    RegexParser parser(pattern, *regex);
+    if (!parser.Parse(error)) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> seen(regex->m_states.size(), 0);
+    regex->AddClosure(regex->m_start, regex->m_startSet, seen);
+    std::sort(regex->m_startSet.begin(), regex->m_startSet.end());
+
+    for (int state : regex->m_startSet) {
+        if (regex->m_states[state].type == NfaState::Byte) {
+            regex->m_firstBytes |= regex->m_sets[regex->m_states[state].set];
+        }
+    }
+
+    if (regex->m_firstBytes.count() == 1) {
+        for (int b = 0; b < 256; ++b) {
+            if (regex->m_firstBytes[static_cast<size_t>(b)]) regex->m_firstByte = b;
+        }
+    }
+
+    regex->BuildByteClasses();
+    return regex;
+}
+
+void ByteRegex::BuildByteClasses() {
+    int classes[256] = {};
+    size_t count = 1;
+
+    // Refine the partition by every set: bytes stay together only while no
+    // set separates them
+    for (const auto& set : m_sets) {
+        int remap[512];
+        std::fill(remap, remap + 512, -1);
+        size_t refined = 0;
+
+        for (int b = 0; b < 256; ++b) {
+            int key = classes[b] * 2 + (set[static_cast<size_t>(b)] ? 1 : 0);
+            if (remap[key] < 0) remap[key] = static_cast<int>(refined++);
+            classes[b] = remap[key];
+        }
+        count = refined;
+    }
+
+    for (int b = 0; b < 256; ++b) {
+        m_byteClass[b] = static_cast<uint8_t>(classes[b]);
+    }
+    m_classCount = count;
+}
+
+// Adds the Byte and Match states reachable from state without consuming input
+void ByteRegex::AddClosure(int state, std::vector<int>& set, std::vector<uint8_t>& seen) const {
+    std::vector<int> stack(1, state);
+
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        if (seen[current]) continue;
+        seen[current] = 1;
+
+        const NfaState& nfa = m_states[current];
+        if (nfa.type == NfaState::Split) {
+            stack.push_back(nfa.out1);
+            stack.push_back(nfa.out);
+        } else {
+            set.push_back(current);
+        }
+    }
+}
+
+ByteRegex::Matcher::Matcher(const ByteRegex& regex) : m_regex(regex) {
+    m_search.unanchored = true;
+    m_anchored.unanchored = false;
+    Reset(m_search);
+    Reset(m_anchored);
+}
+
+void ByteRegex::Matcher::Reset(Dfa& dfa) {
+    dfa.sets.clear();
+    dfa.matching.clear();
+    dfa.next.clear();
+    dfa.index.clear();
+    dfa.start = -1;
+}
+
+int32_t ByteRegex::Matcher::Intern(Dfa& dfa, std::vector<int>& set) {
+    auto found = dfa.index.find(set);
+    if (found != dfa.index.end()) return found->second;
+
+    bool matching = false;
+    for (int state : set) {
+        if (m_regex.m_states[state].type == NfaState::Match) matching = true;
+    }
+
+    int32_t id = static_cast<int32_t>(dfa.sets.size());
+    dfa.sets.push_back(set);
+    dfa.matching.push_back(matching ? 1 : 0);
+    dfa.next.resize(dfa.next.size() + m_regex.m_classCount, -1);
+    dfa.index.emplace(set, id);
+    return id;
+}
+
+int32_t ByteRegex::Matcher::Start(Dfa& dfa) {
+    if (dfa.start < 0) {
+        m_scratch = m_regex.m_startSet;
+        dfa.start = Intern(dfa, m_scratch);
+    }
+    return dfa.start;
+}
+
+int32_t ByteRegex::Matcher::Build(Dfa& dfa, int32_t state, uint8_t byte) {
+    m_scratch.clear();
+    m_seen.assign(m_regex.m_states.size(), 0);
+
+    for (int nfaState : dfa.sets[state]) {
+        const NfaState& nfa = m_regex.m_states[nfaState];
+        if (nfa.type == NfaState::Byte && m_regex.m_sets[nfa.set][byte]) {
+            m_regex.AddClosure(nfa.out, m_scratch, m_seen);
+        }
+    }
+
+    // The unanchored search may start a new match at every byte
+    if (dfa.unanchored) {
+        for (int nfaState : m_regex.m_startSet) {
+            if (!m_seen[nfaState]) {
+                m_seen[nfaState] = 1;
+                m_scratch.push_back(nfaState);
+            }
+        }
+    }
+    std::sort(m_scratch.begin(), m_scratch.end());
+
+    // A full cache is flushed and rebuilt from the state being entered; the
+    // caller only holds the id returned here
+    if (dfa.sets.size() >= DFA_CACHE_STATES && dfa.index.find(m_scratch) == dfa.index.end()) {
+        Reset(dfa);
+        return Intern(dfa, m_scratch);
+    }
+
+    int32_t next = Intern(dfa, m_scratch);
+    dfa.next[static_cast<size_t>(state) * m_regex.m_classCount + m_regex.m_byteClass[byte]] = next;
+    return next;
+}
+
+size_t ByteRegex::Matcher::LongestAt(const uint8_t* data, size_t start, size_t end) {
+    int32_t state = Start(m_anchored);
+    size_t longest = 0;
+
+    for (size_t i = start; i < end; ++i) {
+        state = Step(m_anchored, state, data[i]);
+        if (m_anchored.sets[state].empty()) break;
+        if (m_anchored.matching[state]) longest = i + 1;
+    }
+    return longest;
+}
+
+bool ByteRegex::Matcher::Find(const uint8_t* data, size_t size, size_t from, size_t limit,
+                              size_t& matchStart, size_t& matchEnd) {
+    const size_t maxLength = m_regex.m_maxLength;
+    limit = std::min(limit, size);
+
+    while (from < limit) {
+        // The earliest end of any match starting at or after from
+        int32_t state = Start(m_search);
+        size_t end = 0;
+        for (size_t i = from; i < size; ++i) {
+            // In the start state every byte but the first byte leads back to
+            // it, so skip straight to the next candidate
+            if (state == m_search.start && m_regex.m_firstByte >= 0) {
+                const void* hit = memchr(data + i, m_regex.m_firstByte, size - i);
+                if (hit == nullptr) break;
+                i = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+            }
+            state = Step(m_search, state, data[i]);
+            if (m_search.matching[state]) {
+                end = i + 1;
+                break;
+            }
+        }
+        if (end == 0) return false;
+
+        // The leftmost match starts no more than maxLength bytes before that
+        // end, since it cannot end any earlier
+        size_t first = end - from > maxLength ? end - maxLength : from;
+        for (size_t start = first; start < end && start < limit; ++start) {
+            if (!m_regex.m_firstBytes[data[start]]) continue;
+
+            size_t longest = LongestAt(data, start, std::min(size, start + maxLength));
+            if (longest != 0) {
+                matchStart = start;
+                matchEnd = longest;
+                return true;
+            }
+        }
+
+        // Only matches longer than the cap end here
+        if (end >= limit) return false;
+        from = end;
+    }
+
+    return false;
+}
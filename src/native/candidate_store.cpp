@@ -0,0 +1,236 @@
+#include "include/candidate_store.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const uint32_t STORE_MAGIC = 0x5343484D;   // "MHCS"
+const uint32_t STORE_VERSION = 1;
+
+// A saved store: this header, the caller's prefix padded to 8 bytes, one
+// StoredBlock per block in address order, then each block's slots and
+// values. Offsets are from the start of the file.
+struct StoreFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t prefixSize;
+    uint64_t blocks;
+    uint64_t count;
+};
+
+struct StoredBlock {
+    uint64_t base;
+    uint64_t offset;
+    uint32_t count;
+    uint32_t firstSlot;
+    uint32_t lastSlot;
+    uint32_t keptPages;
+    uint32_t slotsSize;
+    uint32_t valuesSize;
+    uint8_t layout;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(StoreFileHeader) == 32 && sizeof(StoredBlock) == 48, "Saved store layout changed");
+
+inline uint64_t AlignTo8(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+} // namespace
+
+CandidateStore::CandidateStore(size_t memoryLimit)
+    : m_memoryLimit(memoryLimit ? memoryLimit : DEFAULT_MEMORY_LIMIT), m_resident(0), m_count(0),
+      m_spillFile(INVALID_HANDLE_VALUE), m_fileSize(0), m_failed(false) {
+}
+
+CandidateStore::~CandidateStore() {
+    Close();
+}
+
+void CandidateStore::Swap(CandidateStore& other) {
+    std::swap(m_memoryLimit, other.m_memoryLimit);
+    std::swap(m_resident, other.m_resident);
+    std::swap(m_count, other.m_count);
+    m_entries.swap(other.m_entries);
+    std::swap(m_spillFile, other.m_spillFile);
+    m_mapped.Swap(other.m_mapped);
+    std::swap(m_fileSize, other.m_fileSize);
+    std::swap(m_failed, other.m_failed);
+}
+
+void CandidateStore::Add(std::vector<CandidateBlock>& blocks) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& block : blocks) {
+        Entry entry;
+        entry.offset = NOT_SPILLED;
+        entry.slotsSize = static_cast<uint32_t>(block.slots.size());
+        entry.valuesSize = static_cast<uint32_t>(block.values.size());
+        entry.block = std::move(block);
+        m_count += entry.block.count;
+
+        size_t bytes = entry.block.slots.capacity() + entry.block.values.capacity();
+        if (m_resident + bytes > m_memoryLimit && !m_failed) {
+            m_failed = !Spill(entry);
+        } else {
+            m_resident += bytes;
+        }
+        m_entries.push_back(std::move(entry));
+    }
+
+    blocks.clear();
+}
+
+bool CandidateStore::Spill(Entry& entry) {
+    if (m_spillFile == INVALID_HANDLE_VALUE) {
+        m_spillFile = CreateTemporaryFile(L"mhs");
+        if (m_spillFile == INVALID_HANDLE_VALUE) return false;
+    }
+
+    if (!WriteAll(m_spillFile, entry.block.slots.data(), entry.slotsSize) ||
+        !WriteAll(m_spillFile, entry.block.values.data(), entry.valuesSize)) {
+        return false;
+    }
+
+    entry.offset = m_fileSize;
+    m_fileSize += static_cast<uint64_t>(entry.slotsSize) + entry.valuesSize;
+    std::vector<uint8_t>().swap(entry.block.slots);
+    std::vector<uint8_t>().swap(entry.block.values);
+    return true;
+}
+
+bool CandidateStore::Finish() {
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.block.base < b.block.base;
+    });
+
+    if (m_failed) return false;
+    if (m_fileSize == 0) return true;
+
+    // The mapping owns the file from here on
+    HANDLE file = m_spillFile;
+    m_spillFile = INVALID_HANDLE_VALUE;
+    return m_mapped.Map(file);
+}
+
+const CandidateBlock& CandidateStore::Get(size_t index, CandidateBlock& scratch) const {
+    const Entry& entry = m_entries[index];
+    if (entry.offset == NOT_SPILLED) return entry.block;
+
+    scratch.base = entry.block.base;
+    scratch.count = entry.block.count;
+    scratch.firstSlot = entry.block.firstSlot;
+    scratch.lastSlot = entry.block.lastSlot;
+    scratch.keptPages = entry.block.keptPages;
+    scratch.layout = entry.block.layout;
+
+    const uint8_t* data = m_mapped.Data() + entry.offset;
+    scratch.slots.assign(data, data + entry.slotsSize);
+    scratch.values.assign(data + entry.slotsSize, data + entry.slotsSize + entry.valuesSize);
+    return scratch;
+}
+
+size_t CandidateStore::MemoryUsage() const {
+    return m_entries.capacity() * sizeof(Entry) + m_resident;
+}
+
+bool CandidateStore::Save(const std::wstring& path, const std::vector<uint8_t>& prefix) const {
+    FileSaver saver(path);
+    if (!saver.IsOpen()) return false;
+
+    StoreFileHeader header = { STORE_MAGIC, STORE_VERSION, prefix.size(), m_entries.size(), m_count };
+    uint64_t offset = AlignTo8(sizeof(header) + prefix.size()) + m_entries.size() * sizeof(StoredBlock);
+
+    FileWriter& writer = saver.Writer();
+    writer.Write(&header, sizeof(header));
+    writer.Write(prefix.data(), prefix.size());
+    writer.Pad(8);
+
+    for (const Entry& entry : m_entries) {
+        StoredBlock stored = {};
+        stored.base = entry.block.base;
+        stored.offset = offset;
+        stored.count = entry.block.count;
+        stored.firstSlot = entry.block.firstSlot;
+        stored.lastSlot = entry.block.lastSlot;
+        stored.keptPages = entry.block.keptPages;
+        stored.slotsSize = entry.slotsSize;
+        stored.valuesSize = entry.valuesSize;
+        stored.layout = static_cast<uint8_t>(entry.block.layout);
+        writer.Write(&stored, sizeof(stored));
+        offset += static_cast<uint64_t>(entry.slotsSize) + entry.valuesSize;
+    }
+
+    for (const Entry& entry : m_entries) {
+        if (entry.offset == NOT_SPILLED) {
+            writer.Write(entry.block.slots.data(), entry.slotsSize);
+            writer.Write(entry.block.values.data(), entry.valuesSize);
+        } else {
+            writer.Write(m_mapped.Data() + entry.offset, static_cast<size_t>(entry.slotsSize) + entry.valuesSize);
+        }
+    }
+
+    return saver.Commit();
+}
+
+bool CandidateStore::Load(const std::wstring& path, const uint8_t*& prefix, size_t& prefixSize) {
+    // Closes whatever was opened if the file turns out to be unusable
+    CandidateStore loaded(m_memoryLimit);
+    if (!loaded.m_mapped.Open(path) || loaded.m_mapped.Size() < sizeof(StoreFileHeader)) return false;
+
+    const uint8_t* view = loaded.m_mapped.Data();
+    uint64_t size = loaded.m_mapped.Size();
+
+    StoreFileHeader header;
+    memcpy(&header, view, sizeof(header));
+    if (header.magic != STORE_MAGIC || header.version != STORE_VERSION ||
+        header.prefixSize > size - sizeof(header)) {
+        return false;
+    }
+
+    uint64_t tableOffset = AlignTo8(sizeof(header) + header.prefixSize);
+    if (tableOffset > size || header.blocks > (size - tableOffset) / sizeof(StoredBlock)) return false;
+
+    // Only the headers are read; block contents stay in the mapping until used
+    loaded.m_entries.resize(static_cast<size_t>(header.blocks));
+    uint64_t count = 0;
+    for (size_t i = 0; i < loaded.m_entries.size(); ++i) {
+        StoredBlock stored;
+        memcpy(&stored, view + tableOffset + i * sizeof(StoredBlock), sizeof(stored));
+
+        uint64_t payloadSize = static_cast<uint64_t>(stored.slotsSize) + stored.valuesSize;
+        if (stored.layout > static_cast<uint8_t>(CandidateLayout::Full) || stored.offset > size ||
+            payloadSize > size - stored.offset || (i > 0 && stored.base <= loaded.m_entries[i - 1].block.base)) {
+            return false;
+        }
+
+        Entry& entry = loaded.m_entries[i];
+        entry.block.base = static_cast<uintptr_t>(stored.base);
+        entry.block.count = stored.count;
+        entry.block.firstSlot = stored.firstSlot;
+        entry.block.lastSlot = stored.lastSlot;
+        entry.block.keptPages = stored.keptPages;
+        entry.block.layout = static_cast<CandidateLayout>(stored.layout);
+        entry.offset = stored.offset;
+        entry.slotsSize = stored.slotsSize;
+        entry.valuesSize = stored.valuesSize;
+        count += stored.count;
+    }
+    if (count != header.count) return false;
+
+    loaded.m_count = static_cast<size_t>(count);
+    loaded.m_fileSize = size;
+    prefix = view + sizeof(header);
+    prefixSize = static_cast<size_t>(header.prefixSize);
+
+    Swap(loaded);
+    return true;
+}
+
+void CandidateStore::Close() {
+    m_mapped.Close();
+    if (m_spillFile != INVALID_HANDLE_VALUE) CloseHandle(m_spillFile);
+    m_spillFile = INVALID_HANDLE_VALUE;
+}
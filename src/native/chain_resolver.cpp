@@ -0,0 +1,239 @@
+#include "include/chain_resolver.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+inline void SkipSpaces(const std::string& text, size_t& pos) {
+    while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) pos++;
+}
+
+// 0x-prefixed hex or decimal; false if there are no digits or the value
+// does not fit in a pointer
+bool ParseNumber(const std::string& text, size_t& pos, uintptr_t& value) {
+    bool hex = text.compare(pos, 2, "0x") == 0 || text.compare(pos, 2, "0X") == 0;
+    if (hex) pos += 2;
+
+    uintptr_t base = hex ? 16 : 10;
+    size_t start = pos;
+    value = 0;
+    for (; pos < text.size(); ++pos) {
+        int c = tolower(static_cast<unsigned char>(text[pos]));
+        uintptr_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uintptr_t>(c - '0');
+        } else if (hex && c >= 'a' && c <= 'f') {
+            digit = static_cast<uintptr_t>(c - 'a' + 10);
+        } else {
+            break;
+        }
+        if (value > (UINTPTR_MAX - digit) / base) return false;
+        value = value * base + digit;
+    }
+    return pos > start;
+}
+
+// A module name runs to the next '+' or ']', or to a '-' before a hex
+// number; a '-' followed by anything else, as in "libc-2.31.so", is part of
+// the name
+size_t ModuleNameEnd(const std::string& text, size_t pos) {
+    for (; pos < text.size(); ++pos) {
+        if (text[pos] == '+' || text[pos] == ']') break;
+        if (text[pos] == '-') {
+            size_t next = pos + 1;
+            SkipSpaces(text, next);
+            if (text.compare(next, 2, "0x") == 0 || text.compare(next, 2, "0X") == 0) break;
+        }
+    }
+    return pos;
+}
+
+bool SameModuleName(const std::string& a, const std::string& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return tolower(static_cast<unsigned char>(x)) == tolower(static_cast<unsigned char>(y));
+    });
+}
+
+} // namespace
+
+ChainSet::ChainSet() : m_bound(false), m_lastReads(0) {
+}
+
+std::unique_ptr<ChainSet> ChainSet::Compile(const std::vector<std::string>& expressions, std::string& error) {
+    std::unique_ptr<ChainSet> set(new ChainSet());
+    for (const std::string& expression : expressions) {
+        if (!set->Parse(expression)) {
+            error = "Invalid pointer chain: " + expression;
+            return nullptr;
+        }
+    }
+
+    set->m_nodeIndex.clear();
+    set->m_baseAddresses.assign(set->m_bases.size(), 0);
+    return set;
+}
+
+size_t ChainSet::Nodes() const {
+    size_t nodes = 0;
+    for (const auto& level : m_levels) nodes += level.size();
+    return nodes;
+}
+
+uint32_t ChainSet::AddBase(const std::string& name, uintptr_t address) {
+    for (size_t i = 0; i < m_bases.size(); ++i) {
+        if (m_bases[i].name == name && m_bases[i].address == address) return static_cast<uint32_t>(i);
+    }
+    m_bases.push_back({ name, address });
+    return static_cast<uint32_t>(m_bases.size() - 1);
+}
+
+uint32_t ChainSet::AddNode(size_t depth, uint32_t parent, uintptr_t offset) {
+    auto key = std::make_tuple(depth, parent, offset);
+    auto found = m_nodeIndex.find(key);
+    if (found != m_nodeIndex.end()) return found->second;
+
+    if (m_levels.size() <= depth) m_levels.resize(depth + 1);
+    uint32_t index = static_cast<uint32_t>(m_levels[depth].size());
+    m_levels[depth].push_back({ parent, offset });
+    m_nodeIndex.emplace(key, index);
+    return index;
+}
+
+bool ChainSet::Parse(const std::string& expression) {
+    size_t pos = 0;
+    Chain chain;
+    if (!ParseTerm(expression, pos, chain)) return false;
+
+    SkipSpaces(expression, pos);
+    if (pos != expression.size()) return false;
+
+    m_chains.push_back(chain);
+    return true;
+}
+
+// term := '[' term ']' offsets | base offsets, where base is a number or a
+// module name
+bool ChainSet::ParseTerm(const std::string& text, size_t& pos, Chain& value) {
+    SkipSpaces(text, pos);
+    if (pos >= text.size()) return false;
+
+    if (text[pos] == '[') {
+        pos++;
+        Chain inner;
+        if (!ParseTerm(text, pos, inner)) return false;
+        SkipSpaces(text, pos);
+        if (pos >= text.size() || text[pos] != ']') return false;
+        pos++;
+
+        // Reading the pointer at the inner address makes a node one level deeper
+        value.node = AddNode(inner.depth, inner.node, inner.offset);
+        value.depth = inner.depth + 1;
+        value.offset = 0;
+    } else if (isdigit(static_cast<unsigned char>(text[pos]))) {
+        uintptr_t address;
+        if (!ParseNumber(text, pos, address)) return false;
+        value.node = AddBase(std::string(), address);
+        value.depth = 0;
+        value.offset = 0;
+    } else {
+        size_t end = ModuleNameEnd(text, pos);
+        size_t last = end;
+        while (last > pos && isspace(static_cast<unsigned char>(text[last - 1]))) last--;
+        if (last == pos || text.find('[', pos) < last) return false;
+
+        value.node = AddBase(text.substr(pos, last - pos), 0);
+        value.depth = 0;
+        value.offset = 0;
+        pos = end;
+    }
+
+    for (;;) {
+        SkipSpaces(text, pos);
+        if (pos >= text.size() || (text[pos] != '+' && text[pos] != '-')) return true;
+
+        bool negative = text[pos] == '-';
+        pos++;
+        SkipSpaces(text, pos);
+        uintptr_t offset;
+        if (!ParseNumber(text, pos, offset)) return false;
+
+        // Wraps, so a negative offset subtracts when added to an address
+        value.offset += negative ? 0 - offset : offset;
+    }
+}
+
+void ChainSet::BindModules(HANDLE processHandle) {
+    std::vector<ModuleImage> modules = MemoryHelpers::GetModuleImages(processHandle);
+
+    m_bound = true;
+    for (size_t i = 0; i < m_bases.size(); ++i) {
+        if (m_bases[i].name.empty()) {
+            m_baseAddresses[i] = m_bases[i].address;
+            continue;
+        }
+
+        m_baseAddresses[i] = 0;
+        for (const ModuleImage& module : modules) {
+            if (SameModuleName(module.name, m_bases[i].name)) {
+                m_baseAddresses[i] = module.base;
+                break;
+            }
+        }
+        if (m_baseAddresses[i] == 0) m_bound = false;
+    }
+}
+
+void ChainSet::Resolve(HANDLE processHandle, std::vector<uintptr_t>& addresses) {
+    if (!m_bound) BindModules(processHandle);
+
+    // The values read at each depth are this resolve's cache: every chain
+    // through a node uses the one read of it
+    PointerReader reader(processHandle);
+    std::vector<size_t> pending;
+    std::vector<uintptr_t> values;
+    std::vector<uint8_t> valid;
+    m_values.resize(m_levels.size());
+    m_valid.resize(m_levels.size());
+
+    for (size_t depth = 0; depth < m_levels.size(); ++depth) {
+        const std::vector<Node>& level = m_levels[depth];
+        m_values[depth].assign(level.size(), 0);
+        m_valid[depth].assign(level.size(), 0);
+
+        // Nodes below a broken pointer are not read at all
+        pending.clear();
+        m_addresses.clear();
+        for (size_t i = 0; i < level.size(); ++i) {
+            uintptr_t from;
+            if (depth == 0) {
+                from = m_baseAddresses[level[i].parent];
+            } else {
+                from = m_valid[depth - 1][level[i].parent] ? m_values[depth - 1][level[i].parent] : 0;
+            }
+            if (from == 0) continue;
+
+            pending.push_back(i);
+            m_addresses.push_back(from + level[i].offset);
+        }
+
+        reader.Read(m_addresses, values, valid);
+        for (size_t k = 0; k < pending.size(); ++k) {
+            // A null pointer ends the chain as surely as an unreadable one
+            m_values[depth][pending[k]] = values[k];
+            m_valid[depth][pending[k]] = valid[k] && values[k] != 0;
+        }
+    }
+
+    addresses.assign(m_chains.size(), 0);
+    for (size_t i = 0; i < m_chains.size(); ++i) {
+        const Chain& chain = m_chains[i];
+        if (chain.depth == 0) {
+            uintptr_t base = m_baseAddresses[chain.node];
+            addresses[i] = base ? base + chain.offset : 0;
+        } else if (m_valid[chain.depth - 1][chain.node]) {
+            addresses[i] = m_values[chain.depth - 1][chain.node] + chain.offset;
+        }
+    }
+
+    m_lastReads = reader.Calls();
+}
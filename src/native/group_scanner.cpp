@@ -0,0 +1,193 @@
+#include "include/group_scanner.h"
+#include <algorithm>
+
+namespace {
+
+const size_t UNPLACED = static_cast<size_t>(-1);
+
+inline bool Overlaps(size_t a, size_t aWidth, size_t b, size_t bWidth) {
+    return a < b + bWidth && b < a + aWidth;
+}
+
+} // namespace
+
+GroupScanner::GroupScanner(const std::vector<ValueQuery>& members, size_t window, bool ordered)
+    : m_window(window), m_ordered(ordered), m_empty(false), m_anchor(0) {
+    size_t totalWidth = 0;
+
+    for (const ValueQuery& query : members) {
+        m_scanners.emplace_back(query);
+        totalWidth += m_scanners.back().Width();
+        if (m_scanners.back().Empty()) m_empty = true;
+    }
+
+    if (m_scanners.empty() || m_scanners.size() > MAX_MEMBERS || window > MAX_WINDOW || totalWidth > window) {
+        m_empty = true;
+    }
+
+    // Until hits are counted, guess that the widest exact value is the rarest
+    for (size_t i = 1; i < members.size(); ++i) {
+        bool exact = members[i].op == ValueOp::Equal;
+        bool anchorExact = members[m_anchor].op == ValueOp::Equal;
+        if (exact != anchorExact ? exact : m_scanners[i].Width() > m_scanners[m_anchor].Width()) {
+            m_anchor = i;
+        }
+    }
+}
+
+void GroupScanner::CountHits(const uint8_t* data, size_t size, uintptr_t address,
+                             std::vector<size_t>& counts) const {
+    counts.resize(m_scanners.size(), 0);
+
+    std::vector<size_t> offsets;
+    for (size_t i = 0; i < m_scanners.size(); ++i) {
+        offsets.clear();
+        counts[i] += m_scanners[i].FindAll(data, size, address, 0, size, offsets, size);
+    }
+}
+
+void GroupScanner::ChooseAnchor(const std::vector<size_t>& counts) {
+    if (counts.size() != m_scanners.size()) return;
+
+    size_t best = 0;
+    for (size_t i = 1; i < counts.size(); ++i) {
+        if (counts[i] < counts[best] ||
+            (counts[i] == counts[best] && m_scanners[i].Width() > m_scanners[best].Width())) {
+            best = i;
+        }
+    }
+    m_anchor = best;
+}
+
+size_t GroupScanner::FindAll(const uint8_t* data, size_t size, uintptr_t address, size_t carried, size_t owned,
+                             std::vector<GroupHit>& hits, size_t maxResults) const {
+    if (m_empty || data == nullptr || maxResults == 0) return 0;
+
+    const ValueScanner& anchor = m_scanners[m_anchor];
+    const size_t anchorWidth = anchor.Width();
+
+    // A group spans at most the window, so it ends past carried only if the
+    // anchor starts within a window of it, and starts before owned only if
+    // the anchor does within a window of that
+    size_t from = carried >= m_window ? carried - m_window + 1 : 0;
+    size_t limit = owned + m_window - anchorWidth;
+
+    std::vector<size_t> anchors;
+    anchor.FindAll(data, size, address, from, limit, anchors, size);
+
+    std::vector<size_t> offsets(m_scanners.size(), UNPLACED);
+    std::vector<std::vector<size_t>> candidates(m_scanners.size());
+    std::vector<size_t> order(m_scanners.size());
+    size_t count = 0;
+
+    for (size_t anchorOffset : anchors) {
+        // Every member must sit within a window of the anchor; collect each
+        // one's candidates there once and drop the anchor if any has none
+        size_t windowFrom = anchorOffset + anchorWidth > m_window ? anchorOffset + anchorWidth - m_window : 0;
+        size_t windowEnd = std::min(size, anchorOffset + m_window);
+        bool possible = true;
+        for (size_t i = 0; i < m_scanners.size() && possible; ++i) {
+            candidates[i].clear();
+            if (i == m_anchor) continue;
+            size_t width = m_scanners[i].Width();
+            if (windowEnd >= windowFrom + width) {
+                m_scanners[i].FindAll(data, size, address, windowFrom, windowEnd - width + 1, candidates[i], size);
+            }
+            possible = !candidates[i].empty();
+        }
+        if (!possible) continue;
+
+        // Ordered groups place members in query order; unordered ones place
+        // the member with the fewest candidates first so dead ends show early
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        if (!m_ordered) {
+            std::stable_sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+                return candidates[a].size() < candidates[b].size();
+            });
+        }
+
+        std::fill(offsets.begin(), offsets.end(), UNPLACED);
+        offsets[m_anchor] = anchorOffset;
+
+        size_t budget = MAX_PLACE_TRIES;
+        if (!Place(0, order, anchorOffset, anchorOffset + anchorWidth, offsets, candidates, budget)) {
+            continue;
+        }
+
+        size_t low = anchorOffset;
+        size_t high = anchorOffset + anchorWidth;
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            low = std::min(low, offsets[i]);
+            high = std::max(high, offsets[i] + m_scanners[i].Width());
+        }
+        if (low >= owned || high <= carried) continue;
+
+        GroupHit hit;
+        hit.offset = low;
+        hit.size = high - low;
+        hit.members = offsets;
+        hits.push_back(std::move(hit));
+        if (++count >= maxResults) break;
+    }
+
+    return count;
+}
+
+// Places the members from order[depth] onwards around the ones already
+// placed, whose bytes span [low, high). Candidates are tried in address
+// order, so the first placement found is kept; budget counts the candidates
+// tried, and the search gives up once it runs out.
+bool GroupScanner::Place(size_t depth, const std::vector<size_t>& order, size_t low, size_t high,
+                         std::vector<size_t>& offsets, const std::vector<std::vector<size_t>>& candidates,
+                         size_t& budget) const {
+    while (depth < order.size() && offsets[order[depth]] != UNPLACED) ++depth;
+    if (depth == order.size()) return true;
+
+    const size_t member = order[depth];
+    const size_t width = m_scanners[member].Width();
+
+    // Keeping the group inside the window bounds where this member can sit
+    size_t from = high > m_window ? high - m_window : 0;
+    size_t end = low + m_window;
+
+    if (m_ordered) {
+        // Members are placed in query order, so the previous one is placed;
+        // the ones between this member and the anchor still need room
+        if (member > 0) from = std::max(from, offsets[member - 1] + m_scanners[member - 1].Width());
+        if (member < m_anchor) {
+            size_t between = 0;
+            for (size_t i = member + 1; i < m_anchor; ++i) between += m_scanners[i].Width();
+            if (offsets[m_anchor] < between) return false;
+            end = std::min(end, offsets[m_anchor] - between);
+        }
+    }
+    if (end < from + width) return false;
+
+    const std::vector<size_t>& found = candidates[member];
+    for (auto it = std::lower_bound(found.begin(), found.end(), from); it != found.end() && *it + width <= end;
+         ++it) {
+        if (budget == 0) return false;
+        --budget;
+
+        size_t offset = *it;
+        bool free = true;
+        if (!m_ordered) {
+            for (size_t i = 0; i < offsets.size() && free; ++i) {
+                if (offsets[i] != UNPLACED && Overlaps(offset, width, offsets[i], m_scanners[i].Width())) {
+                    free = false;
+                }
+            }
+        }
+        if (!free) continue;
+
+        offsets[member] = offset;
+        if (Place(depth + 1, order, std::min(low, offset), std::max(high, offset + width), offsets, candidates,
+                  budget)) {
+            return true;
+        }
+        offsets[member] = UNPLACED;
+        if (budget == 0) return false;
+    }
+
+    return false;
+}
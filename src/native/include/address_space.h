@@ -0,0 +1,30 @@
+#ifndef ADDRESS_SPACE_H
+#define ADDRESS_SPACE_H
+
+#include <windows.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "module_map.h"
+#include "memory_helpers.h"
+#include "scan_executor.h"
+
+// The module table of a Windows target, for turning absolute addresses into
+// module-relative ones and for keeping scans to static memory. The modules
+// are the loaded images and their sections come from the section headers of
+// each image, read from the target.
+class AddressSpace : public ModuleMap {
+public:
+    static std::unique_ptr<AddressSpace> Capture(HANDLE processHandle);
+
+    // The module table in the form the pointer scanners take
+    std::vector<ModuleImage> Images() const;
+
+    // Appends the parts of [start, end) that lie inside module images
+    void ImageRanges(uintptr_t start, uintptr_t end, std::vector<ScanRange>& ranges) const;
+
+private:
+    AddressSpace();
+};
+
+#endif // ADDRESS_SPACE_H
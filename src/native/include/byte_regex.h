@@ -0,0 +1,108 @@
+#ifndef BYTE_REGEX_H
+#define BYTE_REGEX_H
+
+#include <bitset>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Regular expressions over raw bytes, matched by a lazily built DFA. There is
+// no backtracking: every input byte costs one table lookup once the states it
+// visits are cached, whatever the pattern.
+//
+// Supported syntax: literals, ".", "[a-z]" / "[^...]" classes, "\d \w \s"
+// and their negations, "\xNN", "\n \r \t \f \v \0", escaped metacharacters,
+// "* + ? {n} {n,} {n,m}" (a trailing "?" is accepted and ignored), groups
+// "(...)" / "(?:...)" and "|". Anchors, backreferences and lookaround are not
+// supported, and a pattern that can match the empty string is rejected.
+//
+// Matches are leftmost-longest and do not overlap. Patterns with unbounded
+// repetition are cut off at MAX_MATCH_LENGTH bytes.
+class ByteRegex {
+public:
+    static constexpr size_t MAX_MATCH_LENGTH = 4096;
+    static constexpr size_t MAX_REPEAT = 1000;
+    static constexpr size_t MAX_NFA_STATES = 50000;
+    static constexpr size_t DFA_CACHE_STATES = 2048;
+
+    // Returns nullptr and fills error when the pattern is not supported
+    static std::unique_ptr<ByteRegex> Compile(const std::string& pattern, std::string& error);
+
+    // Longest possible match, capped at MAX_MATCH_LENGTH
+    size_t MaxMatchLength() const { return m_maxLength; }
+    bool Unbounded() const { return m_unbounded; }
+
+    // Holds the DFA state caches. A ByteRegex is immutable and can be shared,
+    // but each thread needs its own Matcher.
+    class Matcher {
+    public:
+        explicit Matcher(const ByteRegex& regex);
+
+        // Finds the leftmost-longest match starting in [from, limit) and
+        // ending within data[0, size). Returns false when there is none.
+        bool Find(const uint8_t* data, size_t size, size_t from, size_t limit,
+                  size_t& matchStart, size_t& matchEnd);
+
+    private:
+        struct Dfa {
+            bool unanchored;
+            std::vector<std::vector<int>> sets;   // Sorted NFA states of each DFA state
+            std::vector<uint8_t> matching;
+            std::vector<int32_t> next;            // state * class count + class, -1 if not built
+            std::map<std::vector<int>, int32_t> index;
+            int32_t start;
+        };
+
+        int32_t Start(Dfa& dfa);
+        int32_t Step(Dfa& dfa, int32_t state, uint8_t byte) {
+            int32_t next = dfa.next[static_cast<size_t>(state) * m_regex.m_classCount + m_regex.m_byteClass[byte]];
+            return next >= 0 ? next : Build(dfa, state, byte);
+        }
+        int32_t Build(Dfa& dfa, int32_t state, uint8_t byte);
+        int32_t Intern(Dfa& dfa, std::vector<int>& set);
+        void Reset(Dfa& dfa);
+
+        // End of the longest match starting at start, or 0 when there is none
+        size_t LongestAt(const uint8_t* data, size_t start, size_t end);
+
+        const ByteRegex& m_regex;
+        Dfa m_search;    // Unanchored, finds the earliest match end
+        Dfa m_anchored;  // Extends a match from a known start
+        std::vector<int> m_scratch;
+        std::vector<uint8_t> m_seen;
+    };
+
+private:
+    struct NfaState {
+        enum Type { Byte, Split, Match } type;
+        int set;    // Byte: index into m_sets
+        int out;
+        int out1;   // Split: second branch
+    };
+
+    friend class RegexParser;
+
+    ByteRegex() : m_start(0), m_classCount(0), m_firstByte(-1), m_maxLength(0), m_unbounded(false) {}
+
+    void BuildByteClasses();
+    void AddClosure(int state, std::vector<int>& set, std::vector<uint8_t>& seen) const;
+
+    std::vector<NfaState> m_states;
+    std::vector<std::bitset<256>> m_sets;
+    std::vector<int> m_startSet;   // Epsilon closure of m_start
+    int m_start;
+
+    // Bytes no pattern set tells apart share a class, shrinking DFA rows
+    uint8_t m_byteClass[256];
+    size_t m_classCount;
+    std::bitset<256> m_firstBytes;
+    int m_firstByte;               // The only possible first byte, or -1
+
+    size_t m_maxLength;
+    bool m_unbounded;
+};
+
+#endif // BYTE_REGEX_H
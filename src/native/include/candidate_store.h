@@ -0,0 +1,111 @@
+#ifndef CANDIDATE_STORE_H
+#define CANDIDATE_STORE_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+
+enum class CandidateLayout : uint8_t {
+    Sparse,   // LEB128 gaps between slot numbers, values packed in slot order
+    Dense,    // Slot bitmap from firstSlot, raw bytes of the pages holding candidates
+    Full      // Every slot from firstSlot to lastSlot, raw bytes of the whole span
+};
+
+// Candidates within one ScanSession::BLOCK_SIZE span of the address space.
+// Slots are addresses base + slot * step, and a block's span runs from its
+// first slot to the end of the value at its last slot. Each block is stored
+// in whichever layout is smaller; a dense block keeps only the 4 KB pages of
+// its span that still hold a candidate, and a block with no candidates is
+// dropped.
+struct CandidateBlock {
+    uintptr_t base;
+    uint32_t count;
+    uint32_t firstSlot;     // Dense: bitmap origin, which need not be a candidate
+    uint32_t lastSlot;
+    uint32_t keptPages;     // Dense: bit p is set when page p of the span is in values
+    CandidateLayout layout;
+    std::vector<uint8_t> slots;     // Sparse: slot gaps; dense: bitmap
+    std::vector<uint8_t> values;
+};
+
+// The candidate blocks of one scan, in address order. Block contents stay in
+// memory up to memoryLimit bytes; past that, each block's slots and values
+// are appended to a temporary file and only its header stays resident, so a
+// first scan for a common value keeps every hit. Finish() maps the file for
+// reading and later scans stream the blocks back in order. The file is
+// deleted when the store is closed.
+//
+// A finished store can also be saved to a file and loaded back: loading
+// maps the saved file and reads only the block headers, so a store of any
+// size reopens at once.
+class CandidateStore {
+public:
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+    // memoryLimit of 0 uses DEFAULT_MEMORY_LIMIT
+    explicit CandidateStore(size_t memoryLimit = 0);
+    ~CandidateStore();
+
+    CandidateStore(const CandidateStore&) = delete;
+    CandidateStore& operator=(const CandidateStore&) = delete;
+
+    void Swap(CandidateStore& other);
+
+    // Takes the contents of blocks, in any order; scan workers may add
+    // concurrently
+    void Add(std::vector<CandidateBlock>& blocks);
+    // Sorts the blocks by address and maps the spilled ones. Returns false
+    // when the temporary file could not be written or mapped.
+    bool Finish();
+
+    size_t Blocks() const { return m_entries.size(); }
+    size_t Count() const { return m_count; }
+    // The block itself when resident; otherwise a copy in scratch. Safe to
+    // call concurrently once finished.
+    const CandidateBlock& Get(size_t index, CandidateBlock& scratch) const;
+
+    // Bytes held in memory, headers included
+    size_t MemoryUsage() const;
+    // Bytes spilled to the temporary file, or mapped from a loaded one
+    size_t DiskUsage() const { return static_cast<size_t>(m_fileSize); }
+
+    // Writes prefix, which the caller reads back on load, and then the
+    // blocks to path. The file is written under a temporary name and
+    // replaces path only once complete.
+    bool Save(const std::wstring& path, const std::vector<uint8_t>& prefix) const;
+    // Replaces the contents with those of a file written by Save and points
+    // prefix at its prefix, which stays valid while the store holds them.
+    // Returns false, leaving the store as it was, when the file cannot be
+    // read or is not a saved store.
+    bool Load(const std::wstring& path, const uint8_t*& prefix, size_t& prefixSize);
+
+private:
+    struct Entry {
+        CandidateBlock block;       // Header only when spilled
+        uint64_t offset;            // In the file or mapping, or NOT_SPILLED
+        uint32_t slotsSize;
+        uint32_t valuesSize;
+    };
+
+    static constexpr uint64_t NOT_SPILLED = ~0ULL;
+
+    bool Spill(Entry& entry);
+    void Close();
+
+    size_t m_memoryLimit;
+    size_t m_resident;
+    size_t m_count;
+    std::vector<Entry> m_entries;
+
+    HANDLE m_spillFile;         // Until Finish() maps it
+    MappedFile m_mapped;        // The spill file, or a loaded file
+    uint64_t m_fileSize;
+    bool m_failed;
+    std::mutex m_mutex;
+};
+
+#endif // CANDIDATE_STORE_H
@@ -0,0 +1,84 @@
+#ifndef CHAIN_RESOLVER_H
+#define CHAIN_RESOLVER_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <tuple>
+#include <cstdint>
+#include <cstddef>
+#include "memory_helpers.h"
+#include "pointer_reader.h"
+
+// Pointer chains compiled for resolving many times, e.g. once per frame.
+// An expression reads like "[[game.exe+0x1234]+0x10]+8": brackets read the
+// pointer at the address inside them, and the base is an address or a
+// module name. Numbers are hex with 0x, decimal otherwise; offsets may be
+// negative, though one right after a module name must be written in hex.
+//
+// The chains are merged into a tree of shared prefixes, so a pointer that
+// several chains pass through is read once per resolve. Resolving walks the
+// tree one depth at a time and reads every pointer of a depth in a single
+// PointerReader batch.
+class ChainSet {
+public:
+    // Fails on the first expression that does not parse, naming it in error
+    static std::unique_ptr<ChainSet> Compile(const std::vector<std::string>& expressions, std::string& error);
+
+    size_t Size() const { return m_chains.size(); }
+    // Pointers read per resolve
+    size_t Nodes() const;
+    // Reads made by the last resolve
+    size_t LastReads() const { return m_lastReads; }
+
+    // Final address of every chain, in expression order; 0 where a module
+    // is not loaded or a pointer on the way cannot be read. Module bases are
+    // looked up on the first call, and again while any module is missing.
+    void Resolve(HANDLE processHandle, std::vector<uintptr_t>& addresses);
+
+private:
+    // A pointer read: at its parent's value, or at its base for depth 0,
+    // plus offset
+    struct Node {
+        uint32_t parent;   // Index in the depth above, or the base for depth 0
+        uintptr_t offset;
+    };
+
+    // The last node read, or the base when the chain reads nothing, plus offset
+    struct Chain {
+        uint32_t depth;    // Pointers read
+        uint32_t node;     // Index in depth - 1, or the base when depth is 0
+        uintptr_t offset;
+    };
+
+    // A module name, or an absolute address when name is empty
+    struct Base {
+        std::string name;
+        uintptr_t address;
+    };
+
+    ChainSet();
+
+    bool Parse(const std::string& expression);
+    bool ParseTerm(const std::string& text, size_t& pos, Chain& value);
+    uint32_t AddBase(const std::string& name, uintptr_t address);
+    uint32_t AddNode(size_t depth, uint32_t parent, uintptr_t offset);
+    void BindModules(HANDLE processHandle);
+
+    std::vector<Base> m_bases;
+    std::vector<std::vector<Node>> m_levels;
+    std::vector<Chain> m_chains;
+    std::map<std::tuple<size_t, uint32_t, uintptr_t>, uint32_t> m_nodeIndex;   // Only while compiling
+
+    // Resolve state, kept to avoid allocating on every call
+    std::vector<uintptr_t> m_baseAddresses;
+    bool m_bound;
+    std::vector<std::vector<uintptr_t>> m_values;
+    std::vector<std::vector<uint8_t>> m_valid;
+    std::vector<uintptr_t> m_addresses;
+    size_t m_lastReads;
+};
+
+#endif // CHAIN_RESOLVER_H
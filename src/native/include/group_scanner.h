@@ -0,0 +1,68 @@
+#ifndef GROUP_SCANNER_H
+#define GROUP_SCANNER_H
+
+#include "value_scanner.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct GroupHit {
+    size_t offset;                 // Lowest member offset
+    size_t size;                   // From offset to the end of the highest member
+    std::vector<size_t> members;   // Member offsets, in query order
+};
+
+// Finds groups of typed values lying close together, e.g. the health, ammo
+// and speed fields of one struct, in a single pass. Each member is a
+// ValueQuery with its own ValueScanner. The scan runs on the anchor member
+// only, which should be the rarest one (see ChooseAnchor); around each anchor
+// hit the other members are searched within the window and one placement
+// that satisfies every constraint is kept. Members never overlap each other,
+// the whole group spans at most window bytes, and ordered groups have their
+// members at increasing addresses in query order. The placement search is a
+// backtracking one, so it is capped at MAX_PLACE_TRIES candidates per anchor
+// hit; an anchor that exhausts it is dropped, which only happens when many
+// members could each sit at many offsets but no placement fits them all.
+class GroupScanner {
+public:
+    static constexpr size_t MAX_MEMBERS = 16;
+    static constexpr size_t MAX_WINDOW = 64 * 1024;
+    static constexpr size_t MAX_PLACE_TRIES = 4096;
+
+    GroupScanner(const std::vector<ValueQuery>& members, size_t window, bool ordered);
+
+    // No group can match: a member never passes, or the members cannot fit
+    // in the window
+    bool Empty() const { return m_empty; }
+    size_t Members() const { return m_scanners.size(); }
+    size_t Window() const { return m_window; }
+    size_t Anchor() const { return m_anchor; }
+
+    // Adds each member's number of hits in data[0, size) to counts, which is
+    // resized to Members(); address is where data[0] lives in the target
+    void CountHits(const uint8_t* data, size_t size, uintptr_t address, std::vector<size_t>& counts) const;
+    // Anchors on the member with the fewest counted hits, preferring wider
+    // values and then earlier members on ties
+    void ChooseAnchor(const std::vector<size_t>& counts);
+
+    // Appends the group found around each anchor hit, in anchor order, when
+    // it lies wholly inside data[0, size), starts before owned and ends past
+    // carried; returns how many were added, stopping at maxResults. Groups
+    // ending inside the carried bytes were reported with the previous chunk.
+    // An anchor with several placements near a chunk seam can be placed
+    // differently on either side, so callers keep one group per anchor.
+    size_t FindAll(const uint8_t* data, size_t size, uintptr_t address, size_t carried, size_t owned,
+                   std::vector<GroupHit>& hits, size_t maxResults) const;
+
+private:
+    bool Place(size_t depth, const std::vector<size_t>& order, size_t low, size_t high, std::vector<size_t>& offsets,
+               const std::vector<std::vector<size_t>>& candidates, size_t& budget) const;
+
+    std::vector<ValueScanner> m_scanners;
+    size_t m_window;
+    bool m_ordered;
+    bool m_empty;
+    size_t m_anchor;
+};
+
+#endif // GROUP_SCANNER_H
@@ -0,0 +1,35 @@
+#ifndef INSTRUCTION_DECODER_H
+#define INSTRUCTION_DECODER_H
+
+#include <cstdint>
+#include <cstddef>
+
+enum class BranchKind : uint8_t {
+    None,
+    Call,          // E8 rel32
+    Jump,          // E9 rel32, EB rel8
+    Conditional    // Jcc rel8 / rel32, LOOPcc, JRCXZ
+};
+
+struct DecodedInstruction {
+    size_t length;
+    BranchKind branch;        // A direct branch to branchTarget
+    uintptr_t branchTarget;
+    bool ripRelative;         // A RIP-relative memory operand at memoryTarget
+    uintptr_t memoryTarget;
+};
+
+// Length decoder for 64-bit mode x86 code: legacy, REX, VEX, EVEX and XOP
+// prefixes, the one-, two- and three-byte opcode maps, ModRM, SIB,
+// displacements and immediates. It finds where each instruction ends and
+// what it branches to or addresses relative to RIP, but not what it does.
+class InstructionDecoder {
+public:
+    static constexpr size_t MAX_LENGTH = 15;
+
+    // False if the bytes are not a valid instruction or it runs past
+    // available; address is where code[0] lies in the target
+    static bool Decode(const uint8_t* code, size_t available, uintptr_t address, DecodedInstruction& instruction);
+};
+
+#endif // INSTRUCTION_DECODER_H
@@ -0,0 +1,89 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Writes all of data at the file's current position
+bool WriteAll(HANDLE file, const void* data, size_t size);
+
+// Creates an empty file in the temp directory that is deleted with its last
+// handle, even if the process dies. Returns INVALID_HANDLE_VALUE on failure.
+HANDLE CreateTemporaryFile(const wchar_t* prefix);
+
+// Collects small writes to a file into large ones. The first failure sticks
+// and is reported by Flush().
+class FileWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 1024 * 1024;
+
+    explicit FileWriter(HANDLE file);
+
+    void Write(const void* data, size_t size);
+    // Writes zeros up to the next multiple of alignment
+    void Pad(size_t alignment);
+    uint64_t Written() const { return m_written; }
+    bool Flush();
+
+private:
+    HANDLE m_file;
+    bool m_failed;
+    uint64_t m_written;
+    std::vector<uint8_t> m_buffer;
+};
+
+// Saves a file under a temporary name next to path, which replaces path on
+// Commit(). A save that fails or is abandoned leaves path as it was.
+class FileSaver {
+public:
+    explicit FileSaver(const std::wstring& path);
+    ~FileSaver();
+
+    FileSaver(const FileSaver&) = delete;
+    FileSaver& operator=(const FileSaver&) = delete;
+
+    bool IsOpen() const { return m_file != INVALID_HANDLE_VALUE; }
+    FileWriter& Writer() { return m_writer; }
+    bool Commit();
+
+private:
+    std::wstring m_path;
+    std::wstring m_temporary;
+    HANDLE m_file;
+    FileWriter m_writer;
+};
+
+// A read-only mapping of a whole file. Saved indexes and sessions are read
+// straight from the mapping, so opening one costs the same at any size and
+// its pages are loaded only as they are used.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void Swap(MappedFile& other);
+
+    // Opens and maps path, which others may read but not change meanwhile
+    bool Open(const std::wstring& path);
+    // Maps file, taking ownership of the handle whether or not it succeeds
+    bool Map(HANDLE file);
+    void Close();
+
+    bool IsOpen() const { return m_view != nullptr; }
+    const uint8_t* Data() const { return m_view; }
+    uint64_t Size() const { return m_size; }
+
+private:
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_view;
+    uint64_t m_size;
+};
+
+#endif // MAPPED_FILE_H
@@ -5,6 +5,16 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <functional>
+#include "region_reader.h"
+#include "scan_executor.h"
+
+class PatternMatcher;
+class Signature;
+enum class StringEncoding : uint32_t;
+class StringSink;
+struct StringExtractionStats;
+struct ValueQuery;
 
 struct PointerResult {
     uintptr_t address;
@@ -18,6 +28,20 @@ struct PatternMatch {
     std::vector<uint8_t> data;
 };
 
+struct StringMatch {
+    uintptr_t address;
+    size_t size;
+    StringEncoding encoding;
+    std::vector<uint8_t> data;
+};
+
+struct MultiPatternMatch {
+    uintptr_t address;
+    size_t patternId;
+    size_t size;
+    std::vector<uint8_t> data;
+};
+
 struct MemoryRegionEx {
     uintptr_t startAddress;
     uintptr_t endAddress;
@@ -27,17 +51,41 @@ struct MemoryRegionEx {
     std::string moduleName;
 };
 
+// A process instance: process ids are reused, so the creation time tells a
+// restarted target apart from the one a result was taken from
+struct ProcessIdentity {
+    DWORD processId;
+    uint64_t startTime;   // FILETIME of creation, in 100 ns units
+};
+
+// A module image loaded in the target
+struct ModuleImage {
+    std::string name;     // Base name, e.g. "game.exe"
+    uintptr_t base;
+    size_t size;
+};
+
 struct NumericMatch {
     uintptr_t address;
     std::string dataType;
     std::vector<uint8_t> rawData;
 };
 
+struct GroupMatch {
+    uintptr_t address;                // Lowest member address
+    std::vector<uintptr_t> members;   // Member addresses, in query order
+    std::vector<uint8_t> data;        // From address to the end of the highest member
+};
+
 class MemoryHelpers {
 public:
     // Pointer finding operations
     static std::vector<PointerResult> FindPointersTo(HANDLE processHandle, uintptr_t targetAddress, 
                                                      uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
+    // Every pointer within maxDepth reads of finalAddress, each as (location,
+    // the address it leads to, offset added). offsets[i] is the largest offset
+    // allowed at depth i + 1, the last one applying deeper; none means exact
+    // pointers only. See PointerPathScanner for full paths from static bases.
     static std::vector<PointerResult> FindPointerChain(HANDLE processHandle, uintptr_t finalAddress, 
                                                        int maxDepth = 5, const std::vector<size_t>& offsets = {});
     static std::vector<uintptr_t> FindNullPointers(HANDLE processHandle, uintptr_t searchStart, 
@@ -47,27 +95,45 @@ public:
     static std::vector<PatternMatch> SearchBytePattern(HANDLE processHandle, const std::vector<uint8_t>& pattern, 
                                                       const std::vector<bool>& mask, uintptr_t searchStart = 0, 
                                                       uintptr_t searchEnd = 0);
+    // Scans with a signature compiled once by Signature::Compile
+    static std::vector<PatternMatch> SearchSignature(HANDLE processHandle, const Signature& signature,
+                                                    uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
     static std::vector<PatternMatch> SearchStringPattern(HANDLE processHandle, const std::string& pattern, 
                                                         bool caseSensitive = true, bool unicode = false,
                                                         uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
+    // One pass finds the text in every requested encoding (StringEncoding flags)
+    static std::vector<StringMatch> SearchString(HANDLE processHandle, const std::string& text, uint32_t encodings,
+                                                 bool caseSensitive = true, uintptr_t searchStart = 0,
+                                                 uintptr_t searchEnd = 0);
+    static std::vector<MultiPatternMatch> SearchMultiplePatterns(HANDLE processHandle,
+                                                                const std::vector<std::vector<uint8_t>>& patterns,
+                                                                const std::vector<std::vector<bool>>& masks,
+                                                                uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
     static std::vector<PatternMatch> SearchRegexPattern(HANDLE processHandle, const std::string& regexPattern,
                                                        uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
+    // Streams every printable run of at least minLength characters in the
+    // requested encodings to sink, in address order and in batches
+    static StringExtractionStats ExtractStrings(HANDLE processHandle, StringSink& sink, size_t minLength,
+                                                uint32_t encodings, uintptr_t searchStart = 0,
+                                                uintptr_t searchEnd = 0, size_t batchSize = 0);
 
-    // Numeric value searching
-    static std::vector<NumericMatch> SearchInt32(HANDLE processHandle, int32_t value, uintptr_t searchStart = 0, 
-                                                 uintptr_t searchEnd = 0, bool aligned = false);
-    static std::vector<NumericMatch> SearchInt64(HANDLE processHandle, int64_t value, uintptr_t searchStart = 0, 
-                                                 uintptr_t searchEnd = 0, bool aligned = false);
-    static std::vector<NumericMatch> SearchFloat(HANDLE processHandle, float value, float tolerance = 0.001f,
-                                                uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
-    static std::vector<NumericMatch> SearchDouble(HANDLE processHandle, double value, double tolerance = 0.001,
+    // Numeric value searching. One SIMD kernel serves every value type,
+    // alignment and predicate; see ValueScanner.
+    static std::vector<NumericMatch> SearchValue(HANDLE processHandle, const ValueQuery& query,
                                                  uintptr_t searchStart = 0, uintptr_t searchEnd = 0);
+    // Finds groups of values within window bytes of each other in one pass,
+    // anchored on whichever member is rarest in a sample; see GroupScanner
+    static std::vector<GroupMatch> SearchGroup(HANDLE processHandle, const std::vector<ValueQuery>& members,
+                                               size_t window, bool ordered, uintptr_t searchStart = 0,
+                                               uintptr_t searchEnd = 0);
 
     // Memory region analysis
     static std::vector<MemoryRegionEx> GetMemoryRegions(HANDLE processHandle, bool executableOnly = false,
                                                        bool writableOnly = false);
     static std::vector<MemoryRegionEx> GetModuleRegions(HANDLE processHandle, const std::string& moduleName = "");
     static MemoryRegionEx GetRegionInfo(HANDLE processHandle, uintptr_t address);
+    // The target's modules, sorted by base address
+    static std::vector<ModuleImage> GetModuleImages(HANDLE processHandle);
 
     // Advanced scanning utilities
     static std::vector<PatternMatch> ScanForCode(HANDLE processHandle, const std::vector<uint8_t>& opcodes,
@@ -89,16 +155,42 @@ public:
     static std::string FormatAddress(uintptr_t address, bool withPrefix = true);
     static bool IsValidCodeAddress(HANDLE processHandle, uintptr_t address);
     static size_t GetAlignment(uintptr_t address);
+    static bool GetProcessIdentity(HANDLE processHandle, ProcessIdentity& identity);
+    // Region maps saved with sessions and indexes: bounds, protection, type
+    // and module name of each region. LoadRegions reads count regions from
+    // data[offset, size) and advances offset; false if they run past size.
+    static void SaveRegions(const std::vector<MemoryRegionEx>& regions, std::vector<uint8_t>& out);
+    static bool LoadRegions(const uint8_t* data, size_t size, size_t& offset, uint64_t count,
+                            std::vector<MemoryRegionEx>& regions);
+
+    // Upper bound on the read buffer each scan holds, whatever the region size
+    static size_t SetScanMemoryBudget(size_t bytes);
+    static size_t GetScanMemoryBudget();
 
 private:
-    static const size_t MAX_SCAN_SIZE = 100 * 1024 * 1024; // 100MB
     static const size_t MAX_RESULTS = 10000;
     static const size_t CHUNK_SIZE = 1024 * 1024; // 1MB chunks
+    static constexpr size_t GROUP_SAMPLES = 32;
+    static constexpr size_t GROUP_SAMPLE_SIZE = 64 * 1024;
     
     static bool IsAddressInRange(uintptr_t address, uintptr_t start, uintptr_t end);
+    static std::vector<PatternMatch> SearchWithMatcher(HANDLE processHandle, const PatternMatcher& matcher,
+                                                      uintptr_t searchStart, uintptr_t searchEnd,
+                                                      const char* operation);
+    static std::vector<ScanRange> CollectScanRanges(HANDLE processHandle, bool executableOnly,
+                                                    uintptr_t searchStart, uintptr_t searchEnd);
+    // Scans every readable region overlapping [searchStart, searchEnd) on the
+    // scan executor; results come back in address order
+    template <typename Result>
+    static std::vector<Result> ScanChunks(HANDLE processHandle, bool executableOnly, uintptr_t searchStart,
+                                          uintptr_t searchEnd, size_t overlap,
+                                          const std::function<bool(const RegionChunk&, std::vector<Result>&)>& scanChunk) {
+        return ParallelScan<Result>(processHandle, CollectScanRanges(processHandle, executableOnly, searchStart, searchEnd),
+                                    overlap, MAX_RESULTS, scanChunk);
+    }
+    static size_t FirstAlignedOffset(const RegionChunk& chunk, size_t alignment);
     static std::vector<uint8_t> ReadMemoryChunk(HANDLE processHandle, uintptr_t address, size_t size);
-    static bool MatchesPattern(const uint8_t* data, const std::vector<uint8_t>& pattern, 
-                              const std::vector<bool>& mask);
+    static size_t ReadMemoryInto(HANDLE processHandle, uintptr_t address, std::vector<uint8_t>& buffer, size_t size);
 };
 
 #endif // MEMORY_HELPERS_H 
\ No newline at end of file
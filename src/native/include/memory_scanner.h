@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 #include "process_manager.h"
+#include "pattern_matcher.h"
+#include "scan_executor.h"
 
 struct ScanResult {
     LPVOID address;
@@ -54,8 +56,11 @@ public:
 private:
     ProcessManager* m_processManager;
     
-    bool scanMemoryRegion(LPVOID startAddress, SIZE_T size, const std::vector<BYTE>& pattern, 
-                         const std::vector<bool>& mask, std::vector<LPVOID>& results);
+    static constexpr size_t MAX_RESULTS = 10000;
+    
+    std::vector<ScanRange> getScannableRanges();
+    bool scanMemoryRegions(const std::vector<ScanRange>& ranges, const PatternMatcher& matcher, 
+                           std::vector<LPVOID>& results);
     MEMORY_BASIC_INFORMATION getMemoryInfo(LPVOID address);
 };
 
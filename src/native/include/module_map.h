@@ -0,0 +1,65 @@
+#ifndef MODULE_MAP_H
+#define MODULE_MAP_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// A section of a module image, relative to the module base
+struct ModuleSection {
+    std::string name;     // ".text" for PE images; the mapping's permissions, e.g. "r-xp", for ELF
+    uintptr_t offset;
+    size_t size;
+};
+
+struct AddressModule {
+    std::string name;     // Base name, e.g. "game.exe" or "libc.so.6"
+    uintptr_t base;
+    size_t size;
+    std::vector<ModuleSection> sections;   // Sorted by offset
+};
+
+// Where an address lies in terms that survive ASLR: a module, the section
+// holding it, and its offset from the module base
+struct ModuleAddress {
+    uint32_t module;      // Index into ModuleMap::Modules()
+    uint32_t section;     // Index into the module's sections, or NO_SECTION
+    uintptr_t moduleOffset;
+};
+
+// The module images of a target, sorted by base. Lookups are binary searches
+// over the module table and then the module's sections. Nothing here uses
+// Win32, so the model can be built and tested from a Linux /proc/<pid>/maps
+// listing: the mappings of one file make a module, each mapping a section,
+// and an anonymous mapping right after a module's writable mapping is its
+// .bss. AddressSpace fills the same table from a Windows target.
+class ModuleMap {
+public:
+    static const uint32_t NO_SECTION = UINT32_MAX;
+
+    static std::unique_ptr<ModuleMap> ParseProcMaps(const std::string& text);
+    static std::unique_ptr<ModuleMap> LoadProcMaps(uint32_t processId, std::string& error);
+
+    virtual ~ModuleMap() {}
+
+    const std::vector<AddressModule>& Modules() const { return m_modules; }
+
+    // False if address is not inside a module image
+    bool Locate(uintptr_t address, ModuleAddress& location) const;
+    // The absolute address of moduleOffset in the named module, compared
+    // ignoring case; 0 if no such module is loaded
+    uintptr_t Resolve(const std::string& module, uintptr_t moduleOffset) const;
+
+protected:
+    ModuleMap();
+
+    // Index of the module holding address, or SIZE_MAX
+    size_t FindModule(uintptr_t address) const;
+    void SortModules();
+
+    std::vector<AddressModule> m_modules;
+};
+
+#endif // MODULE_MAP_H
@@ -0,0 +1,53 @@
+#ifndef MULTI_PATTERN_SCANNER_H
+#define MULTI_PATTERN_SCANNER_H
+
+#include "pattern_matcher.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct MultiPatternHit {
+    size_t offset;
+    size_t patternId;
+};
+
+// Finds any number of masked patterns in one pass over a buffer. Each pattern
+// is bucketed by its rarest pair of adjacent fixed bytes (or its rarest single
+// fixed byte when it has no such pair); a bitmap over all 65536 byte pairs
+// rejects almost every offset before any bucket is visited.
+class MultiPatternScanner {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    MultiPatternScanner();
+
+    // Returns the pattern id used to tag hits, or npos for an invalid pattern
+    size_t AddPattern(const std::vector<uint8_t>& pattern, const std::vector<bool>& mask);
+
+    size_t PatternCount() const { return m_patterns.size(); }
+    size_t PatternSize(size_t patternId) const { return m_patterns[patternId].Size(); }
+    size_t MaxPatternSize() const { return m_maxPatternSize; }
+
+    // Appends hits sorted by offset, then pattern id, and returns how many were added
+    size_t FindAll(const uint8_t* data, size_t size, std::vector<MultiPatternHit>& hits,
+                   size_t maxResults = npos) const;
+
+private:
+    struct BucketEntry {
+        uint32_t patternId;
+        uint32_t anchorOffset;
+    };
+
+    std::vector<PatternMatcher> m_patterns;
+    std::vector<BucketEntry> m_byteBuckets[256];
+    std::vector<uint64_t> m_pairFilter;          // one bit per (byte, next byte) key
+    std::vector<std::vector<BucketEntry>> m_pairBuckets;
+    std::vector<uint32_t> m_wildcardPatterns;    // patterns without a single fixed byte
+    bool m_hasByteBuckets;
+    size_t m_maxPatternSize;
+
+    void Verify(const BucketEntry& entry, const uint8_t* data, size_t size, size_t pos,
+                std::vector<MultiPatternHit>& hits) const;
+};
+
+#endif // MULTI_PATTERN_SCANNER_H
@@ -0,0 +1,124 @@
+#ifndef PATTERN_MATCHER_H
+#define PATTERN_MATCHER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Masked byte-pattern matcher that works on plain in-memory buffers.
+// Candidates are located with SIMD compares on the two rarest fixed bytes
+// (the anchors) and then verified against the full pattern.
+class PatternMatcher {
+public:
+    enum class Kernel {
+        Auto,   // Best kernel supported by the running CPU
+        Scalar, // Byte-by-byte reference implementation
+        SSE2,
+        AVX2,
+        Horspool // Skip-table search over the longest fixed run
+    };
+
+    // Auto uses Horspool for runs at least this long when no SIMD kernel is
+    // available. With SSE2/AVX2 the anchor scan streams memory faster than
+    // Horspool can skip it (measured 32-128 byte signatures), so it stays
+    // the default there.
+    static constexpr size_t HORSPOOL_MIN_RUN = 16;
+    static constexpr size_t HORSPOOL_MAX_RUN = 255;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    PatternMatcher(const std::vector<uint8_t>& pattern, const std::vector<bool>& mask);
+    // Per-byte masks: 0xFF fixed, 0x00 wildcard, 0xF0 or 0x0F for half-byte
+    // wildcards such as "4?" or "?8"
+    PatternMatcher(const std::vector<uint8_t>& pattern, const std::vector<uint8_t>& byteMask);
+
+    // Matches ASCII letters in either case and every other byte exactly. Upper
+    // and lower case differ only in bit 0x20, so a letter is a byte with that
+    // bit masked out (CASE_FOLD_MASK) and the anchor compares fold it in-register.
+    // The first and last bytes are the anchors.
+    static PatternMatcher CaseInsensitive(const std::vector<uint8_t>& pattern);
+    static constexpr uint8_t CASE_FOLD_MASK = 0xDF;
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    size_t FixedCount() const { return m_fixedCount; }
+    size_t ConstrainedCount() const { return m_constrainedCount; }
+    size_t AnchorOffset() const { return m_anchor1; }
+    size_t FixedRunOffset() const { return m_runOffset; }
+    size_t FixedRunLength() const { return m_runLength; }
+    uint8_t AnchorValue() const { return m_fixedCount ? m_value[m_anchor1] : 0; }
+
+    // Appends the offset of every match in data[0, size) to offsets and returns
+    // the number of matches added, stopping once maxResults have been added.
+    size_t FindAll(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                   size_t maxResults = npos, Kernel kernel = Kernel::Auto) const;
+    size_t FindFirst(const uint8_t* data, size_t size, Kernel kernel = Kernel::Auto) const;
+    bool MatchesAt(const uint8_t* data) const;
+
+    static bool IsKernelSupported(Kernel kernel);
+    static Kernel BestKernel();
+
+    // Relative frequency of a byte value in typical process memory (higher is
+    // more common); used to pick anchors. constexpr so compile-time matchers
+    // pick anchors from the same table.
+    static constexpr int ByteCommonness(uint8_t value) {
+        switch (value) {
+            case 0x00: return 100;
+            case 0xFF: return 90;
+            case 0xCC: return 80;
+            case 0x48: return 70;
+            case 0x8B: return 65;
+            case 0x89: return 60;
+            case 0x4C: return 55;
+            case 0x24: return 50;
+            case 0x0F: return 45;
+            case 0x01: return 45;
+            case 0x90: return 40;
+            case 0x20: return 40;
+            case 0xE8: return 35;
+            case 0x83: return 35;
+            case 0xC3: return 30;
+            case 0x8D: return 30;
+            case 0x44: return 30;
+            default: break;
+        }
+
+        if (value < 0x10) return 25;
+        if (value >= 'a' && value <= 'z') return 20;
+        if (value >= 'A' && value <= 'Z') return 15;
+        if (value >= '0' && value <= '9') return 15;
+        if (value >= 0xF0) return 10;
+        return 0;
+    }
+
+private:
+    // Both are zero-padded to a multiple of 16 bytes so verification can use
+    // whole-vector loads; a zero mask byte matches anything.
+    std::vector<uint8_t> m_value; // pattern bytes with wildcard bits cleared
+    std::vector<uint8_t> m_mask;  // 0xFF for fixed bytes, 0x00 for wildcards
+    size_t m_size;
+    size_t m_fixedCount;       // bytes with every bit fixed
+    size_t m_anchorableCount;  // fixed or case-folded bytes; only these can be anchors
+    size_t m_constrainedCount; // bytes with at least one bit fixed
+    size_t m_anchor1;
+    size_t m_anchor2;
+    size_t m_runOffset;              // longest run of fully fixed bytes, capped at HORSPOOL_MAX_RUN
+    size_t m_runLength;
+    std::vector<uint8_t> m_shift;    // Horspool shift per byte value, empty without a run
+
+    size_t FindScalar(const uint8_t* data, size_t size, std::vector<size_t>& offsets, size_t maxResults) const;
+    size_t FindSSE2(const uint8_t* data, size_t size, std::vector<size_t>& offsets, size_t maxResults) const;
+    size_t FindAVX2(const uint8_t* data, size_t size, std::vector<size_t>& offsets, size_t maxResults) const;
+    size_t FindHorspool(const uint8_t* data, size_t size, std::vector<size_t>& offsets, size_t maxResults) const;
+    size_t Dispatch(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                    size_t maxResults, Kernel kernel) const;
+    bool VerifySSE2(const uint8_t* data, size_t available) const;
+    bool IsAnchorable(size_t index) const {
+        return m_mask[index] == 0xFF || m_mask[index] == CASE_FOLD_MASK;
+    }
+    void Init(const std::vector<uint8_t>& pattern, const std::vector<uint8_t>& byteMask);
+    void ChooseAnchors();
+    void BuildShiftTable();
+};
+
+#endif // PATTERN_MATCHER_H
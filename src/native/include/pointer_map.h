@@ -0,0 +1,84 @@
+#ifndef POINTER_MAP_H
+#define POINTER_MAP_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "memory_helpers.h"
+#include "mapped_file.h"
+
+struct PointerEntry {
+    uintptr_t value;     // The address pointed to
+    uintptr_t address;   // Where the pointer is stored
+};
+
+struct PointerMapOptions {
+    uintptr_t searchStart;   // Where pointers may be stored
+    uintptr_t searchEnd;
+    bool writableOnly;
+    bool moduleImagesOnly;   // Only pointers stored in module images, i.e. static ones
+};
+
+// Every aligned pointer-sized word of the target whose value lands inside a
+// committed region, sorted by value. Built in one parallel pass over memory;
+// after that, finding the pointers to an address, or to anywhere in a range
+// of addresses, is a bucket lookup plus a binary search and never reads the
+// target again. A radix table over the top bits of the value narrows each
+// search to one bucket of the array.
+//
+// A map describes one process instance at the time it was built. It can be
+// saved and loaded again, in which case the entries are read straight from
+// the mapped file.
+class PointerMap {
+public:
+    static constexpr size_t BUCKETS = 64 * 1024;
+
+    static std::unique_ptr<PointerMap> Build(HANDLE processHandle, const PointerMapOptions& options);
+
+    size_t Size() const { return m_size; }
+    const PointerEntry* Entries() const { return m_data; }
+
+    // Entries whose value lies in [low, high], as a range of Entries()
+    // ordered by value and then address
+    void Range(uintptr_t low, uintptr_t high, size_t& begin, size_t& end) const;
+    // Addresses of up to maxResults pointers to value, in address order
+    size_t Find(uintptr_t value, std::vector<uintptr_t>& addresses, size_t maxResults) const;
+
+    const PointerMapOptions& Options() const { return m_options; }
+    const ProcessIdentity& Process() const { return m_process; }
+    // The committed regions of the target when the map was built
+    const std::vector<MemoryRegionEx>& Regions() const { return m_regions; }
+    // Bytes held in memory; a loaded map's entries are in the mapping instead
+    size_t MemoryUsage() const;
+
+    bool Save(const std::wstring& path, std::string& error) const;
+    // Fails unless processHandle is the process instance the map was built from
+    static std::unique_ptr<PointerMap> Load(HANDLE processHandle, const std::wstring& path, std::string& error);
+
+private:
+    PointerMap();
+
+    void Index();
+    size_t Bucket(uintptr_t value) const;
+
+    PointerMapOptions m_options;
+    ProcessIdentity m_process;
+    std::vector<MemoryRegionEx> m_regions;
+
+    std::vector<PointerEntry> m_entries;   // Empty when loaded
+    MappedFile m_mapped;                   // Holds the entries when loaded
+    const PointerEntry* m_data;
+    size_t m_size;
+
+    // Entries with Bucket(value) < b start at m_buckets[b]; bucket b covers
+    // values from m_lowest + (b << m_shift)
+    uintptr_t m_lowest;
+    uint32_t m_shift;
+    std::vector<uint64_t> m_ownBuckets;
+    const uint64_t* m_buckets;
+};
+
+#endif // POINTER_MAP_H
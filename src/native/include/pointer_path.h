@@ -0,0 +1,86 @@
+#ifndef POINTER_PATH_H
+#define POINTER_PATH_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "memory_helpers.h"
+#include "pointer_map.h"
+
+struct PointerPathOptions {
+    size_t maxDepth;    // Pointers read along a path
+    size_t maxOffset;   // Largest offset added to a pointer read
+    size_t maxPaths;
+};
+
+// Reading the pointer at base, adding offsets[0], reading the pointer there,
+// and so on, ends at the target after the last offset is added
+struct PointerPath {
+    uintptr_t base;
+    size_t module;                // Index of the module image holding base
+    std::vector<size_t> offsets;
+};
+
+struct PointerPathResult {
+    std::vector<ModuleImage> modules;
+    std::vector<PointerPath> paths;   // Shortest first, then by base address
+    size_t nodes;                     // Pointer locations visited
+    bool truncated;                   // maxPaths or the node limit was reached
+};
+
+// Pointer path search over a PointerMap, working back from the target one
+// level at a time. Level 0 is the target; level k holds every location whose
+// pointer, plus up to maxOffset, lands on a location of level k - 1. A
+// location lying in a module image is a static base: it ends the paths
+// through it and is not searched from further. A location is searched only
+// from the first level it appears in, so paths never loop and a location
+// reached again by a longer route adds nothing. The deepest level keeps
+// static bases only, since nothing is searched from it.
+//
+// Each level is expanded in parallel with map lookups only; the target is
+// never read.
+class PointerPathScanner {
+public:
+    // A level the target is at most a few hops from. Keeps a pathological
+    // search from exhausting memory before it reaches any static base.
+    static constexpr size_t MAX_LEVEL_NODES = 8 * 1024 * 1024;
+
+    PointerPathScanner(const PointerMap& map, std::vector<ModuleImage> modules);
+
+    PointerPathResult Scan(uintptr_t target, const PointerPathOptions& options) const;
+
+    // Every pointer within maxDepth reads of target, level by level, as
+    // (location, the location of the level below, offset). maxOffsets[i]
+    // limits the offset at level i + 1; the last one applies to deeper levels.
+    std::vector<PointerResult> Tree(uintptr_t target, size_t maxDepth, const std::vector<size_t>& maxOffsets,
+                                    size_t maxResults) const;
+
+private:
+    struct Edge {
+        uint32_t child;   // Index in the level below
+        size_t offset;
+    };
+
+    // Locations of one level, sorted, with their edges to the level below
+    struct Level {
+        std::vector<uintptr_t> addresses;
+        std::vector<size_t> firstEdge;   // Edges of node i are [firstEdge[i], firstEdge[i + 1])
+        std::vector<Edge> edges;
+        std::vector<uint8_t> isBase;
+    };
+
+    // Builds the next level from the non-base locations of levels.back(),
+    // keeping only locations in module images if basesOnly; false if it was
+    // cut at MAX_LEVEL_NODES
+    bool Expand(std::vector<Level>& levels, size_t maxOffset, bool findBases, bool basesOnly) const;
+    size_t FindModule(uintptr_t address) const;
+    void CollectPaths(const std::vector<Level>& levels, size_t level, size_t node, PointerPath& path,
+                      std::vector<PointerPath>& paths, size_t maxPaths) const;
+
+    const PointerMap& m_map;
+    std::vector<ModuleImage> m_modules;
+};
+
+#endif // POINTER_PATH_H
@@ -0,0 +1,58 @@
+#ifndef POINTER_PATH_SET_H
+#define POINTER_PATH_SET_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "memory_helpers.h"
+#include "pointer_path.h"
+
+// A pointer path held relative to its module, so that it means the same in
+// every run of the target
+struct StoredPath {
+    uint32_t module;              // Index into PointerPathSet::Modules()
+    uintptr_t moduleOffset;
+    std::vector<size_t> offsets;
+};
+
+// Pointer paths kept across restarts of the target. Most paths found in one
+// run are coincidences; validating the set against each new run, or
+// intersecting it with a new run's scan, leaves the stable ones.
+//
+// Saved sets are compact: module names once, then each path as varints.
+class PointerPathSet {
+public:
+    PointerPathSet();
+    explicit PointerPathSet(const PointerPathResult& result);
+
+    // Adds a path; false if it has no offsets
+    bool Add(const std::string& module, uintptr_t moduleOffset, const std::vector<size_t>& offsets);
+
+    size_t Size() const { return m_paths.size(); }
+    const std::vector<std::string>& Modules() const { return m_modules; }
+    const std::vector<StoredPath>& Paths() const { return m_paths; }
+
+    // Where each path ends in the target, resolved level by level with one
+    // batch of reads per level. 0 where the module is not loaded or a pointer
+    // on the way cannot be read.
+    std::vector<uintptr_t> Resolve(HANDLE processHandle, const std::vector<ModuleImage>& modules) const;
+    // Keeps the paths that end at target; returns how many remain
+    size_t Validate(HANDLE processHandle, const std::vector<ModuleImage>& modules, uintptr_t target);
+    // Keeps the paths that other holds too; returns how many remain
+    size_t Intersect(const PointerPathSet& other);
+
+    bool Save(const std::wstring& path, std::string& error) const;
+    static std::unique_ptr<PointerPathSet> Load(const std::wstring& path, std::string& error);
+
+private:
+    uint32_t ModuleIndex(const std::string& name);
+    void Keep(const std::vector<uint8_t>& keep);
+
+    std::vector<std::string> m_modules;
+    std::vector<StoredPath> m_paths;
+};
+
+#endif // POINTER_PATH_SET_H
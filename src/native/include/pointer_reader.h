@@ -0,0 +1,34 @@
+#ifndef POINTER_READER_H
+#define POINTER_READER_H
+
+#include <windows.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Reads many pointer-sized values from the target in few calls. The
+// addresses are sorted and those close together are read as one span, so a
+// batch costs one call per cluster rather than one per pointer. A span that
+// cannot be read whole falls back to reading its pointers one by one.
+class PointerReader {
+public:
+    static constexpr size_t MAX_SPAN = 64 * 1024;   // Largest single read
+    static constexpr size_t MAX_GAP = 256;          // Unwanted bytes read to join two neighbours
+
+    explicit PointerReader(HANDLE processHandle);
+
+    // values[i] is the pointer at addresses[i], and valid[i] is 0 where it
+    // could not be read. addresses may be in any order and repeat.
+    void Read(const std::vector<uintptr_t>& addresses, std::vector<uintptr_t>& values, std::vector<uint8_t>& valid);
+
+    // Calls made to the target so far
+    size_t Calls() const { return m_calls; }
+
+private:
+    HANDLE m_processHandle;
+    std::vector<size_t> m_order;
+    std::vector<uint8_t> m_buffer;
+    size_t m_calls;
+};
+
+#endif // POINTER_READER_H
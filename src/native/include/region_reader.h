@@ -0,0 +1,70 @@
+#ifndef REGION_READER_H
+#define REGION_READER_H
+
+#include <windows.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+struct RegionChunk {
+    uintptr_t address;    // Address of data[0]
+    const uint8_t* data;
+    size_t size;          // Bytes in data, including the carried tail
+    size_t carried;       // Leading bytes repeated from the end of the previous chunk
+    size_t owned;         // Items starting at or past this offset belong to the next range
+    bool last;            // No further chunks follow in this range
+};
+
+// Streams a memory range of another process in large reads. The last
+// `overlap` bytes of each chunk are carried to the front of the next one, so
+// items of up to overlap + 1 bytes straddling a read boundary are still seen.
+// An item lying entirely inside the carried bytes was already visible in the
+// previous chunk and should be skipped.
+//
+// A reader holds a single buffer that is reused for every chunk and region,
+// never larger than the memory budget in effect when the reader was created,
+// so peak scan memory does not depend on region size.
+class RegionReader {
+public:
+    static constexpr size_t MIN_CHUNK_SIZE = 256 * 1024;
+    static constexpr size_t PAGE_GRANULARITY = 4096;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 4 * 1024 * 1024;
+    static constexpr size_t MIN_MEMORY_BUDGET = 64 * 1024;
+
+    // memoryBudget of 0 uses the process-wide budget
+    RegionReader(HANDLE processHandle, size_t overlap = 0, size_t memoryBudget = 0);
+
+    // Process-wide budget for a reader's buffer, clamped to MIN_MEMORY_BUDGET.
+    // Returns the budget actually applied.
+    static size_t SetMemoryBudget(size_t bytes);
+    static size_t MemoryBudget();
+
+    // Starts streaming [start, start + size + readAhead). Only items starting
+    // before start + size are owned by this range; the read-ahead lets them
+    // complete. Accessibility is checked here, once per range, instead of
+    // before every read.
+    bool Begin(uintptr_t start, size_t size, size_t readAhead = 0);
+    bool Next(RegionChunk& chunk);
+
+    size_t Overlap() const { return m_overlap; }
+    size_t FailedReads() const { return m_failedReads; }
+    size_t SuccessfulReads() const { return m_successfulReads; }
+
+private:
+    HANDLE m_processHandle;
+    size_t m_overlap;
+    uintptr_t m_cursor;
+    uintptr_t m_end;
+    uintptr_t m_ownedEnd;
+    size_t m_chunkSize;
+    size_t m_maxChunkSize;
+    size_t m_failedReads;
+    size_t m_successfulReads;
+    std::vector<uint8_t> m_buffer;
+    size_t m_bufferUsed;
+
+    static std::atomic<size_t> s_memoryBudget;
+};
+
+#endif // REGION_READER_H
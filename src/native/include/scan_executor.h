@@ -0,0 +1,150 @@
+#ifndef SCAN_EXECUTOR_H
+#define SCAN_EXECUTOR_H
+
+#include <windows.h>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "region_reader.h"
+
+struct ScanRange {
+    uintptr_t start;
+    size_t size;       // Bytes owned by this range; items are reported only if they start here
+    size_t readAhead;  // Bytes read past the owned end so straddling items are complete
+};
+
+// Work-stealing thread pool for region scans. Tasks are dealt to workers in
+// contiguous blocks; each worker takes from the front of its own deque (lowest
+// addresses first) and steals from the back of the others when it runs dry.
+// The calling thread takes part as worker 0.
+class ScanExecutor {
+public:
+    static constexpr size_t SPLIT_SIZE = 16 * 1024 * 1024;
+
+    static ScanExecutor& Instance();
+
+    // 0 selects the hardware thread count. Returns the parallelism applied.
+    size_t SetParallelism(size_t threads);
+    size_t Parallelism() const;
+
+    // Runs task(index) for every index in [0, count) and blocks until all have
+    // finished. The first exception thrown by a task is rethrown here. Calls
+    // made from inside a task run inline on that worker.
+    void Run(size_t count, const std::function<void(size_t)>& task);
+
+    // Cuts ranges into pieces of at most splitSize owned bytes. Each piece reads
+    // up to overlap bytes into its successor, never past the end of its range.
+    static std::vector<ScanRange> SplitRanges(const std::vector<ScanRange>& ranges, size_t overlap,
+                                              size_t splitSize = SPLIT_SIZE);
+
+    ~ScanExecutor();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    ScanExecutor();
+    ScanExecutor(const ScanExecutor&) = delete;
+    ScanExecutor& operator=(const ScanExecutor&) = delete;
+
+    void StartWorkers(size_t threads);
+    void StopWorkers();
+    void WorkerLoop(size_t worker);
+    void Drain(size_t worker);
+    bool TakeTask(size_t worker, size_t& task);
+
+    std::vector<std::thread> m_threads;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+    std::mutex m_runMutex;        // One job at a time
+    std::mutex m_stateMutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation;
+    bool m_stopping;
+    std::atomic<size_t> m_remaining;
+
+    const std::function<void(size_t)>* m_task;
+    std::exception_ptr m_error;
+    std::atomic<size_t> m_parallelism;
+};
+
+// Tracks which tasks may still contribute to a capped, address-ordered result
+// set. Once the completed prefix of tasks holds maxResults items, every later
+// task is cut off, so the merged output does not depend on thread timing.
+class ResultCutoff {
+public:
+    ResultCutoff(size_t taskCount, size_t maxResults);
+
+    bool IsCutOff(size_t task) const { return task > m_cutoff.load(); }
+    void Complete(size_t task, size_t resultCount);
+
+private:
+    std::mutex m_mutex;
+    std::vector<size_t> m_counts;
+    std::vector<bool> m_completed;
+    size_t m_prefix;
+    size_t m_prefixResults;
+    size_t m_maxResults;
+    std::atomic<size_t> m_cutoff;
+};
+
+// Streams ranges on the scan executor, one RegionReader per piece, and calls
+// scanChunk for every chunk with that piece's result vector. Items must be
+// reported only when they start before chunk.owned and end after
+// chunk.carried. Piece results are concatenated in address order and
+// truncated to maxResults; scanChunk returns false to stop its piece.
+template <typename Result>
+std::vector<Result> ParallelScan(HANDLE processHandle, const std::vector<ScanRange>& ranges, size_t overlap,
+                                 size_t maxResults,
+                                 const std::function<bool(const RegionChunk&, std::vector<Result>&)>& scanChunk) {
+    ScanExecutor& executor = ScanExecutor::Instance();
+    std::vector<ScanRange> pieces = ScanExecutor::SplitRanges(ranges, overlap);
+    std::vector<std::vector<Result>> pieceResults(pieces.size());
+    ResultCutoff cutoff(pieces.size(), maxResults);
+
+    // Concurrent readers share the budget
+    size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+
+    executor.Run(pieces.size(), [&](size_t index) {
+        std::vector<Result>& out = pieceResults[index];
+
+        if (!cutoff.IsCutOff(index)) {
+            RegionReader reader(processHandle, overlap, readerBudget);
+            RegionChunk chunk;
+
+            if (reader.Begin(pieces[index].start, pieces[index].size, pieces[index].readAhead)) {
+                while (out.size() < maxResults && !cutoff.IsCutOff(index) && reader.Next(chunk)) {
+                    if (!scanChunk(chunk, out)) break;
+                }
+            }
+        }
+
+        if (out.size() > maxResults) out.resize(maxResults);
+        cutoff.Complete(index, out.size());
+    });
+
+    std::vector<Result> results;
+    for (auto& piece : pieceResults) {
+        size_t take = std::min(piece.size(), maxResults - results.size());
+        results.insert(results.end(), std::make_move_iterator(piece.begin()),
+                       std::make_move_iterator(piece.begin() + take));
+        if (results.size() >= maxResults) break;
+    }
+
+    return results;
+}
+
+#endif // SCAN_EXECUTOR_H
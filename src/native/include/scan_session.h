@@ -0,0 +1,123 @@
+#ifndef SCAN_SESSION_H
+#define SCAN_SESSION_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "value_scanner.h"
+#include "candidate_store.h"
+#include "memory_helpers.h"
+
+// How a candidate's current value is tested. Equal through Truncated
+// compare against the given values and run on ValueScanner; the rest compare
+// against the value the candidate had after the previous scan and need a
+// first scan to exist. Unknown is a first scan that keeps every address,
+// i.e. a snapshot.
+enum class ScanCompare : uint32_t {
+    Unknown,
+    Equal,
+    NotEqual,
+    Range,        // value <= current <= value2
+    Rounded,      // Float and double: displays as value with decimals places
+    Ulps,         // Float and double: at most ulps representable steps from value
+    Truncated,    // Float and double: truncates to the integer value
+    Changed,
+    Unchanged,
+    Increased,
+    Decreased,
+    IncreasedBy,  // current == previous + value
+    DecreasedBy   // current == previous - value
+};
+
+// Accepts "unknown", "equal", "notEqual", "range", "rounded", "ulps",
+// "truncated", "changed", "unchanged", "increased", "decreased",
+// "increasedBy" and "decreasedBy"
+bool ParseScanCompare(const std::string& name, ScanCompare& compare);
+bool ComparesToPrevious(ScanCompare compare);
+
+struct ScanParams {
+    double value;
+    double value2;
+    int64_t intValue;    // Integer types compare against these, so 64-bit
+    int64_t intValue2;   // values keep their precision
+    double tolerance;    // Float and double Equal / IncreasedBy / DecreasedBy only
+    uint32_t decimals;   // Rounded only
+    uint32_t ulps;       // Ulps only
+};
+
+struct ScanSessionOptions {
+    ScanValueType type;
+    bool aligned;         // Only addresses that are a multiple of the value size
+    bool writableOnly;
+    uintptr_t searchStart;
+    uintptr_t searchEnd;
+    size_t memoryLimit;   // Candidate bytes kept in memory before the rest spills
+                          // to a temporary file; 0 uses the store's default
+    bool moduleImagesOnly;   // Only addresses inside module images, which keep
+                             // their module offset across runs
+};
+
+struct SessionCandidate {
+    uintptr_t address;
+    std::vector<uint8_t> value;   // Bytes read by the last scan
+};
+
+// An iterative value scan. First() scans every readable region (or only the
+// writable ones) and keeps the addresses that pass, or snapshots all of them
+// when the initial value is unknown; each Next() re-reads only the surviving
+// candidates and filters them again. Candidates never leave native memory
+// until Results() is asked for the final, small set, and a set too large
+// for memory spills to disk (see CandidateStore). A session can be saved and
+// loaded again later, e.g. after the tool restarts, as long as the same
+// process instance is still running.
+class ScanSession {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    explicit ScanSession(const ScanSessionOptions& options);
+
+    // Both return false and fill error when the compare cannot be applied or
+    // the candidates could not be spilled; the previous candidates are kept
+    bool First(HANDLE processHandle, ScanCompare compare, const ScanParams& params, std::string& error);
+    bool Next(HANDLE processHandle, ScanCompare compare, const ScanParams& params, std::string& error);
+    void Reset();
+
+    ScanValueType Type() const { return m_options.type; }
+    size_t Width() const { return m_width; }
+    size_t Count() const { return m_store.Count(); }
+    size_t Scans() const { return m_scans; }
+    // Bytes held by the candidate storage in memory and on disk
+    size_t MemoryUsage() const { return m_store.MemoryUsage(); }
+    size_t DiskUsage() const { return m_store.DiskUsage(); }
+
+    // The process instance and the regions the first scan covered
+    const ProcessIdentity& Process() const { return m_process; }
+    const std::vector<MemoryRegionEx>& Regions() const { return m_regions; }
+
+    // The first maxResults candidates in address order, with their last values
+    std::vector<SessionCandidate> Results(size_t maxResults) const;
+
+    // Writes the options, process instance, region map and candidates with
+    // their last values to path; returns false and fills error on failure
+    bool Save(const std::wstring& path, std::string& error) const;
+    // Reads a session written by Save. The candidates are mapped from the
+    // file rather than copied, and each block is checked to decode within
+    // its payload, so a truncated or corrupt file is rejected here. Fails
+    // unless processHandle is the process instance the session scanned.
+    static std::unique_ptr<ScanSession> Load(HANDLE processHandle, const std::wstring& path, size_t memoryLimit,
+                                             std::string& error);
+
+private:
+    ScanSessionOptions m_options;
+    size_t m_width;
+    size_t m_step;
+    CandidateStore m_store;
+    size_t m_scans;
+    ProcessIdentity m_process;
+    std::vector<MemoryRegionEx> m_regions;
+};
+
+#endif // SCAN_SESSION_H
@@ -0,0 +1,41 @@
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include "pattern_matcher.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// A byte signature parsed once and kept with its prepared matcher, so the
+// same signature can be scanned for repeatedly without re-parsing.
+//
+// Accepted syntax: hex bytes separated by whitespace ("48 8B 0D"), "?" or
+// "??" for a wildcard byte, and "4?" / "?B" for a byte with one wildcard
+// nibble. Tokens longer than two characters are read as runs of byte pairs,
+// so "488B0D????" is also valid.
+class Signature {
+public:
+    // Returns nullptr and fills error when the text is not a valid signature
+    static std::unique_ptr<Signature> Compile(const std::string& text, std::string& error);
+
+    Signature(const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& masks);
+
+    static bool Parse(const std::string& text, std::vector<uint8_t>& bytes,
+                      std::vector<uint8_t>& masks, std::string& error);
+
+    size_t Size() const { return m_bytes.size(); }
+    const std::vector<uint8_t>& Bytes() const { return m_bytes; }
+    const std::vector<uint8_t>& Masks() const { return m_masks; }
+    const PatternMatcher& Matcher() const { return m_matcher; }
+
+    // Canonical text form, e.g. "48 8B 0D ?? ?? ?? ?? 4? 8B"
+    std::string ToString() const;
+
+private:
+    std::vector<uint8_t> m_bytes;
+    std::vector<uint8_t> m_masks;
+    PatternMatcher m_matcher;
+};
+
+#endif // SIGNATURE_H
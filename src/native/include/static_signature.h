@@ -0,0 +1,209 @@
+#ifndef STATIC_SIGNATURE_H
+#define STATIC_SIGNATURE_H
+
+#include "pattern_matcher.h"
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STATIC_SIGNATURE_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(STATIC_SIGNATURE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define STATIC_SIGNATURE_SSE2 __attribute__((target("sse2")))
+#define STATIC_SIGNATURE_AVX2 __attribute__((target("avx2")))
+#else
+#define STATIC_SIGNATURE_SSE2
+#define STATIC_SIGNATURE_AVX2
+#endif
+
+// Signatures fixed at compile time. Each byte is a template argument, with
+// StaticSignatureAny (-1) as a wildcard:
+//
+//     using MovRbxToStack = StaticSignature<0x48, 0x89, 0x5C, 0x24>;
+//     using RelativeCall  = StaticSignature<0xE8, StaticSignatureAny, StaticSignatureAny,
+//                                           StaticSignatureAny, StaticSignatureAny>;
+//
+// Candidates are found with the same SSE2/AVX2 two-anchor compare as
+// PatternMatcher, but the anchors are chosen by the compiler, a signature
+// with one fixed byte compares once instead of twice, and verification is a
+// fold over the remaining fixed bytes, so wildcards and anchors cost nothing.
+// Matches go straight to a visitor instead of through an offsets vector.
+constexpr int StaticSignatureAny = -1;
+
+inline unsigned StaticSignatureLowestSetBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+// Index of the rarest fixed byte other than skip, preferring a value
+// different from avoid (pass -1 for neither); size if there is none. Ties go
+// to the lower index, as PatternMatcher's stable sort does.
+constexpr size_t StaticSignatureAnchor(const int* values, size_t size, size_t skip = static_cast<size_t>(-1),
+                                       int avoid = -1) {
+    size_t best = size;
+    for (int pass = 0; pass < 2 && best == size; ++pass) {
+        for (size_t i = 0; i < size; ++i) {
+            if (values[i] < 0 || i == skip || (pass == 0 && values[i] == avoid)) continue;
+            if (best == size ||
+                PatternMatcher::ByteCommonness(static_cast<uint8_t>(values[i])) <
+                PatternMatcher::ByteCommonness(static_cast<uint8_t>(values[best]))) {
+                best = i;
+            }
+        }
+    }
+    return best;
+}
+
+template <int... Bytes>
+class StaticSignature {
+public:
+    static_assert(sizeof...(Bytes) > 0, "StaticSignature needs at least one byte");
+    static_assert(((Bytes >= -1 && Bytes <= 0xFF) && ...), "StaticSignature bytes must be 0x00-0xFF or StaticSignatureAny");
+    static_assert(((Bytes >= 0) || ...), "StaticSignature needs at least one fixed byte");
+
+    static constexpr size_t Size = sizeof...(Bytes);
+    static constexpr std::array<int, sizeof...(Bytes)> Values = { Bytes... };
+    static constexpr size_t Anchor = StaticSignatureAnchor(Values.data(), sizeof...(Bytes));
+    static constexpr uint8_t AnchorValue = static_cast<uint8_t>(Values[Anchor]);
+    // The second anchor, or Anchor itself when there is one fixed byte
+    static constexpr size_t Anchor2 = StaticSignatureAnchor(Values.data(), sizeof...(Bytes), Anchor, AnchorValue) <
+                                      sizeof...(Bytes)
+                                          ? StaticSignatureAnchor(Values.data(), sizeof...(Bytes), Anchor, AnchorValue)
+                                          : Anchor;
+    static constexpr uint8_t Anchor2Value = static_cast<uint8_t>(Values[Anchor2]);
+
+    static bool MatchesAt(const uint8_t* data) {
+        return MatchesAt(data, std::make_index_sequence<sizeof...(Bytes)>());
+    }
+
+    // Calls visit(offset) for every match in data[0, size) in ascending order
+    // until it returns false.
+    template <typename Visitor>
+    static void ForEachMatch(const uint8_t* data, size_t size, Visitor&& visit) {
+        if (data == nullptr || size < Size) return;
+
+        size_t i = 0;
+#if defined(STATIC_SIGNATURE_X86)
+        if (PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::AVX2)) {
+            if (!ScanAVX2(data, size, i, visit)) return;
+        } else if (!ScanSSE2(data, size, i, visit)) {
+            return;
+        }
+#endif
+        for (; i <= size - Size; ++i) {
+            if (MatchesAt(data + i) && !visit(i)) return;
+        }
+    }
+
+    static size_t FindAll(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                          size_t maxResults = PatternMatcher::npos) {
+        size_t count = 0;
+        if (maxResults == 0) return 0;
+
+        ForEachMatch(data, size, [&](size_t offset) {
+            offsets.push_back(offset);
+            return ++count < maxResults;
+        });
+        return count;
+    }
+
+private:
+    template <size_t... Index>
+    static bool MatchesAt(const uint8_t* data, std::index_sequence<Index...>) {
+        // Wildcard positions fold to a constant true and are compiled out
+        return ((Bytes < 0 || data[Index] == static_cast<uint8_t>(Bytes)) && ...);
+    }
+
+    // The fixed bytes the anchor compare has not already checked
+    template <size_t... Index>
+    static bool VerifyRest(const uint8_t* data, std::index_sequence<Index...>) {
+        return ((Bytes < 0 || Index == Anchor || Index == Anchor2 || data[Index] == static_cast<uint8_t>(Bytes)) && ...);
+    }
+
+    // Visits the candidates set in bits, offsets relative to base; false once
+    // visit asks to stop
+    template <typename Visitor>
+    static bool VisitCandidates(const uint8_t* data, size_t base, uint64_t bits, Visitor& visit) {
+        while (bits) {
+            size_t pos = base + StaticSignatureLowestSetBit(bits);
+            bits &= bits - 1;
+            if (VerifyRest(data + pos, std::make_index_sequence<sizeof...(Bytes)>()) && !visit(pos)) return false;
+        }
+        return true;
+    }
+
+#if defined(STATIC_SIGNATURE_X86)
+    // Both scans test the start offsets [i, i + block) per iteration and leave
+    // i at the first offset not tested; anchor loads stay below size
+
+    template <typename Visitor>
+    STATIC_SIGNATURE_SSE2
+    static bool ScanSSE2(const uint8_t* data, size_t size, size_t& i, Visitor& visit) {
+        const size_t starts = size - Size + 1;
+        const __m128i anchor1 = _mm_set1_epi8(static_cast<char>(AnchorValue));
+        const __m128i anchor2 = _mm_set1_epi8(static_cast<char>(Anchor2Value));
+        const uint8_t* base1 = data + Anchor;
+        const uint8_t* base2 = data + Anchor2;
+
+        for (; i + 32 <= starts; i += 32) {
+            __m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base1 + i)), anchor1);
+            __m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base1 + i + 16)), anchor1);
+            if (Anchor2 != Anchor) {
+                lo = _mm_and_si128(lo, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base2 + i)), anchor2));
+                hi = _mm_and_si128(hi, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base2 + i + 16)), anchor2));
+            }
+            uint64_t bits = static_cast<uint32_t>(_mm_movemask_epi8(lo)) |
+                            (static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hi))) << 16);
+            if (!VisitCandidates(data, i, bits, visit)) return false;
+        }
+        return true;
+    }
+
+    template <typename Visitor>
+    STATIC_SIGNATURE_AVX2
+    static bool ScanAVX2(const uint8_t* data, size_t size, size_t& i, Visitor& visit) {
+        const size_t starts = size - Size + 1;
+        const __m256i anchor1 = _mm256_set1_epi8(static_cast<char>(AnchorValue));
+        const __m256i anchor2 = _mm256_set1_epi8(static_cast<char>(Anchor2Value));
+        const uint8_t* base1 = data + Anchor;
+        const uint8_t* base2 = data + Anchor2;
+
+        for (; i + 64 <= starts; i += 64) {
+            __m256i lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base1 + i)), anchor1);
+            __m256i hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base1 + i + 32)), anchor1);
+            if (Anchor2 != Anchor) {
+                lo = _mm256_and_si256(lo, _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base2 + i)), anchor2));
+                hi = _mm256_and_si256(hi, _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base2 + i + 32)), anchor2));
+            }
+            uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+                            (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+            if (!VisitCandidates(data, i, bits, visit)) return false;
+        }
+        // Finish whole 32-offset blocks with SSE2, the rest byte by byte
+        return ScanSSE2(data, size, i, visit);
+    }
+#endif
+};
+
+#endif // STATIC_SIGNATURE_H
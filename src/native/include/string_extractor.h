@@ -0,0 +1,106 @@
+#ifndef STRING_EXTRACTOR_H
+#define STRING_EXTRACTOR_H
+
+#include <windows.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "scan_executor.h"
+#include "string_searcher.h"
+
+struct ExtractedString {
+    uintptr_t address;
+    StringEncoding encoding;  // Utf8 stands for printable ASCII runs
+    size_t length;            // Characters in the run; text stops at MAX_STRING_LENGTH
+    std::string text;
+};
+
+// Receives extracted strings in address order, one batch at a time. Calls
+// come from whichever scan thread completes the next piece, but never
+// overlap.
+class StringSink {
+public:
+    virtual ~StringSink() {}
+    // Returning false stops the extraction
+    virtual bool Write(const std::vector<ExtractedString>& batch) = 0;
+};
+
+// Writes "address<TAB>encoding<TAB>text" lines; tabs and backslashes in the
+// text are escaped
+class FileStringSink : public StringSink {
+public:
+    explicit FileStringSink(const std::string& path);
+
+    bool IsOpen() const { return m_file.is_open(); }
+    bool Write(const std::vector<ExtractedString>& batch) override;
+
+private:
+    std::ofstream m_file;
+};
+
+// Hands batches from the scan threads to one consumer thread, holding at most
+// `capacity` batches; writers wait while the queue is full. Lets a caller that
+// must stay on its own thread (the JS thread) drain results as they arrive.
+class QueuedStringSink : public StringSink {
+public:
+    explicit QueuedStringSink(size_t capacity = 4);
+
+    bool Write(const std::vector<ExtractedString>& batch) override;
+
+    // Blocks for the next batch; false once the queue is closed and empty
+    bool Take(std::vector<ExtractedString>& batch);
+    // Producer side: no more batches will be written
+    void Close();
+    // Consumer side: reject further batches, which stops the extraction
+    void Stop();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<std::vector<ExtractedString>> m_queue;
+    size_t m_capacity;
+    bool m_closed;
+    bool m_stopped;
+};
+
+struct StringExtractionStats {
+    size_t strings;
+    size_t ranges;
+    uint64_t bytesScanned;
+    bool stopped;             // The sink asked to stop
+};
+
+// Emits every run of printable ASCII characters (0x20-0x7E and tab) at least
+// minLength long, and the same runs stored as 2-byte aligned UTF-16 code
+// units, like strings(1) for a live process. Ranges are split into pieces
+// and scanned on the scan executor; every piece is streamed once and
+// classified 64 bytes at a time. Finished pieces are handed to the sink in
+// address order and in batches, so the full result set is never held at once.
+class StringExtractor {
+public:
+    static constexpr size_t DEFAULT_MIN_LENGTH = 4;
+    static constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+    static constexpr size_t MAX_STRING_LENGTH = 4096;
+
+    // encodings is a mask of StringEncoding flags
+    StringExtractor(HANDLE processHandle, size_t minLength = DEFAULT_MIN_LENGTH,
+                    uint32_t encodings = static_cast<uint32_t>(StringEncoding::Utf8) |
+                                         static_cast<uint32_t>(StringEncoding::Utf16LE),
+                    size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    StringExtractionStats Run(const std::vector<ScanRange>& ranges, StringSink& sink);
+
+private:
+    HANDLE m_processHandle;
+    size_t m_minLength;
+    uint32_t m_encodings;
+    size_t m_batchSize;
+};
+
+#endif // STRING_EXTRACTOR_H
@@ -0,0 +1,80 @@
+#ifndef STRING_SEARCHER_H
+#define STRING_SEARCHER_H
+
+#include "pattern_matcher.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Bit flags so one search can ask for several encodings
+enum class StringEncoding : uint32_t {
+    Utf8 = 1,     // Also covers plain ASCII
+    Utf16LE = 2,
+    Utf16BE = 4
+};
+
+const char* StringEncodingName(StringEncoding encoding);
+// Accepts "utf8", "ascii", "utf16le", "utf16" (little endian) and "utf16be"
+bool ParseStringEncoding(const std::string& name, StringEncoding& encoding);
+
+struct StringHit {
+    size_t offset;
+    size_t size;
+    StringEncoding encoding;
+};
+
+// Finds one string in several encodings in a single pass over a buffer. The
+// text is decoded from UTF-8 once and encoded explicitly per encoding, so the
+// needle width never depends on the compiler's wchar_t. Every block of the
+// buffer is loaded once and tested against the first and last code unit of
+// each encoding (folded in-register when case-insensitive); candidates are
+// verified with that encoding's PatternMatcher. Case folding covers ASCII
+// letters only.
+class StringSearcher {
+public:
+    // encodings is a mask of StringEncoding flags
+    StringSearcher(const std::string& text, uint32_t encodings, bool caseSensitive = true);
+
+    bool Empty() const { return m_needles.empty(); }
+    size_t MaxNeedleSize() const { return m_maxSize; }
+    const std::vector<uint8_t>& NeedleBytes(StringEncoding encoding) const;
+
+    // Appends hits sorted by offset, then encoding, and returns how many were
+    // added. address is where data[0] lives in the target; UTF-16 hits are
+    // only reported on even addresses.
+    size_t FindAll(const uint8_t* data, size_t size, uintptr_t address, std::vector<StringHit>& hits,
+                   size_t maxResults = PatternMatcher::npos) const;
+
+private:
+    struct Needle {
+        StringEncoding encoding;
+        std::vector<uint8_t> bytes;
+        PatternMatcher matcher;
+        size_t firstOffset;   // Anchor byte in the first code unit
+        size_t lastOffset;    // Anchor byte in the last code unit
+        uint8_t firstValue;
+        uint8_t firstMask;
+        uint8_t lastValue;
+        uint8_t lastMask;
+        size_t alignment;
+    };
+
+    void AddNeedle(StringEncoding encoding, const std::vector<uint8_t>& bytes, size_t unitSize, bool caseSensitive);
+    bool Accept(const Needle& needle, const uint8_t* data, size_t pos, uintptr_t address) const {
+        return (address + pos) % needle.alignment == 0 && needle.matcher.MatchesAt(data + pos);
+    }
+
+    size_t FindScalar(const uint8_t* data, size_t size, size_t from, uintptr_t address,
+                      std::vector<StringHit>& hits, size_t maxResults) const;
+    size_t FindSSE2(const uint8_t* data, size_t size, uintptr_t address,
+                    std::vector<StringHit>& hits, size_t maxResults) const;
+    size_t FindAVX2(const uint8_t* data, size_t size, uintptr_t address,
+                    std::vector<StringHit>& hits, size_t maxResults) const;
+
+    std::vector<Needle> m_needles;
+    size_t m_maxSize;
+    size_t m_minSize;
+};
+
+#endif // STRING_SEARCHER_H
@@ -0,0 +1,99 @@
+#ifndef VALUE_SCANNER_H
+#define VALUE_SCANNER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum class ScanValueType : uint32_t {
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double
+};
+
+size_t ScanValueSize(ScanValueType type);
+const char* ScanValueTypeName(ScanValueType type);
+// Accepts the names above in lower case ("int32", "uint8", "float", ...)
+bool ParseScanValueType(const std::string& name, ScanValueType& type);
+// Reads a value of the given type from its little-endian bytes
+double ScanValueToDouble(ScanValueType type, const uint8_t* data);
+
+enum class ValueOp : uint32_t {
+    Equal,
+    NotEqual,
+    Range,      // value <= current <= value2
+    Near,       // |current - value| <= tolerance
+    // Float and double only; each is run as a Range in the type's precision
+    Rounded,    // Displays as value when rounded to decimals places
+    Ulps,       // At most ulps representable steps from value
+    Truncated   // Truncates to the integer value
+};
+
+// Accepts "equal", "notEqual", "range", "near", "rounded", "ulps" and
+// "truncated"
+bool ParseValueOp(const std::string& name, ValueOp& op);
+
+struct ValueQuery {
+    ScanValueType type;
+    ValueOp op;
+    bool aligned;         // Only addresses that are a multiple of the value size
+    double value;         // Float and double operands
+    double value2;
+    int64_t intValue;     // Integer operands, so 64-bit values keep their
+    int64_t intValue2;    // precision; uint64 carries its bits here
+    double tolerance;     // Near only
+    uint32_t decimals;    // Rounded only
+    uint32_t ulps;        // Ulps only
+};
+
+// Finds every value of one type that passes one predicate in a buffer. Each
+// (type, alignment, op) combination is its own instantiation of a single
+// kernel template: blocks of 16 bytes are compared lane-wise with SSE2 and the
+// byte mask from movemask is cut down to the lanes' first bytes. Unaligned
+// scans compare the block once per byte phase and interleave the masks.
+// Integer queries are clamped to the type's range up front, so an operand the
+// type cannot hold never wraps into false matches, and an integer Near becomes
+// a Range. Rounded, Ulps and Truncated become a Range whose closed bounds
+// are the outermost floats the query accepts, so they share the range kernel;
+// values exactly halfway between two displayed decimals pass for either.
+class ValueScanner {
+public:
+    explicit ValueScanner(const ValueQuery& query);
+
+    ScanValueType Type() const { return m_type; }
+    size_t Width() const { return m_width; }
+    size_t Step() const { return m_step; }
+    // No value of the type can pass
+    bool Empty() const { return m_find == nullptr; }
+
+    // Appends the offset of every passing value starting in [from, limit) to
+    // offsets and returns how many were added, stopping at maxResults. Values
+    // must lie wholly inside data[0, size); address is where data[0] lives in
+    // the target and decides alignment.
+    size_t FindAll(const uint8_t* data, size_t size, uintptr_t address, size_t from, size_t limit,
+                   std::vector<size_t>& offsets, size_t maxResults) const;
+    // Tests one value's bytes, ignoring alignment
+    bool Matches(const uint8_t* value) const { return m_test != nullptr && m_test(m_operands, value); }
+
+    typedef size_t (*FindFunction)(const uint8_t* operands, const uint8_t* data, size_t size, size_t from,
+                                   size_t limit, std::vector<size_t>& offsets, size_t maxResults);
+    typedef bool (*TestFunction)(const uint8_t* operands, const uint8_t* value);
+
+private:
+    ScanValueType m_type;
+    size_t m_width;
+    size_t m_step;
+    FindFunction m_find;
+    TestFunction m_test;
+    uint8_t m_operands[16];   // Two operands in the type's own bytes
+};
+
+#endif // VALUE_SCANNER_H
@@ -0,0 +1,68 @@
+#ifndef XREF_INDEX_H
+#define XREF_INDEX_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "memory_helpers.h"
+#include "mapped_file.h"
+#include "xref_sweep.h"
+
+struct XrefIndexOptions {
+    uintptr_t searchStart;   // Where code is decoded
+    uintptr_t searchEnd;
+};
+
+// Every direct branch and RIP-relative operand in the executable regions of
+// the target, sorted by the address referenced. Built in one parallel linear
+// sweep with XrefSweep; after that, finding the callers of a function or the
+// code touching a global is a binary search and never reads the target again.
+//
+// A linear sweep decodes data inside code as if it were instructions, so an
+// index can hold a few references that no real instruction makes. It falls
+// back into step with the real instruction stream within a few instructions.
+//
+// Like a PointerMap, an index describes one process instance at the time it
+// was built, and a saved index is read straight from the mapped file.
+class XrefIndex {
+public:
+    static std::unique_ptr<XrefIndex> Build(HANDLE processHandle, const XrefIndexOptions& options);
+
+    size_t Size() const { return m_size; }
+    const XrefEntry* Entries() const { return m_data; }
+
+    // Entries whose target lies in [low, high], as a range of Entries()
+    // ordered by target and then source
+    void Range(uintptr_t low, uintptr_t high, size_t& begin, size_t& end) const;
+
+    const XrefIndexOptions& Options() const { return m_options; }
+    const ProcessIdentity& Process() const { return m_process; }
+    // The executable regions decoded
+    const std::vector<MemoryRegionEx>& Regions() const { return m_regions; }
+    // Instructions decoded while building
+    uint64_t Instructions() const { return m_instructions; }
+    // Bytes held in memory; a loaded index's entries are in the mapping instead
+    size_t MemoryUsage() const;
+
+    bool Save(const std::wstring& path, std::string& error) const;
+    // Fails unless processHandle is the process instance the index was built from
+    static std::unique_ptr<XrefIndex> Load(HANDLE processHandle, const std::wstring& path, std::string& error);
+
+private:
+    XrefIndex();
+
+    XrefIndexOptions m_options;
+    ProcessIdentity m_process;
+    std::vector<MemoryRegionEx> m_regions;
+    uint64_t m_instructions;
+
+    std::vector<XrefEntry> m_entries;   // Empty when loaded
+    MappedFile m_mapped;                // Holds the entries when loaded
+    const XrefEntry* m_data;
+    size_t m_size;
+};
+
+#endif // XREF_INDEX_H
@@ -0,0 +1,74 @@
+#ifndef XREF_SWEEP_H
+#define XREF_SWEEP_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+enum class XrefKind : uint8_t {
+    Call,      // A direct call
+    Jump,      // A direct unconditional jump
+    Branch,    // A direct conditional jump or loop
+    Data       // A RIP-relative memory operand, including LEA
+};
+
+struct XrefEntry {
+    uintptr_t target;          // The address referenced
+    uintptr_t sourceAndKind;   // The referencing instruction, with the kind in the top byte
+
+    static constexpr size_t KIND_SHIFT = 8 * sizeof(uintptr_t) - 8;
+
+    uintptr_t Source() const { return sourceAndKind & ((uintptr_t(1) << KIND_SHIFT) - 1); }
+    XrefKind Kind() const { return static_cast<XrefKind>(sourceAndKind >> KIND_SHIFT); }
+
+    static XrefEntry Make(uintptr_t target, uintptr_t source, XrefKind kind) {
+        return { target, source | (static_cast<uintptr_t>(kind) << KIND_SHIFT) };
+    }
+};
+
+// Index order: by target, then by source
+inline bool XrefByTarget(const XrefEntry& a, const XrefEntry& b) {
+    return a.target != b.target ? a.target < b.target : a.Source() < b.Source();
+}
+
+// The linear sweep behind XrefIndex, free of any process access so it can be
+// run over plain buffers. A sweep decodes from `from`, which may lie before
+// the owned range [ownedStart, ownedEnd), and keeps the references of the
+// instructions starting inside it; the lead-in brings it back in step with
+// the instruction stream. Bytes that do not decode are stepped over one at a
+// time.
+class XrefSweep {
+public:
+    // A piece that starts inside a range decodes this many bytes before its
+    // start and discards them, so its sweep is back in step with the
+    // instruction stream by the time it reaches the bytes it owns
+    static constexpr size_t LEAD_IN = 64;
+
+    XrefSweep(uintptr_t from, uintptr_t ownedStart, uintptr_t ownedEnd, std::vector<XrefEntry>& out);
+
+    // Chunks are fed in address order, as a RegionReader with an overlap of
+    // InstructionDecoder::MAX_LENGTH - 1 produces them: each may start with
+    // the last bytes of the one before, and gaps are unreadable memory.
+    // Returns false once the owned range is done.
+    bool Feed(uintptr_t address, const uint8_t* data, size_t size, bool last);
+
+    // Instructions decoded in the owned range
+    uint64_t Instructions() const { return m_instructions; }
+
+private:
+    uintptr_t m_cursor;
+    uintptr_t m_ownedStart;
+    uintptr_t m_ownedEnd;
+    uint64_t m_instructions;
+    std::vector<XrefEntry>& m_out;
+};
+
+// Merges consecutive sorted runs entries[bounds[i], bounds[i + 1]) into one
+// sorted array, pairwise, a round of merges at a time. Runs are in address
+// order and merging is stable, so entries with equal targets stay in source
+// order. run(count, task) executes task(0..count-1), in parallel if it likes.
+void MergeXrefRuns(std::vector<XrefEntry>& entries, const std::vector<size_t>& bounds,
+                   const std::function<void(size_t, const std::function<void(size_t)>&)>& run);
+
+#endif // XREF_SWEEP_H
@@ -0,0 +1,259 @@
+#include "include/instruction_decoder.h"
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+// What follows an opcode, one entry per opcode byte
+enum OpcodeFlags : uint16_t {
+    MODRM = 1 << 0,
+    IMM8 = 1 << 1,
+    IMM16 = 1 << 2,
+    IMMZ = 1 << 3,      // 16 or 32 bits by operand size
+    IMMV = 1 << 4,      // 16, 32 or 64 bits by operand size (MOV r, imm)
+    MOFFS = 1 << 5,     // An address, 64 or 32 bits by address size
+    REL8 = 1 << 6,
+    REL32 = 1 << 7,
+    GROUP3 = 1 << 8,    // F6 / F7: the immediate is there only for TEST (reg 0 or 1)
+    CALL = 1 << 9,
+    JUMP = 1 << 10,
+    INVALID = 1 << 11
+};
+
+struct OpcodeTables {
+    uint16_t oneByte[256];
+    uint16_t twoByte[256];
+
+    OpcodeTables() {
+        // The eight ALU groups: r/m forms, then AL, imm8 and eAX, immz
+        for (int op = 0; op < 0x40; ++op) {
+            switch (op & 7) {
+            case 4: oneByte[op] = IMM8; break;
+            case 5: oneByte[op] = IMMZ; break;
+            case 6:
+            case 7: oneByte[op] = INVALID; break;   // Push/pop segment, DAA and friends
+            default: oneByte[op] = MODRM; break;
+            }
+        }
+        for (int op = 0x40; op < 0x100; ++op) oneByte[op] = 0;
+
+        oneByte[0x60] = oneByte[0x61] = INVALID;
+        oneByte[0x63] = MODRM;
+        oneByte[0x68] = IMMZ;
+        oneByte[0x69] = MODRM | IMMZ;
+        oneByte[0x6A] = IMM8;
+        oneByte[0x6B] = MODRM | IMM8;
+        for (int op = 0x70; op < 0x80; ++op) oneByte[op] = REL8;
+        oneByte[0x80] = MODRM | IMM8;
+        oneByte[0x81] = MODRM | IMMZ;
+        oneByte[0x82] = INVALID;
+        oneByte[0x83] = MODRM | IMM8;
+        for (int op = 0x84; op < 0x90; ++op) oneByte[op] = MODRM;
+        oneByte[0x9A] = INVALID;
+        for (int op = 0xA0; op < 0xA4; ++op) oneByte[op] = MOFFS;
+        oneByte[0xA8] = IMM8;
+        oneByte[0xA9] = IMMZ;
+        for (int op = 0xB0; op < 0xB8; ++op) oneByte[op] = IMM8;
+        for (int op = 0xB8; op < 0xC0; ++op) oneByte[op] = IMMV;
+        oneByte[0xC0] = oneByte[0xC1] = MODRM | IMM8;
+        oneByte[0xC2] = IMM16;
+        oneByte[0xC6] = MODRM | IMM8;
+        oneByte[0xC7] = MODRM | IMMZ;
+        oneByte[0xC8] = IMM16 | IMM8;
+        oneByte[0xCA] = IMM16;
+        oneByte[0xCD] = IMM8;
+        oneByte[0xCE] = INVALID;
+        for (int op = 0xD0; op < 0xD4; ++op) oneByte[op] = MODRM;
+        oneByte[0xD4] = oneByte[0xD5] = oneByte[0xD6] = INVALID;
+        for (int op = 0xD8; op < 0xE0; ++op) oneByte[op] = MODRM;
+        for (int op = 0xE0; op < 0xE4; ++op) oneByte[op] = REL8;
+        for (int op = 0xE4; op < 0xE8; ++op) oneByte[op] = IMM8;
+        oneByte[0xE8] = REL32 | CALL;
+        oneByte[0xE9] = REL32 | JUMP;
+        oneByte[0xEA] = INVALID;
+        oneByte[0xEB] = REL8 | JUMP;
+        oneByte[0xF6] = MODRM | GROUP3 | IMM8;
+        oneByte[0xF7] = MODRM | GROUP3 | IMMZ;
+        oneByte[0xFE] = oneByte[0xFF] = MODRM;
+
+        // Most of the 0F map takes a ModRM byte
+        for (int op = 0; op < 0x100; ++op) twoByte[op] = MODRM;
+        for (int op : { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x0E, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x37, 0x77,
+                        0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA }) {
+            twoByte[op] = 0;
+        }
+        for (int op = 0xC8; op < 0xD0; ++op) twoByte[op] = 0;
+        for (int op : { 0x04, 0x0A, 0x0C, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x7A, 0x7B }) {
+            twoByte[op] = INVALID;
+        }
+        for (int op = 0x80; op < 0x90; ++op) twoByte[op] = REL32;
+        for (int op : { 0x0F, 0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6 }) {
+            twoByte[op] = MODRM | IMM8;
+        }
+    }
+};
+
+const OpcodeTables& Tables() {
+    static const OpcodeTables tables;
+    return tables;
+}
+
+// VEX and EVEX encodings of the 0F map that take an imm8
+inline bool VexMap1HasImm8(uint8_t opcode) {
+    return (opcode >= 0x70 && opcode <= 0x73) || opcode == 0xC2 || opcode == 0xC4 || opcode == 0xC5 || opcode == 0xC6;
+}
+
+inline int32_t ReadInt32(const uint8_t* code) {
+    int32_t value;
+    memcpy(&value, code, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+bool InstructionDecoder::Decode(const uint8_t* code, size_t available, uintptr_t address,
+                                DecodedInstruction& instruction) {
+    const OpcodeTables& tables = Tables();
+    size_t limit = available < MAX_LENGTH ? available : MAX_LENGTH;
+    size_t pos = 0;
+    bool operandSize16 = false;
+    bool addressSize32 = false;
+    bool rexW = false;
+    uint8_t repeat = 0;   // F2 or F3, which select some 0F map forms
+
+    // Legacy prefixes in any order; REX counts only right before the opcode
+    for (;; ++pos) {
+        if (pos >= limit) return false;
+        uint8_t byte = code[pos];
+        if (byte == 0x66) {
+            operandSize16 = true;
+        } else if (byte == 0x67) {
+            addressSize32 = true;
+        } else if (byte == 0xF2 || byte == 0xF3) {
+            repeat = byte;
+        } else if (byte == 0xF0 || byte == 0x2E || byte == 0x36 || byte == 0x3E || byte == 0x26 || byte == 0x64 ||
+                   byte == 0x65) {
+        } else if ((byte & 0xF0) == 0x40) {
+            if (pos + 1 >= limit) return false;
+            uint8_t next = code[pos + 1];
+            bool prefixFollows = next == 0x66 || next == 0x67 || next == 0xF2 || next == 0xF3 || next == 0xF0 ||
+                                 next == 0x2E || next == 0x36 || next == 0x3E || next == 0x26 || next == 0x64 ||
+                                 next == 0x65 || (next & 0xF0) == 0x40;
+            if (!prefixFollows) {
+                rexW = (byte & 0x08) != 0;
+                pos++;
+                break;
+            }
+        } else {
+            break;
+        }
+    }
+
+    uint16_t flags;
+    uint8_t opcode = code[pos++];
+    bool group3 = false;
+    instruction.branch = BranchKind::None;
+
+    if (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62 || (opcode == 0x8F && pos < limit && (code[pos] & 0x1F) >= 8)) {
+        // VEX, EVEX and XOP carry the map in their payload; every form has
+        // a ModRM byte except VZEROUPPER / VZEROALL
+        size_t payload = opcode == 0xC5 ? 1 : (opcode == 0x62 ? 3 : 2);
+        if (pos + payload >= limit) return false;
+        uint8_t map = opcode == 0xC5 ? 1 : (opcode == 0x62 ? (code[pos] & 0x07) : (code[pos] & 0x1F));
+        pos += payload;
+        uint8_t op = code[pos++];
+
+        if (opcode == 0x8F) {
+            if (map == 8) {
+                flags = MODRM | IMM8;
+            } else if (map == 9) {
+                flags = MODRM;
+            } else if (map == 10) {
+                flags = MODRM | IMMZ;
+                operandSize16 = false;
+            } else {
+                return false;
+            }
+        } else if (map == 1) {
+            flags = (op == 0x77 && opcode != 0x62) ? 0 : (VexMap1HasImm8(op) ? MODRM | IMM8 : MODRM);
+        } else if (map == 2 || (opcode == 0x62 && (map == 5 || map == 6))) {
+            flags = MODRM;
+        } else if (map == 3) {
+            flags = MODRM | IMM8;
+        } else {
+            return false;
+        }
+    } else if (opcode == 0x0F) {
+        if (pos >= limit) return false;
+        uint8_t op = code[pos++];
+        if (op == 0x38 || op == 0x3A) {
+            if (pos >= limit) return false;
+            pos++;
+            flags = op == 0x3A ? MODRM | IMM8 : MODRM;
+        } else {
+            flags = tables.twoByte[op];
+            // EXTRQ / INSERTQ take two imm8s in their 66 and F2 forms
+            if (op == 0x78 && (operandSize16 || repeat == 0xF2)) flags |= IMM16;
+            if (op >= 0x80 && op < 0x90) instruction.branch = BranchKind::Conditional;
+        }
+    } else {
+        flags = tables.oneByte[opcode];
+        group3 = (flags & GROUP3) != 0;
+        if (flags & REL8 || flags & REL32) {
+            instruction.branch = (flags & CALL) ? BranchKind::Call : (flags & JUMP) ? BranchKind::Jump : BranchKind::Conditional;
+        }
+    }
+    if (flags & INVALID) return false;
+
+    // ModRM, SIB and displacement; 32-bit addressing has the same layout
+    size_t ripDisplacement = 0;
+    if (flags & MODRM) {
+        if (pos >= limit) return false;
+        uint8_t modrm = code[pos++];
+        uint8_t mod = modrm >> 6;
+        uint8_t rm = modrm & 7;
+        if (group3 && ((modrm >> 3) & 7) > 1) flags &= ~(IMM8 | IMMZ);
+
+        if (mod != 3) {
+            if (rm == 4) {
+                if (pos >= limit) return false;
+                uint8_t sib = code[pos++];
+                if (mod == 0 && (sib & 7) == 5) pos += 4;
+            } else if (mod == 0 && rm == 5) {
+                ripDisplacement = pos;
+                pos += 4;
+            }
+            if (mod == 1) pos += 1;
+            if (mod == 2) pos += 4;
+        }
+    }
+
+    size_t relative = pos;
+    if (flags & IMM8) pos += 1;
+    if (flags & IMM16) pos += 2;
+    if (flags & IMMZ) pos += operandSize16 ? 2 : 4;
+    if (flags & IMMV) pos += rexW ? 8 : (operandSize16 ? 2 : 4);
+    if (flags & MOFFS) pos += addressSize32 ? 4 : 8;
+    if (flags & REL8) pos += 1;
+    if (flags & REL32) pos += 4;
+    if (pos > limit) return false;
+
+    instruction.length = pos;
+    uintptr_t next = address + pos;
+
+    instruction.branchTarget = 0;
+    if (flags & REL8) {
+        instruction.branchTarget = next + static_cast<intptr_t>(static_cast<int8_t>(code[relative]));
+    } else if (flags & REL32) {
+        instruction.branchTarget = next + static_cast<intptr_t>(ReadInt32(code + relative));
+    }
+
+    // The displacement is taken from the end of the instruction, immediates included
+    instruction.ripRelative = ripDisplacement != 0;
+    instruction.memoryTarget = 0;
+    if (instruction.ripRelative) {
+        instruction.memoryTarget = next + static_cast<intptr_t>(ReadInt32(code + ripDisplacement));
+        if (addressSize32) instruction.memoryTarget &= 0xFFFFFFFF;
+    }
+    return true;
+}
@@ -0,0 +1,145 @@
+#include "include/mapped_file.h"
+#include <algorithm>
+#include <utility>
+
+bool WriteAll(HANDLE file, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        DWORD written = 0;
+        DWORD part = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        if (!WriteFile(file, bytes, part, &written, nullptr) || written == 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+HANDLE CreateTemporaryFile(const wchar_t* prefix) {
+    wchar_t directory[MAX_PATH + 1];
+    wchar_t path[MAX_PATH + 1];
+    DWORD length = GetTempPathW(MAX_PATH + 1, directory);
+    if (length == 0 || length > MAX_PATH || GetTempFileNameW(directory, prefix, 0, path) == 0) {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    // Temporary keeps the pages in the cache when memory allows
+    return CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+}
+
+FileWriter::FileWriter(HANDLE file) : m_file(file), m_failed(false), m_written(0) {
+}
+
+void FileWriter::Write(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_written += size;
+
+    if (m_buffer.size() + size > BUFFER_SIZE) Flush();
+    if (size >= BUFFER_SIZE) {
+        m_failed = m_failed || !WriteAll(m_file, bytes, size);
+        return;
+    }
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+void FileWriter::Pad(size_t alignment) {
+    static const uint8_t zeros[64] = {};
+    size_t padding = static_cast<size_t>((alignment - m_written % alignment) % alignment);
+    while (padding > 0) {
+        size_t part = std::min(padding, sizeof(zeros));
+        Write(zeros, part);
+        padding -= part;
+    }
+}
+
+bool FileWriter::Flush() {
+    m_failed = m_failed || m_file == INVALID_HANDLE_VALUE || !WriteAll(m_file, m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+    return !m_failed;
+}
+
+FileSaver::FileSaver(const std::wstring& path)
+    : m_path(path), m_temporary(path + L".tmp"),
+      m_file(CreateFileW(m_temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                         nullptr)),
+      m_writer(m_file) {
+}
+
+FileSaver::~FileSaver() {
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        DeleteFileW(m_temporary.c_str());
+    }
+}
+
+bool FileSaver::Commit() {
+    if (m_file == INVALID_HANDLE_VALUE) return false;
+
+    bool written = m_writer.Flush();
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+
+    if (!written || !MoveFileExW(m_temporary.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileW(m_temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+MappedFile::MappedFile() : m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_view(nullptr), m_size(0) {
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::Swap(MappedFile& other) {
+    std::swap(m_file, other.m_file);
+    std::swap(m_mapping, other.m_mapping);
+    std::swap(m_view, other.m_view);
+    std::swap(m_size, other.m_size);
+}
+
+bool MappedFile::Open(const std::wstring& path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        Close();
+        return false;
+    }
+    return Map(file);
+}
+
+bool MappedFile::Map(HANDLE file) {
+    Close();
+    m_file = file;
+
+    // An empty file cannot be mapped, and none of ours is valid empty
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart <= 0) {
+        Close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) {
+        m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_view == nullptr) {
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_view = nullptr;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+    m_size = 0;
+}
@@ -1,11 +1,25 @@
 #include "include/memory_helpers.h"
 #include "include/error_handler.h"
+#include "include/pattern_matcher.h"
+#include "include/multi_pattern_scanner.h"
+#include "include/signature.h"
+#include "include/static_signature.h"
+#include "include/byte_regex.h"
+#include "include/string_searcher.h"
+#include "include/string_extractor.h"
+#include "include/value_scanner.h"
+#include "include/group_scanner.h"
+#include "include/pointer_map.h"
+#include "include/pointer_path.h"
 #include <psapi.h>
 #include <tlhelp32.h>
-#include <regex>
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+#include <unordered_set>
 
 // Pointer finding operations
 std::vector<PointerResult> MemoryHelpers::FindPointersTo(HANDLE processHandle, uintptr_t targetAddress, 
@@ -13,37 +27,27 @@ std::vector<PointerResult> MemoryHelpers::FindPointersTo(HANDLE processHandle, u
     std::vector<PointerResult> results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
-        
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty()) continue;
-            
+        results = ScanChunks<PointerResult>(processHandle, false, searchStart, searchEnd, sizeof(uintptr_t) - 1,
+                                            [&](const RegionChunk& chunk, std::vector<PointerResult>& out) {
             // Search for pointers (assuming pointer size is sizeof(uintptr_t))
-            for (size_t i = 0; i <= buffer.size() - sizeof(uintptr_t); i += sizeof(uintptr_t)) {
-                uintptr_t* ptrValue = reinterpret_cast<uintptr_t*>(&buffer[i]);
+            for (size_t i = FirstAlignedOffset(chunk, sizeof(uintptr_t)); i < chunk.owned && i + sizeof(uintptr_t) <= chunk.size; i += sizeof(uintptr_t)) {
+                if (i + sizeof(uintptr_t) <= chunk.carried) continue;
+                
+                uintptr_t ptrValue;
+                memcpy(&ptrValue, chunk.data + i, sizeof(ptrValue));
                 
-                if (*ptrValue == targetAddress) {
+                if (ptrValue == targetAddress) {
                     PointerResult result;
-                    result.address = start + i;
+                    result.address = chunk.address + i;
                     result.pointsTo = targetAddress;
                     result.offset = 0;
-                    results.push_back(result);
+                    out.push_back(result);
                     
-                    if (results.size() >= MAX_RESULTS) break;
+                    if (out.size() >= MAX_RESULTS) return false;
                 }
             }
-            
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return true;
+        });
     }
     catch (const MemoryHookingException& e) {
         ErrorHandler::logError("FindPointersTo failed: " + std::string(e.what()));
@@ -57,36 +61,12 @@ std::vector<PointerResult> MemoryHelpers::FindPointerChain(HANDLE processHandle,
     std::vector<PointerResult> results;
     
     try {
-        // Start by finding direct pointers to the final address
-        auto directPointers = FindPointersTo(processHandle, finalAddress);
-        
-        for (const auto& directPtr : directPointers) {
-            PointerResult result = directPtr;
-            results.push_back(result);
-        }
-        
-        // If offsets are provided, search for pointer chains
-        if (!offsets.empty() && maxDepth > 1) {
-            for (int depth = 1; depth < maxDepth; ++depth) {
-                std::vector<PointerResult> newResults;
-                
-                for (const auto& existingPtr : results) {
-                    // Find pointers to this pointer's address
-                    auto chainPointers = FindPointersTo(processHandle, existingPtr.address);
-                    
-                    for (const auto& chainPtr : chainPointers) {
-                        PointerResult chainResult;
-                        chainResult.address = chainPtr.address;
-                        chainResult.pointsTo = finalAddress;
-                        chainResult.offset = depth < offsets.size() ? offsets[depth] : 0;
-                        newResults.push_back(chainResult);
-                    }
-                }
-                
-                results.insert(results.end(), newResults.begin(), newResults.end());
-                if (results.size() >= MAX_RESULTS) break;
-            }
-        }
+        // One pass over memory indexes every pointer; each level of the
+        // chain is then a set of lookups in the index
+        PointerMapOptions options = { 0, 0, false, false };
+        std::unique_ptr<PointerMap> map = PointerMap::Build(processHandle, options);
+        PointerPathScanner scanner(*map, std::vector<ModuleImage>());
+        results = scanner.Tree(finalAddress, static_cast<size_t>(std::max(maxDepth, 0)), offsets, MAX_RESULTS);
     }
     catch (const MemoryHookingException& e) {
         ErrorHandler::logError("FindPointerChain failed: " + std::string(e.what()));
@@ -100,31 +80,21 @@ std::vector<uintptr_t> MemoryHelpers::FindNullPointers(HANDLE processHandle, uin
     std::vector<uintptr_t> results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
-        
-        for (const auto& region : regions) {
-            uintptr_t start = std::max(searchStart, region.startAddress);
-            uintptr_t end = std::min(searchEnd, region.endAddress);
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty()) continue;
-            
-            for (size_t i = 0; i <= buffer.size() - sizeof(uintptr_t); i += sizeof(uintptr_t)) {
-                uintptr_t* ptrValue = reinterpret_cast<uintptr_t*>(&buffer[i]);
+        results = ScanChunks<uintptr_t>(processHandle, false, searchStart, searchEnd, sizeof(uintptr_t) - 1,
+                                        [&](const RegionChunk& chunk, std::vector<uintptr_t>& out) {
+            for (size_t i = FirstAlignedOffset(chunk, sizeof(uintptr_t)); i < chunk.owned && i + sizeof(uintptr_t) <= chunk.size; i += sizeof(uintptr_t)) {
+                if (i + sizeof(uintptr_t) <= chunk.carried) continue;
                 
-                if (*ptrValue == 0) {
-                    results.push_back(start + i);
-                    if (results.size() >= MAX_RESULTS) break;
+                uintptr_t ptrValue;
+                memcpy(&ptrValue, chunk.data + i, sizeof(ptrValue));
+                
+                if (ptrValue == 0) {
+                    out.push_back(chunk.address + i);
+                    if (out.size() >= MAX_RESULTS) return false;
                 }
             }
-            
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return true;
+        });
     }
     catch (const MemoryHookingException& e) {
         ErrorHandler::logError("FindNullPointers failed: " + std::string(e.what()));
@@ -137,44 +107,107 @@ std::vector<uintptr_t> MemoryHelpers::FindNullPointers(HANDLE processHandle, uin
 std::vector<PatternMatch> MemoryHelpers::SearchBytePattern(HANDLE processHandle, const std::vector<uint8_t>& pattern, 
                                                           const std::vector<bool>& mask, uintptr_t searchStart, 
                                                           uintptr_t searchEnd) {
+    if (pattern.empty() || mask.size() != pattern.size()) {
+        return std::vector<PatternMatch>();
+    }
+    
+    return SearchWithMatcher(processHandle, PatternMatcher(pattern, mask), searchStart, searchEnd, "SearchBytePattern");
+}
+
+std::vector<PatternMatch> MemoryHelpers::SearchSignature(HANDLE processHandle, const Signature& signature,
+                                                        uintptr_t searchStart, uintptr_t searchEnd) {
+    return SearchWithMatcher(processHandle, signature.Matcher(), searchStart, searchEnd, "SearchSignature");
+}
+
+std::vector<PatternMatch> MemoryHelpers::SearchWithMatcher(HANDLE processHandle, const PatternMatcher& matcher,
+                                                          uintptr_t searchStart, uintptr_t searchEnd,
+                                                          const char* operation) {
     std::vector<PatternMatch> results;
     
-    if (pattern.empty() || mask.size() != pattern.size()) {
+    if (matcher.Empty()) {
         return results;
     }
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        size_t patternSize = matcher.Size();
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
+        results = ScanChunks<PatternMatch>(processHandle, false, searchStart, searchEnd, patternSize - 1,
+                                           [&](const RegionChunk& chunk, std::vector<PatternMatch>& out) {
+            // Only matches starting in the owned part of the chunk
+            std::vector<size_t> offsets;
+            size_t searchSize = std::min(chunk.size, chunk.owned + patternSize - 1);
+            matcher.FindAll(chunk.data, searchSize, offsets, MAX_RESULTS - out.size());
             
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
+            for (size_t i : offsets) {
+                PatternMatch match;
+                match.address = chunk.address + i;
+                match.size = patternSize;
+                match.data.assign(chunk.data + i, chunk.data + i + patternSize);
+                out.push_back(match);
+            }
             
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty() || buffer.size() < pattern.size()) continue;
+            return out.size() < MAX_RESULTS;
+        });
+    }
+    catch (const MemoryHookingException& e) {
+        ErrorHandler::logError(std::string(operation) + " failed: " + std::string(e.what()));
+    }
+    
+    return results;
+}
+
+std::vector<MultiPatternMatch> MemoryHelpers::SearchMultiplePatterns(HANDLE processHandle,
+                                                                    const std::vector<std::vector<uint8_t>>& patterns,
+                                                                    const std::vector<std::vector<bool>>& masks,
+                                                                    uintptr_t searchStart, uintptr_t searchEnd) {
+    std::vector<MultiPatternMatch> results;
+    
+    if (patterns.empty() || masks.size() != patterns.size()) {
+        return results;
+    }
+    
+    try {
+        // Pattern ids handed back to the caller are indices into patterns, even
+        // when some entries are invalid and never make it into the scanner
+        MultiPatternScanner scanner;
+        std::vector<size_t> callerIds;
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            if (scanner.AddPattern(patterns[i], masks[i]) != MultiPatternScanner::npos) {
+                callerIds.push_back(i);
+            }
+        }
+        if (scanner.PatternCount() == 0) return results;
+        
+        results = ScanChunks<MultiPatternMatch>(processHandle, false, searchStart, searchEnd, scanner.MaxPatternSize() - 1,
+                                                [&](const RegionChunk& chunk, std::vector<MultiPatternMatch>& out) {
+            // Hits inside the carried tail are dropped below; at most one per
+            // pattern and offset, so allow for them on top of what is left
+            std::vector<MultiPatternHit> hits;
+            size_t searchSize = std::min(chunk.size, chunk.owned + scanner.MaxPatternSize() - 1);
+            scanner.FindAll(chunk.data, searchSize, hits,
+                            MAX_RESULTS - out.size() + chunk.carried * scanner.PatternCount());
             
-            for (size_t i = 0; i <= buffer.size() - pattern.size(); ++i) {
-                if (MatchesPattern(&buffer[i], pattern, mask)) {
-                    PatternMatch match;
-                    match.address = start + i;
-                    match.size = pattern.size();
-                    match.data.assign(buffer.begin() + i, buffer.begin() + i + pattern.size());
-                    results.push_back(match);
-                    
-                    if (results.size() >= MAX_RESULTS) break;
-                }
+            for (const auto& hit : hits) {
+                size_t size = scanner.PatternSize(hit.patternId);
+                
+                // Shorter patterns can fit entirely in the carried tail
+                if (hit.offset + size <= chunk.carried || hit.offset >= chunk.owned) continue;
+                
+                MultiPatternMatch match;
+                match.address = chunk.address + hit.offset;
+                match.patternId = callerIds[hit.patternId];
+                match.size = size;
+                match.data.assign(chunk.data + hit.offset, chunk.data + hit.offset + size);
+                out.push_back(match);
+                
+                if (out.size() >= MAX_RESULTS) return false;
             }
             
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return true;
+        });
     }
     catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchBytePattern failed: " + std::string(e.what()));
+        ErrorHandler::logError("SearchMultiplePatterns failed: " + std::string(e.what()));
     }
     
     return results;
@@ -185,113 +218,193 @@ std::vector<PatternMatch> MemoryHelpers::SearchStringPattern(HANDLE processHandl
                                                             uintptr_t searchStart, uintptr_t searchEnd) {
     std::vector<PatternMatch> results;
     
-    if (pattern.empty()) return results;
+    StringEncoding encoding = unicode ? StringEncoding::Utf16LE : StringEncoding::Utf8;
+    for (auto& match : SearchString(processHandle, pattern, static_cast<uint32_t>(encoding), caseSensitive,
+                                    searchStart, searchEnd)) {
+        PatternMatch patternMatch;
+        patternMatch.address = match.address;
+        patternMatch.size = match.size;
+        patternMatch.data = std::move(match.data);
+        results.push_back(std::move(patternMatch));
+    }
+    
+    return results;
+}
+
+std::vector<StringMatch> MemoryHelpers::SearchString(HANDLE processHandle, const std::string& text, uint32_t encodings,
+                                                     bool caseSensitive, uintptr_t searchStart, uintptr_t searchEnd) {
+    std::vector<StringMatch> results;
+    
+    StringSearcher searcher(text, encodings, caseSensitive);
+    if (searcher.Empty()) return results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        size_t maxSize = searcher.MaxNeedleSize();
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty()) continue;
-            
-            std::string searchStr = pattern;
-            if (!caseSensitive) {
-                std::transform(searchStr.begin(), searchStr.end(), searchStr.begin(), ::tolower);
-            }
+        results = ScanChunks<StringMatch>(processHandle, false, searchStart, searchEnd, maxSize - 1,
+                                          [&](const RegionChunk& chunk, std::vector<StringMatch>& out) {
+            // Shorter encodings are cut off at chunk.owned below, the longest one here
+            std::vector<StringHit> hits;
+            size_t searchSize = std::min(chunk.size, chunk.owned + maxSize - 1);
+            searcher.FindAll(chunk.data, searchSize, chunk.address, hits);
             
-            if (unicode) {
-                // Search for Unicode (UTF-16) strings
-                std::wstring widePattern(pattern.begin(), pattern.end());
-                const uint8_t* wideBytes = reinterpret_cast<const uint8_t*>(widePattern.c_str());
-                size_t wideSize = widePattern.size() * sizeof(wchar_t);
+            for (const StringHit& hit : hits) {
+                // Already reported from the previous chunk, or owned by the next range
+                if (hit.offset + hit.size <= chunk.carried || hit.offset >= chunk.owned) continue;
                 
-                for (size_t i = 0; i <= buffer.size() - wideSize; i += 2) {
-                    if (memcmp(&buffer[i], wideBytes, wideSize) == 0) {
-                        PatternMatch match;
-                        match.address = start + i;
-                        match.size = wideSize;
-                        match.data.assign(buffer.begin() + i, buffer.begin() + i + wideSize);
-                        results.push_back(match);
-                        
-                        if (results.size() >= MAX_RESULTS) break;
-                    }
-                }
-            } else {
-                // Search for ASCII strings
-                for (size_t i = 0; i <= buffer.size() - pattern.size(); ++i) {
-                    std::string candidate(buffer.begin() + i, buffer.begin() + i + pattern.size());
-                    
-                    if (!caseSensitive) {
-                        std::transform(candidate.begin(), candidate.end(), candidate.begin(), ::tolower);
-                    }
-                    
-                    if (candidate == searchStr) {
-                        PatternMatch match;
-                        match.address = start + i;
-                        match.size = pattern.size();
-                        match.data.assign(buffer.begin() + i, buffer.begin() + i + pattern.size());
-                        results.push_back(match);
-                        
-                        if (results.size() >= MAX_RESULTS) break;
-                    }
-                }
+                StringMatch match;
+                match.address = chunk.address + hit.offset;
+                match.size = hit.size;
+                match.encoding = hit.encoding;
+                match.data.assign(chunk.data + hit.offset, chunk.data + hit.offset + hit.size);
+                out.push_back(match);
+                
+                if (out.size() >= MAX_RESULTS) return false;
             }
             
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return true;
+        });
     }
     catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchStringPattern failed: " + std::string(e.what()));
+        ErrorHandler::logError("SearchString failed: " + std::string(e.what()));
     }
     
     return results;
 }
 
+namespace {
+
+// Matches of one piece of a regex scan, with the address matching had
+// resumed at when the piece's owned range began
+struct RegexPiece {
+    std::vector<PatternMatch> matches;
+    uintptr_t resume;
+};
+
+// Matches are leftmost-longest and do not overlap, so where one may start
+// depends on where the previous one ended. A piece therefore starts matching
+// at from, before its owned range, to fall in step with the previous piece.
+// Matches starting before piece.start belong to that piece and only move the
+// resume point.
+void ScanRegexPiece(HANDLE processHandle, ByteRegex::Matcher& matcher, size_t maxLength, uintptr_t from,
+                    const ScanRange& piece, size_t readerBudget, size_t maxResults, RegexPiece& out) {
+    out.matches.clear();
+    out.resume = std::max(from, piece.start);
+    if (from >= piece.start + piece.size) return;
+
+    RegionReader reader(processHandle, maxLength, readerBudget);
+    RegionChunk chunk;
+    if (!reader.Begin(from, piece.start + piece.size - from, piece.readAhead)) return;
+
+    uintptr_t previousEnd = from;
+    while (out.matches.size() < maxResults && reader.Next(chunk)) {
+        // Every match fits in the carried window, so a chunk resolves the starts
+        // before its last maxLength bytes and leaves the rest to the next chunk
+        size_t limit = chunk.owned;
+        if (!chunk.last) {
+            limit = std::min(limit, chunk.size > maxLength ? chunk.size - maxLength : 0);
+        }
+        
+        // Resume after the previous match, which may reach into this chunk
+        size_t next = previousEnd > chunk.address ? static_cast<size_t>(previousEnd - chunk.address) : 0;
+        size_t matchStart, matchEnd;
+        while (out.matches.size() < maxResults && matcher.Find(chunk.data, chunk.size, next, limit, matchStart, matchEnd)) {
+            uintptr_t address = chunk.address + matchStart;
+            previousEnd = chunk.address + matchEnd;
+            next = matchEnd;
+            
+            if (address < piece.start) {
+                out.resume = std::max(previousEnd, piece.start);
+                continue;
+            }
+            
+            PatternMatch patternMatch;
+            patternMatch.address = address;
+            patternMatch.size = matchEnd - matchStart;
+            patternMatch.data.assign(chunk.data + matchStart, chunk.data + matchEnd);
+            out.matches.push_back(std::move(patternMatch));
+        }
+    }
+}
+
+} // namespace
+
 std::vector<PatternMatch> MemoryHelpers::SearchRegexPattern(HANDLE processHandle, const std::string& regexPattern,
                                                            uintptr_t searchStart, uintptr_t searchEnd) {
     std::vector<PatternMatch> results;
     
     try {
-        std::regex regex(regexPattern);
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        std::string error;
+        std::unique_ptr<ByteRegex> regex = ByteRegex::Compile(regexPattern, error);
+        if (!regex) {
+            ErrorHandler::logError("SearchRegexPattern: " + error);
+            return results;
+        }
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty()) continue;
-            
-            // Convert buffer to string for regex matching
-            std::string text(buffer.begin(), buffer.end());
-            std::sregex_iterator iter(text.begin(), text.end(), regex);
-            std::sregex_iterator end_iter;
-            
-            for (; iter != end_iter && results.size() < MAX_RESULTS; ++iter) {
-                const std::smatch& match = *iter;
+        const size_t maxLength = regex->MaxMatchLength();
+        const size_t leadIn = 2 * maxLength;
+        
+        std::vector<ScanRange> ranges = CollectScanRanges(processHandle, false, searchStart, searchEnd);
+        ScanExecutor& executor = ScanExecutor::Instance();
+        std::vector<ScanRange> pieces = ScanExecutor::SplitRanges(ranges, maxLength);
+        std::vector<RegexPiece> found(pieces.size());
+        ResultCutoff cutoff(pieces.size(), MAX_RESULTS);
+        size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+        
+        // DFA caches are not shared between threads; pieces borrow a matcher
+        std::mutex poolMutex;
+        std::vector<std::unique_ptr<ByteRegex::Matcher>> pool;
+        auto borrow = [&]() {
+            std::unique_ptr<ByteRegex::Matcher> matcher;
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!pool.empty()) {
+                matcher = std::move(pool.back());
+                pool.pop_back();
+            }
+            if (!matcher) matcher.reset(new ByteRegex::Matcher(*regex));
+            return matcher;
+        };
+        
+        executor.Run(pieces.size(), [&](size_t task) {
+            // A cut-off piece can still be needed if an earlier piece is
+            // rescanned below; resume 0 never matches, so it is rescanned too
+            found[task].resume = 0;
+            if (!cutoff.IsCutOff(task)) {
+                // The lead-in stays inside the piece's range
+                const ScanRange& piece = pieces[task];
+                auto range = std::upper_bound(ranges.begin(), ranges.end(), piece.start,
+                                              [](uintptr_t value, const ScanRange& r) { return value < r.start; }) - 1;
+                uintptr_t from = piece.start - std::min<uintptr_t>(leadIn, piece.start - range->start);
                 
-                PatternMatch patternMatch;
-                patternMatch.address = start + match.position();
-                patternMatch.size = match.length();
-                patternMatch.data.assign(buffer.begin() + match.position(), 
-                                       buffer.begin() + match.position() + match.length());
-                results.push_back(patternMatch);
+                std::unique_ptr<ByteRegex::Matcher> matcher = borrow();
+                ScanRegexPiece(processHandle, *matcher, maxLength, from, piece, readerBudget, MAX_RESULTS, found[task]);
+                std::lock_guard<std::mutex> lock(poolMutex);
+                pool.push_back(std::move(matcher));
+            }
+            cutoff.Complete(task, found[task].matches.size());
+        });
+        
+        // Each piece keeps only matches starting in its owned range. Where its
+        // lead-in resumed somewhere other than the previous piece's last match
+        // actually ends, it fell out of step and is scanned again from there.
+        // Regions never share a match, so a new region resumes at its start.
+        uintptr_t previousEnd = 0;
+        for (size_t task = 0; task < pieces.size() && results.size() < MAX_RESULTS; ++task) {
+            RegexPiece& piece = found[task];
+            uintptr_t resume = std::max(pieces[task].start, previousEnd);
+            if (piece.resume != resume) {
+                std::unique_ptr<ByteRegex::Matcher> matcher = borrow();
+                ScanRegexPiece(processHandle, *matcher, maxLength, resume, pieces[task], readerBudget,
+                               MAX_RESULTS, piece);
+                pool.push_back(std::move(matcher));
             }
             
-            if (results.size() >= MAX_RESULTS) break;
+            size_t take = std::min(piece.matches.size(), MAX_RESULTS - results.size());
+            results.insert(results.end(), std::make_move_iterator(piece.matches.begin()),
+                           std::make_move_iterator(piece.matches.begin() + take));
+            if (!piece.matches.empty()) {
+                previousEnd = piece.matches.back().address + piece.matches.back().size;
+            }
         }
     }
     catch (const std::exception& e) {
@@ -301,178 +414,129 @@ std::vector<PatternMatch> MemoryHelpers::SearchRegexPattern(HANDLE processHandle
     return results;
 }
 
-// Numeric value searching
-std::vector<NumericMatch> MemoryHelpers::SearchInt32(HANDLE processHandle, int32_t value, uintptr_t searchStart, 
-                                                     uintptr_t searchEnd, bool aligned) {
-    std::vector<NumericMatch> results;
+StringExtractionStats MemoryHelpers::ExtractStrings(HANDLE processHandle, StringSink& sink, size_t minLength,
+                                                    uint32_t encodings, uintptr_t searchStart, uintptr_t searchEnd,
+                                                    size_t batchSize) {
+    StringExtractionStats stats = {};
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        // Code units are tracked from the start of each range; keep them on even addresses
+        if (searchStart & 1) searchStart--;
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty() || buffer.size() < sizeof(int32_t)) continue;
-            
-            size_t step = aligned ? sizeof(int32_t) : 1;
-            
-            for (size_t i = 0; i <= buffer.size() - sizeof(int32_t); i += step) {
-                int32_t* candidate = reinterpret_cast<int32_t*>(&buffer[i]);
-                
-                if (*candidate == value) {
-                    NumericMatch match;
-                    match.address = start + i;
-                    match.dataType = "int32";
-                    match.rawData.assign(buffer.begin() + i, buffer.begin() + i + sizeof(int32_t));
-                    results.push_back(match);
-                    
-                    if (results.size() >= MAX_RESULTS) break;
-                }
-            }
-            
-            if (results.size() >= MAX_RESULTS) break;
-        }
+        StringExtractor extractor(processHandle, minLength, encodings,
+                                  batchSize ? batchSize : StringExtractor::DEFAULT_BATCH_SIZE);
+        stats = extractor.Run(CollectScanRanges(processHandle, false, searchStart, searchEnd), sink);
     }
-    catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchInt32 failed: " + std::string(e.what()));
+    catch (const std::exception& e) {
+        ErrorHandler::logError("ExtractStrings failed: " + std::string(e.what()));
     }
     
-    return results;
+    return stats;
 }
 
-std::vector<NumericMatch> MemoryHelpers::SearchInt64(HANDLE processHandle, int64_t value, uintptr_t searchStart, 
-                                                     uintptr_t searchEnd, bool aligned) {
+// Numeric value searching
+std::vector<NumericMatch> MemoryHelpers::SearchValue(HANDLE processHandle, const ValueQuery& query,
+                                                     uintptr_t searchStart, uintptr_t searchEnd) {
     std::vector<NumericMatch> results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        ValueScanner scanner(query);
+        if (scanner.Empty()) return results;
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty() || buffer.size() < sizeof(int64_t)) continue;
+        const size_t width = scanner.Width();
+        const char* typeName = ScanValueTypeName(query.type);
+        
+        results = ScanChunks<NumericMatch>(processHandle, false, searchStart, searchEnd, width - 1,
+                                           [&](const RegionChunk& chunk, std::vector<NumericMatch>& out) {
+            // Values wholly inside the carried bytes were tested with the previous chunk
+            size_t from = chunk.carried >= width ? chunk.carried - width + 1 : 0;
             
-            size_t step = aligned ? sizeof(int64_t) : 1;
+            std::vector<size_t> offsets;
+            scanner.FindAll(chunk.data, chunk.size, chunk.address, from, chunk.owned, offsets, MAX_RESULTS - out.size());
             
-            for (size_t i = 0; i <= buffer.size() - sizeof(int64_t); i += step) {
-                int64_t* candidate = reinterpret_cast<int64_t*>(&buffer[i]);
-                
-                if (*candidate == value) {
-                    NumericMatch match;
-                    match.address = start + i;
-                    match.dataType = "int64";
-                    match.rawData.assign(buffer.begin() + i, buffer.begin() + i + sizeof(int64_t));
-                    results.push_back(match);
-                    
-                    if (results.size() >= MAX_RESULTS) break;
-                }
+            for (size_t offset : offsets) {
+                NumericMatch match;
+                match.address = chunk.address + offset;
+                match.dataType = typeName;
+                match.rawData.assign(chunk.data + offset, chunk.data + offset + width);
+                out.push_back(match);
             }
-            
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return out.size() < MAX_RESULTS;
+        });
     }
     catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchInt64 failed: " + std::string(e.what()));
+        ErrorHandler::logError("SearchValue failed: " + std::string(e.what()));
     }
     
     return results;
 }
 
-std::vector<NumericMatch> MemoryHelpers::SearchFloat(HANDLE processHandle, float value, float tolerance,
-                                                    uintptr_t searchStart, uintptr_t searchEnd) {
-    std::vector<NumericMatch> results;
+std::vector<GroupMatch> MemoryHelpers::SearchGroup(HANDLE processHandle, const std::vector<ValueQuery>& members,
+                                                   size_t window, bool ordered, uintptr_t searchStart,
+                                                   uintptr_t searchEnd) {
+    std::vector<GroupMatch> results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
+        GroupScanner scanner(members, window, ordered);
+        if (scanner.Empty()) return results;
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
+        std::vector<ScanRange> ranges = CollectScanRanges(processHandle, false, searchStart, searchEnd);
+        
+        // Count each member's hits in evenly spread samples and anchor on the rarest
+        if (scanner.Members() > 1) {
+            size_t total = 0;
+            for (const auto& range : ranges) total += range.size;
             
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty() || buffer.size() < sizeof(float)) continue;
+            size_t stride = std::max(total / GROUP_SAMPLES, GROUP_SAMPLE_SIZE);
+            size_t next = 0;
+            size_t seen = 0;
+            std::vector<size_t> counts;
+            std::vector<uint8_t> sample;
             
-            for (size_t i = 0; i <= buffer.size() - sizeof(float); i += sizeof(float)) {
-                float* candidate = reinterpret_cast<float*>(&buffer[i]);
-                
-                if (std::abs(*candidate - value) <= tolerance) {
-                    NumericMatch match;
-                    match.address = start + i;
-                    match.dataType = "float";
-                    match.rawData.assign(buffer.begin() + i, buffer.begin() + i + sizeof(float));
-                    results.push_back(match);
-                    
-                    if (results.size() >= MAX_RESULTS) break;
+            for (const auto& range : ranges) {
+                for (; next < seen + range.size; next += stride) {
+                    size_t offset = next - seen;
+                    size_t read = ReadMemoryInto(processHandle, range.start + offset, sample,
+                                                 std::min(GROUP_SAMPLE_SIZE, range.size - offset));
+                    scanner.CountHits(sample.data(), read, range.start + offset, counts);
                 }
+                seen += range.size;
             }
-            
-            if (results.size() >= MAX_RESULTS) break;
+            scanner.ChooseAnchor(counts);
         }
-    }
-    catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchFloat failed: " + std::string(e.what()));
-    }
-    
-    return results;
-}
-
-std::vector<NumericMatch> MemoryHelpers::SearchDouble(HANDLE processHandle, double value, double tolerance,
-                                                     uintptr_t searchStart, uintptr_t searchEnd) {
-    std::vector<NumericMatch> results;
-    
-    try {
-        auto regions = GetMemoryRegions(processHandle, false, false);
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
+        // A group spans at most the window, so carrying window - 1 bytes
+        // keeps every group whole in some chunk
+        results = ParallelScan<GroupMatch>(processHandle, ranges, window - 1, MAX_RESULTS,
+                                           [&](const RegionChunk& chunk, std::vector<GroupMatch>& out) {
+            std::vector<GroupHit> hits;
+            scanner.FindAll(chunk.data, chunk.size, chunk.address, chunk.carried, chunk.owned, hits,
+                            MAX_RESULTS - out.size());
             
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
-            
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty() || buffer.size() < sizeof(double)) continue;
-            
-            for (size_t i = 0; i <= buffer.size() - sizeof(double); i += sizeof(double)) {
-                double* candidate = reinterpret_cast<double*>(&buffer[i]);
-                
-                if (std::abs(*candidate - value) <= tolerance) {
-                    NumericMatch match;
-                    match.address = start + i;
-                    match.dataType = "double";
-                    match.rawData.assign(buffer.begin() + i, buffer.begin() + i + sizeof(double));
-                    results.push_back(match);
-                    
-                    if (results.size() >= MAX_RESULTS) break;
+            for (const GroupHit& hit : hits) {
+                GroupMatch match;
+                match.address = chunk.address + hit.offset;
+                for (size_t offset : hit.members) {
+                    match.members.push_back(chunk.address + offset);
                 }
+                match.data.assign(chunk.data + hit.offset, chunk.data + hit.offset + hit.size);
+                out.push_back(std::move(match));
             }
-            
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return out.size() < MAX_RESULTS;
+        });
+        
+        // Keep one group per anchor hit, in address order
+        const size_t anchor = scanner.Anchor();
+        std::unordered_set<uintptr_t> anchors;
+        results.erase(std::remove_if(results.begin(), results.end(), [&](const GroupMatch& match) {
+            return !anchors.insert(match.members[anchor]).second;
+        }), results.end());
+        std::stable_sort(results.begin(), results.end(), [](const GroupMatch& a, const GroupMatch& b) {
+            return a.address < b.address;
+        });
     }
     catch (const MemoryHookingException& e) {
-        ErrorHandler::logError("SearchDouble failed: " + std::string(e.what()));
+        ErrorHandler::logError("SearchGroup failed: " + std::string(e.what()));
     }
     
     return results;
@@ -581,6 +645,42 @@ MemoryRegionEx MemoryHelpers::GetRegionInfo(HANDLE processHandle, uintptr_t addr
     return region;
 }
 
+std::vector<ModuleImage> MemoryHelpers::GetModuleImages(HANDLE processHandle) {
+    std::vector<ModuleImage> images;
+    
+    // The module count can change between calls, so retry with the size asked for
+    std::vector<HMODULE> modules(256);
+    DWORD needed = 0;
+    while (EnumProcessModulesEx(processHandle, modules.data(), static_cast<DWORD>(modules.size() * sizeof(HMODULE)),
+                                &needed, LIST_MODULES_ALL)) {
+        if (needed <= modules.size() * sizeof(HMODULE)) {
+            modules.resize(needed / sizeof(HMODULE));
+            break;
+        }
+        modules.resize(needed / sizeof(HMODULE));
+        needed = 0;
+    }
+    if (needed == 0) {
+        return images;
+    }
+    
+    for (HMODULE module : modules) {
+        MODULEINFO info;
+        char name[MAX_PATH];
+        if (!GetModuleInformation(processHandle, module, &info, sizeof(info)) ||
+            !GetModuleBaseNameA(processHandle, module, name, MAX_PATH)) {
+            continue;
+        }
+        
+        images.push_back({ name, reinterpret_cast<uintptr_t>(info.lpBaseOfDll), info.SizeOfImage });
+    }
+    
+    std::sort(images.begin(), images.end(), [](const ModuleImage& a, const ModuleImage& b) {
+        return a.base < b.base;
+    });
+    return images;
+}
+
 // Advanced scanning utilities
 std::vector<PatternMatch> MemoryHelpers::ScanForCode(HANDLE processHandle, const std::vector<uint8_t>& opcodes,
                                                     uintptr_t searchStart, uintptr_t searchEnd) {
@@ -588,33 +688,51 @@ std::vector<PatternMatch> MemoryHelpers::ScanForCode(HANDLE processHandle, const
     return SearchBytePattern(processHandle, opcodes, mask, searchStart, searchEnd);
 }
 
+namespace {
+
+// Appends the matches of one signature that start in the owned part of the
+// chunk. A match lying entirely in the carried tail was reported from the
+// previous chunk; one that only begins there was not, so the test uses this
+// signature's own length.
+template <typename Signature>
+void CollectOwnedMatches(const RegionChunk& chunk, size_t searchSize, std::vector<size_t>& offsets) {
+    Signature::ForEachMatch(chunk.data, searchSize, [&](size_t i) {
+        if (i + Signature::Size > chunk.carried && i < chunk.owned) offsets.push_back(i);
+        return true;
+    });
+}
+
+} // namespace
+
 std::vector<uintptr_t> MemoryHelpers::FindFunctionPrologs(HANDLE processHandle, uintptr_t searchStart, uintptr_t searchEnd) {
     std::vector<uintptr_t> results;
     
     try {
-        // Common x86/x64 function prologues
-        std::vector<std::vector<uint8_t>> prologPatterns = {
-            {0x55, 0x8B, 0xEC},                    // push ebp; mov ebp, esp (x86)
-            {0x48, 0x89, 0x5C, 0x24},              // mov [rsp+XX], rbx (x64)
-            {0x48, 0x83, 0xEC},                    // sub rsp, XX (x64)
-            {0x55, 0x48, 0x89, 0xE5}               // push rbp; mov rbp, rsp (x64)
-        };
+        // Common x86/x64 function prologues, matched by compile-time signatures
+        using PushEbpMovEbpEsp = StaticSignature<0x55, 0x8B, 0xEC>;        // push ebp; mov ebp, esp (x86)
+        using MovRbxToStack    = StaticSignature<0x48, 0x89, 0x5C, 0x24>;  // mov [rsp+XX], rbx (x64)
+        using SubRsp           = StaticSignature<0x48, 0x83, 0xEC>;        // sub rsp, XX (x64)
+        using PushRbpMovRbpRsp = StaticSignature<0x55, 0x48, 0x89, 0xE5>;  // push rbp; mov rbp, rsp (x64)
         
-        for (const auto& pattern : prologPatterns) {
-            std::vector<bool> mask(pattern.size(), true);
-            auto matches = SearchBytePattern(processHandle, pattern, mask, searchStart, searchEnd);
+        results = ScanChunks<uintptr_t>(processHandle, false, searchStart, searchEnd, 3,
+                                        [&](const RegionChunk& chunk, std::vector<uintptr_t>& out) {
+            // Matches must start in the owned part of the chunk; the longest prologue is 4 bytes
+            size_t searchSize = std::min(chunk.size, chunk.owned + 3);
+            std::vector<size_t> offsets;
+            CollectOwnedMatches<PushEbpMovEbpEsp>(chunk, searchSize, offsets);
+            CollectOwnedMatches<MovRbxToStack>(chunk, searchSize, offsets);
+            CollectOwnedMatches<SubRsp>(chunk, searchSize, offsets);
+            CollectOwnedMatches<PushRbpMovRbpRsp>(chunk, searchSize, offsets);
             
-            for (const auto& match : matches) {
-                results.push_back(match.address);
-                if (results.size() >= MAX_RESULTS) break;
-            }
+            std::sort(offsets.begin(), offsets.end());
+            offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
             
-            if (results.size() >= MAX_RESULTS) break;
-        }
-        
-        // Remove duplicates and sort
-        std::sort(results.begin(), results.end());
-        results.erase(std::unique(results.begin(), results.end()), results.end());
+            for (size_t i : offsets) {
+                out.push_back(chunk.address + i);
+                if (out.size() >= MAX_RESULTS) return false;
+            }
+            return true;
+        });
     }
     catch (const MemoryHookingException& e) {
         ErrorHandler::logError("FindFunctionPrologs failed: " + std::string(e.what()));
@@ -628,36 +746,29 @@ std::vector<uintptr_t> MemoryHelpers::FindCallInstructions(HANDLE processHandle,
     std::vector<uintptr_t> results;
     
     try {
-        auto regions = GetMemoryRegions(processHandle, true, false); // Executable regions only
+        // Relative call: E8 followed by a 32-bit displacement
+        using RelativeCall = StaticSignature<0xE8, StaticSignatureAny, StaticSignatureAny,
+                                             StaticSignatureAny, StaticSignatureAny>;
         
-        for (const auto& region : regions) {
-            uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
-            uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
-            
-            if (start >= end) continue;
-            
-            size_t regionSize = end - start;
-            if (regionSize > MAX_SCAN_SIZE) continue;
+        // Executable regions only; a call is 5 bytes so carry 4 between chunks
+        results = ScanChunks<uintptr_t>(processHandle, true, searchStart, searchEnd, 4,
+                                        [&](const RegionChunk& chunk, std::vector<uintptr_t>& out) {
+            size_t searchSize = std::min(chunk.size, chunk.owned + 4);
             
-            auto buffer = ReadMemoryChunk(processHandle, start, regionSize);
-            if (buffer.empty()) continue;
-            
-            // Look for call instructions (0xE8 for relative call)
-            for (size_t i = 0; i < buffer.size() - 5; ++i) {
-                if (buffer[i] == 0xE8) { // Call instruction
-                    // Calculate the target address of the call
-                    int32_t* offset = reinterpret_cast<int32_t*>(&buffer[i + 1]);
-                    uintptr_t callTarget = start + i + 5 + *offset; // instruction pointer + instruction size + offset
-                    
-                    if (callTarget == targetAddress) {
-                        results.push_back(start + i);
-                        if (results.size() >= MAX_RESULTS) break;
-                    }
+            RelativeCall::ForEachMatch(chunk.data, searchSize, [&](size_t i) {
+                // Calculate the target address of the call
+                int32_t offset;
+                memcpy(&offset, chunk.data + i + 1, sizeof(offset));
+                uintptr_t callTarget = chunk.address + i + 5 + offset; // instruction pointer + instruction size + offset
+                
+                if (callTarget == targetAddress) {
+                    out.push_back(chunk.address + i);
                 }
-            }
+                return out.size() < MAX_RESULTS;
+            });
             
-            if (results.size() >= MAX_RESULTS) break;
-        }
+            return out.size() < MAX_RESULTS;
+        });
     }
     catch (const MemoryHookingException& e) {
         ErrorHandler::logError("FindCallInstructions failed: " + std::string(e.what()));
@@ -672,22 +783,28 @@ std::vector<uintptr_t> MemoryHelpers::CompareMemoryRegions(HANDLE processHandle,
     std::vector<uintptr_t> differences;
     
     try {
-        if (size > MAX_SCAN_SIZE) {
-            throw MemoryHookingException(MemoryHookingError::InvalidSize, "Region size too large for comparison");
-        }
-        
-        auto buffer1 = ReadMemoryChunk(processHandle, region1Start, size);
-        auto buffer2 = ReadMemoryChunk(processHandle, region2Start, size);
+        // Compare window by window so both buffers together stay within the scan budget
+        size_t windowSize = std::max<size_t>(RegionReader::PAGE_GRANULARITY, RegionReader::MemoryBudget() / 2);
+        std::vector<uint8_t> buffer1;
+        std::vector<uint8_t> buffer2;
         
-        if (buffer1.size() != buffer2.size()) {
-            throw MemoryHookingException(MemoryHookingError::InvalidSize, "Buffer sizes don't match");
-        }
-        
-        for (size_t i = 0; i < buffer1.size(); ++i) {
-            if (buffer1[i] != buffer2[i]) {
-                differences.push_back(region1Start + i);
-                if (differences.size() >= MAX_RESULTS) break;
+        for (size_t offset = 0; offset < size; offset += windowSize) {
+            size_t readSize = std::min(windowSize, size - offset);
+            size_t read1 = ReadMemoryInto(processHandle, region1Start + offset, buffer1, readSize);
+            size_t read2 = ReadMemoryInto(processHandle, region2Start + offset, buffer2, readSize);
+            
+            if (read1 != read2) {
+                throw MemoryHookingException(MemoryHookingError::InvalidSize, "Buffer sizes don't match");
             }
+            
+            for (size_t i = 0; i < read1; ++i) {
+                if (buffer1[i] != buffer2[i]) {
+                    differences.push_back(region1Start + offset + i);
+                    if (differences.size() >= MAX_RESULTS) return differences;
+                }
+            }
+            
+            if (read1 < readSize) break;
         }
     }
     catch (const MemoryHookingException& e) {
@@ -795,30 +912,122 @@ size_t MemoryHelpers::GetAlignment(uintptr_t address) {
     return alignment >> 1;
 }
 
+bool MemoryHelpers::GetProcessIdentity(HANDLE processHandle, ProcessIdentity& identity) {
+    FILETIME creation, exit, kernel, user;
+    identity.processId = GetProcessId(processHandle);
+    if (identity.processId == 0 || !GetProcessTimes(processHandle, &creation, &exit, &kernel, &user)) {
+        return false;
+    }
+
+    identity.startTime = (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    return true;
+}
+
+namespace {
+
+struct SavedRegion {
+    uint64_t startAddress;
+    uint64_t endAddress;
+    uint32_t protection;
+    uint32_t type;
+    uint32_t nameLength;    // Module name bytes that follow
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SavedRegion) == 32, "Saved region layout changed");
+
+} // namespace
+
+void MemoryHelpers::SaveRegions(const std::vector<MemoryRegionEx>& regions, std::vector<uint8_t>& out) {
+    for (const MemoryRegionEx& region : regions) {
+        SavedRegion saved = {};
+        saved.startAddress = region.startAddress;
+        saved.endAddress = region.endAddress;
+        saved.protection = region.protection;
+        saved.type = region.type;
+        saved.nameLength = static_cast<uint32_t>(region.moduleName.size());
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&saved);
+        out.insert(out.end(), bytes, bytes + sizeof(saved));
+        out.insert(out.end(), region.moduleName.begin(), region.moduleName.end());
+    }
+}
+
+bool MemoryHelpers::LoadRegions(const uint8_t* data, size_t size, size_t& offset, uint64_t count,
+                                std::vector<MemoryRegionEx>& regions) {
+    for (uint64_t i = 0; i < count; ++i) {
+        SavedRegion saved;
+        if (offset > size || size - offset < sizeof(saved)) return false;
+        memcpy(&saved, data + offset, sizeof(saved));
+        offset += sizeof(saved);
+        if (size - offset < saved.nameLength || saved.endAddress < saved.startAddress) return false;
+
+        MemoryRegionEx region;
+        region.startAddress = static_cast<uintptr_t>(saved.startAddress);
+        region.endAddress = static_cast<uintptr_t>(saved.endAddress);
+        region.size = static_cast<size_t>(saved.endAddress - saved.startAddress);
+        region.protection = saved.protection;
+        region.type = saved.type;
+        region.moduleName.assign(reinterpret_cast<const char*>(data + offset), saved.nameLength);
+        offset += saved.nameLength;
+        regions.push_back(std::move(region));
+    }
+    return true;
+}
+
+size_t MemoryHelpers::SetScanMemoryBudget(size_t bytes) {
+    return RegionReader::SetMemoryBudget(bytes);
+}
+
+size_t MemoryHelpers::GetScanMemoryBudget() {
+    return RegionReader::MemoryBudget();
+}
+
 // Private helper methods
+std::vector<ScanRange> MemoryHelpers::CollectScanRanges(HANDLE processHandle, bool executableOnly,
+                                                        uintptr_t searchStart, uintptr_t searchEnd) {
+    std::vector<ScanRange> ranges;
+    auto regions = GetMemoryRegions(processHandle, executableOnly, false);
+    
+    for (const auto& region : regions) {
+        uintptr_t start = (searchStart > 0) ? std::max(searchStart, region.startAddress) : region.startAddress;
+        uintptr_t end = (searchEnd > 0) ? std::min(searchEnd, region.endAddress) : region.endAddress;
+        
+        if (start >= end) continue;
+        
+        ranges.push_back({start, end - start, 0});
+    }
+    
+    return ranges;
+}
+
+size_t MemoryHelpers::FirstAlignedOffset(const RegionChunk& chunk, size_t alignment) {
+    if (alignment <= 1) return 0;
+    size_t misalignment = chunk.address % alignment;
+    return misalignment ? alignment - misalignment : 0;
+}
+
 bool MemoryHelpers::IsAddressInRange(uintptr_t address, uintptr_t start, uintptr_t end) {
     return (start == 0 || address >= start) && (end == 0 || address < end);
 }
 
 std::vector<uint8_t> MemoryHelpers::ReadMemoryChunk(HANDLE processHandle, uintptr_t address, size_t size) {
-    std::vector<uint8_t> buffer(size);
-    SIZE_T bytesRead;
+    std::vector<uint8_t> buffer;
+    ReadMemoryInto(processHandle, address, buffer, size);
+    return buffer;
+}
+
+size_t MemoryHelpers::ReadMemoryInto(HANDLE processHandle, uintptr_t address, std::vector<uint8_t>& buffer, size_t size) {
+    // Reuses the caller's allocation; capacity only grows
+    buffer.resize(size);
+    SIZE_T bytesRead = 0;
     
     if (!ErrorHandler::safeReadMemory(processHandle, reinterpret_cast<LPCVOID>(address), 
                                            buffer.data(), size, &bytesRead)) {
-        return std::vector<uint8_t>(); // Return empty vector on failure
+        buffer.clear(); // Empty buffer on failure
+        return 0;
     }
     
     buffer.resize(bytesRead);
-    return buffer;
-}
-
-bool MemoryHelpers::MatchesPattern(const uint8_t* data, const std::vector<uint8_t>& pattern, 
-                                  const std::vector<bool>& mask) {
-    for (size_t i = 0; i < pattern.size(); ++i) {
-        if (mask[i] && data[i] != pattern[i]) {
-            return false;
-        }
-    }
-    return true;
-} 
\ No newline at end of file
+    return bytesRead;
+}
\ No newline at end of file
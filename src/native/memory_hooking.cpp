@@ -4,7 +4,233 @@
 #include "include/memory_scanner.h"
 #include "include/memory_helpers.h"
 #include "include/automation_helpers.h"
+#include "include/scan_executor.h"
+#include "include/signature.h"
+#include "include/string_searcher.h"
+#include "include/string_extractor.h"
+#include "include/scan_session.h"
+#include "include/value_scanner.h"
+#include "include/group_scanner.h"
+#include "include/pointer_map.h"
+#include "include/pointer_path.h"
+#include "include/pointer_path_set.h"
+#include "include/chain_resolver.h"
+#include "include/address_space.h"
+#include "include/xref_index.h"
 #include <memory>
+#include <thread>
+#include <algorithm>
+
+// Identifies externals created by compileSignature so foreign handles are rejected
+static const napi_type_tag SIGNATURE_TYPE_TAG = { 0x5f3c9a2e8d714b06ULL, 0xb4e1d7c2a9086f35ULL };
+
+static const Signature* UnwrapSignature(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<Signature> external = value.As<Napi::External<Signature>>();
+    if (!external.CheckTypeTag(&SIGNATURE_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+// Identifies externals created by createScanSession
+static const napi_type_tag SCAN_SESSION_TYPE_TAG = { 0x2b9d64f1c07a3e58ULL, 0x8e15a3c6f24d7b90ULL };
+
+static ScanSession* UnwrapScanSession(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<ScanSession> external = value.As<Napi::External<ScanSession>>();
+    if (!external.CheckTypeTag(&SCAN_SESSION_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+// Identifies externals created by buildPointerMap
+static const napi_type_tag POINTER_MAP_TYPE_TAG = { 0x71c4e9a25d38b06fULL, 0xa3f80d6b1e57c294ULL };
+
+static PointerMap* UnwrapPointerMap(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<PointerMap> external = value.As<Napi::External<PointerMap>>();
+    if (!external.CheckTypeTag(&POINTER_MAP_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+// Identifies externals created by createPointerPathSet and loadPointerPathSet
+static const napi_type_tag POINTER_PATH_SET_TYPE_TAG = { 0x5e0a7c93b1f6248dULL, 0xc82d15e49a07f3b6ULL };
+
+static PointerPathSet* UnwrapPointerPathSet(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<PointerPathSet> external = value.As<Napi::External<PointerPathSet>>();
+    if (!external.CheckTypeTag(&POINTER_PATH_SET_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+// Identifies externals created by compileChains
+static const napi_type_tag CHAIN_SET_TYPE_TAG = { 0x93d4a1e07c5b2f68ULL, 0x1f7e3c9a64b0d285ULL };
+
+static ChainSet* UnwrapChainSet(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<ChainSet> external = value.As<Napi::External<ChainSet>>();
+    if (!external.CheckTypeTag(&CHAIN_SET_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+// Identifies externals created by buildXrefIndex and loadXrefIndex
+static const napi_type_tag XREF_INDEX_TYPE_TAG = { 0xd61b3f08a94e27c5ULL, 0x4a8c07e25f1d93b6ULL };
+
+static XrefIndex* UnwrapXrefIndex(const Napi::Value& value) {
+    if (!value.IsExternal()) {
+        return nullptr;
+    }
+    
+    Napi::External<XrefIndex> external = value.As<Napi::External<XrefIndex>>();
+    if (!external.CheckTypeTag(&XREF_INDEX_TYPE_TAG)) {
+        return nullptr;
+    }
+    
+    return external.Data();
+}
+
+static const char* const XREF_KIND_NAMES[] = { "call", "jump", "branch", "data" };
+
+// File paths arrive from JS as UTF-8; the Win32 file APIs take UTF-16
+static std::wstring Utf8ToWide(const std::string& text) {
+    if (text.empty()) {
+        return std::wstring();
+    }
+    
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &wide[0], length);
+    return wide;
+}
+
+// Reads an array of encoding names into StringEncoding flags; throws a JS
+// TypeError and returns false on an unknown name
+static bool ParseEncodingList(Napi::Env env, const Napi::Array& names, uint32_t& encodings) {
+    encodings = 0;
+    for (uint32_t i = 0; i < names.Length(); ++i) {
+        StringEncoding encoding;
+        std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+        if (!ParseStringEncoding(name, encoding)) {
+            Napi::TypeError::New(env, "Unknown string encoding: " + name).ThrowAsJavaScriptException();
+            return false;
+        }
+        encodings |= static_cast<uint32_t>(encoding);
+    }
+    return true;
+}
+
+// Set on the JS thread while extractStrings delivers batches. Its scan holds
+// the scan executor on another thread and waits for batches to be taken, so
+// a scan started from the callback would wait on it forever.
+static thread_local bool t_deliveringStrings = false;
+
+// Throws and returns true when called from inside an extractStrings callback
+static bool RejectInsideStringBatch(Napi::Env env) {
+    if (!t_deliveringStrings) return false;
+    Napi::Error::New(env, "Cannot scan or change the process from an extractStrings callback")
+        .ThrowAsJavaScriptException();
+    return true;
+}
+
+static Napi::Object StringExtractionStatsToObject(Napi::Env env, const StringExtractionStats& stats) {
+    Napi::Object statsObj = Napi::Object::New(env);
+    statsObj.Set("strings", Napi::Number::New(env, static_cast<double>(stats.strings)));
+    statsObj.Set("regions", Napi::Number::New(env, static_cast<double>(stats.ranges)));
+    statsObj.Set("bytesScanned", Napi::Number::New(env, static_cast<double>(stats.bytesScanned)));
+    statsObj.Set("stopped", Napi::Boolean::New(env, stats.stopped));
+    return statsObj;
+}
+
+// Reads a number or bigint operand. Integer types take the integer exactly
+// when it is a bigint; uint64 operands keep their bits in intValue.
+static void ReadValueOperand(const Napi::Value& operand, ScanValueType type, double& value, int64_t& intValue) {
+    value = 0;
+    intValue = 0;
+    
+    if (operand.IsBigInt()) {
+        bool lossless;
+        if (type == ScanValueType::UInt64) {
+            intValue = static_cast<int64_t>(operand.As<Napi::BigInt>().Uint64Value(&lossless));
+        } else {
+            intValue = operand.As<Napi::BigInt>().Int64Value(&lossless);
+        }
+        value = type == ScanValueType::UInt64 ? static_cast<double>(static_cast<uint64_t>(intValue))
+                                              : static_cast<double>(intValue);
+        return;
+    }
+    if (!operand.IsNumber()) return;
+    
+    value = operand.As<Napi::Number>().DoubleValue();
+    if (type == ScanValueType::UInt64 && value >= 9223372036854775808.0) {
+        intValue = value >= 18446744073709551615.0 ? -1 : static_cast<int64_t>(static_cast<uint64_t>(value));
+    } else {
+        intValue = operand.As<Napi::Number>().Int64Value();
+    }
+}
+
+// Reads { type, op = "equal", value, value2, tolerance, decimals, ulps,
+// aligned = true }; throws and returns false when the query is invalid
+static bool ReadValueQuery(Napi::Env env, const Napi::Object& options, ValueQuery& query) {
+    std::string typeName = options.Has("type") ? options.Get("type").ToString().Utf8Value() : "";
+    if (!ParseScanValueType(typeName, query.type)) {
+        Napi::TypeError::New(env, "Unknown value type: " + typeName).ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    std::string opName = "equal";
+    if (options.Has("op") && options.Get("op").IsString()) {
+        opName = options.Get("op").As<Napi::String>().Utf8Value();
+    }
+    if (!ParseValueOp(opName, query.op)) {
+        Napi::TypeError::New(env, "Unknown value op: " + opName).ThrowAsJavaScriptException();
+        return false;
+    }
+    bool floatType = query.type == ScanValueType::Float || query.type == ScanValueType::Double;
+    if (!floatType && (query.op == ValueOp::Rounded || query.op == ValueOp::Ulps || query.op == ValueOp::Truncated)) {
+        Napi::TypeError::New(env, "Value op " + opName + " needs a float or double type").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    ReadValueOperand(options.Get("value"), query.type, query.value, query.intValue);
+    ReadValueOperand(options.Get("value2"), query.type, query.value2, query.intValue2);
+    Napi::Value tolerance = options.Get("tolerance");
+    query.tolerance = tolerance.IsNumber() ? tolerance.As<Napi::Number>().DoubleValue() : 0;
+    Napi::Value decimals = options.Get("decimals");
+    query.decimals = decimals.IsNumber() ? decimals.As<Napi::Number>().Uint32Value() : 0;
+    Napi::Value ulps = options.Get("ulps");
+    query.ulps = ulps.IsNumber() ? ulps.As<Napi::Number>().Uint32Value() : 0;
+    Napi::Value aligned = options.Get("aligned");
+    query.aligned = aligned.IsBoolean() ? aligned.As<Napi::Boolean>().Value() : true;
+    return true;
+}
 
 class MemoryHookingAddon : public Napi::ObjectWrap<MemoryHookingAddon> {
 public:
@@ -45,16 +271,64 @@ private:
     Napi::Value FindPointerChain(const Napi::CallbackInfo& info);
     Napi::Value FindNullPointers(const Napi::CallbackInfo& info);
     
+    // Memory Helpers - Pointer Maps
+    Napi::Value BuildPointerMap(const Napi::CallbackInfo& info);
+    Napi::Value PointerMapFind(const Napi::CallbackInfo& info);
+    Napi::Value PointerMapStats(const Napi::CallbackInfo& info);
+    Napi::Value SavePointerMap(const Napi::CallbackInfo& info);
+    Napi::Value LoadPointerMap(const Napi::CallbackInfo& info);
+    Napi::Value ScanPointerPaths(const Napi::CallbackInfo& info);
+    
+    // Memory Helpers - Pointer Path Sets
+    Napi::Value CreatePointerPathSet(const Napi::CallbackInfo& info);
+    Napi::Value PointerPathSetPaths(const Napi::CallbackInfo& info);
+    Napi::Value PointerPathSetCount(const Napi::CallbackInfo& info);
+    Napi::Value ValidatePointerPathSet(const Napi::CallbackInfo& info);
+    Napi::Value IntersectPointerPathSets(const Napi::CallbackInfo& info);
+    Napi::Value SavePointerPathSet(const Napi::CallbackInfo& info);
+    Napi::Value LoadPointerPathSet(const Napi::CallbackInfo& info);
+    
+    // Memory Helpers - Pointer Chains
+    Napi::Value CompileChains(const Napi::CallbackInfo& info);
+    Napi::Value ResolveChains(const Napi::CallbackInfo& info);
+    Napi::Value ChainSetStats(const Napi::CallbackInfo& info);
+    
+    // Memory Helpers - Address Space
+    Napi::Value GetModuleSections(const Napi::CallbackInfo& info);
+    Napi::Value LocateAddresses(const Napi::CallbackInfo& info);
+    
+    // Memory Helpers - Cross References
+    Napi::Value BuildXrefIndex(const Napi::CallbackInfo& info);
+    Napi::Value XrefIndexFind(const Napi::CallbackInfo& info);
+    Napi::Value XrefIndexStats(const Napi::CallbackInfo& info);
+    Napi::Value SaveXrefIndex(const Napi::CallbackInfo& info);
+    Napi::Value LoadXrefIndex(const Napi::CallbackInfo& info);
+    
     // Memory Helpers - Pattern Searching
     Napi::Value SearchBytePattern(const Napi::CallbackInfo& info);
+    Napi::Value SearchMultiplePatterns(const Napi::CallbackInfo& info);
+    Napi::Value CompileSignature(const Napi::CallbackInfo& info);
+    Napi::Value SearchSignature(const Napi::CallbackInfo& info);
     Napi::Value SearchStringPattern(const Napi::CallbackInfo& info);
+    Napi::Value SearchString(const Napi::CallbackInfo& info);
     Napi::Value SearchRegexPattern(const Napi::CallbackInfo& info);
+    Napi::Value ExtractStrings(const Napi::CallbackInfo& info);
+    Napi::Value ExtractStringsToFile(const Napi::CallbackInfo& info);
     
     // Memory Helpers - Numeric Searching
-    Napi::Value SearchInt32(const Napi::CallbackInfo& info);
-    Napi::Value SearchInt64(const Napi::CallbackInfo& info);
-    Napi::Value SearchFloat(const Napi::CallbackInfo& info);
-    Napi::Value SearchDouble(const Napi::CallbackInfo& info);
+    Napi::Value SearchValue(const Napi::CallbackInfo& info);
+    Napi::Value SearchGroup(const Napi::CallbackInfo& info);
+    
+    // Memory Helpers - Scan Sessions
+    Napi::Value CreateScanSession(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionFirst(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionNext(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionCount(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionResults(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionStats(const Napi::CallbackInfo& info);
+    Napi::Value SaveScanSession(const Napi::CallbackInfo& info);
+    Napi::Value LoadScanSession(const Napi::CallbackInfo& info);
+    Napi::Value ScanSessionFilter(const Napi::CallbackInfo& info, bool first);
     
     // Memory Helpers - Region Analysis
     Napi::Value GetMemoryRegionsEx(const Napi::CallbackInfo& info);
@@ -76,6 +350,10 @@ private:
     Napi::Value FormatAddress(const Napi::CallbackInfo& info);
     Napi::Value IsValidCodeAddress(const Napi::CallbackInfo& info);
     Napi::Value GetAlignment(const Napi::CallbackInfo& info);
+    Napi::Value SetScanMemoryBudget(const Napi::CallbackInfo& info);
+    Napi::Value GetScanMemoryBudget(const Napi::CallbackInfo& info);
+    Napi::Value SetScanParallelism(const Napi::CallbackInfo& info);
+    Napi::Value GetScanParallelism(const Napi::CallbackInfo& info);
     
     // Automation Helpers - Mouse Control
     Napi::Value MoveMouse(const Napi::CallbackInfo& info);
@@ -168,16 +446,63 @@ Napi::Object MemoryHookingAddon::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("findPointerChain", &MemoryHookingAddon::FindPointerChain),
         InstanceMethod("findNullPointers", &MemoryHookingAddon::FindNullPointers),
         
+        // Memory Helpers - Pointer Maps
+        InstanceMethod("buildPointerMap", &MemoryHookingAddon::BuildPointerMap),
+        InstanceMethod("pointerMapFind", &MemoryHookingAddon::PointerMapFind),
+        InstanceMethod("pointerMapStats", &MemoryHookingAddon::PointerMapStats),
+        InstanceMethod("savePointerMap", &MemoryHookingAddon::SavePointerMap),
+        InstanceMethod("loadPointerMap", &MemoryHookingAddon::LoadPointerMap),
+        InstanceMethod("scanPointerPaths", &MemoryHookingAddon::ScanPointerPaths),
+        
+        // Memory Helpers - Pointer Path Sets
+        InstanceMethod("createPointerPathSet", &MemoryHookingAddon::CreatePointerPathSet),
+        InstanceMethod("pointerPathSetPaths", &MemoryHookingAddon::PointerPathSetPaths),
+        InstanceMethod("pointerPathSetCount", &MemoryHookingAddon::PointerPathSetCount),
+        InstanceMethod("validatePointerPathSet", &MemoryHookingAddon::ValidatePointerPathSet),
+        InstanceMethod("intersectPointerPathSets", &MemoryHookingAddon::IntersectPointerPathSets),
+        InstanceMethod("savePointerPathSet", &MemoryHookingAddon::SavePointerPathSet),
+        InstanceMethod("loadPointerPathSet", &MemoryHookingAddon::LoadPointerPathSet),
+        
+        // Memory Helpers - Pointer Chains
+        InstanceMethod("compileChains", &MemoryHookingAddon::CompileChains),
+        InstanceMethod("resolveChains", &MemoryHookingAddon::ResolveChains),
+        InstanceMethod("chainSetStats", &MemoryHookingAddon::ChainSetStats),
+        
+        // Memory Helpers - Address Space
+        InstanceMethod("getModuleSections", &MemoryHookingAddon::GetModuleSections),
+        InstanceMethod("locateAddresses", &MemoryHookingAddon::LocateAddresses),
+        
+        // Memory Helpers - Cross References
+        InstanceMethod("buildXrefIndex", &MemoryHookingAddon::BuildXrefIndex),
+        InstanceMethod("xrefIndexFind", &MemoryHookingAddon::XrefIndexFind),
+        InstanceMethod("xrefIndexStats", &MemoryHookingAddon::XrefIndexStats),
+        InstanceMethod("saveXrefIndex", &MemoryHookingAddon::SaveXrefIndex),
+        InstanceMethod("loadXrefIndex", &MemoryHookingAddon::LoadXrefIndex),
+        
         // Memory Helpers - Pattern Searching
         InstanceMethod("searchBytePattern", &MemoryHookingAddon::SearchBytePattern),
+        InstanceMethod("searchMultiplePatterns", &MemoryHookingAddon::SearchMultiplePatterns),
+        InstanceMethod("compileSignature", &MemoryHookingAddon::CompileSignature),
+        InstanceMethod("searchSignature", &MemoryHookingAddon::SearchSignature),
         InstanceMethod("searchStringPattern", &MemoryHookingAddon::SearchStringPattern),
+        InstanceMethod("searchString", &MemoryHookingAddon::SearchString),
         InstanceMethod("searchRegexPattern", &MemoryHookingAddon::SearchRegexPattern),
+        InstanceMethod("extractStrings", &MemoryHookingAddon::ExtractStrings),
+        InstanceMethod("extractStringsToFile", &MemoryHookingAddon::ExtractStringsToFile),
         
         // Memory Helpers - Numeric Searching
-        InstanceMethod("searchInt32", &MemoryHookingAddon::SearchInt32),
-        InstanceMethod("searchInt64", &MemoryHookingAddon::SearchInt64),
-        InstanceMethod("searchFloat", &MemoryHookingAddon::SearchFloat),
-        InstanceMethod("searchDouble", &MemoryHookingAddon::SearchDouble),
+        InstanceMethod("searchValue", &MemoryHookingAddon::SearchValue),
+        InstanceMethod("searchGroup", &MemoryHookingAddon::SearchGroup),
+        
+        // Memory Helpers - Scan Sessions
+        InstanceMethod("createScanSession", &MemoryHookingAddon::CreateScanSession),
+        InstanceMethod("scanSessionFirst", &MemoryHookingAddon::ScanSessionFirst),
+        InstanceMethod("scanSessionNext", &MemoryHookingAddon::ScanSessionNext),
+        InstanceMethod("scanSessionCount", &MemoryHookingAddon::ScanSessionCount),
+        InstanceMethod("scanSessionResults", &MemoryHookingAddon::ScanSessionResults),
+        InstanceMethod("scanSessionStats", &MemoryHookingAddon::ScanSessionStats),
+        InstanceMethod("saveScanSession", &MemoryHookingAddon::SaveScanSession),
+        InstanceMethod("loadScanSession", &MemoryHookingAddon::LoadScanSession),
         
         // Memory Helpers - Region Analysis
         InstanceMethod("getMemoryRegionsEx", &MemoryHookingAddon::GetMemoryRegionsEx),
@@ -199,6 +524,10 @@ Napi::Object MemoryHookingAddon::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("formatAddress", &MemoryHookingAddon::FormatAddress),
         InstanceMethod("isValidCodeAddress", &MemoryHookingAddon::IsValidCodeAddress),
         InstanceMethod("getAlignment", &MemoryHookingAddon::GetAlignment),
+        InstanceMethod("setScanMemoryBudget", &MemoryHookingAddon::SetScanMemoryBudget),
+        InstanceMethod("getScanMemoryBudget", &MemoryHookingAddon::GetScanMemoryBudget),
+        InstanceMethod("setScanParallelism", &MemoryHookingAddon::SetScanParallelism),
+        InstanceMethod("getScanParallelism", &MemoryHookingAddon::GetScanParallelism),
         
         // Automation Helpers - Mouse Control
         InstanceMethod("moveMouse", &MemoryHookingAddon::MoveMouse),
@@ -293,6 +622,7 @@ Napi::Value MemoryHookingAddon::GetRunningProcesses(const Napi::CallbackInfo& in
 
 Napi::Value MemoryHookingAddon::AttachToProcess(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1) {
         Napi::TypeError::New(env, "Expected process ID or name").ThrowAsJavaScriptException();
@@ -314,6 +644,7 @@ Napi::Value MemoryHookingAddon::AttachToProcess(const Napi::CallbackInfo& info)
 
 Napi::Value MemoryHookingAddon::DetachFromProcess(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     m_processManager->detachFromProcess();
     return env.Undefined();
@@ -404,6 +735,7 @@ Napi::Value MemoryHookingAddon::GetModuleInfo(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::ScanForPattern(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 2) {
         Napi::TypeError::New(env, "Expected pattern and mask").ThrowAsJavaScriptException();
@@ -425,6 +757,7 @@ Napi::Value MemoryHookingAddon::ScanForPattern(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::ScanForString(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1) {
         Napi::TypeError::New(env, "Expected string to search").ThrowAsJavaScriptException();
@@ -446,6 +779,7 @@ Napi::Value MemoryHookingAddon::ScanForString(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::ScanForValue(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1) {
         Napi::TypeError::New(env, "Expected value to search").ThrowAsJavaScriptException();
@@ -476,6 +810,7 @@ Napi::Value MemoryHookingAddon::ScanForValue(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::ScanForBytes(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1) {
         Napi::TypeError::New(env, "Expected bytes array").ThrowAsJavaScriptException();
@@ -573,6 +908,7 @@ Napi::Value MemoryHookingAddon::HexStringToBytes(const Napi::CallbackInfo& info)
 // Memory Helpers - Pointer Operations
 Napi::Value MemoryHookingAddon::FindPointersTo(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Expected target address and attached process").ThrowAsJavaScriptException();
@@ -599,6 +935,7 @@ Napi::Value MemoryHookingAddon::FindPointersTo(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::FindPointerChain(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Expected final address and attached process").ThrowAsJavaScriptException();
@@ -632,6 +969,7 @@ Napi::Value MemoryHookingAddon::FindPointerChain(const Napi::CallbackInfo& info)
 
 Napi::Value MemoryHookingAddon::FindNullPointers(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 2 || !m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Expected search start, search end, and attached process").ThrowAsJavaScriptException();
@@ -651,256 +989,1397 @@ Napi::Value MemoryHookingAddon::FindNullPointers(const Napi::CallbackInfo& info)
     return resultArray;
 }
 
-// Memory Helpers - Pattern Searching
-Napi::Value MemoryHookingAddon::SearchBytePattern(const Napi::CallbackInfo& info) {
+// Memory Helpers - Pointer Maps
+// Arguments: searchStart, searchEnd, writableOnly, moduleImagesOnly. Reads the
+// whole target once; lookups on the returned handle never read it again.
+Napi::Value MemoryHookingAddon::BuildPointerMap(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
-    if (info.Length() < 2 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected pattern array, mask array, and attached process").ThrowAsJavaScriptException();
+    if (!m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Process not attached").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    // Parse pattern
-    Napi::Array patternArray = info[0].As<Napi::Array>();
-    std::vector<uint8_t> pattern;
-    for (uint32_t i = 0; i < patternArray.Length(); ++i) {
-        pattern.push_back(static_cast<uint8_t>(patternArray.Get(i).As<Napi::Number>().Uint32Value()));
+    PointerMapOptions options;
+    options.searchStart = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Int64Value() : 0;
+    options.searchEnd = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
+    options.writableOnly = info.Length() > 2 ? info[2].As<Napi::Boolean>().Value() : true;
+    options.moduleImagesOnly = info.Length() > 3 ? info[3].As<Napi::Boolean>().Value() : false;
+    
+    std::unique_ptr<PointerMap> map = PointerMap::Build(m_processManager->getProcessHandle(), options);
+    
+    // The handle owns the index; it is freed when JS collects the handle
+    Napi::External<PointerMap> handle = Napi::External<PointerMap>::New(env, map.release(),
+        [](Napi::Env, PointerMap* data) { delete data; });
+    handle.TypeTag(&POINTER_MAP_TYPE_TAG);
+    
+    return handle;
+}
+
+// Arguments: map, target address, maxResults. Same result shape as findPointersTo.
+Napi::Value MemoryHookingAddon::PointerMapFind(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Expected pointer map and target address").ThrowAsJavaScriptException();
+        return env.Null();
     }
     
-    // Parse mask
-    Napi::Array maskArray = info[1].As<Napi::Array>();
-    std::vector<bool> mask;
-    for (uint32_t i = 0; i < maskArray.Length(); ++i) {
-        mask.push_back(maskArray.Get(i).As<Napi::Boolean>().Value());
+    PointerMap* map = UnwrapPointerMap(info[0]);
+    if (!map) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildPointerMap").ThrowAsJavaScriptException();
+        return env.Null();
     }
     
-    uintptr_t searchStart = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t targetAddress = info[1].As<Napi::Number>().Int64Value();
+    size_t maxResults = 10000;
+    if (info.Length() > 2 && info[2].IsNumber()) {
+        maxResults = static_cast<size_t>(std::max<int64_t>(info[2].As<Napi::Number>().Int64Value(), 0));
+    }
     
-    auto results = MemoryHelpers::SearchBytePattern(m_processManager->getProcessHandle(), pattern, mask, searchStart, searchEnd);
+    std::vector<uintptr_t> addresses;
+    map->Find(targetAddress, addresses, maxResults);
     
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("size", Napi::Number::New(env, results[i].size));
-        
-        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
-        for (size_t j = 0; j < results[i].data.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
-        }
-        matchObj.Set("data", dataArray);
-        
-        resultArray[i] = matchObj;
+    Napi::Array resultArray = Napi::Array::New(env, addresses.size());
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        Napi::Object pointerObj = Napi::Object::New(env);
+        pointerObj.Set("address", Napi::Number::New(env, static_cast<double>(addresses[i])));
+        pointerObj.Set("pointsTo", Napi::Number::New(env, static_cast<double>(targetAddress)));
+        pointerObj.Set("offset", Napi::Number::New(env, 0));
+        resultArray[i] = pointerObj;
     }
     
     return resultArray;
 }
 
-Napi::Value MemoryHookingAddon::SearchStringPattern(const Napi::CallbackInfo& info) {
+Napi::Value MemoryHookingAddon::PointerMapStats(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected search string and attached process").ThrowAsJavaScriptException();
+    PointerMap* map = info.Length() > 0 ? UnwrapPointerMap(info[0]) : nullptr;
+    if (!map) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildPointerMap").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string pattern = info[0].As<Napi::String>().Utf8Value();
-    bool caseSensitive = info.Length() > 1 ? info[1].As<Napi::Boolean>().Value() : true;
-    bool unicode = info.Length() > 2 ? info[2].As<Napi::Boolean>().Value() : false;
-    uintptr_t searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
-    
-    auto results = MemoryHelpers::SearchStringPattern(m_processManager->getProcessHandle(), pattern, caseSensitive, unicode, searchStart, searchEnd);
-    
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("size", Napi::Number::New(env, results[i].size));
-        
-        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
-        for (size_t j = 0; j < results[i].data.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
-        }
-        matchObj.Set("data", dataArray);
-        
-        resultArray[i] = matchObj;
-    }
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("pointers", Napi::Number::New(env, static_cast<double>(map->Size())));
+    stats.Set("regions", Napi::Number::New(env, static_cast<double>(map->Regions().size())));
+    stats.Set("memoryBytes", Napi::Number::New(env, static_cast<double>(map->MemoryUsage())));
     
-    return resultArray;
+    return stats;
 }
 
-Napi::Value MemoryHookingAddon::SearchRegexPattern(const Napi::CallbackInfo& info) {
+Napi::Value MemoryHookingAddon::SavePointerMap(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected regex pattern and attached process").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected pointer map and file path").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string regexPattern = info[0].As<Napi::String>().Utf8Value();
-    uintptr_t searchStart = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    
-    auto results = MemoryHelpers::SearchRegexPattern(m_processManager->getProcessHandle(), regexPattern, searchStart, searchEnd);
+    PointerMap* map = UnwrapPointerMap(info[0]);
+    if (!map) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildPointerMap").ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("size", Napi::Number::New(env, results[i].size));
-        
-        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
-        for (size_t j = 0; j < results[i].data.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
-        }
-        matchObj.Set("data", dataArray);
-        
-        resultArray[i] = matchObj;
+    std::string error;
+    if (!map->Save(Utf8ToWide(info[1].As<Napi::String>().Utf8Value()), error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
     }
     
-    return resultArray;
+    return Napi::Boolean::New(env, true);
 }
 
-// Memory Helpers - Numeric Searching
-Napi::Value MemoryHookingAddon::SearchInt32(const Napi::CallbackInfo& info) {
+// Arguments: path. The map must have been saved from the attached process
+// instance; its entries are read from the mapped file as they are used.
+Napi::Value MemoryHookingAddon::LoadPointerMap(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected int32 value and attached process").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsString() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected file path and attached process").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    int32_t value = info[0].As<Napi::Number>().Int32Value();
-    uintptr_t searchStart = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    bool aligned = info.Length() > 3 ? info[3].As<Napi::Boolean>().Value() : false;
-    
-    auto results = MemoryHelpers::SearchInt32(m_processManager->getProcessHandle(), value, searchStart, searchEnd, aligned);
-    
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("dataType", Napi::String::New(env, results[i].dataType));
-        
-        Napi::Array dataArray = Napi::Array::New(env, results[i].rawData.size());
-        for (size_t j = 0; j < results[i].rawData.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].rawData[j]);
-        }
-        matchObj.Set("rawData", dataArray);
-        
-        resultArray[i] = matchObj;
+    std::string error;
+    std::unique_ptr<PointerMap> map = PointerMap::Load(m_processManager->getProcessHandle(),
+        Utf8ToWide(info[0].As<Napi::String>().Utf8Value()), error);
+    if (!map) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
     }
     
-    return resultArray;
+    Napi::External<PointerMap> handle = Napi::External<PointerMap>::New(env, map.release(),
+        [](Napi::Env, PointerMap* data) { delete data; });
+    handle.TypeTag(&POINTER_MAP_TYPE_TAG);
+    
+    return handle;
 }
 
-Napi::Value MemoryHookingAddon::SearchInt64(const Napi::CallbackInfo& info) {
+// Arguments: map, target address, maxDepth, maxOffset, maxPaths. Paths start
+// at static bases in the attached process's modules and are found with map
+// lookups only.
+Napi::Value MemoryHookingAddon::ScanPointerPaths(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected int64 value and attached process").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[1].IsNumber() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected pointer map, target address and attached process").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    int64_t value = info[0].As<Napi::Number>().Int64Value();
-    uintptr_t searchStart = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    bool aligned = info.Length() > 3 ? info[3].As<Napi::Boolean>().Value() : false;
+    PointerMap* map = UnwrapPointerMap(info[0]);
+    if (!map) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildPointerMap").ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
-    auto results = MemoryHelpers::SearchInt64(m_processManager->getProcessHandle(), value, searchStart, searchEnd, aligned);
+    uintptr_t target = info[1].As<Napi::Number>().Int64Value();
+    PointerPathOptions options;
+    options.maxDepth = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value() : 5;
+    options.maxOffset = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 0x1000;
+    options.maxPaths = 10000;
+    if (info.Length() > 4 && info[4].IsNumber()) {
+        options.maxPaths = static_cast<size_t>(std::max<int64_t>(info[4].As<Napi::Number>().Int64Value(), 0));
+    }
     
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("dataType", Napi::String::New(env, results[i].dataType));
+    PointerPathScanner scanner(*map, MemoryHelpers::GetModuleImages(m_processManager->getProcessHandle()));
+    PointerPathResult result = scanner.Scan(target, options);
+    
+    Napi::Array pathArray = Napi::Array::New(env, result.paths.size());
+    for (size_t i = 0; i < result.paths.size(); ++i) {
+        const PointerPath& path = result.paths[i];
+        const ModuleImage& module = result.modules[path.module];
         
-        Napi::Array dataArray = Napi::Array::New(env, results[i].rawData.size());
-        for (size_t j = 0; j < results[i].rawData.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].rawData[j]);
+        Napi::Object pathObj = Napi::Object::New(env);
+        pathObj.Set("base", Napi::Number::New(env, static_cast<double>(path.base)));
+        pathObj.Set("module", Napi::String::New(env, module.name));
+        pathObj.Set("moduleOffset", Napi::Number::New(env, static_cast<double>(path.base - module.base)));
+        
+        Napi::Array offsetArray = Napi::Array::New(env, path.offsets.size());
+        for (size_t j = 0; j < path.offsets.size(); ++j) {
+            offsetArray[j] = Napi::Number::New(env, static_cast<double>(path.offsets[j]));
         }
-        matchObj.Set("rawData", dataArray);
+        pathObj.Set("offsets", offsetArray);
         
-        resultArray[i] = matchObj;
+        pathArray[i] = pathObj;
     }
     
-    return resultArray;
+    Napi::Object resultObj = Napi::Object::New(env);
+    resultObj.Set("paths", pathArray);
+    resultObj.Set("nodes", Napi::Number::New(env, static_cast<double>(result.nodes)));
+    resultObj.Set("truncated", Napi::Boolean::New(env, result.truncated));
+    
+    return resultObj;
 }
 
-Napi::Value MemoryHookingAddon::SearchFloat(const Napi::CallbackInfo& info) {
+// Memory Helpers - Pointer Path Sets
+// Argument: array of {module, moduleOffset, offsets}, as returned by
+// scanPointerPaths
+Napi::Value MemoryHookingAddon::CreatePointerPathSet(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected float value and attached process").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Expected array of pointer paths").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    float value = info[0].As<Napi::Number>().FloatValue();
-    float tolerance = info.Length() > 1 ? info[1].As<Napi::Number>().FloatValue() : 0.001f;
-    uintptr_t searchStart = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
-    
-    auto results = MemoryHelpers::SearchFloat(m_processManager->getProcessHandle(), value, tolerance, searchStart, searchEnd);
-    
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("dataType", Napi::String::New(env, results[i].dataType));
-        
-        Napi::Array dataArray = Napi::Array::New(env, results[i].rawData.size());
-        for (size_t j = 0; j < results[i].rawData.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].rawData[j]);
+    std::unique_ptr<PointerPathSet> set(new PointerPathSet());
+    Napi::Array pathArray = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < pathArray.Length(); ++i) {
+        Napi::Object pathObj = pathArray.Get(i).As<Napi::Object>();
+        std::vector<size_t> offsets;
+        Napi::Array offsetArray = pathObj.Get("offsets").As<Napi::Array>();
+        for (uint32_t j = 0; j < offsetArray.Length(); ++j) {
+            offsets.push_back(static_cast<size_t>(offsetArray.Get(j).As<Napi::Number>().Int64Value()));
         }
-        matchObj.Set("rawData", dataArray);
         
-        resultArray[i] = matchObj;
+        if (!set->Add(pathObj.Get("module").As<Napi::String>().Utf8Value(),
+                      static_cast<uintptr_t>(pathObj.Get("moduleOffset").As<Napi::Number>().Int64Value()), offsets)) {
+            Napi::TypeError::New(env, "Pointer path without offsets").ThrowAsJavaScriptException();
+            return env.Null();
+        }
     }
     
-    return resultArray;
+    // The handle owns the paths; they are freed when JS collects the handle
+    Napi::External<PointerPathSet> handle = Napi::External<PointerPathSet>::New(env, set.release(),
+        [](Napi::Env, PointerPathSet* data) { delete data; });
+    handle.TypeTag(&POINTER_PATH_SET_TYPE_TAG);
+    
+    return handle;
 }
 
-Napi::Value MemoryHookingAddon::SearchDouble(const Napi::CallbackInfo& info) {
+Napi::Value MemoryHookingAddon::PointerPathSetPaths(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
-        Napi::TypeError::New(env, "Expected double value and attached process").ThrowAsJavaScriptException();
+    PointerPathSet* set = info.Length() > 0 ? UnwrapPointerPathSet(info[0]) : nullptr;
+    if (!set) {
+        Napi::TypeError::New(env, "Expected a handle returned by createPointerPathSet").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    double value = info[0].As<Napi::Number>().DoubleValue();
-    double tolerance = info.Length() > 1 ? info[1].As<Napi::Number>().DoubleValue() : 0.001;
-    uintptr_t searchStart = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
-    uintptr_t searchEnd = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
-    
-    auto results = MemoryHelpers::SearchDouble(m_processManager->getProcessHandle(), value, tolerance, searchStart, searchEnd);
+    size_t maxResults = 10000;
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        maxResults = static_cast<size_t>(std::max<int64_t>(info[1].As<Napi::Number>().Int64Value(), 0));
+    }
     
-    Napi::Array resultArray = Napi::Array::New(env, results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-        Napi::Object matchObj = Napi::Object::New(env);
-        matchObj.Set("address", Napi::Number::New(env, results[i].address));
-        matchObj.Set("dataType", Napi::String::New(env, results[i].dataType));
+    size_t count = std::min(set->Size(), maxResults);
+    Napi::Array pathArray = Napi::Array::New(env, count);
+    for (size_t i = 0; i < count; ++i) {
+        const StoredPath& path = set->Paths()[i];
         
-        Napi::Array dataArray = Napi::Array::New(env, results[i].rawData.size());
-        for (size_t j = 0; j < results[i].rawData.size(); ++j) {
-            dataArray[j] = Napi::Number::New(env, results[i].rawData[j]);
+        Napi::Object pathObj = Napi::Object::New(env);
+        pathObj.Set("module", Napi::String::New(env, set->Modules()[path.module]));
+        pathObj.Set("moduleOffset", Napi::Number::New(env, static_cast<double>(path.moduleOffset)));
+        
+        Napi::Array offsetArray = Napi::Array::New(env, path.offsets.size());
+        for (size_t j = 0; j < path.offsets.size(); ++j) {
+            offsetArray[j] = Napi::Number::New(env, static_cast<double>(path.offsets[j]));
         }
-        matchObj.Set("rawData", dataArray);
+        pathObj.Set("offsets", offsetArray);
         
-        resultArray[i] = matchObj;
+        pathArray[i] = pathObj;
     }
     
-    return resultArray;
+    return pathArray;
 }
 
-// Memory Helpers - Region Analysis
-Napi::Value MemoryHookingAddon::GetMemoryRegionsEx(const Napi::CallbackInfo& info) {
+Napi::Value MemoryHookingAddon::PointerPathSetCount(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!m_processManager->isProcessAttached()) {
+    PointerPathSet* set = info.Length() > 0 ? UnwrapPointerPathSet(info[0]) : nullptr;
+    if (!set) {
+        Napi::TypeError::New(env, "Expected a handle returned by createPointerPathSet").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, static_cast<double>(set->Size()));
+}
+
+// Arguments: set, target address. Keeps the paths that lead to the target in
+// the attached process; returns how many remain.
+Napi::Value MemoryHookingAddon::ValidatePointerPathSet(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsNumber() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected pointer path set, target address and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    PointerPathSet* set = UnwrapPointerPathSet(info[0]);
+    if (!set) {
+        Napi::TypeError::New(env, "Expected a handle returned by createPointerPathSet").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    HANDLE processHandle = m_processManager->getProcessHandle();
+    uintptr_t target = info[1].As<Napi::Number>().Int64Value();
+    size_t remaining = set->Validate(processHandle, MemoryHelpers::GetModuleImages(processHandle), target);
+    
+    return Napi::Number::New(env, static_cast<double>(remaining));
+}
+
+// Arguments: set, other. Keeps the paths of set that other holds too.
+Napi::Value MemoryHookingAddon::IntersectPointerPathSets(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    PointerPathSet* set = info.Length() > 1 ? UnwrapPointerPathSet(info[0]) : nullptr;
+    PointerPathSet* other = info.Length() > 1 ? UnwrapPointerPathSet(info[1]) : nullptr;
+    if (!set || !other) {
+        Napi::TypeError::New(env, "Expected two handles returned by createPointerPathSet").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, static_cast<double>(set->Intersect(*other)));
+}
+
+Napi::Value MemoryHookingAddon::SavePointerPathSet(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected pointer path set and file path").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    PointerPathSet* set = UnwrapPointerPathSet(info[0]);
+    if (!set) {
+        Napi::TypeError::New(env, "Expected a handle returned by createPointerPathSet").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    if (!set->Save(Utf8ToWide(info[1].As<Napi::String>().Utf8Value()), error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Argument: path. Unlike sessions and maps, a path set is not tied to the
+// process instance it was found in.
+Napi::Value MemoryHookingAddon::LoadPointerPathSet(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected file path").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    std::unique_ptr<PointerPathSet> set = PointerPathSet::Load(Utf8ToWide(info[0].As<Napi::String>().Utf8Value()), error);
+    if (!set) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::External<PointerPathSet> handle = Napi::External<PointerPathSet>::New(env, set.release(),
+        [](Napi::Env, PointerPathSet* data) { delete data; });
+    handle.TypeTag(&POINTER_PATH_SET_TYPE_TAG);
+    
+    return handle;
+}
+
+// Memory Helpers - Pointer Chains
+// Argument: array of chain expressions such as "[[game.exe+0x1234]+0x10]+8"
+Napi::Value MemoryHookingAddon::CompileChains(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Expected array of chain expressions").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<std::string> expressions;
+    Napi::Array expressionArray = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < expressionArray.Length(); ++i) {
+        Napi::Value expression = expressionArray.Get(i);
+        if (!expression.IsString()) {
+            Napi::TypeError::New(env, "Chain expressions must be strings").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        expressions.push_back(expression.As<Napi::String>().Utf8Value());
+    }
+    
+    std::string error;
+    std::unique_ptr<ChainSet> chains = ChainSet::Compile(expressions, error);
+    if (!chains) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::External<ChainSet> handle = Napi::External<ChainSet>::New(env, chains.release(),
+        [](Napi::Env, ChainSet* data) { delete data; });
+    handle.TypeTag(&CHAIN_SET_TYPE_TAG);
+    
+    return handle;
+}
+
+// Argument: compiled chains. Returns a Float64Array of final addresses in
+// expression order, 0 for chains that do not resolve.
+Napi::Value MemoryHookingAddon::ResolveChains(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected compiled chains and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ChainSet* chains = UnwrapChainSet(info[0]);
+    if (!chains) {
+        Napi::TypeError::New(env, "Expected a handle returned by compileChains").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<uintptr_t> addresses;
+    chains->Resolve(m_processManager->getProcessHandle(), addresses);
+    
+    Napi::Float64Array result = Napi::Float64Array::New(env, addresses.size());
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        result[i] = static_cast<double>(addresses[i]);
+    }
+    
+    return result;
+}
+
+Napi::Value MemoryHookingAddon::ChainSetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    ChainSet* chains = info.Length() > 0 ? UnwrapChainSet(info[0]) : nullptr;
+    if (!chains) {
+        Napi::TypeError::New(env, "Expected a handle returned by compileChains").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("chains", Napi::Number::New(env, static_cast<double>(chains->Size())));
+    stats.Set("nodes", Napi::Number::New(env, static_cast<double>(chains->Nodes())));
+    stats.Set("reads", Napi::Number::New(env, static_cast<double>(chains->LastReads())));
+    
+    return stats;
+}
+
+// Memory Helpers - Address Space
+Napi::Value MemoryHookingAddon::GetModuleSections(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Process not attached").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::unique_ptr<AddressSpace> space = AddressSpace::Capture(m_processManager->getProcessHandle());
+    Napi::Array moduleArray = Napi::Array::New(env, space->Modules().size());
+    for (size_t i = 0; i < space->Modules().size(); ++i) {
+        const AddressModule& module = space->Modules()[i];
+        
+        Napi::Object moduleObj = Napi::Object::New(env);
+        moduleObj.Set("name", Napi::String::New(env, module.name));
+        moduleObj.Set("base", Napi::Number::New(env, static_cast<double>(module.base)));
+        moduleObj.Set("size", Napi::Number::New(env, static_cast<double>(module.size)));
+        
+        Napi::Array sectionArray = Napi::Array::New(env, module.sections.size());
+        for (size_t j = 0; j < module.sections.size(); ++j) {
+            Napi::Object sectionObj = Napi::Object::New(env);
+            sectionObj.Set("name", Napi::String::New(env, module.sections[j].name));
+            sectionObj.Set("moduleOffset", Napi::Number::New(env, static_cast<double>(module.sections[j].offset)));
+            sectionObj.Set("size", Napi::Number::New(env, static_cast<double>(module.sections[j].size)));
+            sectionArray[j] = sectionObj;
+        }
+        moduleObj.Set("sections", sectionArray);
+        
+        moduleArray[i] = moduleObj;
+    }
+    
+    return moduleArray;
+}
+
+// Argument: array of addresses. Each becomes {module, section, moduleOffset},
+// or null if it is not inside a module image.
+Napi::Value MemoryHookingAddon::LocateAddresses(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected array of addresses and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::unique_ptr<AddressSpace> space = AddressSpace::Capture(m_processManager->getProcessHandle());
+    Napi::Array addressArray = info[0].As<Napi::Array>();
+    Napi::Array resultArray = Napi::Array::New(env, addressArray.Length());
+    for (uint32_t i = 0; i < addressArray.Length(); ++i) {
+        ModuleAddress location;
+        uintptr_t address = static_cast<uintptr_t>(addressArray.Get(i).As<Napi::Number>().Int64Value());
+        if (!space->Locate(address, location)) {
+            resultArray[i] = env.Null();
+            continue;
+        }
+        
+        const AddressModule& module = space->Modules()[location.module];
+        Napi::Object locationObj = Napi::Object::New(env);
+        locationObj.Set("module", Napi::String::New(env, module.name));
+        if (location.section == AddressSpace::NO_SECTION) {
+            locationObj.Set("section", env.Null());
+        } else {
+            locationObj.Set("section", Napi::String::New(env, module.sections[location.section].name));
+        }
+        locationObj.Set("moduleOffset", Napi::Number::New(env, static_cast<double>(location.moduleOffset)));
+        
+        resultArray[i] = locationObj;
+    }
+    
+    return resultArray;
+}
+
+// Memory Helpers - Cross References
+// Arguments: searchStart, searchEnd. Decodes every executable region once;
+// lookups on the returned handle never read the target again.
+Napi::Value MemoryHookingAddon::BuildXrefIndex(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (!m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Process not attached").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    XrefIndexOptions options;
+    options.searchStart = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Int64Value() : 0;
+    options.searchEnd = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
+    
+    std::unique_ptr<XrefIndex> index = XrefIndex::Build(m_processManager->getProcessHandle(), options);
+    
+    Napi::External<XrefIndex> handle = Napi::External<XrefIndex>::New(env, index.release(),
+        [](Napi::Env, XrefIndex* data) { delete data; });
+    handle.TypeTag(&XREF_INDEX_TYPE_TAG);
+    
+    return handle;
+}
+
+// Arguments: index, low, high, kind, maxResults. References to any address in
+// [low, high] (high defaults to low), optionally of one kind, ordered by
+// target and then source.
+Napi::Value MemoryHookingAddon::XrefIndexFind(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Expected xref index and target address").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    XrefIndex* index = UnwrapXrefIndex(info[0]);
+    if (!index) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildXrefIndex").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    uintptr_t low = info[1].As<Napi::Number>().Int64Value();
+    uintptr_t high = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Int64Value() : low;
+    
+    int kind = -1;
+    if (info.Length() > 3 && info[3].IsString()) {
+        std::string name = info[3].As<Napi::String>().Utf8Value();
+        for (int i = 0; i < 4; ++i) {
+            if (name == XREF_KIND_NAMES[i]) kind = i;
+        }
+        if (kind < 0) {
+            Napi::TypeError::New(env, "Unknown xref kind: " + name).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    
+    size_t maxResults = 10000;
+    if (info.Length() > 4 && info[4].IsNumber()) {
+        maxResults = static_cast<size_t>(std::max<int64_t>(info[4].As<Napi::Number>().Int64Value(), 0));
+    }
+    
+    size_t begin, end;
+    index->Range(low, high, begin, end);
+    
+    Napi::Array resultArray = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (size_t i = begin; i < end && count < maxResults; ++i) {
+        const XrefEntry& entry = index->Entries()[i];
+        if (kind >= 0 && static_cast<int>(entry.Kind()) != kind) continue;
+        
+        Napi::Object xrefObj = Napi::Object::New(env);
+        xrefObj.Set("source", Napi::Number::New(env, static_cast<double>(entry.Source())));
+        xrefObj.Set("target", Napi::Number::New(env, static_cast<double>(entry.target)));
+        xrefObj.Set("kind", Napi::String::New(env, XREF_KIND_NAMES[static_cast<int>(entry.Kind())]));
+        resultArray[count++] = xrefObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::XrefIndexStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    XrefIndex* index = info.Length() > 0 ? UnwrapXrefIndex(info[0]) : nullptr;
+    if (!index) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildXrefIndex").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("references", Napi::Number::New(env, static_cast<double>(index->Size())));
+    stats.Set("instructions", Napi::Number::New(env, static_cast<double>(index->Instructions())));
+    stats.Set("regions", Napi::Number::New(env, static_cast<double>(index->Regions().size())));
+    stats.Set("memoryBytes", Napi::Number::New(env, static_cast<double>(index->MemoryUsage())));
+    
+    return stats;
+}
+
+Napi::Value MemoryHookingAddon::SaveXrefIndex(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected xref index and file path").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    XrefIndex* index = UnwrapXrefIndex(info[0]);
+    if (!index) {
+        Napi::TypeError::New(env, "Expected a handle returned by buildXrefIndex").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    if (!index->Save(Utf8ToWide(info[1].As<Napi::String>().Utf8Value()), error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Arguments: path. The index must have been saved from the attached process
+// instance; its entries are read from the mapped file as they are used.
+Napi::Value MemoryHookingAddon::LoadXrefIndex(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected file path and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    std::unique_ptr<XrefIndex> index = XrefIndex::Load(m_processManager->getProcessHandle(),
+        Utf8ToWide(info[0].As<Napi::String>().Utf8Value()), error);
+    if (!index) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::External<XrefIndex> handle = Napi::External<XrefIndex>::New(env, index.release(),
+        [](Napi::Env, XrefIndex* data) { delete data; });
+    handle.TypeTag(&XREF_INDEX_TYPE_TAG);
+    
+    return handle;
+}
+
+// Memory Helpers - Pattern Searching
+Napi::Value MemoryHookingAddon::SearchBytePattern(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 2 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected pattern array, mask array, and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse pattern
+    Napi::Array patternArray = info[0].As<Napi::Array>();
+    std::vector<uint8_t> pattern;
+    for (uint32_t i = 0; i < patternArray.Length(); ++i) {
+        pattern.push_back(static_cast<uint8_t>(patternArray.Get(i).As<Napi::Number>().Uint32Value()));
+    }
+    
+    // Parse mask
+    Napi::Array maskArray = info[1].As<Napi::Array>();
+    std::vector<bool> mask;
+    for (uint32_t i = 0; i < maskArray.Length(); ++i) {
+        mask.push_back(maskArray.Get(i).As<Napi::Boolean>().Value());
+    }
+    
+    uintptr_t searchStart = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchBytePattern(m_processManager->getProcessHandle(), pattern, mask, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::SearchMultiplePatterns(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsArray() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected patterns array and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Each pattern is either a signature string ("48 8B ?? ??") or a byte array
+    // paired with the mask array at the same index
+    Napi::Array patternsArray = info[0].As<Napi::Array>();
+    Napi::Array masksArray = (info.Length() > 1 && info[1].IsArray()) ? info[1].As<Napi::Array>() : Napi::Array::New(env);
+    
+    std::vector<std::vector<uint8_t>> patterns;
+    std::vector<std::vector<bool>> masks;
+    for (uint32_t i = 0; i < patternsArray.Length(); ++i) {
+        Napi::Value entry = patternsArray.Get(i);
+        
+        if (entry.IsString()) {
+            std::string signature = entry.As<Napi::String>().Utf8Value();
+            patterns.push_back(MemoryHelpers::ParseBytePattern(signature));
+            masks.push_back(MemoryHelpers::ParsePatternMask(signature));
+            continue;
+        }
+        
+        std::vector<uint8_t> pattern;
+        if (entry.IsArray()) {
+            Napi::Array patternArray = entry.As<Napi::Array>();
+            for (uint32_t j = 0; j < patternArray.Length(); ++j) {
+                pattern.push_back(static_cast<uint8_t>(patternArray.Get(j).As<Napi::Number>().Uint32Value()));
+            }
+        }
+        
+        std::vector<bool> mask;
+        Napi::Value maskEntry = i < masksArray.Length() ? masksArray.Get(i) : env.Undefined();
+        if (maskEntry.IsArray()) {
+            Napi::Array maskArray = maskEntry.As<Napi::Array>();
+            for (uint32_t j = 0; j < maskArray.Length(); ++j) {
+                mask.push_back(maskArray.Get(j).As<Napi::Boolean>().Value());
+            }
+        } else {
+            mask.assign(pattern.size(), true);
+        }
+        
+        patterns.push_back(pattern);
+        masks.push_back(mask);
+    }
+    
+    uintptr_t searchStart = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchMultiplePatterns(m_processManager->getProcessHandle(), patterns, masks, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("patternId", Napi::Number::New(env, results[i].patternId));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::CompileSignature(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected signature string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    std::unique_ptr<Signature> signature = Signature::Compile(info[0].As<Napi::String>().Utf8Value(), error);
+    if (!signature) {
+        Napi::Error::New(env, "Invalid signature: " + error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // The handle owns the signature; it is freed when JS collects the handle
+    Napi::External<Signature> handle = Napi::External<Signature>::New(env, signature.release(),
+        [](Napi::Env, Signature* data) { delete data; });
+    handle.TypeTag(&SIGNATURE_TYPE_TAG);
+    
+    return handle;
+}
+
+Napi::Value MemoryHookingAddon::SearchSignature(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected signature handle and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    const Signature* signature = UnwrapSignature(info[0]);
+    if (!signature) {
+        Napi::TypeError::New(env, "Expected a handle returned by compileSignature").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    uintptr_t searchStart = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchSignature(m_processManager->getProcessHandle(), *signature, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::SearchStringPattern(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected search string and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string pattern = info[0].As<Napi::String>().Utf8Value();
+    bool caseSensitive = info.Length() > 1 ? info[1].As<Napi::Boolean>().Value() : true;
+    bool unicode = info.Length() > 2 ? info[2].As<Napi::Boolean>().Value() : false;
+    uintptr_t searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchStringPattern(m_processManager->getProcessHandle(), pattern, caseSensitive, unicode, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::SearchString(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected search string and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string text = info[0].As<Napi::String>().Utf8Value();
+    
+    uint32_t encodings = static_cast<uint32_t>(StringEncoding::Utf8) | static_cast<uint32_t>(StringEncoding::Utf16LE);
+    if (info.Length() > 1 && info[1].IsArray()) {
+        if (!ParseEncodingList(env, info[1].As<Napi::Array>(), encodings)) return env.Null();
+    }
+    
+    bool caseSensitive = info.Length() > 2 ? info[2].As<Napi::Boolean>().Value() : true;
+    uintptr_t searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchString(m_processManager->getProcessHandle(), text, encodings, caseSensitive, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        matchObj.Set("encoding", Napi::String::New(env, StringEncodingName(results[i].encoding)));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::SearchRegexPattern(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected regex pattern and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string regexPattern = info[0].As<Napi::String>().Utf8Value();
+    uintptr_t searchStart = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 2 ? info[2].As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchRegexPattern(m_processManager->getProcessHandle(), regexPattern, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, results[i].address));
+        matchObj.Set("size", Napi::Number::New(env, results[i].size));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].data.size());
+        for (size_t j = 0; j < results[i].data.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].data[j]);
+        }
+        matchObj.Set("data", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+Napi::Value MemoryHookingAddon::ExtractStrings(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsFunction() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected batch callback and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Function onBatch = info[0].As<Napi::Function>();
+    size_t minLength = info.Length() > 1 && info[1].IsNumber()
+        ? static_cast<size_t>(std::max<int64_t>(info[1].As<Napi::Number>().Int64Value(), 1))
+        : StringExtractor::DEFAULT_MIN_LENGTH;
+    
+    uint32_t encodings = static_cast<uint32_t>(StringEncoding::Utf8) | static_cast<uint32_t>(StringEncoding::Utf16LE);
+    if (info.Length() > 2 && info[2].IsArray()) {
+        if (!ParseEncodingList(env, info[2].As<Napi::Array>(), encodings)) return env.Null();
+    }
+    
+    uintptr_t searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
+    size_t batchSize = info.Length() > 5 && info[5].IsNumber()
+        ? static_cast<size_t>(std::max<int64_t>(info[5].As<Napi::Number>().Int64Value(), 0))
+        : 0;
+    
+    // The scan runs on its own thread; batches are handed over through a
+    // bounded queue so the callback always runs on the JS thread. Scans
+    // started from the callback are refused, see t_deliveringStrings.
+    QueuedStringSink sink;
+    StringExtractionStats stats = {};
+    HANDLE processHandle = m_processManager->getProcessHandle();
+    
+    std::thread scanThread([&]() {
+        stats = MemoryHelpers::ExtractStrings(processHandle, sink, minLength, encodings, searchStart, searchEnd, batchSize);
+        sink.Close();
+    });
+    
+    std::vector<ExtractedString> batch;
+    t_deliveringStrings = true;
+    while (sink.Take(batch)) {
+        Napi::Array batchArray = Napi::Array::New(env, batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Napi::Object stringObj = Napi::Object::New(env);
+            stringObj.Set("address", Napi::Number::New(env, static_cast<double>(batch[i].address)));
+            stringObj.Set("encoding", Napi::String::New(env, StringEncodingName(batch[i].encoding)));
+            stringObj.Set("length", Napi::Number::New(env, static_cast<double>(batch[i].length)));
+            stringObj.Set("text", Napi::String::New(env, batch[i].text));
+            batchArray[i] = stringObj;
+        }
+        
+        // Returning false from the callback, or throwing, stops the extraction
+        Napi::Value keepGoing = onBatch.Call({ batchArray });
+        if (env.IsExceptionPending() || (keepGoing.IsBoolean() && !keepGoing.As<Napi::Boolean>().Value())) {
+            sink.Stop();
+        }
+    }
+    t_deliveringStrings = false;
+    
+    scanThread.join();
+    
+    if (env.IsExceptionPending()) return env.Null();
+    return StringExtractionStatsToObject(env, stats);
+}
+
+Napi::Value MemoryHookingAddon::ExtractStringsToFile(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsString() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected output path and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    size_t minLength = info.Length() > 1 && info[1].IsNumber()
+        ? static_cast<size_t>(std::max<int64_t>(info[1].As<Napi::Number>().Int64Value(), 1))
+        : StringExtractor::DEFAULT_MIN_LENGTH;
+    
+    uint32_t encodings = static_cast<uint32_t>(StringEncoding::Utf8) | static_cast<uint32_t>(StringEncoding::Utf16LE);
+    if (info.Length() > 2 && info[2].IsArray()) {
+        if (!ParseEncodingList(env, info[2].As<Napi::Array>(), encodings)) return env.Null();
+    }
+    
+    uintptr_t searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
+    
+    FileStringSink sink(path);
+    if (!sink.IsOpen()) {
+        Napi::Error::New(env, "Cannot open output file: " + path).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    StringExtractionStats stats = MemoryHelpers::ExtractStrings(m_processManager->getProcessHandle(), sink, minLength,
+                                                                encodings, searchStart, searchEnd);
+    if (stats.stopped) {
+        Napi::Error::New(env, "Failed writing to output file: " + path).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return StringExtractionStatsToObject(env, stats);
+}
+
+// Memory Helpers - Numeric Searching
+// Takes { type, op = "equal", value, value2, tolerance, decimals, ulps,
+// aligned = true, searchStart, searchEnd }
+Napi::Value MemoryHookingAddon::SearchValue(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsObject() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected value query and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object options = info[0].As<Napi::Object>();
+    ValueQuery query = {};
+    if (!ReadValueQuery(env, options, query)) {
+        return env.Null();
+    }
+    
+    Napi::Value start = options.Get("searchStart");
+    Napi::Value end = options.Get("searchEnd");
+    uintptr_t searchStart = start.IsNumber() ? start.As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = end.IsNumber() ? end.As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchValue(m_processManager->getProcessHandle(), query, searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, static_cast<double>(results[i].address)));
+        matchObj.Set("dataType", Napi::String::New(env, results[i].dataType));
+        matchObj.Set("value", Napi::Number::New(env, ScanValueToDouble(query.type, results[i].rawData.data())));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].rawData.size());
+        for (size_t j = 0; j < results[i].rawData.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].rawData[j]);
+        }
+        matchObj.Set("rawData", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+// Takes { members: [{ type, op, value, value2, tolerance, decimals, ulps,
+// aligned }], window = 64, ordered = false, searchStart, searchEnd }
+Napi::Value MemoryHookingAddon::SearchGroup(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsObject() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected group query and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object options = info[0].As<Napi::Object>();
+    Napi::Value membersValue = options.Get("members");
+    if (!membersValue.IsArray() || membersValue.As<Napi::Array>().Length() == 0 ||
+        membersValue.As<Napi::Array>().Length() > GroupScanner::MAX_MEMBERS) {
+        Napi::TypeError::New(env, "Expected 1 to " + std::to_string(GroupScanner::MAX_MEMBERS) + " group members")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Array membersArray = membersValue.As<Napi::Array>();
+    std::vector<ValueQuery> members;
+    size_t totalWidth = 0;
+    
+    for (uint32_t i = 0; i < membersArray.Length(); ++i) {
+        Napi::Value member = membersArray.Get(i);
+        if (!member.IsObject()) {
+            Napi::TypeError::New(env, "Expected each group member to be a value query").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        
+        ValueQuery query = {};
+        if (!ReadValueQuery(env, member.As<Napi::Object>(), query)) {
+            return env.Null();
+        }
+        members.push_back(query);
+        totalWidth += ScanValueSize(query.type);
+    }
+    
+    Napi::Value windowValue = options.Get("window");
+    size_t window = windowValue.IsNumber() ? windowValue.As<Napi::Number>().Uint32Value() : 64;
+    if (window < totalWidth || window > GroupScanner::MAX_WINDOW) {
+        Napi::TypeError::New(env, "Group window must fit every member and be at most " +
+                                  std::to_string(GroupScanner::MAX_WINDOW) + " bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Value ordered = options.Get("ordered");
+    Napi::Value start = options.Get("searchStart");
+    Napi::Value end = options.Get("searchEnd");
+    uintptr_t searchStart = start.IsNumber() ? start.As<Napi::Number>().Int64Value() : 0;
+    uintptr_t searchEnd = end.IsNumber() ? end.As<Napi::Number>().Int64Value() : 0;
+    
+    auto results = MemoryHelpers::SearchGroup(m_processManager->getProcessHandle(), members, window,
+                                              ordered.IsBoolean() && ordered.As<Napi::Boolean>().Value(),
+                                              searchStart, searchEnd);
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        const GroupMatch& group = results[i];
+        Napi::Object groupObj = Napi::Object::New(env);
+        groupObj.Set("address", Napi::Number::New(env, static_cast<double>(group.address)));
+        groupObj.Set("size", Napi::Number::New(env, static_cast<double>(group.data.size())));
+        
+        Napi::Array memberArray = Napi::Array::New(env, group.members.size());
+        for (size_t j = 0; j < group.members.size(); ++j) {
+            size_t width = ScanValueSize(members[j].type);
+            const uint8_t* data = group.data.data() + (group.members[j] - group.address);
+            
+            Napi::Object matchObj = Napi::Object::New(env);
+            matchObj.Set("address", Napi::Number::New(env, static_cast<double>(group.members[j])));
+            matchObj.Set("dataType", Napi::String::New(env, ScanValueTypeName(members[j].type)));
+            matchObj.Set("value", Napi::Number::New(env, ScanValueToDouble(members[j].type, data)));
+            
+            Napi::Array dataArray = Napi::Array::New(env, width);
+            for (size_t k = 0; k < width; ++k) {
+                dataArray[k] = Napi::Number::New(env, data[k]);
+            }
+            matchObj.Set("rawData", dataArray);
+            
+            memberArray[j] = matchObj;
+        }
+        groupObj.Set("members", memberArray);
+        
+        resultArray[i] = groupObj;
+    }
+    
+    return resultArray;
+}
+
+// Memory Helpers - Scan Sessions
+Napi::Value MemoryHookingAddon::CreateScanSession(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected value type").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ScanSessionOptions options;
+    std::string typeName = info[0].As<Napi::String>().Utf8Value();
+    if (!ParseScanValueType(typeName, options.type)) {
+        Napi::TypeError::New(env, "Unknown value type: " + typeName).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    options.aligned = info.Length() > 1 ? info[1].As<Napi::Boolean>().Value() : true;
+    options.writableOnly = info.Length() > 2 ? info[2].As<Napi::Boolean>().Value() : true;
+    options.searchStart = info.Length() > 3 ? info[3].As<Napi::Number>().Int64Value() : 0;
+    options.searchEnd = info.Length() > 4 ? info[4].As<Napi::Number>().Int64Value() : 0;
+    options.memoryLimit = info.Length() > 5 && info[5].IsNumber()
+        ? static_cast<size_t>(std::max<int64_t>(info[5].As<Napi::Number>().Int64Value(), 0))
+        : 0;
+    options.moduleImagesOnly = info.Length() > 6 ? info[6].As<Napi::Boolean>().Value() : false;
+    
+    // The handle owns the candidate set; it is freed when JS collects the handle
+    Napi::External<ScanSession> handle = Napi::External<ScanSession>::New(env, new ScanSession(options),
+        [](Napi::Env, ScanSession* data) { delete data; });
+    handle.TypeTag(&SCAN_SESSION_TYPE_TAG);
+    
+    return handle;
+}
+
+Napi::Value MemoryHookingAddon::ScanSessionFirst(const Napi::CallbackInfo& info) {
+    return ScanSessionFilter(info, true);
+}
+
+Napi::Value MemoryHookingAddon::ScanSessionNext(const Napi::CallbackInfo& info) {
+    return ScanSessionFilter(info, false);
+}
+
+// Arguments: session, compare, value, value2, tolerance, decimals, ulps.
+// Returns the number of candidates left.
+Napi::Value MemoryHookingAddon::ScanSessionFilter(const Napi::CallbackInfo& info, bool first) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 2 || !info[1].IsString() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected scan session, compare and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ScanSession* session = UnwrapScanSession(info[0]);
+    if (!session) {
+        Napi::TypeError::New(env, "Expected a handle returned by createScanSession").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ScanCompare compare;
+    std::string compareName = info[1].As<Napi::String>().Utf8Value();
+    if (!ParseScanCompare(compareName, compare)) {
+        Napi::TypeError::New(env, "Unknown scan compare: " + compareName).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ScanParams params = {};
+    if (info.Length() > 2 && info[2].IsNumber()) {
+        params.value = info[2].As<Napi::Number>().DoubleValue();
+        params.intValue = info[2].As<Napi::Number>().Int64Value();
+    }
+    if (info.Length() > 3 && info[3].IsNumber()) {
+        params.value2 = info[3].As<Napi::Number>().DoubleValue();
+        params.intValue2 = info[3].As<Napi::Number>().Int64Value();
+    }
+    params.tolerance = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().DoubleValue() : 0;
+    params.decimals = info.Length() > 5 && info[5].IsNumber() ? info[5].As<Napi::Number>().Uint32Value() : 0;
+    params.ulps = info.Length() > 6 && info[6].IsNumber() ? info[6].As<Napi::Number>().Uint32Value() : 0;
+    
+    std::string error;
+    HANDLE processHandle = m_processManager->getProcessHandle();
+    bool ok = first ? session->First(processHandle, compare, params, error)
+                    : session->Next(processHandle, compare, params, error);
+    if (!ok) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, static_cast<double>(session->Count()));
+}
+
+Napi::Value MemoryHookingAddon::ScanSessionCount(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    ScanSession* session = info.Length() > 0 ? UnwrapScanSession(info[0]) : nullptr;
+    if (!session) {
+        Napi::TypeError::New(env, "Expected a handle returned by createScanSession").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, static_cast<double>(session->Count()));
+}
+
+Napi::Value MemoryHookingAddon::ScanSessionStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    ScanSession* session = info.Length() > 0 ? UnwrapScanSession(info[0]) : nullptr;
+    if (!session) {
+        Napi::TypeError::New(env, "Expected a handle returned by createScanSession").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("candidates", Napi::Number::New(env, static_cast<double>(session->Count())));
+    stats.Set("scans", Napi::Number::New(env, static_cast<double>(session->Scans())));
+    stats.Set("memoryBytes", Napi::Number::New(env, static_cast<double>(session->MemoryUsage())));
+    stats.Set("diskBytes", Napi::Number::New(env, static_cast<double>(session->DiskUsage())));
+    stats.Set("regions", Napi::Number::New(env, static_cast<double>(session->Regions().size())));
+    
+    return stats;
+}
+
+Napi::Value MemoryHookingAddon::SaveScanSession(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected scan session and file path").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ScanSession* session = UnwrapScanSession(info[0]);
+    if (!session) {
+        Napi::TypeError::New(env, "Expected a handle returned by createScanSession").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string error;
+    if (!session->Save(Utf8ToWide(info[1].As<Napi::String>().Utf8Value()), error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Arguments: path, memoryLimit. The session must have been saved from the
+// attached process instance.
+Napi::Value MemoryHookingAddon::LoadScanSession(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString() || !m_processManager->isProcessAttached()) {
+        Napi::TypeError::New(env, "Expected file path and attached process").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    size_t memoryLimit = info.Length() > 1 && info[1].IsNumber()
+        ? static_cast<size_t>(std::max<int64_t>(info[1].As<Napi::Number>().Int64Value(), 0))
+        : 0;
+    
+    std::string error;
+    std::unique_ptr<ScanSession> session = ScanSession::Load(m_processManager->getProcessHandle(),
+        Utf8ToWide(info[0].As<Napi::String>().Utf8Value()), memoryLimit, error);
+    if (!session) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::External<ScanSession> handle = Napi::External<ScanSession>::New(env, session.release(),
+        [](Napi::Env, ScanSession* data) { delete data; });
+    handle.TypeTag(&SCAN_SESSION_TYPE_TAG);
+    
+    return handle;
+}
+
+Napi::Value MemoryHookingAddon::ScanSessionResults(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    ScanSession* session = info.Length() > 0 ? UnwrapScanSession(info[0]) : nullptr;
+    if (!session) {
+        Napi::TypeError::New(env, "Expected a handle returned by createScanSession").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    size_t maxResults = 10000;
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        maxResults = static_cast<size_t>(std::max<int64_t>(info[1].As<Napi::Number>().Int64Value(), 0));
+    }
+    
+    auto results = session->Results(maxResults);
+    const char* typeName = ScanValueTypeName(session->Type());
+    
+    Napi::Array resultArray = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        Napi::Object matchObj = Napi::Object::New(env);
+        matchObj.Set("address", Napi::Number::New(env, static_cast<double>(results[i].address)));
+        matchObj.Set("dataType", Napi::String::New(env, typeName));
+        matchObj.Set("value", Napi::Number::New(env, ScanValueToDouble(session->Type(), results[i].value.data())));
+        
+        Napi::Array dataArray = Napi::Array::New(env, results[i].value.size());
+        for (size_t j = 0; j < results[i].value.size(); ++j) {
+            dataArray[j] = Napi::Number::New(env, results[i].value[j]);
+        }
+        matchObj.Set("rawData", dataArray);
+        
+        resultArray[i] = matchObj;
+    }
+    
+    return resultArray;
+}
+
+// Memory Helpers - Region Analysis
+Napi::Value MemoryHookingAddon::GetMemoryRegionsEx(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Process not attached").ThrowAsJavaScriptException();
         return env.Null();
     }
@@ -978,6 +2457,7 @@ Napi::Value MemoryHookingAddon::GetRegionInfo(const Napi::CallbackInfo& info) {
 // Memory Helpers - Advanced Scanning
 Napi::Value MemoryHookingAddon::ScanForCode(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Expected opcodes array and attached process").ThrowAsJavaScriptException();
@@ -1015,6 +2495,7 @@ Napi::Value MemoryHookingAddon::ScanForCode(const Napi::CallbackInfo& info) {
 
 Napi::Value MemoryHookingAddon::FindFunctionPrologs(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (!m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Process not attached").ThrowAsJavaScriptException();
@@ -1036,6 +2517,7 @@ Napi::Value MemoryHookingAddon::FindFunctionPrologs(const Napi::CallbackInfo& in
 
 Napi::Value MemoryHookingAddon::FindCallInstructions(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
     
     if (info.Length() < 1 || !m_processManager->isProcessAttached()) {
         Napi::TypeError::New(env, "Expected target address and attached process").ThrowAsJavaScriptException();
@@ -1187,6 +2669,45 @@ Napi::Value MemoryHookingAddon::GetAlignment(const Napi::CallbackInfo& info) {
     return Napi::Number::New(env, result);
 }
 
+Napi::Value MemoryHookingAddon::SetScanMemoryBudget(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected budget in bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int64_t bytes = info[0].As<Napi::Number>().Int64Value();
+    size_t result = MemoryHelpers::SetScanMemoryBudget(bytes > 0 ? static_cast<size_t>(bytes) : 0);
+    
+    return Napi::Number::New(env, static_cast<double>(result));
+}
+
+Napi::Value MemoryHookingAddon::GetScanMemoryBudget(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    return Napi::Number::New(env, static_cast<double>(MemoryHelpers::GetScanMemoryBudget()));
+}
+
+Napi::Value MemoryHookingAddon::SetScanParallelism(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (RejectInsideStringBatch(env)) return env.Null();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected thread count (0 for all cores)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int64_t threads = info[0].As<Napi::Number>().Int64Value();
+    size_t result = ScanExecutor::Instance().SetParallelism(threads > 0 ? static_cast<size_t>(threads) : 0);
+    
+    return Napi::Number::New(env, static_cast<double>(result));
+}
+
+Napi::Value MemoryHookingAddon::GetScanParallelism(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    return Napi::Number::New(env, static_cast<double>(ScanExecutor::Instance().Parallelism()));
+}
+
 // Automation Helpers - Mouse Control
 Napi::Value MemoryHookingAddon::MoveMouse(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -1,10 +1,12 @@
 #include "include/memory_scanner.h"
 #include "include/error_handler.h"
+#include "include/pattern_matcher.h"
+#include "include/region_reader.h"
+#include "include/scan_executor.h"
 #include <windows.h>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
-#include <cctype>
 
 MemoryScanner::MemoryScanner(ProcessManager* processManager) 
     : m_processManager(processManager) {
@@ -27,16 +29,15 @@ std::vector<LPVOID> MemoryScanner::scanForPattern(const std::string& pattern, co
         maskVector.push_back(c == 'x');
     }
     
-    auto regions = getMemoryRegions();
-    for (const auto& region : regions) {
-        if (region.state == MEM_COMMIT && 
-            (region.protection & PAGE_GUARD) == 0 &&
-            (region.protection & PAGE_NOACCESS) == 0) {
-            
-            scanMemoryRegion(region.baseAddress, region.size, patternBytes, maskVector, results);
-        }
+    if (patternBytes.empty() || maskVector.size() != patternBytes.size()) {
+        ErrorHandler::logError("scanForPattern: Invalid pattern or mask");
+        return results;
     }
     
+    PatternMatcher matcher(patternBytes, maskVector);
+    
+    scanMemoryRegions(getScannableRanges(), matcher, results);
+    
     return results;
 }
 
@@ -47,34 +48,40 @@ std::vector<LPVOID> MemoryScanner::scanForBytes(const std::vector<BYTE>& bytes)
         return results;
     }
     
-    std::vector<bool> mask(bytes.size(), true);
-    
-    auto regions = getMemoryRegions();
-    for (const auto& region : regions) {
-        if (region.state == MEM_COMMIT && 
-            (region.protection & PAGE_GUARD) == 0 &&
-            (region.protection & PAGE_NOACCESS) == 0) {
-            
-            scanMemoryRegion(region.baseAddress, region.size, bytes, mask, results);
-        }
+    if (bytes.empty()) {
+        ErrorHandler::logError("scanForBytes: Empty pattern");
+        return results;
     }
     
+    PatternMatcher matcher(bytes, std::vector<bool>(bytes.size(), true));
+    
+    scanMemoryRegions(getScannableRanges(), matcher, results);
+    
     return results;
 }
 
 std::vector<LPVOID> MemoryScanner::scanForString(const std::string& text, bool caseSensitive) {
-    std::vector<BYTE> bytes;
-    std::string searchText = text;
+    std::vector<LPVOID> results;
     
-    if (!caseSensitive) {
-        std::transform(searchText.begin(), searchText.end(), searchText.begin(), ::tolower);
+    if (caseSensitive) {
+        return scanForBytes(std::vector<BYTE>(text.begin(), text.end()));
     }
     
-    for (char c : searchText) {
-        bytes.push_back(static_cast<BYTE>(c));
+    if (!m_processManager->isProcessAttached()) {
+        return results;
     }
     
-    return scanForBytes(bytes);
+    if (text.empty()) {
+        ErrorHandler::logError("scanForString: Empty pattern");
+        return results;
+    }
+    
+    // Both needle and haystack are folded, inside the matcher's compares
+    PatternMatcher matcher = PatternMatcher::CaseInsensitive(std::vector<uint8_t>(text.begin(), text.end()));
+    
+    scanMemoryRegions(getScannableRanges(), matcher, results);
+    
+    return results;
 }
 
 std::vector<LPVOID> MemoryScanner::scanForValue(int value) {
@@ -216,83 +223,60 @@ std::vector<BYTE> MemoryScanner::patternToBytes(const std::string& pattern, cons
     return bytes;
 }
 
-bool MemoryScanner::scanMemoryRegion(LPVOID startAddress, SIZE_T size, const std::vector<BYTE>& pattern, 
-                                    const std::vector<bool>& mask, std::vector<LPVOID>& results) {
+std::vector<ScanRange> MemoryScanner::getScannableRanges() {
+    std::vector<ScanRange> ranges;
     
-    if (!m_processManager->isProcessAttached()) {
-        ErrorHandler::logError("scanMemoryRegion: No process attached");
-        return false;
+    auto regions = getMemoryRegions();
+    for (const auto& region : regions) {
+        if (region.state == MEM_COMMIT && 
+            (region.protection & PAGE_GUARD) == 0 &&
+            (region.protection & PAGE_NOACCESS) == 0) {
+            
+            ranges.push_back({reinterpret_cast<uintptr_t>(region.baseAddress), region.size, 0});
+        }
     }
     
-    if (pattern.empty() || mask.size() != pattern.size()) {
-        ErrorHandler::logError("scanMemoryRegion: Invalid pattern or mask");
+    return ranges;
+}
+
+bool MemoryScanner::scanMemoryRegions(const std::vector<ScanRange>& ranges, const PatternMatcher& matcher, 
+                                      std::vector<LPVOID>& results) {
+    
+    if (!m_processManager->isProcessAttached()) {
+        ErrorHandler::logError("scanMemoryRegions: No process attached");
         return false;
     }
     
-    const SIZE_T CHUNK_SIZE = 4096;
-    const SIZE_T MAX_SCAN_SIZE = 100 * 1024 * 1024; // 100MB limit for safety
-    
-    if (size > MAX_SCAN_SIZE) {
-        ErrorHandler::logWarning("scanMemoryRegion: Scan size exceeds safety limit, truncating to " + 
-                                 std::to_string(MAX_SCAN_SIZE) + " bytes");
-        size = MAX_SCAN_SIZE;
+    if (matcher.Empty()) {
+        ErrorHandler::logError("scanMemoryRegions: Invalid pattern or mask");
+        return false;
     }
     
-    std::vector<BYTE> buffer(CHUNK_SIZE);
-    SIZE_T successfulReads = 0;
-    SIZE_T failedReads = 0;
-    
     try {
-        for (SIZE_T offset = 0; offset < size; offset += CHUNK_SIZE) {
-            SIZE_T readSize = std::min(CHUNK_SIZE, size - offset);
-            LPVOID currentAddress = static_cast<LPBYTE>(startAddress) + offset;
+        // Regions are split across the scan executor; results come back in address order
+        auto addresses = ParallelScan<LPVOID>(m_processManager->getProcessHandle(), ranges, matcher.Size() - 1,
+                                              MAX_RESULTS - std::min(results.size(), MAX_RESULTS),
+                                              [&](const RegionChunk& chunk, std::vector<LPVOID>& out) {
+            std::vector<size_t> offsets;
+            size_t searchSize = std::min(chunk.size, chunk.owned + matcher.Size() - 1);
+            matcher.FindAll(chunk.data, searchSize, offsets, MAX_RESULTS - out.size());
             
-            // Fix: Use attached process handle instead of GetCurrentProcess()
-            if (!ErrorHandler::isAddressAccessible(m_processManager->getProcessHandle(), currentAddress, readSize)) {
-                failedReads++;
-                continue;
+            for (size_t i : offsets) {
+                out.push_back(reinterpret_cast<LPVOID>(chunk.address + i));
             }
             
-            SIZE_T bytesRead = 0;
-            if (m_processManager->readMemory(currentAddress, buffer.data(), readSize)) {
-                successfulReads++;
-                
-                // Ensure we don't exceed buffer bounds
-                SIZE_T searchEnd = (readSize >= pattern.size()) ? readSize - pattern.size() + 1 : 0;
-                
-                for (SIZE_T i = 0; i < searchEnd; ++i) {
-                    bool match = true;
-                    
-                    for (SIZE_T j = 0; j < pattern.size(); ++j) {
-                        if (mask[j] && buffer[i + j] != pattern[j]) {
-                            match = false;
-                            break;
-                        }
-                    }
-                    
-                    if (match) {
-                        LPVOID matchAddress = static_cast<LPBYTE>(currentAddress) + i;
-                        results.push_back(matchAddress);
-                        
-                        // Limit results to prevent memory exhaustion
-                        if (results.size() >= 10000) {
-                            ErrorHandler::logWarning("scanMemoryRegion: Reached maximum result limit (10000), stopping scan");
-                            return true;
-                        }
-                    }
-                }
-            } else {
-                failedReads++;
-            }
-        }
+            return out.size() < MAX_RESULTS;
+        });
+        
+        results.insert(results.end(), addresses.begin(), addresses.end());
         
-        if (failedReads > 0) {
-            ErrorHandler::logInfo("scanMemoryRegion: " + std::to_string(successfulReads) + 
-                                 " successful reads, " + std::to_string(failedReads) + " failed reads");
+        // Limit results to prevent memory exhaustion
+        if (results.size() >= MAX_RESULTS) {
+            ErrorHandler::logWarning("scanMemoryRegions: Reached maximum result limit (10000), stopping scan");
         }
         
     } catch (const std::exception& e) {
-        ErrorHandler::logError("scanMemoryRegion: Exception during scan - " + std::string(e.what()));
+        ErrorHandler::logError("scanMemoryRegions: Exception during scan - " + std::string(e.what()));
         return false;
     }
     
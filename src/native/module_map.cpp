@@ -0,0 +1,135 @@
+#include "include/module_map.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool SameModuleName(const std::string& a, const std::string& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return tolower(static_cast<unsigned char>(x)) == tolower(static_cast<unsigned char>(y));
+    });
+}
+
+} // namespace
+
+ModuleMap::ModuleMap() {
+}
+
+// Lines read "start-end perms offset dev inode path", with the numbers in hex
+std::unique_ptr<ModuleMap> ModuleMap::ParseProcMaps(const std::string& text) {
+    std::unique_ptr<ModuleMap> map(new ModuleMap());
+    std::istringstream lines(text);
+    std::string line;
+    bool afterModule = false;
+
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string range, perms, offset, device, inode, path;
+        if (!(fields >> range >> perms >> offset >> device >> inode)) {
+            afterModule = false;
+            continue;
+        }
+        std::getline(fields, path);
+        path.erase(0, path.find_first_not_of(' '));
+
+        char* rest = nullptr;
+        uintptr_t start = static_cast<uintptr_t>(strtoull(range.c_str(), &rest, 16));
+        if (*rest != '-') continue;
+        uintptr_t end = static_cast<uintptr_t>(strtoull(rest + 1, nullptr, 16));
+        if (end <= start) continue;
+
+        AddressModule* last = map->m_modules.empty() ? nullptr : &map->m_modules.back();
+
+        // Zero-filled static data follows the image's writable mapping
+        // without a file behind it
+        if (path.empty()) {
+            if (afterModule && last && last->base + last->size == start && !last->sections.empty() &&
+                last->sections.back().name.compare(0, 2, "rw") == 0) {
+                last->sections.push_back({ "[bss]", start - last->base, static_cast<size_t>(end - start) });
+                last->size = static_cast<size_t>(end - last->base);
+            }
+            afterModule = false;
+            continue;
+        }
+
+        // Heap, stack, vdso and the like are not files
+        afterModule = path[0] == '/';
+        if (!afterModule) continue;
+
+        const std::string deleted = " (deleted)";
+        if (path.size() > deleted.size() && path.compare(path.size() - deleted.size(), deleted.size(), deleted) == 0) {
+            path.erase(path.size() - deleted.size());
+        }
+        std::string name = path.substr(path.find_last_of('/') + 1);
+
+        // An image's first mapping covers the start of its file, so a mapping
+        // at file offset 0 begins a new image even when the same file was
+        // mapped just before
+        bool fileStart = strtoull(offset.c_str(), nullptr, 16) == 0;
+        if (!last || last->name != name || fileStart || start < last->base + last->size) {
+            map->m_modules.push_back({ name, start, 0, {} });
+            last = &map->m_modules.back();
+        }
+        last->sections.push_back({ perms, start - last->base, static_cast<size_t>(end - start) });
+        last->size = static_cast<size_t>(end - last->base);
+    }
+
+    map->SortModules();
+    return map;
+}
+
+std::unique_ptr<ModuleMap> ModuleMap::LoadProcMaps(uint32_t processId, std::string& error) {
+    std::ifstream file("/proc/" + std::to_string(processId) + "/maps");
+    if (!file) {
+        error = "Could not read the memory map of process " + std::to_string(processId);
+        return nullptr;
+    }
+
+    std::ostringstream text;
+    text << file.rdbuf();
+    return ParseProcMaps(text.str());
+}
+
+void ModuleMap::SortModules() {
+    std::sort(m_modules.begin(), m_modules.end(),
+              [](const AddressModule& a, const AddressModule& b) { return a.base < b.base; });
+}
+
+size_t ModuleMap::FindModule(uintptr_t address) const {
+    auto next = std::upper_bound(m_modules.begin(), m_modules.end(), address,
+                                 [](uintptr_t value, const AddressModule& module) { return value < module.base; });
+    if (next == m_modules.begin()) return SIZE_MAX;
+
+    size_t index = static_cast<size_t>(next - m_modules.begin()) - 1;
+    return address - m_modules[index].base < m_modules[index].size ? index : SIZE_MAX;
+}
+
+bool ModuleMap::Locate(uintptr_t address, ModuleAddress& location) const {
+    size_t index = FindModule(address);
+    if (index == SIZE_MAX) return false;
+
+    const AddressModule& module = m_modules[index];
+    location.module = static_cast<uint32_t>(index);
+    location.moduleOffset = address - module.base;
+    location.section = NO_SECTION;
+
+    auto next = std::upper_bound(module.sections.begin(), module.sections.end(), location.moduleOffset,
+                                 [](uintptr_t value, const ModuleSection& section) { return value < section.offset; });
+    if (next != module.sections.begin()) {
+        const ModuleSection& section = *(next - 1);
+        if (location.moduleOffset - section.offset < section.size) {
+            location.section = static_cast<uint32_t>(next - 1 - module.sections.begin());
+        }
+    }
+    return true;
+}
+
+uintptr_t ModuleMap::Resolve(const std::string& module, uintptr_t moduleOffset) const {
+    for (const AddressModule& candidate : m_modules) {
+        if (SameModuleName(candidate.name, module)) return candidate.base + moduleOffset;
+    }
+    return 0;
+}
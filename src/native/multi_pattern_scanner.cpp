@@ -0,0 +1,109 @@
+#include "include/multi_pattern_scanner.h"
+#include <algorithm>
+
+MultiPatternScanner::MultiPatternScanner()
+    : m_pairFilter(65536 / 64, 0), m_pairBuckets(65536), m_hasByteBuckets(false), m_maxPatternSize(0) {
+}
+
+size_t MultiPatternScanner::AddPattern(const std::vector<uint8_t>& pattern, const std::vector<bool>& mask) {
+    PatternMatcher matcher(pattern, mask);
+    if (matcher.Empty()) {
+        return npos;
+    }
+
+    uint32_t id = static_cast<uint32_t>(m_patterns.size());
+
+    // Pick the rarest pair of adjacent fixed bytes as the bucket key
+    size_t bestPair = npos;
+    int bestScore = 0;
+    for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+        if (!mask[i] || !mask[i + 1]) continue;
+
+        int score = PatternMatcher::ByteCommonness(pattern[i]) + PatternMatcher::ByteCommonness(pattern[i + 1]);
+        if (bestPair == npos || score < bestScore) {
+            bestPair = i;
+            bestScore = score;
+        }
+    }
+
+    if (bestPair != npos) {
+        uint32_t key = pattern[bestPair] | (static_cast<uint32_t>(pattern[bestPair + 1]) << 8);
+        m_pairFilter[key >> 6] |= 1ULL << (key & 63);
+        m_pairBuckets[key].push_back({ id, static_cast<uint32_t>(bestPair) });
+    } else if (matcher.FixedCount() > 0) {
+        m_byteBuckets[matcher.AnchorValue()].push_back({ id, static_cast<uint32_t>(matcher.AnchorOffset()) });
+        m_hasByteBuckets = true;
+    } else {
+        m_wildcardPatterns.push_back(id);
+    }
+
+    m_maxPatternSize = std::max(m_maxPatternSize, matcher.Size());
+    m_patterns.push_back(std::move(matcher));
+    return id;
+}
+
+void MultiPatternScanner::Verify(const BucketEntry& entry, const uint8_t* data, size_t size, size_t pos,
+                                 std::vector<MultiPatternHit>& hits) const {
+    if (pos < entry.anchorOffset) return;
+
+    size_t start = pos - entry.anchorOffset;
+    const PatternMatcher& matcher = m_patterns[entry.patternId];
+    if (matcher.Size() > size - start) return;
+
+    if (matcher.MatchesAt(data + start)) {
+        hits.push_back({ start, entry.patternId });
+    }
+}
+
+size_t MultiPatternScanner::FindAll(const uint8_t* data, size_t size, std::vector<MultiPatternHit>& hits,
+                                    size_t maxResults) const {
+    if (data == nullptr || size == 0 || m_patterns.empty() || maxResults == 0) {
+        return 0;
+    }
+
+    // A wildcard-only pattern hits every offset it fits at, so the first
+    // maxResults hits all start below maxResults and nothing past the longest
+    // pattern beyond that can make the cut
+    if (!m_wildcardPatterns.empty() && maxResults < size) {
+        size = std::min(size, maxResults - 1 + m_maxPatternSize);
+    }
+
+    size_t firstHit = hits.size();
+    const uint64_t* pairFilter = m_pairFilter.data();
+
+    // Pair-keyed patterns: the bitmap test is the only work done at most offsets
+    uint32_t key = static_cast<uint32_t>(data[0]) << 8;
+    for (size_t pos = 0; pos + 1 < size; ++pos) {
+        key = (key >> 8) | (static_cast<uint32_t>(data[pos + 1]) << 8);
+        if (pairFilter[key >> 6] & (1ULL << (key & 63))) {
+            for (const BucketEntry& entry : m_pairBuckets[key]) {
+                Verify(entry, data, size, pos, hits);
+            }
+        }
+    }
+
+    if (m_hasByteBuckets) {
+        for (size_t pos = 0; pos < size; ++pos) {
+            for (const BucketEntry& entry : m_byteBuckets[data[pos]]) {
+                Verify(entry, data, size, pos, hits);
+            }
+        }
+    }
+
+    for (uint32_t id : m_wildcardPatterns) {
+        for (size_t pos = 0; pos + m_patterns[id].Size() <= size; ++pos) {
+            hits.push_back({ pos, id });
+        }
+    }
+
+    // Anchors sit at different offsets within their patterns, so hits come out of
+    // order; sort before truncating so the kept set does not depend on anchors
+    std::sort(hits.begin() + firstHit, hits.end(), [](const MultiPatternHit& a, const MultiPatternHit& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.patternId < b.patternId;
+    });
+
+    if (hits.size() - firstHit > maxResults) {
+        hits.resize(firstHit + maxResults);
+    }
+    return hits.size() - firstHit;
+}
@@ -0,0 +1,437 @@
+#include "include/pattern_matcher.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PATTERN_MATCHER_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PATTERN_MATCHER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+inline unsigned LowestSetBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+bool DetectAvx2() {
+#if defined(PATTERN_MATCHER_X86)
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+
+    __cpuid(regs, 1);
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+PatternMatcher::PatternMatcher(const std::vector<uint8_t>& pattern, const std::vector<bool>& mask)
+    : m_size(0), m_fixedCount(0), m_anchorableCount(0), m_constrainedCount(0), m_anchor1(0), m_anchor2(0),
+      m_runOffset(0), m_runLength(0) {
+    if (pattern.empty() || mask.size() != pattern.size()) {
+        return;
+    }
+
+    std::vector<uint8_t> byteMask(mask.size());
+    for (size_t i = 0; i < mask.size(); ++i) {
+        byteMask[i] = mask[i] ? 0xFF : 0x00;
+    }
+    Init(pattern, byteMask);
+}
+
+PatternMatcher::PatternMatcher(const std::vector<uint8_t>& pattern, const std::vector<uint8_t>& byteMask)
+    : m_size(0), m_fixedCount(0), m_anchorableCount(0), m_constrainedCount(0), m_anchor1(0), m_anchor2(0),
+      m_runOffset(0), m_runLength(0) {
+    if (pattern.empty() || byteMask.size() != pattern.size()) {
+        return;
+    }
+
+    Init(pattern, byteMask);
+}
+
+PatternMatcher PatternMatcher::CaseInsensitive(const std::vector<uint8_t>& pattern) {
+    std::vector<uint8_t> byteMask(pattern.size(), 0xFF);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        uint8_t c = pattern[i];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            byteMask[i] = CASE_FOLD_MASK;
+        }
+    }
+
+    PatternMatcher matcher(pattern, byteMask);
+    if (!matcher.Empty()) {
+        // Neighbouring letters of text are correlated; the ends filter independently
+        matcher.m_anchor1 = 0;
+        matcher.m_anchor2 = matcher.m_size - 1;
+    }
+    return matcher;
+}
+
+void PatternMatcher::Init(const std::vector<uint8_t>& pattern, const std::vector<uint8_t>& byteMask) {
+    m_size = pattern.size();
+    size_t padded = (m_size + 15) & ~static_cast<size_t>(15);
+    m_value.assign(padded, 0);
+    m_mask.assign(padded, 0);
+
+    for (size_t i = 0; i < m_size; ++i) {
+        m_mask[i] = byteMask[i];
+        m_value[i] = pattern[i] & byteMask[i];
+
+        if (byteMask[i] != 0x00) m_constrainedCount++;
+        if (byteMask[i] == 0xFF) m_fixedCount++;
+        if (IsAnchorable(i)) m_anchorableCount++;
+    }
+
+    ChooseAnchors();
+    BuildShiftTable();
+}
+
+void PatternMatcher::ChooseAnchors() {
+    std::vector<size_t> fixed;
+    for (size_t i = 0; i < m_size; ++i) {
+        if (IsAnchorable(i)) fixed.push_back(i);
+    }
+    if (fixed.empty()) return;
+
+    std::stable_sort(fixed.begin(), fixed.end(), [this](size_t a, size_t b) {
+        return ByteCommonness(m_value[a]) < ByteCommonness(m_value[b]);
+    });
+
+    m_anchor1 = fixed[0];
+    m_anchor2 = fixed[0];
+
+    // Prefer a second anchor with a different value so the two compares filter independently
+    for (size_t i = 1; i < fixed.size(); ++i) {
+        if (m_value[fixed[i]] != m_value[m_anchor1]) {
+            m_anchor2 = fixed[i];
+            return;
+        }
+    }
+    if (fixed.size() > 1) {
+        m_anchor2 = fixed[1];
+    }
+}
+
+void PatternMatcher::BuildShiftTable() {
+    // Find the longest run of fully fixed bytes; wildcards break a run because
+    // a shift past them could skip a match
+    size_t runStart = 0;
+    for (size_t i = 0; i <= m_size; ++i) {
+        if (i < m_size && m_mask[i] == 0xFF) continue;
+
+        if (i - runStart > m_runLength) {
+            m_runOffset = runStart;
+            m_runLength = i - runStart;
+        }
+        runStart = i + 1;
+    }
+
+    if (m_runLength == 0) return;
+
+    // Keep the tail of very long runs so shifts fit in a byte
+    if (m_runLength > HORSPOOL_MAX_RUN) {
+        m_runOffset += m_runLength - HORSPOOL_MAX_RUN;
+        m_runLength = HORSPOOL_MAX_RUN;
+    }
+
+    m_shift.assign(256, static_cast<uint8_t>(m_runLength));
+    for (size_t i = 0; i + 1 < m_runLength; ++i) {
+        m_shift[m_value[m_runOffset + i]] = static_cast<uint8_t>(m_runLength - 1 - i);
+    }
+}
+
+bool PatternMatcher::IsKernelSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Auto:
+        case Kernel::Scalar:
+        case Kernel::Horspool:
+            return true;
+        case Kernel::SSE2:
+#if defined(PATTERN_MATCHER_X86)
+            return true;
+#else
+            return false;
+#endif
+        case Kernel::AVX2: {
+            static const bool hasAvx2 = DetectAvx2();
+            return hasAvx2;
+        }
+    }
+    return false;
+}
+
+PatternMatcher::Kernel PatternMatcher::BestKernel() {
+    if (IsKernelSupported(Kernel::AVX2)) return Kernel::AVX2;
+    if (IsKernelSupported(Kernel::SSE2)) return Kernel::SSE2;
+    return Kernel::Scalar;
+}
+
+bool PatternMatcher::MatchesAt(const uint8_t* data) const {
+    for (size_t i = 0; i < m_size; ++i) {
+        if ((data[i] & m_mask[i]) != m_value[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PatternMatcher::FindAll(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                               size_t maxResults, Kernel kernel) const {
+    return Dispatch(data, size, offsets, maxResults, kernel);
+}
+
+size_t PatternMatcher::FindFirst(const uint8_t* data, size_t size, Kernel kernel) const {
+    std::vector<size_t> offsets;
+    Dispatch(data, size, offsets, 1, kernel);
+    return offsets.empty() ? npos : offsets[0];
+}
+
+size_t PatternMatcher::Dispatch(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                size_t maxResults, Kernel kernel) const {
+    if (m_size == 0 || data == nullptr || size < m_size || maxResults == 0) {
+        return 0;
+    }
+
+    // A pattern made only of wildcards matches at every offset
+    if (m_constrainedCount == 0) {
+        size_t count = 0;
+        for (size_t i = 0; i <= size - m_size && count < maxResults; ++i, ++count) {
+            offsets.push_back(i);
+        }
+        return count;
+    }
+
+    if (kernel == Kernel::Auto) {
+        kernel = BestKernel();
+        if (kernel == Kernel::Scalar && m_runLength >= HORSPOOL_MIN_RUN) {
+            kernel = Kernel::Horspool;
+        }
+    } else if (!IsKernelSupported(kernel) || (kernel == Kernel::Horspool && m_runLength == 0)) {
+        kernel = BestKernel();
+    }
+
+    // The SIMD kernels need a fixed or case-folded byte to anchor on
+    if (m_anchorableCount == 0) {
+        kernel = Kernel::Scalar;
+    }
+
+    switch (kernel) {
+        case Kernel::Horspool: return FindHorspool(data, size, offsets, maxResults);
+        case Kernel::AVX2: return FindAVX2(data, size, offsets, maxResults);
+        case Kernel::SSE2: return FindSSE2(data, size, offsets, maxResults);
+        default: return FindScalar(data, size, offsets, maxResults);
+    }
+}
+
+size_t PatternMatcher::FindScalar(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                  size_t maxResults) const {
+    size_t count = 0;
+    for (size_t i = 0; i <= size - m_size; ++i) {
+        if (MatchesAt(data + i)) {
+            offsets.push_back(i);
+            if (++count >= maxResults) break;
+        }
+    }
+    return count;
+}
+
+size_t PatternMatcher::FindHorspool(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                    size_t maxResults) const {
+    const uint8_t* run = m_value.data() + m_runOffset;
+    const size_t runLast = m_runLength - 1;
+    const uint8_t lastByte = run[runLast];
+
+    // pos is where the run would start; the pattern then starts at pos - m_runOffset
+    const size_t lastPos = size - m_size + m_runOffset;
+    size_t count = 0;
+
+    for (size_t pos = m_runOffset; pos <= lastPos; ) {
+        uint8_t tail = data[pos + runLast];
+
+        if (tail == lastByte && memcmp(data + pos, run, runLast) == 0) {
+            size_t start = pos - m_runOffset;
+            if (MatchesAt(data + start)) {
+                offsets.push_back(start);
+                if (++count >= maxResults) break;
+            }
+        }
+
+        pos += m_shift[tail];
+    }
+    return count;
+}
+
+#if defined(PATTERN_MATCHER_X86)
+
+TARGET_SSE2
+bool PatternMatcher::VerifySSE2(const uint8_t* data, size_t available) const {
+    size_t j = 0;
+    for (; j < m_size && j + 16 <= available; j += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j));
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_mask.data() + j));
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_value.data() + j));
+        __m128i eq = _mm_cmpeq_epi8(_mm_and_si128(bytes, mask), value);
+        if (_mm_movemask_epi8(eq) != 0xFFFF) {
+            return false;
+        }
+    }
+
+    // Near the end of the buffer a full vector load would overrun it
+    for (; j < m_size; ++j) {
+        if ((data[j] & m_mask[j]) != m_value[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TARGET_SSE2
+size_t PatternMatcher::FindSSE2(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                size_t maxResults) const {
+    const size_t lastStart = size - m_size;
+    const __m128i anchor1 = _mm_set1_epi8(static_cast<char>(m_value[m_anchor1]));
+    const __m128i anchor2 = _mm_set1_epi8(static_cast<char>(m_value[m_anchor2]));
+    const __m128i fold1 = _mm_set1_epi8(static_cast<char>(m_mask[m_anchor1]));
+    const __m128i fold2 = _mm_set1_epi8(static_cast<char>(m_mask[m_anchor2]));
+    const uint8_t* base1 = data + m_anchor1;
+    const uint8_t* base2 = data + m_anchor2;
+
+    size_t count = 0;
+    size_t i = 0;
+
+    // Each iteration tests 32 start offsets; anchor loads stay below size
+    for (; i + 32 <= lastStart + 1; i += 32) {
+        // Anchor masks are 0xFF, or CASE_FOLD_MASK to fold letters before the compare
+        __m128i lo = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base1 + i)), fold1), anchor1),
+            _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base2 + i)), fold2), anchor2));
+        __m128i hi = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base1 + i + 16)), fold1), anchor1),
+            _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base2 + i + 16)), fold2), anchor2));
+
+        uint64_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(lo)) |
+                              (static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hi))) << 16);
+
+        while (candidates) {
+            size_t pos = i + LowestSetBit(candidates);
+            candidates &= candidates - 1;
+
+            if (VerifySSE2(data + pos, size - pos)) {
+                offsets.push_back(pos);
+                if (++count >= maxResults) return count;
+            }
+        }
+    }
+
+    for (; i <= lastStart; ++i) {
+        if (MatchesAt(data + i)) {
+            offsets.push_back(i);
+            if (++count >= maxResults) break;
+        }
+    }
+    return count;
+}
+
+TARGET_AVX2
+size_t PatternMatcher::FindAVX2(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                size_t maxResults) const {
+    const size_t lastStart = size - m_size;
+    const __m256i anchor1 = _mm256_set1_epi8(static_cast<char>(m_value[m_anchor1]));
+    const __m256i anchor2 = _mm256_set1_epi8(static_cast<char>(m_value[m_anchor2]));
+    const __m256i fold1 = _mm256_set1_epi8(static_cast<char>(m_mask[m_anchor1]));
+    const __m256i fold2 = _mm256_set1_epi8(static_cast<char>(m_mask[m_anchor2]));
+    const uint8_t* base1 = data + m_anchor1;
+    const uint8_t* base2 = data + m_anchor2;
+
+    size_t count = 0;
+    size_t i = 0;
+
+    // Each iteration tests 64 start offsets; anchor loads stay below size
+    for (; i + 64 <= lastStart + 1; i += 64) {
+        __m256i lo = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base1 + i)), fold1), anchor1),
+            _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base2 + i)), fold2), anchor2));
+        __m256i hi = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base1 + i + 32)), fold1), anchor1),
+            _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base2 + i + 32)), fold2), anchor2));
+
+        uint64_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+                              (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+
+        while (candidates) {
+            size_t pos = i + LowestSetBit(candidates);
+            candidates &= candidates - 1;
+
+            if (VerifySSE2(data + pos, size - pos)) {
+                offsets.push_back(pos);
+                if (++count >= maxResults) return count;
+            }
+        }
+    }
+
+    // Finish the tail with the 32-wide kernel
+    if (i <= lastStart) {
+        std::vector<size_t> tail;
+        size_t tailCount = FindSSE2(data + i, size - i, tail, maxResults - count);
+        for (size_t offset : tail) {
+            offsets.push_back(i + offset);
+        }
+        count += tailCount;
+    }
+    return count;
+}
+
+#else
+
+bool PatternMatcher::VerifySSE2(const uint8_t* data, size_t) const {
+    return MatchesAt(data);
+}
+
+size_t PatternMatcher::FindSSE2(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                size_t maxResults) const {
+    return FindScalar(data, size, offsets, maxResults);
+}
+
+size_t PatternMatcher::FindAVX2(const uint8_t* data, size_t size, std::vector<size_t>& offsets,
+                                size_t maxResults) const {
+    return FindScalar(data, size, offsets, maxResults);
+}
+
+#endif
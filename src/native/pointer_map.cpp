@@ -0,0 +1,380 @@
+#include "include/pointer_map.h"
+#include "include/address_space.h"
+#include "include/region_reader.h"
+#include "include/scan_executor.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const size_t POINTER_SIZE = sizeof(uintptr_t);
+
+const uint32_t MAP_MAGIC = 0x4D50484D;   // "MHPM"
+const uint32_t MAP_VERSION = 1;
+
+// A saved map: this header, the region map (see MemoryHelpers::SaveRegions)
+// padded to 8 bytes, the BUCKETS + 1 bucket starts, then the entries
+struct PointerMapHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t processId;
+    uint32_t pointerSize;
+    uint64_t startTime;
+    uint64_t searchStart;
+    uint64_t searchEnd;
+    uint64_t entries;
+    uint64_t regions;
+    uint64_t lowest;
+    uint32_t shift;
+    uint8_t writableOnly;
+    uint8_t moduleImagesOnly;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(PointerMapHeader) == 72, "Saved pointer map layout changed");
+
+// The committed regions merged into disjoint spans, for testing whether a
+// word could be a pointer at all
+class TargetSpans {
+public:
+    explicit TargetSpans(const std::vector<MemoryRegionEx>& regions) {
+        for (const auto& region : regions) {
+            if (!m_ends.empty() && region.startAddress <= m_ends.back()) {
+                m_ends.back() = std::max(m_ends.back(), region.endAddress);
+            } else {
+                m_starts.push_back(region.startAddress);
+                m_ends.push_back(region.endAddress);
+            }
+        }
+        m_low = m_starts.empty() ? 0 : m_starts.front();
+        m_span = m_starts.empty() ? 0 : m_ends.back() - m_low;
+    }
+
+    bool Contains(uintptr_t value) const {
+        // Most words are small numbers or flags and fail the bounds check
+        if (value - m_low >= m_span) return false;
+        size_t next = std::upper_bound(m_starts.begin(), m_starts.end(), value) - m_starts.begin();
+        return next > 0 && value < m_ends[next - 1];
+    }
+
+    uintptr_t Low() const { return m_low; }
+    uintptr_t Span() const { return m_span; }
+
+private:
+    std::vector<uintptr_t> m_starts;
+    std::vector<uintptr_t> m_ends;
+    uintptr_t m_low;
+    uintptr_t m_span;
+};
+
+void ScanPiece(HANDLE processHandle, const ScanRange& piece, const TargetSpans& targets, size_t readerBudget,
+               std::vector<PointerEntry>& out) {
+    RegionReader reader(processHandle, POINTER_SIZE - 1, readerBudget);
+    RegionChunk chunk;
+    if (!reader.Begin(piece.start, piece.size, piece.readAhead)) return;
+
+    while (reader.Next(chunk)) {
+        // Words ending inside the carried bytes were read with the previous chunk
+        size_t i = static_cast<size_t>((POINTER_SIZE - chunk.address % POINTER_SIZE) % POINTER_SIZE);
+        while (i + POINTER_SIZE <= chunk.carried) i += POINTER_SIZE;
+
+        for (; i < chunk.owned && i + POINTER_SIZE <= chunk.size; i += POINTER_SIZE) {
+            uintptr_t value;
+            memcpy(&value, chunk.data + i, POINTER_SIZE);
+            if (targets.Contains(value)) out.push_back({ value, chunk.address + i });
+        }
+    }
+}
+
+// Sorts by value with a parallel least-significant-digit radix sort over
+// value - low. The pieces were scanned in address order and every pass is
+// stable, so entries with equal values stay in address order.
+void SortByValue(std::vector<PointerEntry>& entries, uintptr_t low, uintptr_t span) {
+    static constexpr size_t DIGIT_BITS = 16;
+    static constexpr size_t DIGITS = size_t(1) << DIGIT_BITS;
+
+    ScanExecutor& executor = ScanExecutor::Instance();
+    size_t blocks = std::max<size_t>(1, std::min(executor.Parallelism(), entries.size() / DIGITS));
+    std::vector<size_t> bounds(blocks + 1);
+    for (size_t i = 0; i <= blocks; ++i) bounds[i] = entries.size() * i / blocks;
+
+    std::vector<PointerEntry> buffer(entries.size());
+    std::vector<size_t> offsets(blocks * DIGITS);
+    PointerEntry* from = entries.data();
+    PointerEntry* to = buffer.data();
+
+    for (size_t shift = 0; shift < 8 * POINTER_SIZE && ((span - 1) >> shift) != 0; shift += DIGIT_BITS) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        executor.Run(blocks, [&](size_t block) {
+            size_t* count = &offsets[block * DIGITS];
+            for (size_t i = bounds[block]; i < bounds[block + 1]; ++i) {
+                count[((from[i].value - low) >> shift) & (DIGITS - 1)]++;
+            }
+        });
+
+        // Each block writes its entries of a digit after those of the
+        // blocks before it
+        size_t next = 0;
+        for (size_t digit = 0; digit < DIGITS; ++digit) {
+            for (size_t block = 0; block < blocks; ++block) {
+                size_t count = offsets[block * DIGITS + digit];
+                offsets[block * DIGITS + digit] = next;
+                next += count;
+            }
+        }
+
+        executor.Run(blocks, [&](size_t block) {
+            size_t* offset = &offsets[block * DIGITS];
+            for (size_t i = bounds[block]; i < bounds[block + 1]; ++i) {
+                to[offset[((from[i].value - low) >> shift) & (DIGITS - 1)]++] = from[i];
+            }
+        });
+        std::swap(from, to);
+    }
+
+    if (from != entries.data()) entries.swap(buffer);
+}
+
+inline bool IsWritable(const MemoryRegionEx& region) {
+    return (region.protection & (PAGE_READWRITE | PAGE_EXECUTE_READWRITE)) != 0;
+}
+
+const char* const LOAD_ERROR = "Not a readable pointer map file";
+
+// Smallest shift that puts a spread of values into BUCKETS buckets
+uint32_t BucketShift(uintptr_t spread) {
+    uint32_t shift = 0;
+    while ((spread >> shift) >= PointerMap::BUCKETS) shift++;
+    return shift;
+}
+
+} // namespace
+
+PointerMap::PointerMap()
+    : m_options(), m_process(), m_data(nullptr), m_size(0), m_lowest(0), m_shift(0), m_buckets(nullptr) {
+}
+
+std::unique_ptr<PointerMap> PointerMap::Build(HANDLE processHandle, const PointerMapOptions& options) {
+    std::unique_ptr<PointerMap> map(new PointerMap());
+    map->m_options = options;
+    MemoryHelpers::GetProcessIdentity(processHandle, map->m_process);
+    map->m_regions = MemoryHelpers::GetMemoryRegions(processHandle, false, false);
+
+    // Pointers may point into any committed region but are only looked for
+    // where the options allow
+    TargetSpans targets(map->m_regions);
+    std::unique_ptr<AddressSpace> space;
+    if (options.moduleImagesOnly) space = AddressSpace::Capture(processHandle);
+
+    std::vector<ScanRange> ranges;
+    for (const auto& region : map->m_regions) {
+        if (options.writableOnly && !IsWritable(region)) continue;
+        uintptr_t start = options.searchStart ? std::max(options.searchStart, region.startAddress) : region.startAddress;
+        uintptr_t end = options.searchEnd ? std::min(options.searchEnd, region.endAddress) : region.endAddress;
+        if (start >= end) continue;
+
+        if (space) {
+            space->ImageRanges(start, end, ranges);
+        } else {
+            ranges.push_back({ start, static_cast<size_t>(end - start), 0 });
+        }
+    }
+
+    ScanExecutor& executor = ScanExecutor::Instance();
+    std::vector<ScanRange> pieces = ScanExecutor::SplitRanges(ranges, POINTER_SIZE - 1);
+    std::vector<std::vector<PointerEntry>> found(pieces.size());
+    size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+
+    executor.Run(pieces.size(), [&](size_t index) {
+        ScanPiece(processHandle, pieces[index], targets, readerBudget, found[index]);
+    });
+
+    size_t total = 0;
+    for (const auto& piece : found) total += piece.size();
+    map->m_entries.reserve(total);
+    for (auto& piece : found) {
+        map->m_entries.insert(map->m_entries.end(), piece.begin(), piece.end());
+        std::vector<PointerEntry>().swap(piece);
+    }
+
+    SortByValue(map->m_entries, targets.Low(), targets.Span());
+    map->m_data = map->m_entries.data();
+    map->m_size = map->m_entries.size();
+    map->Index();
+    return map;
+}
+
+void PointerMap::Index() {
+    m_lowest = m_size ? m_data[0].value : 0;
+    uintptr_t spread = m_size ? m_data[m_size - 1].value - m_lowest : 0;
+
+    m_shift = BucketShift(spread);
+
+    m_ownBuckets.assign(BUCKETS + 1, 0);
+    size_t index = 0;
+    for (size_t bucket = 0; bucket <= BUCKETS; ++bucket) {
+        while (index < m_size && Bucket(m_data[index].value) < bucket) index++;
+        m_ownBuckets[bucket] = index;
+    }
+    m_buckets = m_ownBuckets.data();
+}
+
+size_t PointerMap::Bucket(uintptr_t value) const {
+    return static_cast<size_t>((value - m_lowest) >> m_shift);
+}
+
+void PointerMap::Range(uintptr_t low, uintptr_t high, size_t& begin, size_t& end) const {
+    begin = end = 0;
+    if (m_size == 0 || low > high) return;
+
+    uintptr_t highest = m_data[m_size - 1].value;
+    if (high < m_lowest) return;
+    if (low > highest) {
+        begin = end = m_size;
+        return;
+    }
+    low = std::max(low, m_lowest);
+    high = std::min(high, highest);
+
+    const PointerEntry* first = m_data + m_buckets[Bucket(low)];
+    const PointerEntry* last = m_data + m_buckets[Bucket(high) + 1];
+    first = std::lower_bound(first, last, low, [](const PointerEntry& entry, uintptr_t value) {
+        return entry.value < value;
+    });
+    last = std::upper_bound(first, last, high, [](uintptr_t value, const PointerEntry& entry) {
+        return value < entry.value;
+    });
+
+    begin = static_cast<size_t>(first - m_data);
+    end = static_cast<size_t>(last - m_data);
+}
+
+size_t PointerMap::Find(uintptr_t value, std::vector<uintptr_t>& addresses, size_t maxResults) const {
+    size_t begin, end;
+    Range(value, value, begin, end);
+    end = std::min(end, begin + maxResults);
+
+    for (size_t i = begin; i < end; ++i) addresses.push_back(m_data[i].address);
+    return end - begin;
+}
+
+size_t PointerMap::MemoryUsage() const {
+    size_t regions = m_regions.capacity() * sizeof(MemoryRegionEx);
+    for (const auto& region : m_regions) regions += region.moduleName.capacity();
+    return m_entries.capacity() * sizeof(PointerEntry) + m_ownBuckets.capacity() * sizeof(uint64_t) + regions;
+}
+
+bool PointerMap::Save(const std::wstring& path, std::string& error) const {
+    PointerMapHeader header = {};
+    header.magic = MAP_MAGIC;
+    header.version = MAP_VERSION;
+    header.processId = m_process.processId;
+    header.pointerSize = POINTER_SIZE;
+    header.startTime = m_process.startTime;
+    header.searchStart = m_options.searchStart;
+    header.searchEnd = m_options.searchEnd;
+    header.entries = m_size;
+    header.regions = m_regions.size();
+    header.lowest = m_lowest;
+    header.shift = m_shift;
+    header.writableOnly = m_options.writableOnly ? 1 : 0;
+    header.moduleImagesOnly = m_options.moduleImagesOnly ? 1 : 0;
+
+    std::vector<uint8_t> regions;
+    MemoryHelpers::SaveRegions(m_regions, regions);
+
+    FileSaver saver(path);
+    FileWriter& writer = saver.Writer();
+    writer.Write(&header, sizeof(header));
+    writer.Write(regions.data(), regions.size());
+    writer.Pad(8);
+    writer.Write(m_buckets, (BUCKETS + 1) * sizeof(uint64_t));
+    writer.Write(m_data, m_size * sizeof(PointerEntry));
+
+    if (!saver.Commit()) {
+        error = "Could not write the pointer map file";
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<PointerMap> PointerMap::Load(HANDLE processHandle, const std::wstring& path, std::string& error) {
+    std::unique_ptr<PointerMap> map(new PointerMap());
+    PointerMapHeader header;
+    if (!map->m_mapped.Open(path) || map->m_mapped.Size() < sizeof(header)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    const uint8_t* view = map->m_mapped.Data();
+    size_t size = static_cast<size_t>(map->m_mapped.Size());
+    memcpy(&header, view, sizeof(header));
+    if (header.magic != MAP_MAGIC || header.version != MAP_VERSION || header.pointerSize != POINTER_SIZE ||
+        header.shift >= 8 * POINTER_SIZE) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    ProcessIdentity current = {};
+    if (!MemoryHelpers::GetProcessIdentity(processHandle, current) || current.processId != header.processId ||
+        current.startTime != header.startTime) {
+        error = "The pointer map was built from a different process instance";
+        return nullptr;
+    }
+
+    size_t offset = sizeof(header);
+    if (!MemoryHelpers::LoadRegions(view, size, offset, header.regions, map->m_regions)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    // The entries must fill the rest of the file exactly, and the bucket
+    // starts must rise from 0 to their count
+    offset = (offset + 7) & ~static_cast<size_t>(7);
+    size_t bucketBytes = (BUCKETS + 1) * sizeof(uint64_t);
+    if (offset > size || size - offset < bucketBytes ||
+        (size - offset - bucketBytes) / sizeof(PointerEntry) != header.entries ||
+        (size - offset - bucketBytes) % sizeof(PointerEntry) != 0) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    const uint64_t* buckets = reinterpret_cast<const uint64_t*>(view + offset);
+    bool ordered = buckets[0] == 0 && buckets[BUCKETS] == header.entries;
+    for (size_t bucket = 0; bucket < BUCKETS && ordered; ++bucket) ordered = buckets[bucket] <= buckets[bucket + 1];
+    if (!ordered) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    // Lookups index the bucket table with the saved lowest value and shift,
+    // so both must be what Index() derives from the entries, which must be
+    // sorted by value and each lie in its bucket
+    const PointerEntry* entries = reinterpret_cast<const PointerEntry*>(view + offset + bucketBytes);
+    size_t count = static_cast<size_t>(header.entries);
+    uintptr_t lowest = count ? entries[0].value : 0;
+    uintptr_t spread = count ? entries[count - 1].value - lowest : 0;
+    bool indexed = header.lowest == lowest && header.shift == BucketShift(spread);
+    for (size_t i = 0; i < count && indexed; ++i) {
+        size_t bucket = static_cast<size_t>((entries[i].value - lowest) >> header.shift);
+        indexed = (i == 0 || entries[i - 1].value <= entries[i].value) && bucket < BUCKETS &&
+                  buckets[bucket] <= i && i < buckets[bucket + 1];
+    }
+    if (!indexed) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    map->m_options.searchStart = static_cast<uintptr_t>(header.searchStart);
+    map->m_options.searchEnd = static_cast<uintptr_t>(header.searchEnd);
+    map->m_options.writableOnly = header.writableOnly != 0;
+    map->m_options.moduleImagesOnly = header.moduleImagesOnly != 0;
+    map->m_process = current;
+    map->m_buckets = buckets;
+    map->m_data = entries;
+    map->m_size = count;
+    map->m_lowest = lowest;
+    map->m_shift = header.shift;
+    return map;
+}
@@ -0,0 +1,265 @@
+#include "include/pointer_path.h"
+#include "include/scan_executor.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+// Frontier locations looked up per task
+const size_t NODES_PER_TASK = 1024;
+
+// Candidates a task gathers before handing them to the level's pool
+const size_t TASK_BATCH = 64 * 1024;
+
+// A pointer found at address that leads, plus offset, to node child of the
+// level being expanded
+struct Candidate {
+    uintptr_t address;
+    uint32_t child;
+    size_t offset;
+};
+
+inline bool ByAddress(const Candidate& a, const Candidate& b) {
+    return a.address != b.address ? a.address < b.address : a.child < b.child;
+}
+
+// Sorts candidates and keeps those of their lowest MAX_LEVEL_NODES distinct
+// addresses. When some are cut, no address above the highest kept one can
+// make the level, so ceiling is lowered to it; returns whether any were cut.
+bool KeepLowest(std::vector<Candidate>& candidates, std::atomic<uintptr_t>& ceiling) {
+    std::sort(candidates.begin(), candidates.end(), ByAddress);
+
+    size_t distinct = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (i > 0 && candidates[i].address == candidates[i - 1].address) continue;
+        if (distinct++ < PointerPathScanner::MAX_LEVEL_NODES) continue;
+
+        uintptr_t highest = candidates[i - 1].address;
+        candidates.resize(i);
+        ceiling.store(highest, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// The candidates of one level, shared by all of its tasks. Tasks add sorted
+// batches as runs; each time the pool grows by MAX_LEVEL_NODES it is cut
+// back to the lowest MAX_LEVEL_NODES addresses, which are all the level can
+// use, so it never holds more than those, MAX_LEVEL_NODES more and a batch.
+class CandidatePool {
+public:
+    CandidatePool() : m_ceiling(UINTPTR_MAX), m_keepAt(2 * PointerPathScanner::MAX_LEVEL_NODES), m_cut(false) {
+    }
+
+    // Candidates above this can no longer make the level
+    uintptr_t Ceiling() const { return m_ceiling.load(std::memory_order_relaxed); }
+
+    // Sorts batch, moves it into the pool and clears it
+    void Add(std::vector<Candidate>& batch) {
+        std::sort(batch.begin(), batch.end(), ByAddress);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uintptr_t ceiling = Ceiling();
+        auto end = std::upper_bound(batch.begin(), batch.end(), ceiling,
+                                    [](uintptr_t value, const Candidate& c) { return value < c.address; });
+        if (end != batch.begin()) {
+            m_runs.push_back(m_candidates.size());
+            m_candidates.insert(m_candidates.end(), batch.begin(), end);
+        }
+        batch.clear();
+
+        if (m_candidates.size() >= m_keepAt) {
+            if (KeepLowest(m_candidates, m_ceiling)) m_cut = true;
+            m_runs.assign(1, 0);
+            m_keepAt = m_candidates.size() + PointerPathScanner::MAX_LEVEL_NODES;
+        }
+    }
+
+    // Whether candidates were dropped for the cap
+    bool Cut() const { return m_cut; }
+
+    // Once every task is done: the candidates, made of sorted runs
+    // starting at Runs()
+    std::vector<Candidate>& Candidates() { return m_candidates; }
+    const std::vector<size_t>& Runs() const { return m_runs; }
+
+private:
+    std::mutex m_mutex;
+    std::atomic<uintptr_t> m_ceiling;
+    std::vector<Candidate> m_candidates;
+    std::vector<size_t> m_runs;
+    size_t m_keepAt;
+    bool m_cut;
+};
+
+} // namespace
+
+PointerPathScanner::PointerPathScanner(const PointerMap& map, std::vector<ModuleImage> modules)
+    : m_map(map), m_modules(std::move(modules)) {
+}
+
+size_t PointerPathScanner::FindModule(uintptr_t address) const {
+    auto next = std::upper_bound(m_modules.begin(), m_modules.end(), address,
+                                 [](uintptr_t value, const ModuleImage& module) { return value < module.base; });
+    if (next == m_modules.begin()) return SIZE_MAX;
+
+    size_t index = static_cast<size_t>(next - m_modules.begin()) - 1;
+    return address - m_modules[index].base < m_modules[index].size ? index : SIZE_MAX;
+}
+
+bool PointerPathScanner::Expand(std::vector<Level>& levels, size_t maxOffset, bool findBases, bool basesOnly) const {
+    const Level& from = levels.back();
+    size_t nodes = from.addresses.size();
+    size_t tasks = (nodes + NODES_PER_TASK - 1) / NODES_PER_TASK;
+
+    // Each task looks up its share of the frontier, leaving out locations of
+    // earlier levels and any above the pool's ceiling, and hands what it
+    // found to the pool in sorted batches; the runs are then merged pairwise
+    CandidatePool pool;
+    ScanExecutor& executor = ScanExecutor::Instance();
+    executor.Run(tasks, [&](size_t task) {
+        std::vector<Candidate> batch;
+        size_t last = std::min(nodes, (task + 1) * NODES_PER_TASK);
+        for (size_t node = task * NODES_PER_TASK; node < last; ++node) {
+            if (from.isBase[node]) continue;
+
+            uintptr_t address = from.addresses[node];
+            size_t begin, end;
+            m_map.Range(address > maxOffset ? address - maxOffset : 0, address, begin, end);
+            for (size_t i = begin; i < end; ++i) {
+                const PointerEntry& entry = m_map.Entries()[i];
+                if (entry.address > pool.Ceiling()) continue;
+                if (basesOnly && FindModule(entry.address) == SIZE_MAX) continue;
+
+                bool seen = false;
+                for (const Level& earlier : levels) {
+                    if (std::binary_search(earlier.addresses.begin(), earlier.addresses.end(), entry.address)) {
+                        seen = true;
+                        break;
+                    }
+                }
+                if (seen) continue;
+
+                batch.push_back({ entry.address, static_cast<uint32_t>(node), address - entry.value });
+                if (batch.size() >= TASK_BATCH) pool.Add(batch);
+            }
+        }
+        pool.Add(batch);
+    });
+
+    std::vector<Candidate>& candidates = pool.Candidates();
+    std::vector<size_t> bounds = pool.Runs();
+    size_t runs = bounds.size();
+    bounds.push_back(candidates.size());
+    for (size_t width = 1; width < runs; width *= 2) {
+        executor.Run((runs + 2 * width - 1) / (2 * width), [&](size_t merge) {
+            size_t first = merge * 2 * width;
+            size_t middle = std::min(first + width, runs);
+            size_t last = std::min(first + 2 * width, runs);
+            if (middle < last) {
+                std::inplace_merge(candidates.begin() + bounds[first], candidates.begin() + bounds[middle],
+                                   candidates.begin() + bounds[last], ByAddress);
+            }
+        });
+    }
+
+    // One node per new location
+    Level level;
+    bool complete = !pool.Cut();
+    for (size_t i = 0; i < candidates.size();) {
+        uintptr_t address = candidates[i].address;
+        size_t next = i;
+        while (next < candidates.size() && candidates[next].address == address) next++;
+
+        if (level.addresses.size() == MAX_LEVEL_NODES) {
+            complete = false;
+            break;
+        }
+        level.addresses.push_back(address);
+        level.firstEdge.push_back(level.edges.size());
+        level.isBase.push_back(findBases && FindModule(address) != SIZE_MAX);
+        for (size_t j = i; j < next; ++j) level.edges.push_back({ candidates[j].child, candidates[j].offset });
+        i = next;
+    }
+    level.firstEdge.push_back(level.edges.size());
+
+    levels.push_back(std::move(level));
+    return complete;
+}
+
+void PointerPathScanner::CollectPaths(const std::vector<Level>& levels, size_t level, size_t node,
+                                      PointerPath& path, std::vector<PointerPath>& paths, size_t maxPaths) const {
+    if (level == 0) {
+        paths.push_back(path);
+        return;
+    }
+
+    const Level& current = levels[level];
+    for (size_t i = current.firstEdge[node]; i < current.firstEdge[node + 1] && paths.size() < maxPaths; ++i) {
+        path.offsets.push_back(current.edges[i].offset);
+        CollectPaths(levels, level - 1, current.edges[i].child, path, paths, maxPaths);
+        path.offsets.pop_back();
+    }
+}
+
+PointerPathResult PointerPathScanner::Scan(uintptr_t target, const PointerPathOptions& options) const {
+    PointerPathResult result;
+    result.modules = m_modules;
+    result.nodes = 0;
+    result.truncated = false;
+
+    std::vector<Level> levels(1);
+    levels[0].addresses.push_back(target);
+    levels[0].firstEdge.assign(2, 0);
+    levels[0].isBase.push_back(0);
+
+    // Paths found at a level are shorter than any found later, so the search
+    // stops deepening once enough have been collected
+    for (size_t depth = 1; depth <= options.maxDepth && result.paths.size() < options.maxPaths; ++depth) {
+        if (!Expand(levels, options.maxOffset, true, depth == options.maxDepth)) result.truncated = true;
+
+        const Level& level = levels.back();
+        result.nodes += level.addresses.size();
+        for (size_t node = 0; node < level.addresses.size() && result.paths.size() < options.maxPaths; ++node) {
+            if (!level.isBase[node]) continue;
+
+            PointerPath path;
+            path.base = level.addresses[node];
+            path.module = FindModule(path.base);
+            CollectPaths(levels, depth, node, path, result.paths, options.maxPaths);
+        }
+        if (level.addresses.empty()) break;
+    }
+
+    if (result.paths.size() >= options.maxPaths) result.truncated = true;
+    return result;
+}
+
+std::vector<PointerResult> PointerPathScanner::Tree(uintptr_t target, size_t maxDepth,
+                                                    const std::vector<size_t>& maxOffsets, size_t maxResults) const {
+    std::vector<PointerResult> results;
+
+    std::vector<Level> levels(1);
+    levels[0].addresses.push_back(target);
+    levels[0].firstEdge.assign(2, 0);
+    levels[0].isBase.push_back(0);
+
+    for (size_t depth = 1; depth <= maxDepth && results.size() < maxResults; ++depth) {
+        size_t maxOffset = maxOffsets.empty() ? 0 : maxOffsets[std::min(depth, maxOffsets.size()) - 1];
+        Expand(levels, maxOffset, false, false);
+
+        const Level& level = levels.back();
+        const Level& below = levels[depth - 1];
+        for (size_t node = 0; node < level.addresses.size() && results.size() < maxResults; ++node) {
+            for (size_t i = level.firstEdge[node]; i < level.firstEdge[node + 1] && results.size() < maxResults; ++i) {
+                const Edge& edge = level.edges[i];
+                results.push_back({ level.addresses[node], below.addresses[edge.child], edge.offset });
+            }
+        }
+        if (level.addresses.empty()) break;
+    }
+
+    return results;
+}
@@ -0,0 +1,267 @@
+#include "include/pointer_path_set.h"
+#include "include/pointer_reader.h"
+#include "include/mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+const uint32_t SET_MAGIC = 0x5050484D;   // "MHPP"
+const uint32_t SET_VERSION = 1;
+
+// Longer paths are not produced by any scan and mark a damaged file
+const uint64_t MAX_SAVED_DEPTH = 64;
+
+// A saved set: this header, then dataSize bytes of varints. Each module is
+// its name length and name; each path its module, depth, module offset and
+// offsets.
+struct PathSetHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t modules;
+    uint32_t reserved;
+    uint64_t paths;
+    uint64_t dataSize;
+};
+
+static_assert(sizeof(PathSetHeader) == 32, "Saved path set layout changed");
+
+inline void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// False if the varint runs past end or does not fit in 64 bits
+inline bool GetVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Module names compare as Windows compares file names, ignoring ASCII case
+std::string FoldCase(const std::string& name) {
+    std::string folded(name);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return folded;
+}
+
+typedef std::tuple<std::string, uintptr_t, std::vector<size_t>> PathKey;
+
+const char* const LOAD_ERROR = "Not a readable pointer path file";
+
+} // namespace
+
+PointerPathSet::PointerPathSet() {
+}
+
+PointerPathSet::PointerPathSet(const PointerPathResult& result) {
+    for (const PointerPath& path : result.paths) {
+        const ModuleImage& module = result.modules[path.module];
+        Add(module.name, path.base - module.base, path.offsets);
+    }
+}
+
+uint32_t PointerPathSet::ModuleIndex(const std::string& name) {
+    std::string folded = FoldCase(name);
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        if (FoldCase(m_modules[i]) == folded) return static_cast<uint32_t>(i);
+    }
+    m_modules.push_back(name);
+    return static_cast<uint32_t>(m_modules.size() - 1);
+}
+
+bool PointerPathSet::Add(const std::string& module, uintptr_t moduleOffset, const std::vector<size_t>& offsets) {
+    if (offsets.empty()) return false;
+    m_paths.push_back({ ModuleIndex(module), moduleOffset, offsets });
+    return true;
+}
+
+std::vector<uintptr_t> PointerPathSet::Resolve(HANDLE processHandle, const std::vector<ModuleImage>& modules) const {
+    std::vector<uintptr_t> bases(m_modules.size(), 0);
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        std::string folded = FoldCase(m_modules[i]);
+        for (const ModuleImage& module : modules) {
+            if (FoldCase(module.name) == folded) {
+                bases[i] = module.base;
+                break;
+            }
+        }
+    }
+
+    // Every path still being followed reads its next pointer in the same batch
+    std::vector<uintptr_t> ends(m_paths.size(), 0);
+    std::vector<size_t> active;
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        if (bases[m_paths[i].module] == 0) continue;
+        ends[i] = bases[m_paths[i].module] + m_paths[i].moduleOffset;
+        active.push_back(i);
+    }
+
+    PointerReader reader(processHandle);
+    std::vector<uintptr_t> addresses, values;
+    std::vector<uint8_t> valid;
+    for (size_t level = 0; !active.empty(); ++level) {
+        addresses.clear();
+        for (size_t path : active) addresses.push_back(ends[path]);
+        reader.Read(addresses, values, valid);
+
+        size_t kept = 0;
+        for (size_t k = 0; k < active.size(); ++k) {
+            size_t path = active[k];
+            if (!valid[k]) {
+                ends[path] = 0;
+                continue;
+            }
+            ends[path] = values[k] + m_paths[path].offsets[level];
+            if (level + 1 < m_paths[path].offsets.size()) active[kept++] = path;
+        }
+        active.resize(kept);
+    }
+
+    return ends;
+}
+
+void PointerPathSet::Keep(const std::vector<uint8_t>& keep) {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        if (keep[i]) {
+            if (kept != i) m_paths[kept] = std::move(m_paths[i]);
+            kept++;
+        }
+    }
+    m_paths.resize(kept);
+}
+
+size_t PointerPathSet::Validate(HANDLE processHandle, const std::vector<ModuleImage>& modules, uintptr_t target) {
+    std::vector<uintptr_t> ends = Resolve(processHandle, modules);
+    std::vector<uint8_t> keep(m_paths.size());
+    for (size_t i = 0; i < m_paths.size(); ++i) keep[i] = target != 0 && ends[i] == target;
+
+    Keep(keep);
+    return m_paths.size();
+}
+
+size_t PointerPathSet::Intersect(const PointerPathSet& other) {
+    std::vector<PathKey> keys;
+    keys.reserve(other.m_paths.size());
+    for (const StoredPath& path : other.m_paths) {
+        keys.emplace_back(FoldCase(other.m_modules[path.module]), path.moduleOffset, path.offsets);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<std::string> folded(m_modules.size());
+    for (size_t i = 0; i < m_modules.size(); ++i) folded[i] = FoldCase(m_modules[i]);
+
+    std::vector<uint8_t> keep(m_paths.size());
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        const StoredPath& path = m_paths[i];
+        keep[i] = std::binary_search(keys.begin(), keys.end(), PathKey(folded[path.module], path.moduleOffset, path.offsets));
+    }
+
+    Keep(keep);
+    return m_paths.size();
+}
+
+bool PointerPathSet::Save(const std::wstring& path, std::string& error) const {
+    std::vector<uint8_t> data;
+    for (const std::string& module : m_modules) {
+        PutVarint(data, module.size());
+        data.insert(data.end(), module.begin(), module.end());
+    }
+    for (const StoredPath& stored : m_paths) {
+        PutVarint(data, stored.module);
+        PutVarint(data, stored.offsets.size());
+        PutVarint(data, stored.moduleOffset);
+        for (size_t offset : stored.offsets) PutVarint(data, offset);
+    }
+
+    PathSetHeader header = {};
+    header.magic = SET_MAGIC;
+    header.version = SET_VERSION;
+    header.modules = static_cast<uint32_t>(m_modules.size());
+    header.paths = m_paths.size();
+    header.dataSize = data.size();
+
+    FileSaver saver(path);
+    saver.Writer().Write(&header, sizeof(header));
+    saver.Writer().Write(data.data(), data.size());
+    if (!saver.Commit()) {
+        error = "Could not write the pointer path file";
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<PointerPathSet> PointerPathSet::Load(const std::wstring& path, std::string& error) {
+    MappedFile file;
+    PathSetHeader header;
+    if (!file.Open(path) || file.Size() < sizeof(header)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    memcpy(&header, file.Data(), sizeof(header));
+    if (header.magic != SET_MAGIC || header.version != SET_VERSION ||
+        file.Size() - sizeof(header) != header.dataSize) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    std::unique_ptr<PointerPathSet> set(new PointerPathSet());
+    const uint8_t* data = file.Data() + sizeof(header);
+    const uint8_t* end = data + header.dataSize;
+    uint64_t value;
+
+    for (uint32_t i = 0; i < header.modules; ++i) {
+        if (!GetVarint(data, end, value) || value > static_cast<uint64_t>(end - data)) {
+            error = LOAD_ERROR;
+            return nullptr;
+        }
+        set->m_modules.emplace_back(reinterpret_cast<const char*>(data), static_cast<size_t>(value));
+        data += value;
+    }
+
+    // Every path takes at least four bytes, which bounds what the count may claim
+    if (header.paths > static_cast<uint64_t>(end - data) / 4) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+    set->m_paths.reserve(static_cast<size_t>(header.paths));
+    for (uint64_t i = 0; i < header.paths; ++i) {
+        StoredPath stored;
+        uint64_t module, depth, moduleOffset;
+        if (!GetVarint(data, end, module) || module >= header.modules || !GetVarint(data, end, depth) ||
+            depth == 0 || depth > MAX_SAVED_DEPTH || !GetVarint(data, end, moduleOffset)) {
+            error = LOAD_ERROR;
+            return nullptr;
+        }
+        stored.module = static_cast<uint32_t>(module);
+        stored.moduleOffset = static_cast<uintptr_t>(moduleOffset);
+
+        for (uint64_t level = 0; level < depth; ++level) {
+            if (!GetVarint(data, end, value)) {
+                error = LOAD_ERROR;
+                return nullptr;
+            }
+            stored.offsets.push_back(static_cast<size_t>(value));
+        }
+        set->m_paths.push_back(std::move(stored));
+    }
+
+    if (data != end) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+    return set;
+}
@@ -0,0 +1,70 @@
+#include "include/pointer_reader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const size_t POINTER_SIZE = sizeof(uintptr_t);
+
+} // namespace
+
+PointerReader::PointerReader(HANDLE processHandle) : m_processHandle(processHandle), m_calls(0) {
+}
+
+void PointerReader::Read(const std::vector<uintptr_t>& addresses, std::vector<uintptr_t>& values,
+                         std::vector<uint8_t>& valid) {
+    size_t count = addresses.size();
+    values.assign(count, 0);
+    valid.assign(count, 0);
+
+    m_order.resize(count);
+    for (size_t i = 0; i < count; ++i) m_order[i] = i;
+    std::sort(m_order.begin(), m_order.end(), [&](size_t a, size_t b) { return addresses[a] < addresses[b]; });
+
+    for (size_t first = 0; first < count;) {
+        // Grow the span while the next address is near and the span stays small
+        uintptr_t start = addresses[m_order[first]];
+        uintptr_t end = start + POINTER_SIZE;
+        size_t last = first + 1;
+        while (last < count) {
+            uintptr_t next = addresses[m_order[last]];
+            if (next > end + MAX_GAP || next + POINTER_SIZE - start > MAX_SPAN || next + POINTER_SIZE < next) break;
+            end = std::max(end, next + POINTER_SIZE);
+            last++;
+        }
+        if (end < start) {
+            first = last;
+            continue;
+        }
+
+        size_t size = static_cast<size_t>(end - start);
+        m_buffer.resize(size);
+        SIZE_T bytesRead = 0;
+        m_calls++;
+        if (ReadProcessMemory(m_processHandle, reinterpret_cast<LPCVOID>(start), m_buffer.data(), size, &bytesRead) &&
+            bytesRead == size) {
+            for (size_t k = first; k < last; ++k) {
+                size_t index = m_order[k];
+                memcpy(&values[index], m_buffer.data() + (addresses[index] - start), POINTER_SIZE);
+                valid[index] = 1;
+            }
+        } else {
+            // Part of the span is not readable; repeated addresses share a read
+            for (size_t k = first; k < last; ++k) {
+                size_t index = m_order[k];
+                if (k > first && addresses[index] == addresses[m_order[k - 1]]) {
+                    values[index] = values[m_order[k - 1]];
+                    valid[index] = valid[m_order[k - 1]];
+                    continue;
+                }
+
+                bytesRead = 0;
+                m_calls++;
+                valid[index] = ReadProcessMemory(m_processHandle, reinterpret_cast<LPCVOID>(addresses[index]),
+                                                 &values[index], POINTER_SIZE, &bytesRead) && bytesRead == POINTER_SIZE;
+                if (!valid[index]) values[index] = 0;
+            }
+        }
+        first = last;
+    }
+}
@@ -0,0 +1,104 @@
+#include "include/region_reader.h"
+#include "include/error_handler.h"
+#include <algorithm>
+#include <cstring>
+
+std::atomic<size_t> RegionReader::s_memoryBudget(RegionReader::DEFAULT_MEMORY_BUDGET);
+
+RegionReader::RegionReader(HANDLE processHandle, size_t overlap, size_t memoryBudget)
+    : m_processHandle(processHandle), m_overlap(overlap), m_cursor(0), m_end(0), m_ownedEnd(0),
+      m_failedReads(0), m_successfulReads(0), m_bufferUsed(0) {
+    // The carried tail comes out of the same budget as the fresh bytes
+    size_t budget = memoryBudget ? memoryBudget : s_memoryBudget.load();
+    size_t available = budget > overlap ? budget - overlap : 0;
+    m_maxChunkSize = std::max(PAGE_GRANULARITY, available & ~(PAGE_GRANULARITY - 1));
+    m_chunkSize = std::min(MIN_CHUNK_SIZE, m_maxChunkSize);
+}
+
+size_t RegionReader::SetMemoryBudget(size_t bytes) {
+    size_t budget = std::max(bytes, MIN_MEMORY_BUDGET);
+    s_memoryBudget.store(budget);
+    return budget;
+}
+
+size_t RegionReader::MemoryBudget() {
+    return s_memoryBudget.load();
+}
+
+bool RegionReader::Begin(uintptr_t start, size_t size, size_t readAhead) {
+    m_cursor = start;
+    m_end = start;
+    m_ownedEnd = start;
+    m_chunkSize = std::min(MIN_CHUNK_SIZE, m_maxChunkSize);
+    m_bufferUsed = 0;
+
+    if (size == 0) {
+        return false;
+    }
+
+    if (!ErrorHandler::isAddressAccessible(m_processHandle, reinterpret_cast<LPCVOID>(start), size + readAhead)) {
+        m_failedReads++;
+        return false;
+    }
+
+    m_end = start + size + readAhead;
+    m_ownedEnd = start + size;
+    return true;
+}
+
+bool RegionReader::Next(RegionChunk& chunk) {
+    while (m_cursor < m_end) {
+        // Move the tail of the previous chunk to the front of the buffer
+        size_t carry = std::min(m_overlap, m_bufferUsed);
+        if (carry > 0 && carry < m_bufferUsed) {
+            memmove(m_buffer.data(), m_buffer.data() + m_bufferUsed - carry, carry);
+        }
+
+        size_t readSize = static_cast<size_t>(std::min<uintptr_t>(m_chunkSize, m_end - m_cursor));
+        if (m_buffer.size() < carry + readSize) {
+            m_buffer.resize(carry + readSize);
+        }
+
+        SIZE_T bytesRead = 0;
+        BOOL result = ReadProcessMemory(m_processHandle, reinterpret_cast<LPCVOID>(m_cursor),
+                                        m_buffer.data() + carry, readSize, &bytesRead);
+
+        if (!result && bytesRead == 0) {
+            m_failedReads++;
+
+            // Retry the same address with a smaller read; the carried tail stays valid
+            if (readSize > PAGE_GRANULARITY) {
+                m_chunkSize = std::max(PAGE_GRANULARITY, (readSize / 2) & ~(PAGE_GRANULARITY - 1));
+                m_bufferUsed = carry;
+                continue;
+            }
+
+            // Skip the unreadable page; the tail no longer borders the next readable byte
+            m_cursor = (m_cursor + PAGE_GRANULARITY) & ~static_cast<uintptr_t>(PAGE_GRANULARITY - 1);
+            m_bufferUsed = 0;
+            continue;
+        }
+
+        m_successfulReads++;
+
+        chunk.address = m_cursor - carry;
+        chunk.data = m_buffer.data();
+        chunk.size = carry + bytesRead;
+        chunk.carried = carry;
+        chunk.owned = chunk.address < m_ownedEnd
+            ? static_cast<size_t>(std::min<uintptr_t>(chunk.size, m_ownedEnd - chunk.address)) : 0;
+
+        m_cursor += bytesRead;
+        m_bufferUsed = chunk.size;
+        chunk.last = m_cursor >= m_end;
+
+        // Grow reads while the target keeps serving them in full
+        if (result && bytesRead == readSize && m_chunkSize < m_maxChunkSize) {
+            m_chunkSize = std::min(m_chunkSize * 2, m_maxChunkSize);
+        }
+
+        return true;
+    }
+
+    return false;
+}
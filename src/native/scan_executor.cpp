@@ -0,0 +1,223 @@
+#include "include/scan_executor.h"
+
+namespace {
+    // Set while a thread is executing a task, so nested Run calls go inline
+    thread_local bool t_insideTask = false;
+}
+
+ScanExecutor& ScanExecutor::Instance() {
+    static ScanExecutor instance;
+    return instance;
+}
+
+ScanExecutor::ScanExecutor()
+    : m_generation(0), m_stopping(false), m_remaining(0), m_task(nullptr), m_parallelism(1) {
+    StartWorkers(0);
+}
+
+ScanExecutor::~ScanExecutor() {
+    StopWorkers();
+}
+
+size_t ScanExecutor::SetParallelism(size_t threads) {
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    StopWorkers();
+    StartWorkers(threads);
+    return m_parallelism.load();
+}
+
+size_t ScanExecutor::Parallelism() const {
+    return m_parallelism.load();
+}
+
+void ScanExecutor::StartWorkers(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    m_stopping = false;
+    m_queues.clear();
+    for (size_t i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    // Worker 0 is whichever thread calls Run
+    for (size_t i = 1; i < threads; ++i) {
+        m_threads.emplace_back(&ScanExecutor::WorkerLoop, this, i);
+    }
+
+    m_parallelism.store(threads);
+}
+
+void ScanExecutor::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_threads.clear();
+}
+
+void ScanExecutor::Run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    if (t_insideTask || count == 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    size_t workers = m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_task = &task;
+        m_error = nullptr;
+        m_remaining.store(count);
+    }
+
+    // Contiguous blocks keep each worker on neighbouring addresses
+    for (size_t worker = 0; worker < workers; ++worker) {
+        size_t first = count * worker / workers;
+        size_t last = count * (worker + 1) / workers;
+
+        std::lock_guard<std::mutex> queueLock(m_queues[worker]->mutex);
+        for (size_t i = first; i < last; ++i) {
+            m_queues[worker]->tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    Drain(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_stateMutex);
+        m_done.wait(lock, [this] { return m_remaining.load() == 0; });
+        m_task = nullptr;
+        error = m_error;
+        m_error = nullptr;
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+void ScanExecutor::WorkerLoop(size_t worker) {
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_stateMutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) return;
+            seenGeneration = m_generation;
+        }
+
+        Drain(worker);
+    }
+}
+
+void ScanExecutor::Drain(size_t worker) {
+    size_t task;
+
+    while (TakeTask(worker, task)) {
+        const std::function<void(size_t)>* current;
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            current = m_task;
+        }
+
+        t_insideTask = true;
+        try {
+            (*current)(task);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            if (!m_error) m_error = std::current_exception();
+        }
+        t_insideTask = false;
+
+        if (m_remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+bool ScanExecutor::TakeTask(size_t worker, size_t& task) {
+    {
+        WorkQueue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the far end of a victim's queue
+    size_t workers = m_queues.size();
+    for (size_t i = 1; i < workers; ++i) {
+        WorkQueue& victim = *m_queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<ScanRange> ScanExecutor::SplitRanges(const std::vector<ScanRange>& ranges, size_t overlap,
+                                                 size_t splitSize) {
+    std::vector<ScanRange> pieces;
+    splitSize = std::max<size_t>(splitSize, 1);
+
+    for (const auto& range : ranges) {
+        uintptr_t rangeEnd = range.start + range.size + range.readAhead;
+
+        for (size_t offset = 0; offset < range.size; offset += splitSize) {
+            ScanRange piece;
+            piece.start = range.start + offset;
+            piece.size = std::min(splitSize, range.size - offset);
+
+            uintptr_t pieceEnd = piece.start + piece.size;
+            piece.readAhead = static_cast<size_t>(std::min<uintptr_t>(overlap, rangeEnd - pieceEnd));
+            pieces.push_back(piece);
+        }
+    }
+
+    return pieces;
+}
+
+ResultCutoff::ResultCutoff(size_t taskCount, size_t maxResults)
+    : m_counts(taskCount, 0), m_completed(taskCount, false), m_prefix(0), m_prefixResults(0),
+      m_maxResults(maxResults), m_cutoff(static_cast<size_t>(-1)) {
+}
+
+void ResultCutoff::Complete(size_t task, size_t resultCount) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts[task] = resultCount;
+    m_completed[task] = true;
+
+    while (m_prefix < m_completed.size() && m_completed[m_prefix]) {
+        m_prefixResults += m_counts[m_prefix];
+        if (m_prefixResults >= m_maxResults) {
+            m_cutoff.store(m_prefix);
+            m_prefix = m_completed.size();
+            break;
+        }
+        m_prefix++;
+    }
+}
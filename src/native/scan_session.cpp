@@ -0,0 +1,1126 @@
+#include "include/scan_session.h"
+#include "include/address_space.h"
+#include "include/memory_helpers.h"
+#include "include/region_reader.h"
+#include "include/scan_executor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+const size_t PAGE_SIZE = RegionReader::PAGE_GRANULARITY;
+
+template <typename T>
+inline T Load(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Integer arithmetic wraps like the target's own counters would
+template <typename T>
+inline T Add(T a, T b, std::false_type) {
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    return static_cast<T>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b));
+}
+
+template <typename T>
+inline T Add(T a, T b, std::true_type) {
+    return a + b;
+}
+
+template <typename T>
+inline T Sub(T a, T b, std::false_type) {
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    return static_cast<T>(static_cast<Unsigned>(a) - static_cast<Unsigned>(b));
+}
+
+template <typename T>
+inline T Sub(T a, T b, std::true_type) {
+    return a - b;
+}
+
+template <typename T>
+inline bool Near(T a, T b, double, std::false_type) {
+    return a == b;
+}
+
+template <typename T>
+inline bool Near(T a, T b, double tolerance, std::true_type) {
+    return std::abs(static_cast<double>(a) - static_cast<double>(b)) <= tolerance;
+}
+
+template <typename T>
+class Predicate {
+public:
+    typedef typename std::is_floating_point<T>::type IsFloat;
+
+    Predicate(ScanCompare compare, const ScanParams& params)
+        : m_compare(compare), m_tolerance(params.tolerance) {
+        m_value = Convert(params.value, params.intValue, IsFloat());
+        m_value2 = Convert(params.value2, params.intValue2, IsFloat());
+    }
+
+    bool operator()(T current, T previous) const {
+        switch (m_compare) {
+            case ScanCompare::Unknown:     return Test<ScanCompare::Unknown>(current, previous);
+            case ScanCompare::Equal:       return Test<ScanCompare::Equal>(current, previous);
+            case ScanCompare::NotEqual:    return Test<ScanCompare::NotEqual>(current, previous);
+            case ScanCompare::Range:       return Test<ScanCompare::Range>(current, previous);
+            case ScanCompare::Rounded:     return Test<ScanCompare::Rounded>(current, previous);
+            case ScanCompare::Ulps:        return Test<ScanCompare::Ulps>(current, previous);
+            case ScanCompare::Truncated:   return Test<ScanCompare::Truncated>(current, previous);
+            case ScanCompare::Changed:     return Test<ScanCompare::Changed>(current, previous);
+            case ScanCompare::Unchanged:   return Test<ScanCompare::Unchanged>(current, previous);
+            case ScanCompare::Increased:   return Test<ScanCompare::Increased>(current, previous);
+            case ScanCompare::Decreased:   return Test<ScanCompare::Decreased>(current, previous);
+            case ScanCompare::IncreasedBy: return Test<ScanCompare::IncreasedBy>(current, previous);
+            case ScanCompare::DecreasedBy: return Test<ScanCompare::DecreasedBy>(current, previous);
+        }
+        return false;
+    }
+
+    // The compare fixed at compile time, for loops over many candidates
+    template <ScanCompare Compare>
+    bool Test(T current, T previous) const {
+        switch (Compare) {
+            case ScanCompare::Unknown:     return true;
+            case ScanCompare::Equal:       return Near(current, m_value, m_tolerance, IsFloat());
+            case ScanCompare::NotEqual:    return !Near(current, m_value, m_tolerance, IsFloat());
+            case ScanCompare::Range:       return current >= m_value && current <= m_value2;
+            // Always run on ValueScanner; see ToValueQuery
+            case ScanCompare::Rounded:
+            case ScanCompare::Ulps:
+            case ScanCompare::Truncated:   return false;
+            case ScanCompare::Changed:     return memcmp(&current, &previous, sizeof(T)) != 0;
+            case ScanCompare::Unchanged:   return memcmp(&current, &previous, sizeof(T)) == 0;
+            case ScanCompare::Increased:   return current > previous;
+            case ScanCompare::Decreased:   return current < previous;
+            case ScanCompare::IncreasedBy: return Near(current, Add(previous, m_value, IsFloat()), m_tolerance, IsFloat());
+            case ScanCompare::DecreasedBy: return Near(current, Sub(previous, m_value, IsFloat()), m_tolerance, IsFloat());
+        }
+        return false;
+    }
+
+    ScanCompare Compare() const { return m_compare; }
+
+private:
+    static T Convert(double value, int64_t, std::true_type) { return static_cast<T>(value); }
+    static T Convert(double, int64_t value, std::false_type) { return static_cast<T>(value); }
+
+    ScanCompare m_compare;
+    double m_tolerance;
+    T m_value;
+    T m_value2;
+};
+
+inline size_t VarintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+inline void PutVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// False if the varint runs past end or does not fit in 32 bits
+inline bool GetVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 32 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline unsigned LowestBit(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+inline unsigned HighestBit(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(bits));
+#endif
+}
+
+// Calls visit(index) for every set bit of a bitmap, in order
+template <typename Visitor>
+void ForEachBit(const uint8_t* bits, size_t bytes, Visitor&& visit) {
+    for (size_t byteIndex = 0; byteIndex < bytes; ++byteIndex) {
+        for (uint32_t byte = bits[byteIndex]; byte; byte &= byte - 1) {
+            visit(static_cast<uint32_t>(byteIndex * 8 + LowestBit(byte)));
+        }
+    }
+}
+
+// Whether any bit in [from, to] is set
+inline bool AnyBitSet(const uint8_t* bits, size_t from, size_t to) {
+    if (from > to) return false;
+    size_t firstByte = from / 8, lastByte = to / 8;
+    uint32_t head = bits[firstByte] & (0xFFu << (from % 8));
+    if (firstByte == lastByte) return (head & (0xFFu >> (7 - to % 8))) != 0;
+    if (head) return true;
+    for (size_t i = firstByte + 1; i < lastByte; ++i) {
+        if (bits[i]) return true;
+    }
+    return (bits[lastByte] & (0xFFu >> (7 - to % 8))) != 0;
+}
+
+const size_t MAX_SPAN_PAGES = ScanSession::BLOCK_SIZE / PAGE_SIZE + 2;
+static_assert(MAX_SPAN_PAGES < 32, "A dense block's pages must fit in keptPages");
+
+// Locates values inside a dense block, whose dropped pages are left out
+class DensePages {
+public:
+    DensePages(const CandidateBlock& block, size_t step, size_t width)
+        : m_values(block.values.data()) {
+        m_start = block.base + static_cast<uintptr_t>(block.firstSlot) * step;
+        m_end = block.base + static_cast<uintptr_t>(block.lastSlot) * step + width;
+        m_firstPage = m_start / PAGE_SIZE;
+        m_pages = static_cast<size_t>((m_end - 1) / PAGE_SIZE - m_firstPage) + 1;
+
+        size_t skipped = 0;
+        for (size_t page = 0; page < m_pages; ++page) {
+            m_skipped[page] = skipped;
+            if (!(block.keptPages & (1u << page))) {
+                uintptr_t pageStart = std::max(m_start, (m_firstPage + page) * PAGE_SIZE);
+                uintptr_t pageEnd = std::min(m_end, (m_firstPage + page + 1) * PAGE_SIZE);
+                skipped += static_cast<size_t>(pageEnd - pageStart);
+            }
+        }
+        m_keptBytes = static_cast<size_t>(m_end - m_start) - skipped;
+    }
+
+    size_t Pages() const { return m_pages; }
+    // Size of the values the kept pages make up
+    size_t KeptBytes() const { return m_keptBytes; }
+
+    // Copies the kept pages back to their place in a span-sized buffer
+    void Expand(const CandidateBlock& block, uint8_t* span) const {
+        const uint8_t* from = m_values;
+        for (size_t page = 0; page < m_pages; ++page) {
+            if (!(block.keptPages & (1u << page))) continue;
+            uintptr_t pageStart = std::max(m_start, (m_firstPage + page) * PAGE_SIZE);
+            uintptr_t pageEnd = std::min(m_end, (m_firstPage + page + 1) * PAGE_SIZE);
+            memcpy(span + (pageStart - m_start), from, static_cast<size_t>(pageEnd - pageStart));
+            from += pageEnd - pageStart;
+        }
+    }
+
+    // A value straddling two pages stays contiguous: both pages are kept
+    const uint8_t* Value(uintptr_t address) const {
+        return m_values + (address - m_start) - m_skipped[address / PAGE_SIZE - m_firstPage];
+    }
+
+private:
+    const uint8_t* m_values;
+    uintptr_t m_start;
+    uintptr_t m_end;
+    uintptr_t m_firstPage;
+    size_t m_pages;
+    size_t m_keptBytes;
+    size_t m_skipped[MAX_SPAN_PAGES];
+};
+
+// Calls visit(slot, value) for every candidate of a block, in slot order
+template <typename Visitor>
+void ForEachCandidate(const CandidateBlock& block, size_t step, size_t width, Visitor&& visit) {
+    switch (block.layout) {
+        case CandidateLayout::Full:
+            for (uint32_t slot = block.firstSlot; slot <= block.lastSlot; ++slot) {
+                visit(slot, block.values.data() + static_cast<size_t>(slot - block.firstSlot) * step);
+            }
+            break;
+
+        case CandidateLayout::Dense: {
+            DensePages pages(block, step, width);
+            ForEachBit(block.slots.data(), block.slots.size(), [&](uint32_t relative) {
+                uint32_t slot = block.firstSlot + relative;
+                visit(slot, pages.Value(block.base + static_cast<uintptr_t>(slot) * step));
+            });
+            break;
+        }
+
+        case CandidateLayout::Sparse: {
+            const uint8_t* gaps = block.slots.data();
+            const uint8_t* end = gaps + block.slots.size();
+            uint32_t slot = 0;
+            uint32_t gap;
+            for (uint32_t i = 0; i < block.count && GetVarint(gaps, end, gap); ++i) {
+                slot += gap;
+                visit(slot, block.values.data() + i * width);
+            }
+            break;
+        }
+    }
+}
+
+// Stores the candidates marked in bits (slot origin + index) in the smallest
+// layout. raw holds the memory from slot origin onwards.
+void EncodeBlock(uintptr_t base, uint32_t origin, const std::vector<uint8_t>& bits, size_t count,
+                 const uint8_t* raw, size_t step, size_t width, std::vector<CandidateBlock>& out) {
+    if (count == 0) return;
+
+    size_t firstByte = 0;
+    while (!bits[firstByte]) firstByte++;
+    size_t lastByte = bits.size() - 1;
+    while (!bits[lastByte]) lastByte--;
+    uint32_t first = static_cast<uint32_t>(firstByte * 8 + LowestBit(bits[firstByte]));
+    uint32_t last = static_cast<uint32_t>(lastByte * 8 + HighestBit(bits[lastByte]));
+
+    CandidateBlock block;
+    block.base = base;
+    block.count = static_cast<uint32_t>(count);
+    block.lastSlot = origin + last;
+    block.keptPages = 0;
+
+    if (count == static_cast<size_t>(last - first) + 1) {
+        block.layout = CandidateLayout::Full;
+        block.firstSlot = origin + first;
+        block.values.assign(raw + static_cast<size_t>(first) * step, raw + static_cast<size_t>(last) * step + width);
+        out.push_back(std::move(block));
+        return;
+    }
+
+    // Pages of the dense span that hold at least one byte of a candidate
+    uint32_t denseOrigin = static_cast<uint32_t>(firstByte * 8);
+    uintptr_t spanStart = base + static_cast<uintptr_t>(origin + denseOrigin) * step;
+    uintptr_t spanEnd = base + static_cast<uintptr_t>(origin + last) * step + width;
+    uintptr_t firstPage = spanStart / PAGE_SIZE;
+    uint32_t kept = 0;
+    for (uintptr_t page = firstPage; page <= (spanEnd - 1) / PAGE_SIZE; ++page) {
+        // Slots whose value has a byte in this page
+        uintptr_t pageStart = page * PAGE_SIZE;
+        size_t from = pageStart > spanStart + width - 1
+            ? static_cast<size_t>((pageStart - (width - 1) - spanStart + step - 1) / step) : 0;
+        size_t to = static_cast<size_t>((std::min(spanEnd, pageStart + PAGE_SIZE) - 1 - spanStart) / step);
+        if (AnyBitSet(bits.data() + firstByte, from, std::min(to, static_cast<size_t>(last - denseOrigin)))) {
+            kept |= 1u << (page - firstPage);
+        }
+    }
+
+    size_t denseSize = lastByte - firstByte + 1;
+    for (uintptr_t page = firstPage; page <= (spanEnd - 1) / PAGE_SIZE; ++page) {
+        if (kept & (1u << (page - firstPage))) {
+            denseSize += static_cast<size_t>(std::min(spanEnd, (page + 1) * PAGE_SIZE) - std::max(spanStart, page * PAGE_SIZE));
+        }
+    }
+
+    size_t sparseSize = count * width;
+    if (sparseSize < denseSize) {
+        uint32_t previous = 0;
+        ForEachBit(bits.data(), bits.size(), [&](uint32_t relative) {
+            sparseSize += VarintSize(origin + relative - previous);
+            previous = origin + relative;
+        });
+    }
+
+    if (sparseSize < denseSize) {
+        block.layout = CandidateLayout::Sparse;
+        block.firstSlot = origin + first;
+        block.values.reserve(count * width);
+        uint32_t previous = 0;
+        ForEachBit(bits.data(), bits.size(), [&](uint32_t relative) {
+            PutVarint(block.slots, origin + relative - previous);
+            previous = origin + relative;
+            const uint8_t* value = raw + static_cast<size_t>(relative) * step;
+            block.values.insert(block.values.end(), value, value + width);
+        });
+    } else {
+        block.layout = CandidateLayout::Dense;
+        block.firstSlot = origin + denseOrigin;
+        block.keptPages = kept;
+        block.slots.assign(bits.begin() + firstByte, bits.begin() + lastByte + 1);
+        block.values.reserve(denseSize - block.slots.size());
+
+        uintptr_t rawStart = base + static_cast<uintptr_t>(origin) * step;
+        for (uintptr_t page = firstPage; page <= (spanEnd - 1) / PAGE_SIZE; ++page) {
+            if (!(kept & (1u << (page - firstPage)))) continue;
+            uintptr_t from = std::max(spanStart, page * PAGE_SIZE);
+            uintptr_t to = std::min(spanEnd, (page + 1) * PAGE_SIZE);
+            block.values.insert(block.values.end(), raw + (from - rawStart), raw + (to - rawStart));
+        }
+    }
+
+    out.push_back(std::move(block));
+}
+
+// Collects the survivors of a scan in slot order for one block
+class BlockBuilder {
+public:
+    BlockBuilder(size_t step, size_t width) : m_step(step), m_width(width), m_base(0) {}
+
+    void Begin(uintptr_t base) {
+        m_base = base;
+        m_slots.clear();
+        m_values.clear();
+    }
+
+    uintptr_t Base() const { return m_base; }
+    bool Empty() const { return m_slots.empty(); }
+
+    void Add(uint32_t slot, const uint8_t* value) {
+        m_slots.push_back(slot);
+        m_values.insert(m_values.end(), value, value + m_width);
+    }
+
+    void Finish(std::vector<CandidateBlock>& out) {
+        if (m_slots.empty()) return;
+
+        size_t sparseSize = m_values.size();
+        uint32_t previous = 0;
+        for (uint32_t slot : m_slots) {
+            sparseSize += VarintSize(slot - previous);
+            previous = slot;
+        }
+
+        uint32_t first = m_slots.front();
+        size_t spanSlots = m_slots.back() - first + 1;
+        size_t denseBound = (spanSlots + 7) / 8 + (spanSlots - 1) * m_step + m_width;
+
+        if (sparseSize <= denseBound) {
+            CandidateBlock block;
+            block.base = m_base;
+            block.count = static_cast<uint32_t>(m_slots.size());
+            block.firstSlot = first;
+            block.lastSlot = m_slots.back();
+            block.keptPages = 0;
+            block.layout = CandidateLayout::Sparse;
+            previous = 0;
+            for (uint32_t slot : m_slots) {
+                PutVarint(block.slots, slot - previous);
+                previous = slot;
+            }
+            block.values = m_values;
+            out.push_back(std::move(block));
+        } else {
+            // Crowded: lay the values back out as memory; bytes between them
+            // stay zero and are never read
+            std::vector<uint8_t> bits((spanSlots + 7) / 8, 0);
+            std::vector<uint8_t> raw((spanSlots - 1) * m_step + m_width, 0);
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                uint32_t relative = m_slots[i] - first;
+                bits[relative / 8] |= static_cast<uint8_t>(1u << (relative % 8));
+                memcpy(raw.data() + relative * m_step, m_values.data() + i * m_width, m_width);
+            }
+            EncodeBlock(m_base, first, bits, m_slots.size(), raw.data(), m_step, m_width, out);
+        }
+
+        m_slots.clear();
+        m_values.clear();
+    }
+
+private:
+    size_t m_step;
+    size_t m_width;
+    uintptr_t m_base;
+    std::vector<uint32_t> m_slots;
+    std::vector<uint8_t> m_values;
+};
+
+inline uintptr_t AlignUp(uintptr_t address, size_t alignment) {
+    uintptr_t misalignment = address % alignment;
+    return misalignment ? address + (alignment - misalignment) : address;
+}
+
+// Reads [address, address + size); pages that cannot be read are marked in
+// pageValid (indexed from the page holding address) and left zeroed
+void ReadCandidates(HANDLE processHandle, uintptr_t address, size_t size, std::vector<uint8_t>& buffer,
+                    std::vector<uint8_t>& pageValid) {
+    uintptr_t firstPage = address & ~static_cast<uintptr_t>(PAGE_SIZE - 1);
+    size_t pages = static_cast<size_t>((address + size - 1 - firstPage) / PAGE_SIZE) + 1;
+    buffer.assign(size, 0);
+    pageValid.assign(pages, 1);
+
+    SIZE_T bytesRead = 0;
+    if (ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(address), buffer.data(), size, &bytesRead) &&
+        bytesRead == size) {
+        return;
+    }
+
+    // Part of the span was freed or protected since the last scan
+    for (size_t page = 0; page < pages; ++page) {
+        uintptr_t start = std::max(address, firstPage + page * PAGE_SIZE);
+        uintptr_t end = std::min(address + size, firstPage + (page + 1) * PAGE_SIZE);
+        bytesRead = 0;
+        if (!ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(start), buffer.data() + (start - address),
+                               static_cast<SIZE_T>(end - start), &bytesRead) || bytesRead != end - start) {
+            pageValid[page] = 0;
+        }
+    }
+}
+
+// Unknown initial value: every slot of the piece becomes a candidate, and
+// the memory read becomes the snapshot later scans compare against
+void SnapshotPiece(HANDLE processHandle, const ScanRange& piece, size_t step, size_t width,
+                   std::vector<CandidateBlock>& out) {
+    uintptr_t pieceEnd = piece.start + piece.size;
+    uintptr_t readLimit = pieceEnd + piece.readAhead;
+    std::vector<uint8_t> buffer, pageValid, bits;
+
+    for (uintptr_t key = piece.start & ~static_cast<uintptr_t>(ScanSession::BLOCK_SIZE - 1); key < pieceEnd;
+         key += ScanSession::BLOCK_SIZE) {
+        uintptr_t base = AlignUp(std::max(key, piece.start), step);
+        uintptr_t ownedEnd = std::min(key + ScanSession::BLOCK_SIZE, pieceEnd);
+        if (base >= ownedEnd || base + width > readLimit) continue;
+
+        size_t slots = static_cast<size_t>((std::min(ownedEnd - 1, readLimit - width) - base) / step) + 1;
+        size_t size = (slots - 1) * step + width;
+        ReadCandidates(processHandle, base, size, buffer, pageValid);
+
+        size_t count = 0;
+        bits.assign((slots + 7) / 8, 0);
+        if (std::find(pageValid.begin(), pageValid.end(), 0) == pageValid.end()) {
+            std::fill(bits.begin(), bits.end(), 0xFF);
+            if (slots % 8) bits.back() = static_cast<uint8_t>((1u << (slots % 8)) - 1);
+            count = slots;
+        } else {
+            uintptr_t firstPage = base / PAGE_SIZE;
+            for (size_t slot = 0; slot < slots; ++slot) {
+                uintptr_t address = base + slot * step;
+                if (pageValid[address / PAGE_SIZE - firstPage] && pageValid[(address + width - 1) / PAGE_SIZE - firstPage]) {
+                    bits[slot / 8] |= static_cast<uint8_t>(1u << (slot % 8));
+                    count++;
+                }
+            }
+        }
+
+        EncodeBlock(base, 0, bits, count, buffer.data(), step, width, out);
+    }
+}
+
+// Scans one piece of a region for the first scan
+template <typename T>
+void ScanPiece(HANDLE processHandle, const ScanRange& piece, size_t step, ScanCompare compare,
+               const ScanParams& params, const ValueScanner* scanner, size_t readerBudget,
+               std::vector<CandidateBlock>& out) {
+    Predicate<T> predicate(compare, params);
+    BlockBuilder builder(step, sizeof(T));
+    uintptr_t blockKey = 0;
+    std::vector<size_t> offsets;
+
+    RegionReader reader(processHandle, sizeof(T) - 1, readerBudget);
+    RegionChunk chunk;
+    if (!reader.Begin(piece.start, piece.size, piece.readAhead)) return;
+
+    auto keep = [&](size_t i) {
+        uintptr_t address = chunk.address + i;
+        uintptr_t key = address & ~static_cast<uintptr_t>(ScanSession::BLOCK_SIZE - 1);
+        if (builder.Empty() || key != blockKey) {
+            builder.Finish(out);
+            blockKey = key;
+            builder.Begin(AlignUp(std::max(key, piece.start), step));
+        }
+        builder.Add(static_cast<uint32_t>((address - builder.Base()) / step), chunk.data + i);
+    };
+
+    while (reader.Next(chunk)) {
+        if (scanner) {
+            // Values wholly inside the carried bytes were tested with the previous chunk
+            size_t from = chunk.carried >= sizeof(T) ? chunk.carried - sizeof(T) + 1 : 0;
+            offsets.clear();
+            scanner->FindAll(chunk.data, chunk.size, chunk.address, from, chunk.owned, offsets, SIZE_MAX);
+            for (size_t i : offsets) keep(i);
+            continue;
+        }
+
+        size_t i = static_cast<size_t>(AlignUp(chunk.address, step) - chunk.address);
+        for (; i < chunk.owned && i + sizeof(T) <= chunk.size; i += step) {
+            if (i + sizeof(T) <= chunk.carried) continue;
+            if (predicate(Load<T>(chunk.data + i), Load<T>(chunk.data + i))) keep(i);
+        }
+    }
+
+    builder.Finish(out);
+}
+
+// Tests the slots marked in candidates, reading slot i at i * step of both
+// spans, and marks the ones that pass in survivors
+template <typename T, ScanCompare Compare>
+size_t FilterSnapshotAs(const Predicate<T>& predicate, const uint8_t* current, const uint8_t* previous, size_t step,
+                        const std::vector<uint8_t>& candidates, std::vector<uint8_t>& survivors) {
+    size_t count = 0;
+
+    for (size_t byteIndex = 0; byteIndex < candidates.size(); ++byteIndex) {
+        uint32_t bits = candidates[byteIndex];
+        if (!bits) continue;
+
+        uint32_t passed = 0;
+        size_t offset = byteIndex * 8 * step;
+        if (bits == 0xFF) {
+            // Every slot of the byte: no bit scanning, and the loop unrolls
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                size_t at = offset + bit * step;
+                passed |= static_cast<uint32_t>(predicate.template Test<Compare>(Load<T>(current + at), Load<T>(previous + at))) << bit;
+            }
+        } else {
+            for (; bits; bits &= bits - 1) {
+                unsigned bit = LowestBit(bits);
+                size_t at = offset + bit * step;
+                passed |= static_cast<uint32_t>(predicate.template Test<Compare>(Load<T>(current + at), Load<T>(previous + at))) << bit;
+            }
+        }
+
+        survivors[byteIndex] = static_cast<uint8_t>(passed);
+        for (; passed; passed &= passed - 1) count++;
+    }
+
+    return count;
+}
+
+template <typename T>
+size_t FilterSnapshot(const Predicate<T>& predicate, const uint8_t* current, const uint8_t* previous, size_t step,
+                      const std::vector<uint8_t>& candidates, std::vector<uint8_t>& survivors) {
+    switch (predicate.Compare()) {
+        case ScanCompare::Unknown:     return FilterSnapshotAs<T, ScanCompare::Unknown>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Equal:       return FilterSnapshotAs<T, ScanCompare::Equal>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::NotEqual:    return FilterSnapshotAs<T, ScanCompare::NotEqual>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Range:       return FilterSnapshotAs<T, ScanCompare::Range>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Changed:     return FilterSnapshotAs<T, ScanCompare::Changed>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Unchanged:   return FilterSnapshotAs<T, ScanCompare::Unchanged>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Increased:   return FilterSnapshotAs<T, ScanCompare::Increased>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::Decreased:   return FilterSnapshotAs<T, ScanCompare::Decreased>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::IncreasedBy: return FilterSnapshotAs<T, ScanCompare::IncreasedBy>(predicate, current, previous, step, candidates, survivors);
+        case ScanCompare::DecreasedBy: return FilterSnapshotAs<T, ScanCompare::DecreasedBy>(predicate, current, previous, step, candidates, survivors);
+        default:                       return 0;
+    }
+}
+
+// Re-reads the candidates of one block and keeps those that pass
+template <typename T>
+void FilterBlock(HANDLE processHandle, const CandidateBlock& block, size_t step, ScanCompare compare,
+                 const ScanParams& params, const ValueScanner* scanner, std::vector<CandidateBlock>& out) {
+    Predicate<T> predicate(compare, params);
+
+    uintptr_t readStart = block.base + static_cast<uintptr_t>(block.firstSlot) * step;
+    size_t readSize = static_cast<size_t>(block.lastSlot - block.firstSlot) * step + sizeof(T);
+    uintptr_t firstPage = readStart / PAGE_SIZE;
+
+    std::vector<uint8_t> buffer, pageValid;
+    ReadCandidates(processHandle, readStart, readSize, buffer, pageValid);
+
+    auto readable = [&](uintptr_t address) {
+        return pageValid[address / PAGE_SIZE - firstPage] && pageValid[(address + sizeof(T) - 1) / PAGE_SIZE - firstPage];
+    };
+
+    if (block.layout == CandidateLayout::Sparse) {
+        BlockBuilder builder(step, sizeof(T));
+        builder.Begin(block.base);
+
+        ForEachCandidate(block, step, sizeof(T), [&](uint32_t slot, const uint8_t* previous) {
+            uintptr_t address = block.base + static_cast<uintptr_t>(slot) * step;
+            const uint8_t* current = buffer.data() + (address - readStart);
+            if (readable(address) && (scanner ? scanner->Matches(current) : predicate(Load<T>(current), Load<T>(previous)))) {
+                builder.Add(slot, current);
+            }
+        });
+
+        builder.Finish(out);
+        return;
+    }
+
+    // Snapshot blocks are filtered bitmap to bitmap. Previous values are laid
+    // out like the memory just read, so slot i is at i * step in both.
+    size_t spanSlots = block.lastSlot - block.firstSlot + 1;
+    std::vector<uint8_t> candidates, previous;
+    const uint8_t* previousData = block.values.data();
+
+    if (block.layout == CandidateLayout::Full) {
+        candidates.assign((spanSlots + 7) / 8, 0xFF);
+        if (spanSlots % 8) candidates.back() = static_cast<uint8_t>((1u << (spanSlots % 8)) - 1);
+    } else {
+        candidates = block.slots;
+        previous.resize(readSize);
+        DensePages(block, step, sizeof(T)).Expand(block, previous.data());
+        previousData = previous.data();
+    }
+
+    if (std::find(pageValid.begin(), pageValid.end(), 0) != pageValid.end()) {
+        for (size_t relative = 0; relative < spanSlots; ++relative) {
+            if (!readable(readStart + relative * step)) {
+                candidates[relative / 8] &= static_cast<uint8_t>(~(1u << (relative % 8)));
+            }
+        }
+    }
+
+    std::vector<uint8_t> survivors(candidates.size(), 0);
+    size_t count = 0;
+    if (scanner) {
+        // Given values need no previous values: scan the whole span in SIMD
+        // and keep the hits that are candidates
+        std::vector<size_t> offsets;
+        scanner->FindAll(buffer.data(), readSize, readStart, 0, readSize, offsets, SIZE_MAX);
+        for (size_t offset : offsets) {
+            size_t relative = offset / step;
+            uint8_t bit = static_cast<uint8_t>(1u << (relative % 8));
+            if (candidates[relative / 8] & bit) {
+                survivors[relative / 8] |= bit;
+                count++;
+            }
+        }
+    } else {
+        count = FilterSnapshot<T>(predicate, buffer.data(), previousData, step, candidates, survivors);
+    }
+
+    EncodeBlock(block.base, block.firstSlot, survivors, count, buffer.data(), step, sizeof(T), out);
+}
+
+struct ScanKernels {
+    void (*scanPiece)(HANDLE, const ScanRange&, size_t, ScanCompare, const ScanParams&, const ValueScanner*,
+                      size_t, std::vector<CandidateBlock>&);
+    void (*filterBlock)(HANDLE, const CandidateBlock&, size_t, ScanCompare, const ScanParams&,
+                        const ValueScanner*, std::vector<CandidateBlock>&);
+};
+
+template <typename T>
+ScanKernels MakeKernels() {
+    ScanKernels kernels = { &ScanPiece<T>, &FilterBlock<T> };
+    return kernels;
+}
+
+ScanKernels KernelsFor(ScanValueType type) {
+    switch (type) {
+        case ScanValueType::Int8:   return MakeKernels<int8_t>();
+        case ScanValueType::Int16:  return MakeKernels<int16_t>();
+        case ScanValueType::Int32:  return MakeKernels<int32_t>();
+        case ScanValueType::Int64:  return MakeKernels<int64_t>();
+        case ScanValueType::UInt8:  return MakeKernels<uint8_t>();
+        case ScanValueType::UInt16: return MakeKernels<uint16_t>();
+        case ScanValueType::UInt32: return MakeKernels<uint32_t>();
+        case ScanValueType::UInt64: return MakeKernels<uint64_t>();
+        case ScanValueType::Float:  return MakeKernels<float>();
+        case ScanValueType::Double: return MakeKernels<double>();
+    }
+    return MakeKernels<int32_t>();
+}
+
+bool IsFloatType(ScanValueType type) {
+    return type == ScanValueType::Float || type == ScanValueType::Double;
+}
+
+bool IsDisplayCompare(ScanCompare compare) {
+    return compare == ScanCompare::Rounded || compare == ScanCompare::Ulps || compare == ScanCompare::Truncated;
+}
+
+// Compares against given values run on ValueScanner. A float NotEqual with
+// a tolerance has no ValueOp and stays on the predicate.
+bool ToValueQuery(const ScanSessionOptions& options, ScanCompare compare, const ScanParams& params,
+                  ValueQuery& query) {
+    bool tolerant = IsFloatType(options.type) && params.tolerance > 0;
+    switch (compare) {
+        case ScanCompare::Equal:     query.op = tolerant ? ValueOp::Near : ValueOp::Equal; break;
+        case ScanCompare::NotEqual:  if (tolerant) return false; query.op = ValueOp::NotEqual; break;
+        case ScanCompare::Range:     query.op = ValueOp::Range; break;
+        case ScanCompare::Rounded:   query.op = ValueOp::Rounded; break;
+        case ScanCompare::Ulps:      query.op = ValueOp::Ulps; break;
+        case ScanCompare::Truncated: query.op = ValueOp::Truncated; break;
+        default:                     return false;
+    }
+
+    query.type = options.type;
+    query.aligned = options.aligned;
+    query.value = params.value;
+    query.value2 = params.value2;
+    query.intValue = params.intValue;
+    query.intValue2 = params.intValue2;
+    query.tolerance = params.tolerance;
+    query.decimals = params.decimals;
+    query.ulps = params.ulps;
+    return true;
+}
+
+const struct {
+    const char* name;
+    ScanCompare compare;
+} COMPARES[] = {
+    { "unknown", ScanCompare::Unknown },
+    { "equal", ScanCompare::Equal },
+    { "notEqual", ScanCompare::NotEqual },
+    { "range", ScanCompare::Range },
+    { "rounded", ScanCompare::Rounded },
+    { "ulps", ScanCompare::Ulps },
+    { "truncated", ScanCompare::Truncated },
+    { "changed", ScanCompare::Changed },
+    { "unchanged", ScanCompare::Unchanged },
+    { "increased", ScanCompare::Increased },
+    { "decreased", ScanCompare::Decreased },
+    { "increasedBy", ScanCompare::IncreasedBy },
+    { "decreasedBy", ScanCompare::DecreasedBy },
+};
+
+const char* const SPILL_ERROR = "Could not spill scan candidates to a temporary file";
+
+const uint32_t SESSION_MAGIC = 0x5353484D;   // "MHSS"
+const uint32_t SESSION_VERSION = 1;
+
+// Saved ahead of the candidates (see CandidateStore::Save): this header,
+// then the region map (see MemoryHelpers::SaveRegions)
+struct SessionFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t processId;
+    uint32_t type;
+    uint64_t startTime;
+    uint64_t searchStart;
+    uint64_t searchEnd;
+    uint64_t scans;
+    uint64_t regions;
+    uint8_t aligned;
+    uint8_t writableOnly;
+    uint8_t pointerSize;
+    uint8_t moduleImagesOnly;
+    uint8_t reserved[4];
+};
+
+static_assert(sizeof(SessionFileHeader) == 64, "Saved session layout changed");
+
+// A loaded block must decode within its own payload, whatever the file held:
+// its base is a slot address whose block cannot wrap, sparse slots strictly
+// increase from firstSlot to lastSlot, and a dense bitmap marks count slots,
+// none past the span and each on kept pages
+bool IsValidBlock(const CandidateBlock& block, size_t step, size_t width) {
+    if (block.base % step != 0 ||
+        block.base > std::numeric_limits<uintptr_t>::max() - ScanSession::BLOCK_SIZE - width) {
+        return false;
+    }
+    if (block.count == 0 || block.firstSlot > block.lastSlot ||
+        static_cast<size_t>(block.lastSlot) * step >= ScanSession::BLOCK_SIZE ||
+        block.count > block.lastSlot - block.firstSlot + 1) {
+        return false;
+    }
+
+    size_t spanSlots = block.lastSlot - block.firstSlot + 1;
+    switch (block.layout) {
+        case CandidateLayout::Full:
+            return block.count == spanSlots && block.values.size() == (spanSlots - 1) * step + width;
+
+        case CandidateLayout::Sparse: {
+            if (block.values.size() != static_cast<size_t>(block.count) * width) return false;
+            const uint8_t* gaps = block.slots.data();
+            const uint8_t* end = gaps + block.slots.size();
+            uint64_t slot = 0;
+            for (uint32_t i = 0; i < block.count; ++i) {
+                uint32_t gap;
+                if (!GetVarint(gaps, end, gap) || (i > 0 && gap == 0)) return false;
+                slot += gap;
+                if (i == 0 ? slot != block.firstSlot : slot > block.lastSlot) return false;
+            }
+            return gaps == end && slot == block.lastSlot;
+        }
+
+        case CandidateLayout::Dense: {
+            // DensePages indexes a fixed table by page, so bound the span first
+            uintptr_t start = block.base + static_cast<uintptr_t>(block.firstSlot) * step;
+            uintptr_t end = block.base + static_cast<uintptr_t>(block.lastSlot) * step + width;
+            if ((end - 1) / PAGE_SIZE - start / PAGE_SIZE + 1 > MAX_SPAN_PAGES) return false;
+
+            DensePages pages(block, step, width);
+            if (block.slots.size() != (spanSlots + 7) / 8 || (block.keptPages >> pages.Pages()) != 0 ||
+                block.values.size() != pages.KeptBytes()) {
+                return false;
+            }
+            uintptr_t firstPage = (block.base + static_cast<uintptr_t>(block.firstSlot) * step) / PAGE_SIZE;
+            size_t count = 0;
+            bool valid = true;
+            ForEachBit(block.slots.data(), block.slots.size(), [&](uint32_t relative) {
+                uintptr_t address = block.base + static_cast<uintptr_t>(block.firstSlot + relative) * step;
+                size_t page = static_cast<size_t>(address / PAGE_SIZE - firstPage);
+                size_t lastPage = static_cast<size_t>((address + width - 1) / PAGE_SIZE - firstPage);
+                if (relative >= spanSlots || !(block.keptPages & (1u << page)) ||
+                    !(block.keptPages & (1u << lastPage))) {
+                    valid = false;
+                }
+                count++;
+            });
+            return valid && count == block.count;
+        }
+    }
+    return false;
+}
+
+const char* const LOAD_ERROR = "Not a readable scan session file";
+
+} // namespace
+
+bool ParseScanCompare(const std::string& name, ScanCompare& compare) {
+    for (const auto& entry : COMPARES) {
+        if (name == entry.name) {
+            compare = entry.compare;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ComparesToPrevious(ScanCompare compare) {
+    return compare != ScanCompare::Unknown && compare != ScanCompare::Equal && compare != ScanCompare::NotEqual &&
+           compare != ScanCompare::Range && !IsDisplayCompare(compare);
+}
+
+ScanSession::ScanSession(const ScanSessionOptions& options)
+    : m_options(options), m_width(ScanValueSize(options.type)), m_store(options.memoryLimit), m_scans(0),
+      m_process() {
+    m_step = options.aligned ? m_width : 1;
+}
+
+bool ScanSession::First(HANDLE processHandle, ScanCompare compare, const ScanParams& params, std::string& error) {
+    if (ComparesToPrevious(compare)) {
+        error = "A first scan can only compare against given values";
+        return false;
+    }
+    if (IsDisplayCompare(compare) && !IsFloatType(m_options.type)) {
+        error = "Rounded, ulps and truncated compares need a float or double session";
+        return false;
+    }
+
+    // Saved sessions are only valid for this process instance
+    ProcessIdentity process = {};
+    MemoryHelpers::GetProcessIdentity(processHandle, process);
+
+    ValueQuery query = {};
+    bool direct = ToValueQuery(m_options, compare, params, query);
+    ValueScanner scanner(query);
+    if (direct && scanner.Empty()) {
+        // Nothing of this type can pass; skip reading memory
+        Reset();
+        m_scans = 1;
+        m_process = process;
+        m_regions.clear();
+        return true;
+    }
+
+    std::unique_ptr<AddressSpace> space;
+    if (m_options.moduleImagesOnly) space = AddressSpace::Capture(processHandle);
+
+    std::vector<ScanRange> ranges;
+    std::vector<MemoryRegionEx> regions;
+    for (auto& region : MemoryHelpers::GetMemoryRegions(processHandle, false, m_options.writableOnly)) {
+        uintptr_t start = m_options.searchStart ? std::max(m_options.searchStart, region.startAddress) : region.startAddress;
+        uintptr_t end = m_options.searchEnd ? std::min(m_options.searchEnd, region.endAddress) : region.endAddress;
+        if (start >= end) continue;
+
+        size_t before = ranges.size();
+        if (space) {
+            space->ImageRanges(start, end, ranges);
+        } else {
+            ranges.push_back({ start, static_cast<size_t>(end - start), 0 });
+        }
+        if (ranges.size() > before) regions.push_back(std::move(region));
+    }
+
+    ScanExecutor& executor = ScanExecutor::Instance();
+    std::vector<ScanRange> pieces = ScanExecutor::SplitRanges(ranges, m_width - 1);
+    size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+    ScanKernels kernels = KernelsFor(m_options.type);
+    CandidateStore store(m_options.memoryLimit);
+
+    executor.Run(pieces.size(), [&](size_t index) {
+        // Each piece is handed to the store as soon as it is done, so only
+        // the store ever holds the whole set
+        std::vector<CandidateBlock> blocks;
+        if (compare == ScanCompare::Unknown) {
+            SnapshotPiece(processHandle, pieces[index], m_step, m_width, blocks);
+        } else {
+            kernels.scanPiece(processHandle, pieces[index], m_step, compare, params, direct ? &scanner : nullptr,
+                              readerBudget, blocks);
+        }
+        store.Add(blocks);
+    });
+
+    if (!store.Finish()) {
+        error = SPILL_ERROR;
+        return false;
+    }
+
+    m_store.Swap(store);
+    m_scans = 1;
+    m_process = process;
+    m_regions.swap(regions);
+    return true;
+}
+
+bool ScanSession::Next(HANDLE processHandle, ScanCompare compare, const ScanParams& params, std::string& error) {
+    if (m_scans == 0) {
+        error = "Run a first scan before filtering";
+        return false;
+    }
+    if (compare == ScanCompare::Unknown) {
+        error = "An unknown value can only start a scan";
+        return false;
+    }
+    if (IsDisplayCompare(compare) && !IsFloatType(m_options.type)) {
+        error = "Rounded, ulps and truncated compares need a float or double session";
+        return false;
+    }
+
+    ValueQuery query = {};
+    bool direct = ToValueQuery(m_options, compare, params, query);
+    ValueScanner scanner(query);
+
+    ScanKernels kernels = KernelsFor(m_options.type);
+    CandidateStore store(m_options.memoryLimit);
+
+    ScanExecutor::Instance().Run(m_store.Blocks(), [&](size_t index) {
+        CandidateBlock scratch;
+        std::vector<CandidateBlock> filtered;
+        kernels.filterBlock(processHandle, m_store.Get(index, scratch), m_step, compare, params,
+                            direct ? &scanner : nullptr, filtered);
+        store.Add(filtered);
+    });
+
+    if (!store.Finish()) {
+        error = SPILL_ERROR;
+        return false;
+    }
+
+    m_store.Swap(store);
+    m_scans++;
+    return true;
+}
+
+void ScanSession::Reset() {
+    CandidateStore empty(m_options.memoryLimit);
+    m_store.Swap(empty);
+    m_scans = 0;
+}
+
+std::vector<SessionCandidate> ScanSession::Results(size_t maxResults) const {
+    std::vector<SessionCandidate> results;
+
+    CandidateBlock scratch;
+    for (size_t index = 0; index < m_store.Blocks() && results.size() < maxResults; ++index) {
+        const CandidateBlock& block = m_store.Get(index, scratch);
+        ForEachCandidate(block, m_step, m_width, [&](uint32_t slot, const uint8_t* value) {
+            if (results.size() >= maxResults) return;
+            SessionCandidate candidate;
+            candidate.address = block.base + static_cast<uintptr_t>(slot) * m_step;
+            candidate.value.assign(value, value + m_width);
+            results.push_back(std::move(candidate));
+        });
+    }
+
+    return results;
+}
+
+bool ScanSession::Save(const std::wstring& path, std::string& error) const {
+    if (m_scans == 0) {
+        error = "Run a first scan before saving";
+        return false;
+    }
+
+    SessionFileHeader header = {};
+    header.magic = SESSION_MAGIC;
+    header.version = SESSION_VERSION;
+    header.processId = m_process.processId;
+    header.type = static_cast<uint32_t>(m_options.type);
+    header.startTime = m_process.startTime;
+    header.searchStart = m_options.searchStart;
+    header.searchEnd = m_options.searchEnd;
+    header.scans = m_scans;
+    header.regions = m_regions.size();
+    header.aligned = m_options.aligned ? 1 : 0;
+    header.writableOnly = m_options.writableOnly ? 1 : 0;
+    header.pointerSize = sizeof(uintptr_t);
+    header.moduleImagesOnly = m_options.moduleImagesOnly ? 1 : 0;
+
+    std::vector<uint8_t> prefix(reinterpret_cast<const uint8_t*>(&header),
+                                reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+    MemoryHelpers::SaveRegions(m_regions, prefix);
+
+    if (!m_store.Save(path, prefix)) {
+        error = "Could not write the scan session file";
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<ScanSession> ScanSession::Load(HANDLE processHandle, const std::wstring& path, size_t memoryLimit,
+                                               std::string& error) {
+    CandidateStore store(memoryLimit);
+    const uint8_t* prefix = nullptr;
+    size_t prefixSize = 0;
+    if (!store.Load(path, prefix, prefixSize)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    SessionFileHeader header;
+    if (prefixSize < sizeof(header)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+    memcpy(&header, prefix, sizeof(header));
+    if (header.magic != SESSION_MAGIC || header.version != SESSION_VERSION ||
+        header.pointerSize != sizeof(uintptr_t) || header.type > static_cast<uint32_t>(ScanValueType::Double) ||
+        header.scans == 0) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    // Addresses and last values mean nothing in any other process, including
+    // a restart of the same program under a reused process id
+    ProcessIdentity current = {};
+    if (!MemoryHelpers::GetProcessIdentity(processHandle, current) || current.processId != header.processId ||
+        current.startTime != header.startTime) {
+        error = "The scan session was saved from a different process instance";
+        return nullptr;
+    }
+
+    std::vector<MemoryRegionEx> regions;
+    size_t offset = sizeof(header);
+    if (!MemoryHelpers::LoadRegions(prefix, prefixSize, offset, header.regions, regions)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    ScanSessionOptions options = {};
+    options.type = static_cast<ScanValueType>(header.type);
+    options.aligned = header.aligned != 0;
+    options.writableOnly = header.writableOnly != 0;
+    options.moduleImagesOnly = header.moduleImagesOnly != 0;
+    options.searchStart = static_cast<uintptr_t>(header.searchStart);
+    options.searchEnd = static_cast<uintptr_t>(header.searchEnd);
+    options.memoryLimit = memoryLimit;
+
+    std::unique_ptr<ScanSession> session(new ScanSession(options));
+    // Every block is decoded once here, so later scans can trust the mapping
+    CandidateBlock scratch;
+    for (size_t index = 0; index < store.Blocks(); ++index) {
+        if (!IsValidBlock(store.Get(index, scratch), session->m_step, session->m_width)) {
+            error = LOAD_ERROR;
+            return nullptr;
+        }
+    }
+
+    session->m_store.Swap(store);
+    session->m_scans = static_cast<size_t>(header.scans);
+    session->m_process = current;
+    session->m_regions.swap(regions);
+    return session;
+}
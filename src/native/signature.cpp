@@ -0,0 +1,109 @@
+#include "include/signature.h"
+#include <cctype>
+
+namespace {
+
+// Returns the nibble value, or -1 for '?' and -2 for anything else
+int ParseNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c == '?') return -1;
+    return -2;
+}
+
+bool ParsePair(char high, char low, uint8_t& value, uint8_t& mask) {
+    int h = ParseNibble(high);
+    int l = ParseNibble(low);
+    if (h == -2 || l == -2) return false;
+
+    value = 0;
+    mask = 0;
+    if (h >= 0) {
+        value |= static_cast<uint8_t>(h << 4);
+        mask |= 0xF0;
+    }
+    if (l >= 0) {
+        value |= static_cast<uint8_t>(l);
+        mask |= 0x0F;
+    }
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<Signature> Signature::Compile(const std::string& text, std::string& error) {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> masks;
+
+    if (!Parse(text, bytes, masks, error)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<Signature>(new Signature(bytes, masks));
+}
+
+Signature::Signature(const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& masks)
+    : m_bytes(bytes), m_masks(masks), m_matcher(bytes, masks) {
+}
+
+bool Signature::Parse(const std::string& text, std::vector<uint8_t>& bytes,
+                      std::vector<uint8_t>& masks, std::string& error) {
+    bytes.clear();
+    masks.clear();
+
+    size_t i = 0;
+    while (i < text.size()) {
+        if (std::isspace(static_cast<unsigned char>(text[i]))) {
+            ++i;
+            continue;
+        }
+
+        size_t tokenStart = i;
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        std::string token = text.substr(tokenStart, i - tokenStart);
+
+        // "?" and single hex digits stand for a whole byte
+        if (token.size() == 1) {
+            token = (token == "?") ? "??" : "0" + token;
+        }
+
+        if (token.size() % 2 != 0) {
+            error = "Odd number of digits in signature token '" + token + "'";
+            return false;
+        }
+
+        for (size_t j = 0; j < token.size(); j += 2) {
+            uint8_t value;
+            uint8_t mask;
+            if (!ParsePair(token[j], token[j + 1], value, mask)) {
+                error = "Invalid signature token '" + token + "'";
+                return false;
+            }
+            bytes.push_back(value);
+            masks.push_back(mask);
+        }
+    }
+
+    if (bytes.empty()) {
+        error = "Empty signature";
+        return false;
+    }
+
+    return true;
+}
+
+std::string Signature::ToString() const {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string text;
+
+    for (size_t i = 0; i < m_bytes.size(); ++i) {
+        if (i > 0) text += ' ';
+        text += (m_masks[i] & 0xF0) ? digits[m_bytes[i] >> 4] : '?';
+        text += (m_masks[i] & 0x0F) ? digits[m_bytes[i] & 0x0F] : '?';
+    }
+
+    return text;
+}
@@ -0,0 +1,423 @@
+#include "include/string_extractor.h"
+#include "include/region_reader.h"
+#include <algorithm>
+#include <mutex>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_EXTRACTOR_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+const uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+inline bool IsPrintable(uint8_t b) {
+    return (b >= 0x20 && b <= 0x7E) || b == '\t';
+}
+
+inline unsigned LowestSetBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+// Sets bit i of printable / zero for data[i], for up to 64 bytes
+void Classify(const uint8_t* data, size_t count, uint64_t& printable, uint64_t& zero) {
+#if defined(STRING_EXTRACTOR_SSE2)
+    if (count == 64) {
+        const __m128i below = _mm_set1_epi8(0x1F);
+        const __m128i above = _mm_set1_epi8(0x7F);
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i nul = _mm_setzero_si128();
+        printable = 0;
+        zero = 0;
+
+        for (int part = 0; part < 4; ++part) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + part * 16));
+            // Signed compares: bytes of 0x80 and up are negative and fail the first test
+            __m128i isPrintable = _mm_or_si128(
+                _mm_and_si128(_mm_cmpgt_epi8(bytes, below), _mm_cmplt_epi8(bytes, above)),
+                _mm_cmpeq_epi8(bytes, tab));
+            printable |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(isPrintable))) << (part * 16);
+            zero |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nul)))) << (part * 16);
+        }
+        return;
+    }
+#endif
+
+    printable = 0;
+    zero = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (IsPrintable(data[i])) printable |= 1ULL << i;
+        if (data[i] == 0) zero |= 1ULL << i;
+    }
+}
+
+// Packs the even bits of x into its low 32 bits
+inline uint64_t CompressEvenBits(uint64_t x) {
+    x &= EVEN_BITS;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+    return x;
+}
+
+// Follows the runs of one encoding through the chunks of a piece. A run is
+// reported by the piece it starts in, once it ends.
+class RunTracker {
+public:
+    RunTracker(StringEncoding encoding, size_t minLength, uintptr_t ownedStart, uintptr_t ownedEnd,
+               std::vector<ExtractedString>& out)
+        : m_encoding(encoding), m_stride(encoding == StringEncoding::Utf8 ? 1 : 2),
+          m_charOffset(encoding == StringEncoding::Utf16BE ? 1 : 0), m_minLength(minLength),
+          m_ownedStart(ownedStart), m_ownedEnd(ownedEnd), m_active(false), m_start(0), m_length(0),
+          m_pending(0), m_out(out) {}
+
+    // bits has one bit per character slot, starting at chunk offset `offset`
+    void Feed(const RegionChunk& chunk, uint64_t bits, unsigned slots, size_t offset) {
+        const uint64_t valid = slots >= 64 ? ~0ULL : ((1ULL << slots) - 1);
+        unsigned pos = 0;
+
+        while (pos < slots) {
+            // Next slot where the run state flips
+            uint64_t flips = (m_active ? ~bits : bits) & valid & (~0ULL << pos);
+            if (flips == 0) {
+                if (m_active) m_length += slots - pos;
+                return;
+            }
+
+            unsigned next = LowestSetBit(flips);
+            if (m_active) {
+                m_length += next - pos;
+                End(chunk, offset + next * m_stride);
+            } else {
+                Start(chunk, offset + next * m_stride);
+            }
+            pos = next;
+        }
+    }
+
+    // The chunk buffer is about to be reused; keep the text of an open run
+    void EndChunk(const RegionChunk& chunk) {
+        if (m_active) {
+            AppendText(chunk, chunk.size);
+            m_pending = 0;
+        }
+    }
+
+    // The run cannot continue (unreadable gap or end of the piece)
+    void Finish() {
+        if (m_active) Emit();
+    }
+
+    // An open run this piece must still report
+    bool Pending() const { return m_active && m_start < m_ownedEnd; }
+
+private:
+    void Start(const RegionChunk& chunk, size_t offset) {
+        m_active = true;
+        m_start = chunk.address + offset;
+        m_length = 0;
+        m_text.clear();
+        m_pending = offset;
+    }
+
+    void End(const RegionChunk& chunk, size_t offset) {
+        // Most runs in binary data are too short to report; skip their text
+        if (m_length >= m_minLength) AppendText(chunk, offset);
+        Emit();
+    }
+
+    void AppendText(const RegionChunk& chunk, size_t end) {
+        for (size_t i = m_pending; i + m_stride <= end && m_text.size() < StringExtractor::MAX_STRING_LENGTH; i += m_stride) {
+            m_text.push_back(static_cast<char>(chunk.data[i + m_charOffset]));
+        }
+        m_pending = end;
+    }
+
+    void Emit() {
+        m_active = false;
+        if (m_length < m_minLength || m_start < m_ownedStart || m_start >= m_ownedEnd) return;
+        m_out.push_back({ m_start, m_encoding, m_length, std::move(m_text) });
+        m_text.clear();
+    }
+
+    StringEncoding m_encoding;
+    size_t m_stride;
+    size_t m_charOffset;
+    size_t m_minLength;
+    uintptr_t m_ownedStart;
+    uintptr_t m_ownedEnd;
+    bool m_active;
+    uintptr_t m_start;
+    size_t m_length;
+    size_t m_pending;    // Chunk offset of the first character not yet in m_text
+    std::string m_text;
+    std::vector<ExtractedString>& m_out;
+};
+
+// Hands finished pieces to the sink in piece order. Whichever worker finds
+// the next piece ready does the writing; the others only deposit results.
+class OrderedBatcher {
+public:
+    OrderedBatcher(StringSink& sink, size_t pieces, size_t batchSize)
+        : m_sink(sink), m_batchSize(std::max<size_t>(batchSize, 1)), m_pending(pieces), m_done(pieces, false),
+          m_next(0), m_flushing(false), m_stopped(false), m_written(0) {}
+
+    bool Stopped() const { return m_stopped.load(); }
+    size_t Written() const { return m_written; }
+
+    void Complete(size_t piece, std::vector<ExtractedString>&& strings) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_pending[piece] = std::move(strings);
+        m_done[piece] = true;
+        if (m_flushing) return;
+
+        m_flushing = true;
+        while (m_next < m_done.size() && m_done[m_next]) {
+            std::vector<ExtractedString> ready = std::move(m_pending[m_next]);
+            m_pending[m_next].shrink_to_fit();
+            m_next++;
+
+            lock.unlock();
+            Append(ready);
+            lock.lock();
+        }
+        m_flushing = false;
+    }
+
+    // Called once every piece has completed
+    void Finish() {
+        if (!m_batch.empty()) WriteBatch();
+    }
+
+private:
+    void Append(std::vector<ExtractedString>& strings) {
+        for (auto& found : strings) {
+            if (m_stopped.load()) return;
+            m_batch.push_back(std::move(found));
+            if (m_batch.size() >= m_batchSize) WriteBatch();
+        }
+    }
+
+    void WriteBatch() {
+        if (!m_stopped.load()) {
+            if (m_sink.Write(m_batch)) {
+                m_written += m_batch.size();
+            } else {
+                m_stopped.store(true);
+            }
+        }
+        m_batch.clear();
+    }
+
+    StringSink& m_sink;
+    size_t m_batchSize;
+    std::mutex m_mutex;
+    std::vector<std::vector<ExtractedString>> m_pending;
+    std::vector<bool> m_done;
+    size_t m_next;
+    bool m_flushing;
+    std::atomic<bool> m_stopped;
+    std::vector<ExtractedString> m_batch;   // Only touched by the flushing thread
+    size_t m_written;
+};
+
+struct ExtractionPiece {
+    ScanRange range;
+    size_t lookBehind;   // Bytes read before the piece to tell whether a run is already open
+    uintptr_t rangeEnd;  // A run still open past the read-ahead is followed up to here
+};
+
+} // namespace
+
+FileStringSink::FileStringSink(const std::string& path)
+    : m_file(path, std::ios::out | std::ios::trunc | std::ios::binary) {
+}
+
+bool FileStringSink::Write(const std::vector<ExtractedString>& batch) {
+    std::string lines;
+    char prefix[48];
+
+    for (const auto& found : batch) {
+        snprintf(prefix, sizeof(prefix), "0x%llX\t%s\t", static_cast<unsigned long long>(found.address),
+                 StringEncodingName(found.encoding));
+        lines += prefix;
+
+        for (char c : found.text) {
+            if (c == '\t') lines += "\\t";
+            else if (c == '\\') lines += "\\\\";
+            else lines += c;
+        }
+        lines += '\n';
+    }
+
+    m_file.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    return m_file.good();
+}
+
+QueuedStringSink::QueuedStringSink(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1)), m_closed(false), m_stopped(false) {
+}
+
+bool QueuedStringSink::Write(const std::vector<ExtractedString>& batch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_stopped || m_queue.size() < m_capacity; });
+    if (m_stopped) return false;
+
+    m_queue.push_back(batch);
+    m_changed.notify_all();
+    return true;
+}
+
+bool QueuedStringSink::Take(std::vector<ExtractedString>& batch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_closed || !m_queue.empty(); });
+    if (m_queue.empty()) return false;
+
+    batch = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_changed.notify_all();
+    return true;
+}
+
+void QueuedStringSink::Close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_changed.notify_all();
+}
+
+void QueuedStringSink::Stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+    m_queue.clear();
+    m_changed.notify_all();
+}
+
+StringExtractor::StringExtractor(HANDLE processHandle, size_t minLength, uint32_t encodings, size_t batchSize)
+    : m_processHandle(processHandle), m_minLength(std::max<size_t>(minLength, 1)), m_encodings(encodings),
+      m_batchSize(batchSize) {
+}
+
+StringExtractionStats StringExtractor::Run(const std::vector<ScanRange>& ranges, StringSink& sink) {
+    StringExtractionStats stats = {};
+    stats.ranges = ranges.size();
+
+    const bool ascii = (m_encodings & static_cast<uint32_t>(StringEncoding::Utf8)) != 0;
+    const bool utf16le = (m_encodings & static_cast<uint32_t>(StringEncoding::Utf16LE)) != 0;
+    const bool utf16be = (m_encodings & static_cast<uint32_t>(StringEncoding::Utf16BE)) != 0;
+    if (!ascii && !utf16le && !utf16be) return stats;
+
+    // A piece finishes the runs it started, reading past its end as far as
+    // they go; later pieces look one code unit back to skip those runs
+    std::vector<ExtractionPiece> pieces;
+    for (const auto& range : ranges) {
+        auto split = ScanExecutor::SplitRanges({ range }, MAX_STRING_LENGTH * 2);
+        for (size_t i = 0; i < split.size(); ++i) {
+            pieces.push_back({ split[i], static_cast<size_t>(i == 0 ? 0 : 2), range.start + range.size });
+        }
+    }
+
+    ScanExecutor& executor = ScanExecutor::Instance();
+    size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+    OrderedBatcher batcher(sink, pieces.size(), m_batchSize);
+    std::atomic<uint64_t> bytesScanned(0);
+
+    executor.Run(pieces.size(), [&](size_t index) {
+        std::vector<ExtractedString> found;
+        const ExtractionPiece& piece = pieces[index];
+        uintptr_t ownedStart = piece.range.start;
+        uintptr_t ownedEnd = piece.range.start + piece.range.size;
+
+        RunTracker asciiRuns(StringEncoding::Utf8, m_minLength, ownedStart, ownedEnd, found);
+        RunTracker leRuns(StringEncoding::Utf16LE, m_minLength, ownedStart, ownedEnd, found);
+        RunTracker beRuns(StringEncoding::Utf16BE, m_minLength, ownedStart, ownedEnd, found);
+
+        RegionReader reader(m_processHandle, 0, readerBudget);
+        RegionChunk chunk;
+        uintptr_t expected = ownedStart - piece.lookBehind;
+        uintptr_t readEnd = ownedEnd + piece.range.readAhead;
+        bool reading = !batcher.Stopped() &&
+            reader.Begin(expected, piece.range.size + piece.lookBehind, piece.range.readAhead);
+
+        while (reading) {
+            if (!reader.Next(chunk)) {
+                // Rare: a run of this piece outlasted the read-ahead
+                bool pending = asciiRuns.Pending() || leRuns.Pending() || beRuns.Pending();
+                reading = pending && readEnd < piece.rangeEnd && !batcher.Stopped() &&
+                    reader.Begin(readEnd, static_cast<size_t>(piece.rangeEnd - readEnd));
+                readEnd = piece.rangeEnd;
+                continue;
+            }
+            if (batcher.Stopped()) break;
+
+            // Skipped unreadable pages end every open run
+            if (chunk.address != expected) {
+                asciiRuns.Finish();
+                leRuns.Finish();
+                beRuns.Finish();
+            }
+            expected = chunk.address + chunk.size;
+            bytesScanned += chunk.size;
+
+            for (size_t i = 0; i < chunk.size; i += 64) {
+                size_t count = std::min<size_t>(64, chunk.size - i);
+                uint64_t printable, zero;
+                Classify(chunk.data + i, count, printable, zero);
+
+                if (ascii) asciiRuns.Feed(chunk, printable, static_cast<unsigned>(count), i);
+                if (!utf16le && !utf16be) continue;
+
+                // Blocks start on even offsets, so no code unit straddles two of them
+                unsigned units = static_cast<unsigned>(count / 2);
+
+                if (utf16le) leRuns.Feed(chunk, CompressEvenBits(printable & (zero >> 1)), units, i);
+                if (utf16be) beRuns.Feed(chunk, CompressEvenBits(zero & (printable >> 1)), units, i);
+            }
+
+            asciiRuns.EndChunk(chunk);
+            leRuns.EndChunk(chunk);
+            beRuns.EndChunk(chunk);
+
+            // The read-ahead only matters while a run of this piece is open
+            if (expected >= ownedEnd && !asciiRuns.Pending() && !leRuns.Pending() && !beRuns.Pending()) {
+                break;
+            }
+        }
+
+        asciiRuns.Finish();
+        leRuns.Finish();
+        beRuns.Finish();
+
+        // Trackers report as runs end, so encodings interleave out of order
+        std::stable_sort(found.begin(), found.end(), [](const ExtractedString& a, const ExtractedString& b) {
+            return a.address < b.address;
+        });
+        batcher.Complete(index, std::move(found));
+    });
+
+    batcher.Finish();
+
+    stats.strings = batcher.Written();
+    stats.bytesScanned = bytesScanned.load();
+    stats.stopped = batcher.Stopped();
+    return stats;
+}
@@ -0,0 +1,340 @@
+#include "include/string_searcher.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STRING_SEARCHER_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(STRING_SEARCHER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+const size_t MAX_NEEDLES = 3;
+
+inline unsigned LowestSetBit(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+bool IsAsciiLetter(uint32_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Decodes UTF-8; a byte that does not start a valid sequence stands for
+// itself (Latin-1), so any input yields a needle
+std::vector<uint32_t> DecodeUtf8(const std::string& text) {
+    std::vector<uint32_t> codePoints;
+    size_t i = 0;
+
+    while (i < text.size()) {
+        uint8_t lead = static_cast<uint8_t>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        uint32_t codePoint = length == 1 ? lead : length == 2 ? (lead & 0x1F) : length == 3 ? (lead & 0x0F) : (lead & 0x07);
+
+        bool valid = length > 0 && i + length <= text.size();
+        for (size_t j = 1; valid && j < length; ++j) {
+            uint8_t next = static_cast<uint8_t>(text[i + j]);
+            valid = (next & 0xC0) == 0x80;
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+
+        if (!valid || codePoint > 0x10FFFF) {
+            codePoints.push_back(lead);
+            i++;
+            continue;
+        }
+
+        codePoints.push_back(codePoint);
+        i += length;
+    }
+    return codePoints;
+}
+
+void AppendUtf16Unit(std::vector<uint8_t>& out, uint16_t unit, bool bigEndian) {
+    uint8_t low = static_cast<uint8_t>(unit & 0xFF);
+    uint8_t high = static_cast<uint8_t>(unit >> 8);
+    out.push_back(bigEndian ? high : low);
+    out.push_back(bigEndian ? low : high);
+}
+
+std::vector<uint8_t> EncodeUtf16(const std::vector<uint32_t>& codePoints, bool bigEndian) {
+    std::vector<uint8_t> out;
+    for (uint32_t codePoint : codePoints) {
+        if (codePoint >= 0x10000) {
+            uint32_t value = codePoint - 0x10000;
+            AppendUtf16Unit(out, static_cast<uint16_t>(0xD800 | (value >> 10)), bigEndian);
+            AppendUtf16Unit(out, static_cast<uint16_t>(0xDC00 | (value & 0x3FF)), bigEndian);
+        } else {
+            AppendUtf16Unit(out, static_cast<uint16_t>(codePoint), bigEndian);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+const char* StringEncodingName(StringEncoding encoding) {
+    switch (encoding) {
+        case StringEncoding::Utf8: return "utf8";
+        case StringEncoding::Utf16LE: return "utf16le";
+        case StringEncoding::Utf16BE: return "utf16be";
+    }
+    return "unknown";
+}
+
+bool ParseStringEncoding(const std::string& name, StringEncoding& encoding) {
+    if (name == "utf8" || name == "ascii") {
+        encoding = StringEncoding::Utf8;
+    } else if (name == "utf16le" || name == "utf16") {
+        encoding = StringEncoding::Utf16LE;
+    } else if (name == "utf16be") {
+        encoding = StringEncoding::Utf16BE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+StringSearcher::StringSearcher(const std::string& text, uint32_t encodings, bool caseSensitive)
+    : m_maxSize(0), m_minSize(0) {
+    if (text.empty()) {
+        return;
+    }
+
+    // Needles are kept in flag order so hits at one offset sort by encoding
+    if (encodings & static_cast<uint32_t>(StringEncoding::Utf8)) {
+        AddNeedle(StringEncoding::Utf8, std::vector<uint8_t>(text.begin(), text.end()), 1, caseSensitive);
+    }
+
+    if (encodings & (static_cast<uint32_t>(StringEncoding::Utf16LE) | static_cast<uint32_t>(StringEncoding::Utf16BE))) {
+        std::vector<uint32_t> codePoints = DecodeUtf8(text);
+        if (encodings & static_cast<uint32_t>(StringEncoding::Utf16LE)) {
+            AddNeedle(StringEncoding::Utf16LE, EncodeUtf16(codePoints, false), 2, caseSensitive);
+        }
+        if (encodings & static_cast<uint32_t>(StringEncoding::Utf16BE)) {
+            AddNeedle(StringEncoding::Utf16BE, EncodeUtf16(codePoints, true), 2, caseSensitive);
+        }
+    }
+
+    for (const Needle& needle : m_needles) {
+        m_maxSize = std::max(m_maxSize, needle.bytes.size());
+        m_minSize = m_minSize == 0 ? needle.bytes.size() : std::min(m_minSize, needle.bytes.size());
+    }
+}
+
+void StringSearcher::AddNeedle(StringEncoding encoding, const std::vector<uint8_t>& bytes, size_t unitSize,
+                               bool caseSensitive) {
+    std::vector<uint8_t> masks(bytes.size(), 0xFF);
+
+    if (!caseSensitive) {
+        // Only the byte holding the letter is folded; the zero high byte of a
+        // UTF-16 unit stays exact
+        for (size_t unit = 0; unit + unitSize <= bytes.size(); unit += unitSize) {
+            size_t low = encoding == StringEncoding::Utf16BE ? unit + 1 : unit;
+            size_t high = encoding == StringEncoding::Utf16BE ? unit : unit + 1;
+            if (IsAsciiLetter(bytes[low]) && (unitSize == 1 || bytes[high] == 0)) {
+                masks[low] = PatternMatcher::CASE_FOLD_MASK;
+            }
+        }
+    }
+
+    // Anchor on the rarer byte of the first and of the last code unit
+    auto pickAnchor = [&](size_t unit) {
+        size_t best = unit;
+        for (size_t i = unit + 1; i < unit + unitSize; ++i) {
+            if (PatternMatcher::ByteCommonness(bytes[i] & masks[i]) < PatternMatcher::ByteCommonness(bytes[best] & masks[best])) {
+                best = i;
+            }
+        }
+        return best;
+    };
+
+    Needle needle{ encoding, bytes, PatternMatcher(bytes, masks), 0, 0, 0, 0, 0, 0, unitSize };
+    needle.firstOffset = pickAnchor(0);
+    needle.lastOffset = pickAnchor(bytes.size() - unitSize);
+    needle.firstMask = masks[needle.firstOffset];
+    needle.firstValue = bytes[needle.firstOffset] & needle.firstMask;
+    needle.lastMask = masks[needle.lastOffset];
+    needle.lastValue = bytes[needle.lastOffset] & needle.lastMask;
+
+    m_needles.push_back(std::move(needle));
+}
+
+const std::vector<uint8_t>& StringSearcher::NeedleBytes(StringEncoding encoding) const {
+    static const std::vector<uint8_t> none;
+    for (const Needle& needle : m_needles) {
+        if (needle.encoding == encoding) return needle.bytes;
+    }
+    return none;
+}
+
+size_t StringSearcher::FindAll(const uint8_t* data, size_t size, uintptr_t address, std::vector<StringHit>& hits,
+                               size_t maxResults) const {
+    if (m_needles.empty() || data == nullptr || size < m_minSize || maxResults == 0) {
+        return 0;
+    }
+
+    if (PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::AVX2)) {
+        return FindAVX2(data, size, address, hits, maxResults);
+    }
+    if (PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::SSE2)) {
+        return FindSSE2(data, size, address, hits, maxResults);
+    }
+    return FindScalar(data, size, 0, address, hits, maxResults);
+}
+
+size_t StringSearcher::FindScalar(const uint8_t* data, size_t size, size_t from, uintptr_t address,
+                                  std::vector<StringHit>& hits, size_t maxResults) const {
+    size_t count = 0;
+    for (size_t pos = from; pos + m_minSize <= size; ++pos) {
+        for (const Needle& needle : m_needles) {
+            if (pos + needle.bytes.size() > size || !Accept(needle, data, pos, address)) continue;
+
+            hits.push_back({ pos, needle.bytes.size(), needle.encoding });
+            if (++count >= maxResults) return count;
+        }
+    }
+    return count;
+}
+
+#if defined(STRING_SEARCHER_X86)
+
+TARGET_SSE2
+size_t StringSearcher::FindSSE2(const uint8_t* data, size_t size, uintptr_t address,
+                                std::vector<StringHit>& hits, size_t maxResults) const {
+    const size_t needleCount = std::min(m_needles.size(), MAX_NEEDLES);
+    __m128i firstValue[MAX_NEEDLES], firstMask[MAX_NEEDLES], lastValue[MAX_NEEDLES], lastMask[MAX_NEEDLES];
+    for (size_t n = 0; n < needleCount; ++n) {
+        firstValue[n] = _mm_set1_epi8(static_cast<char>(m_needles[n].firstValue));
+        firstMask[n] = _mm_set1_epi8(static_cast<char>(m_needles[n].firstMask));
+        lastValue[n] = _mm_set1_epi8(static_cast<char>(m_needles[n].lastValue));
+        lastMask[n] = _mm_set1_epi8(static_cast<char>(m_needles[n].lastMask));
+    }
+
+    std::vector<StringHit> block;
+    size_t count = 0;
+    size_t i = 0;
+
+    // Each block tests 16 starts for every encoding while its bytes are in L1;
+    // every load stays below size for the longest needle
+    for (; i + 16 + m_maxSize - 1 <= size; i += 16) {
+        block.clear();
+
+        for (size_t n = 0; n < needleCount; ++n) {
+            const Needle& needle = m_needles[n];
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + needle.firstOffset));
+            __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + needle.lastOffset));
+            __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(first, firstMask[n]), firstValue[n]),
+                                       _mm_cmpeq_epi8(_mm_and_si128(last, lastMask[n]), lastValue[n]));
+
+            uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+            while (candidates) {
+                size_t pos = i + LowestSetBit(candidates);
+                candidates &= candidates - 1;
+                if (Accept(needle, data, pos, address)) {
+                    block.push_back({ pos, needle.bytes.size(), needle.encoding });
+                }
+            }
+        }
+
+        if (block.empty()) continue;
+        std::sort(block.begin(), block.end(), [](const StringHit& a, const StringHit& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.encoding < b.encoding;
+        });
+        for (const StringHit& hit : block) {
+            hits.push_back(hit);
+            if (++count >= maxResults) return count;
+        }
+    }
+
+    return count + FindScalar(data, size, i, address, hits, maxResults - count);
+}
+
+TARGET_AVX2
+size_t StringSearcher::FindAVX2(const uint8_t* data, size_t size, uintptr_t address,
+                                std::vector<StringHit>& hits, size_t maxResults) const {
+    const size_t needleCount = std::min(m_needles.size(), MAX_NEEDLES);
+    __m256i firstValue[MAX_NEEDLES], firstMask[MAX_NEEDLES], lastValue[MAX_NEEDLES], lastMask[MAX_NEEDLES];
+    for (size_t n = 0; n < needleCount; ++n) {
+        firstValue[n] = _mm256_set1_epi8(static_cast<char>(m_needles[n].firstValue));
+        firstMask[n] = _mm256_set1_epi8(static_cast<char>(m_needles[n].firstMask));
+        lastValue[n] = _mm256_set1_epi8(static_cast<char>(m_needles[n].lastValue));
+        lastMask[n] = _mm256_set1_epi8(static_cast<char>(m_needles[n].lastMask));
+    }
+
+    std::vector<StringHit> block;
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 32 + m_maxSize - 1 <= size; i += 32) {
+        block.clear();
+
+        for (size_t n = 0; n < needleCount; ++n) {
+            const Needle& needle = m_needles[n];
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + needle.firstOffset));
+            __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + needle.lastOffset));
+            __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(first, firstMask[n]), firstValue[n]),
+                                          _mm256_cmpeq_epi8(_mm256_and_si256(last, lastMask[n]), lastValue[n]));
+
+            uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+            while (candidates) {
+                size_t pos = i + LowestSetBit(candidates);
+                candidates &= candidates - 1;
+                if (Accept(needle, data, pos, address)) {
+                    block.push_back({ pos, needle.bytes.size(), needle.encoding });
+                }
+            }
+        }
+
+        if (block.empty()) continue;
+        std::sort(block.begin(), block.end(), [](const StringHit& a, const StringHit& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.encoding < b.encoding;
+        });
+        for (const StringHit& hit : block) {
+            hits.push_back(hit);
+            if (++count >= maxResults) return count;
+        }
+    }
+
+    // Finish the tail 16 starts at a time
+    if (i + m_minSize <= size) {
+        std::vector<StringHit> tail;
+        size_t tailCount = FindSSE2(data + i, size - i, address + i, tail, maxResults - count);
+        for (StringHit hit : tail) {
+            hit.offset += i;
+            hits.push_back(hit);
+        }
+        count += tailCount;
+    }
+    return count;
+}
+
+#else
+
+size_t StringSearcher::FindSSE2(const uint8_t* data, size_t size, uintptr_t address,
+                                std::vector<StringHit>& hits, size_t maxResults) const {
+    return FindScalar(data, size, 0, address, hits, maxResults);
+}
+
+size_t StringSearcher::FindAVX2(const uint8_t* data, size_t size, uintptr_t address,
+                                std::vector<StringHit>& hits, size_t maxResults) const {
+    return FindScalar(data, size, 0, address, hits, maxResults);
+}
+
+#endif
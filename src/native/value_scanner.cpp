@@ -0,0 +1,652 @@
+#include "include/value_scanner.h"
+#include "include/pattern_matcher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VALUE_SCANNER_X86 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(VALUE_SCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_SSE2
+#endif
+
+namespace {
+
+const struct {
+    const char* name;
+    ScanValueType type;
+    size_t size;
+} VALUE_TYPES[] = {
+    { "int8", ScanValueType::Int8, 1 },
+    { "int16", ScanValueType::Int16, 2 },
+    { "int32", ScanValueType::Int32, 4 },
+    { "int64", ScanValueType::Int64, 8 },
+    { "uint8", ScanValueType::UInt8, 1 },
+    { "uint16", ScanValueType::UInt16, 2 },
+    { "uint32", ScanValueType::UInt32, 4 },
+    { "uint64", ScanValueType::UInt64, 8 },
+    { "float", ScanValueType::Float, 4 },
+    { "double", ScanValueType::Double, 8 },
+};
+
+const struct {
+    const char* name;
+    ValueOp op;
+} VALUE_OPS[] = {
+    { "equal", ValueOp::Equal },
+    { "notEqual", ValueOp::NotEqual },
+    { "range", ValueOp::Range },
+    { "near", ValueOp::Near },
+    { "rounded", ValueOp::Rounded },
+    { "ulps", ValueOp::Ulps },
+    { "truncated", ValueOp::Truncated },
+};
+
+typedef ValueScanner::FindFunction FindFunction;
+typedef ValueScanner::TestFunction TestFunction;
+
+template <typename T>
+inline T Load(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+inline unsigned LowestSetBit(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+// Integer queries arrive as Near only after being turned into a Range, so
+// the integer overload is the same inclusive bound test
+template <typename T>
+inline bool Within(T current, T value, T tolerance, std::true_type) {
+    return std::abs(current - value) <= tolerance;
+}
+
+template <typename T>
+inline bool Within(T current, T low, T high, std::false_type) {
+    return current >= low && current <= high;
+}
+
+template <typename T, ValueOp Op>
+inline bool Passes(T current, T a, T b) {
+    switch (Op) {
+        case ValueOp::Equal:    return current == a;
+        case ValueOp::NotEqual: return !(current == a);
+        case ValueOp::Range:    return current >= a && current <= b;
+        case ValueOp::Near:     return Within(current, a, b, typename std::is_floating_point<T>::type());
+        default:                return false;
+    }
+}
+
+template <typename T, ValueOp Op>
+bool TestValue(const uint8_t* operands, const uint8_t* value) {
+    return Passes<T, Op>(Load<T>(value), Load<T>(operands), Load<T>(operands + 8));
+}
+
+// Reference kernel; also finishes the tail the SIMD kernel cannot load
+template <typename T, bool Aligned, ValueOp Op>
+size_t FindScalar(const uint8_t* operands, const uint8_t* data, size_t, size_t from, size_t limit,
+                  std::vector<size_t>& offsets, size_t maxResults) {
+    const T a = Load<T>(operands);
+    const T b = Load<T>(operands + 8);
+    const size_t step = Aligned ? sizeof(T) : 1;
+
+    size_t count = 0;
+    for (size_t i = from; i < limit; i += step) {
+        if (!Passes<T, Op>(Load<T>(data + i), a, b)) continue;
+
+        offsets.push_back(i);
+        if (++count >= maxResults) break;
+    }
+    return count;
+}
+
+#if defined(VALUE_SCANNER_X86)
+
+// Lane-wise compares on 16 bytes. Every lane of a true compare is all ones,
+// so movemask sets all sizeof(T) bits of a passing lane. SSE2 only compares
+// signed lanes, so unsigned lanes are biased by their sign bit first; 64-bit
+// lanes are assembled from 32-bit compares.
+template <typename T>
+struct Lanes;
+
+template <typename Derived>
+struct IntegerLanes {
+    TARGET_SSE2 static __m128i Equal(__m128i x, __m128i a, __m128i) {
+        return Derived::Eq(x, a);
+    }
+    TARGET_SSE2 static __m128i NotEqual(__m128i x, __m128i a, __m128i) {
+        return _mm_andnot_si128(Derived::Eq(x, a), _mm_set1_epi32(-1));
+    }
+    TARGET_SSE2 static __m128i Range(__m128i x, __m128i low, __m128i high) {
+        return _mm_andnot_si128(_mm_or_si128(Derived::Gt(low, x), Derived::Gt(x, high)), _mm_set1_epi32(-1));
+    }
+    TARGET_SSE2 static __m128i Near(__m128i x, __m128i low, __m128i high) {
+        return Range(x, low, high);
+    }
+};
+
+template <>
+struct Lanes<int8_t> : IntegerLanes<Lanes<int8_t>> {
+    TARGET_SSE2 static __m128i Set(int8_t v) { return _mm_set1_epi8(static_cast<char>(v)); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+};
+
+template <>
+struct Lanes<uint8_t> : IntegerLanes<Lanes<uint8_t>> {
+    TARGET_SSE2 static __m128i Set(uint8_t v) { return _mm_set1_epi8(static_cast<char>(v)); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) {
+        const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+        return _mm_cmpgt_epi8(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+};
+
+template <>
+struct Lanes<int16_t> : IntegerLanes<Lanes<int16_t>> {
+    TARGET_SSE2 static __m128i Set(int16_t v) { return _mm_set1_epi16(v); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+};
+
+template <>
+struct Lanes<uint16_t> : IntegerLanes<Lanes<uint16_t>> {
+    TARGET_SSE2 static __m128i Set(uint16_t v) { return _mm_set1_epi16(static_cast<short>(v)); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) {
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        return _mm_cmpgt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+};
+
+template <>
+struct Lanes<int32_t> : IntegerLanes<Lanes<int32_t>> {
+    TARGET_SSE2 static __m128i Set(int32_t v) { return _mm_set1_epi32(v); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+};
+
+template <>
+struct Lanes<uint32_t> : IntegerLanes<Lanes<uint32_t>> {
+    TARGET_SSE2 static __m128i Set(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) {
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+};
+
+// Both halves equal
+TARGET_SSE2 inline __m128i Eq64(__m128i a, __m128i b) {
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// High halves compared signed; on a tie the low halves decide, unsigned
+TARGET_SSE2 inline __m128i Gt64(__m128i a, __m128i b) {
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i highGt = _mm_cmpgt_epi32(a, b);
+    __m128i highEq = _mm_cmpeq_epi32(a, b);
+    __m128i lowGt = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    __m128i gt = _mm_or_si128(highGt, _mm_and_si128(highEq, _mm_shuffle_epi32(lowGt, _MM_SHUFFLE(2, 2, 0, 0))));
+    return _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+template <>
+struct Lanes<int64_t> : IntegerLanes<Lanes<int64_t>> {
+    TARGET_SSE2 static __m128i Set(int64_t v) { return _mm_set1_epi64x(v); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return Eq64(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) { return Gt64(a, b); }
+};
+
+template <>
+struct Lanes<uint64_t> : IntegerLanes<Lanes<uint64_t>> {
+    TARGET_SSE2 static __m128i Set(uint64_t v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+    TARGET_SSE2 static __m128i Eq(__m128i a, __m128i b) { return Eq64(a, b); }
+    TARGET_SSE2 static __m128i Gt(__m128i a, __m128i b) {
+        const __m128i bias = _mm_set1_epi64x(std::numeric_limits<long long>::min());
+        return Gt64(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+};
+
+// Ordered compares are false for NaN, as in the scalar predicates
+template <>
+struct Lanes<float> {
+    TARGET_SSE2 static __m128i Set(float v) { return _mm_castps_si128(_mm_set1_ps(v)); }
+    TARGET_SSE2 static __m128i Equal(__m128i x, __m128i a, __m128i) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(a)));
+    }
+    TARGET_SSE2 static __m128i NotEqual(__m128i x, __m128i a, __m128i) {
+        return _mm_castps_si128(_mm_cmpneq_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(a)));
+    }
+    TARGET_SSE2 static __m128i Range(__m128i x, __m128i low, __m128i high) {
+        __m128 value = _mm_castsi128_ps(x);
+        return _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(value, _mm_castsi128_ps(low)),
+                                           _mm_cmple_ps(value, _mm_castsi128_ps(high))));
+    }
+    TARGET_SSE2 static __m128i Near(__m128i x, __m128i value, __m128i tolerance) {
+        const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 distance = _mm_and_ps(_mm_sub_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(value)), magnitude);
+        return _mm_castps_si128(_mm_cmple_ps(distance, _mm_castsi128_ps(tolerance)));
+    }
+};
+
+template <>
+struct Lanes<double> {
+    TARGET_SSE2 static __m128i Set(double v) { return _mm_castpd_si128(_mm_set1_pd(v)); }
+    TARGET_SSE2 static __m128i Equal(__m128i x, __m128i a, __m128i) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(a)));
+    }
+    TARGET_SSE2 static __m128i NotEqual(__m128i x, __m128i a, __m128i) {
+        return _mm_castpd_si128(_mm_cmpneq_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(a)));
+    }
+    TARGET_SSE2 static __m128i Range(__m128i x, __m128i low, __m128i high) {
+        __m128d value = _mm_castsi128_pd(x);
+        return _mm_castpd_si128(_mm_and_pd(_mm_cmpge_pd(value, _mm_castsi128_pd(low)),
+                                           _mm_cmple_pd(value, _mm_castsi128_pd(high))));
+    }
+    TARGET_SSE2 static __m128i Near(__m128i x, __m128i value, __m128i tolerance) {
+        const __m128d magnitude = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFll));
+        __m128d distance = _mm_and_pd(_mm_sub_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(value)), magnitude);
+        return _mm_castpd_si128(_mm_cmple_pd(distance, _mm_castsi128_pd(tolerance)));
+    }
+};
+
+template <typename T, ValueOp Op>
+TARGET_SSE2 inline uint32_t CompareMask(const uint8_t* data, __m128i a, __m128i b) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i passed;
+    switch (Op) {
+        case ValueOp::Equal:    passed = Lanes<T>::Equal(x, a, b); break;
+        case ValueOp::NotEqual: passed = Lanes<T>::NotEqual(x, a, b); break;
+        case ValueOp::Range:    passed = Lanes<T>::Range(x, a, b); break;
+        default:                passed = Lanes<T>::Near(x, a, b); break;
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(passed));
+}
+
+// One bit per lane: the bit of the lane's first byte
+inline uint32_t LaneStarts(size_t width) {
+    switch (width) {
+        case 1:  return 0xFFFF;
+        case 2:  return 0x5555;
+        case 4:  return 0x1111;
+        default: return 0x0101;
+    }
+}
+
+// Tests the 16 starts [i, i + 16) per block. An aligned block is one load
+// whose lanes are exactly its aligned starts; an unaligned block is loaded at
+// each of the sizeof(T) byte phases, and phase p's lane starts shifted by p
+// fill in the starts between.
+template <typename T, bool Aligned, ValueOp Op>
+TARGET_SSE2
+size_t FindSSE2(const uint8_t* operands, const uint8_t* data, size_t size, size_t from, size_t limit,
+                std::vector<size_t>& offsets, size_t maxResults) {
+    const __m128i a = Lanes<T>::Set(Load<T>(operands));
+    const __m128i b = Lanes<T>::Set(Load<T>(operands + 8));
+    const uint32_t starts = LaneStarts(sizeof(T));
+    const size_t reach = Aligned ? 16 : 16 + sizeof(T) - 1;
+
+    size_t count = 0;
+    size_t i = from;
+    for (; i < limit && i + reach <= size; i += 16) {
+        uint32_t mask = CompareMask<T, Op>(data + i, a, b) & starts;
+        if (!Aligned) {
+            for (size_t phase = 1; phase < sizeof(T); ++phase) {
+                mask |= (CompareMask<T, Op>(data + i + phase, a, b) & starts) << phase;
+            }
+        }
+        if (limit - i < 16) mask &= (1u << (limit - i)) - 1;
+
+        while (mask) {
+            offsets.push_back(i + LowestSetBit(mask));
+            mask &= mask - 1;
+            if (++count >= maxResults) return count;
+        }
+    }
+
+    if (i < limit) {
+        count += FindScalar<T, Aligned, Op>(operands, data, size, i, limit, offsets, maxResults - count);
+    }
+    return count;
+}
+
+#else
+
+template <typename T, bool Aligned, ValueOp Op>
+size_t FindSSE2(const uint8_t* operands, const uint8_t* data, size_t size, size_t from, size_t limit,
+                std::vector<size_t>& offsets, size_t maxResults) {
+    return FindScalar<T, Aligned, Op>(operands, data, size, from, limit, offsets, maxResults);
+}
+
+#endif
+
+template <typename T, bool Aligned, ValueOp Op>
+FindFunction SelectKernel(bool simd) {
+    return simd ? &FindSSE2<T, Aligned, Op> : &FindScalar<T, Aligned, Op>;
+}
+
+// Only the ops PrepareOperands leaves behind have kernels
+template <typename T, bool Aligned>
+FindFunction SelectKernel(ValueOp op, bool simd) {
+    switch (op) {
+        case ValueOp::Equal:    return SelectKernel<T, Aligned, ValueOp::Equal>(simd);
+        case ValueOp::NotEqual: return SelectKernel<T, Aligned, ValueOp::NotEqual>(simd);
+        case ValueOp::Range:    return SelectKernel<T, Aligned, ValueOp::Range>(simd);
+        case ValueOp::Near:     return SelectKernel<T, Aligned, ValueOp::Near>(simd);
+        default:                return nullptr;
+    }
+}
+
+template <typename T>
+TestFunction SelectTest(ValueOp op) {
+    switch (op) {
+        case ValueOp::Equal:    return &TestValue<T, ValueOp::Equal>;
+        case ValueOp::NotEqual: return &TestValue<T, ValueOp::NotEqual>;
+        case ValueOp::Range:    return &TestValue<T, ValueOp::Range>;
+        case ValueOp::Near:     return &TestValue<T, ValueOp::Near>;
+        default:                return nullptr;
+    }
+}
+
+inline int64_t SaturatingSub(int64_t value, uint64_t amount) {
+    uint64_t room = static_cast<uint64_t>(value) - static_cast<uint64_t>(std::numeric_limits<int64_t>::min());
+    return amount >= room ? std::numeric_limits<int64_t>::min()
+                          : static_cast<int64_t>(static_cast<uint64_t>(value) - amount);
+}
+
+inline int64_t SaturatingAdd(int64_t value, uint64_t amount) {
+    uint64_t room = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) - static_cast<uint64_t>(value);
+    return amount >= room ? std::numeric_limits<int64_t>::max()
+                          : static_cast<int64_t>(static_cast<uint64_t>(value) + amount);
+}
+
+inline uint64_t SaturatingSub(uint64_t value, uint64_t amount) {
+    return amount >= value ? 0 : value - amount;
+}
+
+inline uint64_t SaturatingAdd(uint64_t value, uint64_t amount) {
+    return amount >= std::numeric_limits<uint64_t>::max() - value ? std::numeric_limits<uint64_t>::max()
+                                                                   : value + amount;
+}
+
+// The nearest T at or above / at or below d
+template <typename T>
+T CeilTo(double d) {
+    T value = static_cast<T>(d);
+    if (static_cast<double>(value) < d) value = std::nextafter(value, std::numeric_limits<T>::infinity());
+    return value;
+}
+
+template <typename T>
+T FloorTo(double d) {
+    T value = static_cast<T>(d);
+    if (static_cast<double>(value) > d) value = std::nextafter(value, -std::numeric_limits<T>::infinity());
+    return value;
+}
+
+// The nearest T strictly above / below d
+template <typename T>
+T Above(double d) {
+    T value = CeilTo<T>(d);
+    return static_cast<double>(value) == d ? std::nextafter(value, std::numeric_limits<T>::infinity()) : value;
+}
+
+template <typename T>
+T Below(double d) {
+    T value = FloorTo<T>(d);
+    return static_cast<double>(value) == d ? std::nextafter(value, -std::numeric_limits<T>::infinity()) : value;
+}
+
+// Maps a float's bits to an unsigned key in the same order as the values, so
+// adjacent representable values have adjacent keys. -0 shares +0's key, as
+// the range compare treats them as one value.
+template <typename T>
+struct OrderedBits {
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Bits;
+    static constexpr Bits SIGN = static_cast<Bits>(1) << (sizeof(Bits) * 8 - 1);
+
+    static Bits Key(T value) {
+        Bits bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if (!(bits & SIGN)) return bits | SIGN;
+        return bits == SIGN ? SIGN : ~bits + 1;
+    }
+
+    static T Value(Bits key) {
+        Bits bits = (key & SIGN) ? key & ~SIGN : ~(key - 1);
+        T value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+// Closed bounds of the values that display as value with decimals places
+template <typename T>
+void RoundedBounds(double value, uint32_t decimals, T& low, T& high) {
+    double half = 0.5 * std::pow(10.0, -static_cast<double>(decimals));
+    low = CeilTo<T>(value - half);
+    high = FloorTo<T>(value + half);
+}
+
+// Closed bounds of the values at most ulps steps from value, stopping at the
+// infinities so NaNs never fall inside
+template <typename T>
+void UlpBounds(double value, uint32_t ulps, T& low, T& high) {
+    typedef OrderedBits<T> Ordered;
+    typedef typename Ordered::Bits Bits;
+    Bits key = Ordered::Key(static_cast<T>(value));
+    Bits lowest = Ordered::Key(-std::numeric_limits<T>::infinity());
+    Bits highest = Ordered::Key(std::numeric_limits<T>::infinity());
+    low = Ordered::Value(key - std::min<Bits>(ulps, key - lowest));
+    high = Ordered::Value(key + std::min<Bits>(ulps, highest - key));
+}
+
+// Closed bounds of the values that truncate to trunc(value): [n, n + 1) above
+// zero, (n - 1, n] below it and (-1, 1) for zero. From 2^53 up every double
+// is an integer and n + 1 rounds back to n, so only n itself is left.
+template <typename T>
+void TruncatedBounds(double value, T& low, T& high) {
+    double n = std::trunc(value);
+    low = n > 0 || n - 1 == n ? CeilTo<T>(n) : Above<T>(n - 1);
+    high = n < 0 || n + 1 == n ? FloorTo<T>(n) : Below<T>(n + 1);
+}
+
+// Floats keep equal / notEqual / range / near as given; the display modes
+// become ranges. Returns false when nothing can pass.
+template <typename T>
+bool PrepareOperands(const ValueQuery& query, ValueOp& op, T& a, T& b, std::true_type) {
+    op = query.op;
+    switch (query.op) {
+        case ValueOp::Rounded:
+            RoundedBounds<T>(query.value, query.decimals, a, b);
+            op = ValueOp::Range;
+            return a <= b;
+        case ValueOp::Ulps:
+            if (std::isnan(query.value)) return false;
+            UlpBounds<T>(query.value, query.ulps, a, b);
+            op = ValueOp::Range;
+            return true;
+        case ValueOp::Truncated:
+            TruncatedBounds<T>(query.value, a, b);
+            op = ValueOp::Range;
+            return a <= b;
+        default: break;
+    }
+
+    a = static_cast<T>(query.value);
+    b = static_cast<T>(op == ValueOp::Near ? query.tolerance : query.value2);
+    if (op == ValueOp::Range && !(a <= b)) return false;
+    if (op == ValueOp::Near && !(b >= 0)) return false;
+    return true;
+}
+
+// Integers become bounds in a type wide enough for every operand (uint64 for
+// uint64 values, int64 for the rest) and are clamped to T's range
+template <typename T>
+bool PrepareOperands(const ValueQuery& query, ValueOp& op, T& a, T& b, std::false_type) {
+    typedef typename std::conditional<std::is_same<T, uint64_t>::value, uint64_t, int64_t>::type Wide;
+    const Wide min = static_cast<Wide>(std::numeric_limits<T>::min());
+    const Wide max = static_cast<Wide>(std::numeric_limits<T>::max());
+    const Wide value = static_cast<Wide>(query.intValue);
+
+    Wide low, high;
+    switch (query.op) {
+        case ValueOp::Equal:
+            low = high = value;
+            break;
+        case ValueOp::NotEqual:
+            // A value the type cannot hold differs from every value it can
+            if (value < min || value > max) {
+                op = ValueOp::Range;
+                a = std::numeric_limits<T>::min();
+                b = std::numeric_limits<T>::max();
+            } else {
+                op = ValueOp::NotEqual;
+                a = b = static_cast<T>(value);
+            }
+            return true;
+        case ValueOp::Range:
+            low = value;
+            high = static_cast<Wide>(query.intValue2);
+            break;
+        case ValueOp::Near: {
+            if (!(query.tolerance >= 0)) return false;
+            uint64_t tolerance = query.tolerance >= 18446744073709551615.0
+                ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(query.tolerance);
+            low = SaturatingSub(value, tolerance);
+            high = SaturatingAdd(value, tolerance);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    if (low > high || high < min || low > max) return false;
+    a = static_cast<T>(std::max(low, min));
+    b = static_cast<T>(std::min(high, max));
+    op = a == b ? ValueOp::Equal : ValueOp::Range;
+    return true;
+}
+
+template <typename T>
+void Prepare(const ValueQuery& query, uint8_t* operands, FindFunction& find, TestFunction& test) {
+    ValueOp op;
+    T a = T(), b = T();
+    if (!PrepareOperands<T>(query, op, a, b, typename std::is_floating_point<T>::type())) return;
+
+    memcpy(operands, &a, sizeof(T));
+    memcpy(operands + 8, &b, sizeof(T));
+
+#if defined(VALUE_SCANNER_X86)
+    bool simd = PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::SSE2);
+#else
+    bool simd = false;
+#endif
+    find = query.aligned ? SelectKernel<T, true>(op, simd) : SelectKernel<T, false>(op, simd);
+    test = SelectTest<T>(op);
+}
+
+} // namespace
+
+size_t ScanValueSize(ScanValueType type) {
+    for (const auto& entry : VALUE_TYPES) {
+        if (entry.type == type) return entry.size;
+    }
+    return 0;
+}
+
+const char* ScanValueTypeName(ScanValueType type) {
+    for (const auto& entry : VALUE_TYPES) {
+        if (entry.type == type) return entry.name;
+    }
+    return "unknown";
+}
+
+bool ParseScanValueType(const std::string& name, ScanValueType& type) {
+    for (const auto& entry : VALUE_TYPES) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+double ScanValueToDouble(ScanValueType type, const uint8_t* data) {
+    switch (type) {
+        case ScanValueType::Int8:   return Load<int8_t>(data);
+        case ScanValueType::Int16:  return Load<int16_t>(data);
+        case ScanValueType::Int32:  return Load<int32_t>(data);
+        case ScanValueType::Int64:  return static_cast<double>(Load<int64_t>(data));
+        case ScanValueType::UInt8:  return Load<uint8_t>(data);
+        case ScanValueType::UInt16: return Load<uint16_t>(data);
+        case ScanValueType::UInt32: return Load<uint32_t>(data);
+        case ScanValueType::UInt64: return static_cast<double>(Load<uint64_t>(data));
+        case ScanValueType::Float:  return Load<float>(data);
+        case ScanValueType::Double: return Load<double>(data);
+    }
+    return 0;
+}
+
+bool ParseValueOp(const std::string& name, ValueOp& op) {
+    for (const auto& entry : VALUE_OPS) {
+        if (name == entry.name) {
+            op = entry.op;
+            return true;
+        }
+    }
+    return false;
+}
+
+ValueScanner::ValueScanner(const ValueQuery& query)
+    : m_type(query.type), m_width(ScanValueSize(query.type)), m_find(nullptr), m_test(nullptr) {
+    m_step = query.aligned ? m_width : 1;
+    memset(m_operands, 0, sizeof(m_operands));
+
+    switch (query.type) {
+        case ScanValueType::Int8:   Prepare<int8_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::Int16:  Prepare<int16_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::Int32:  Prepare<int32_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::Int64:  Prepare<int64_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::UInt8:  Prepare<uint8_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::UInt16: Prepare<uint16_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::UInt32: Prepare<uint32_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::UInt64: Prepare<uint64_t>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::Float:  Prepare<float>(query, m_operands, m_find, m_test); break;
+        case ScanValueType::Double: Prepare<double>(query, m_operands, m_find, m_test); break;
+    }
+}
+
+size_t ValueScanner::FindAll(const uint8_t* data, size_t size, uintptr_t address, size_t from, size_t limit,
+                             std::vector<size_t>& offsets, size_t maxResults) const {
+    if (!m_find || data == nullptr || size < m_width || maxResults == 0) {
+        return 0;
+    }
+
+    limit = std::min(limit, size - m_width + 1);
+    size_t misalignment = static_cast<size_t>((address + from) % m_step);
+    if (misalignment) from += m_step - misalignment;
+    if (from >= limit) return 0;
+
+    return m_find(m_operands, data, size, from, limit, offsets, maxResults);
+}
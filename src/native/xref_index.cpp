@@ -0,0 +1,214 @@
+#include "include/xref_index.h"
+#include "include/instruction_decoder.h"
+#include "include/region_reader.h"
+#include "include/scan_executor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const uint32_t INDEX_MAGIC = 0x5258484D;   // "MHXR"
+const uint32_t INDEX_VERSION = 1;
+
+// A saved index: this header, the region map (see MemoryHelpers::SaveRegions)
+// padded to 8 bytes, then the entries
+struct XrefIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t processId;
+    uint32_t pointerSize;
+    uint64_t startTime;
+    uint64_t searchStart;
+    uint64_t searchEnd;
+    uint64_t entries;
+    uint64_t regions;
+    uint64_t instructions;
+};
+
+static_assert(sizeof(XrefIndexHeader) == 64, "Saved xref index layout changed");
+
+// Sweeps the piece from `from`, which may lie before it, and sorts its entries
+uint64_t SweepPiece(HANDLE processHandle, const ScanRange& piece, uintptr_t from, size_t readerBudget,
+                    std::vector<XrefEntry>& out) {
+    uintptr_t ownedEnd = piece.start + piece.size;
+    RegionReader reader(processHandle, InstructionDecoder::MAX_LENGTH - 1, readerBudget);
+    RegionChunk chunk;
+    if (!reader.Begin(from, static_cast<size_t>(ownedEnd - from), piece.readAhead)) return 0;
+
+    XrefSweep sweep(from, piece.start, ownedEnd, out);
+    while (reader.Next(chunk)) {
+        if (!sweep.Feed(chunk.address, chunk.data, chunk.size, chunk.last)) break;
+    }
+
+    std::sort(out.begin(), out.end(), XrefByTarget);
+    return sweep.Instructions();
+}
+
+const char* const LOAD_ERROR = "Not a readable xref index file";
+
+} // namespace
+
+XrefIndex::XrefIndex() : m_options(), m_process(), m_instructions(0), m_data(nullptr), m_size(0) {
+}
+
+std::unique_ptr<XrefIndex> XrefIndex::Build(HANDLE processHandle, const XrefIndexOptions& options) {
+    std::unique_ptr<XrefIndex> index(new XrefIndex());
+    index->m_options = options;
+    MemoryHelpers::GetProcessIdentity(processHandle, index->m_process);
+
+    std::vector<ScanRange> ranges;
+    for (const auto& region : MemoryHelpers::GetMemoryRegions(processHandle, true, false)) {
+        uintptr_t start = options.searchStart ? std::max(options.searchStart, region.startAddress) : region.startAddress;
+        uintptr_t end = options.searchEnd ? std::min(options.searchEnd, region.endAddress) : region.endAddress;
+        if (start >= end) continue;
+
+        index->m_regions.push_back(region);
+        ranges.push_back({ start, static_cast<size_t>(end - start), 0 });
+    }
+
+    ScanExecutor& executor = ScanExecutor::Instance();
+    std::vector<ScanRange> pieces = ScanExecutor::SplitRanges(ranges, InstructionDecoder::MAX_LENGTH - 1);
+    std::vector<std::vector<XrefEntry>> found(pieces.size());
+    std::vector<uint64_t> instructions(pieces.size(), 0);
+    size_t readerBudget = RegionReader::MemoryBudget() / executor.Parallelism();
+
+    executor.Run(pieces.size(), [&](size_t task) {
+        // The lead-in stays inside the piece's range
+        const ScanRange& piece = pieces[task];
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), piece.start,
+                                      [](uintptr_t value, const ScanRange& r) { return value < r.start; }) - 1;
+        uintptr_t from = piece.start - std::min<uintptr_t>(XrefSweep::LEAD_IN, piece.start - range->start);
+        instructions[task] = SweepPiece(processHandle, piece, from, readerBudget, found[task]);
+    });
+
+    // Each piece is sorted; merge them into one array
+    std::vector<size_t> bounds(pieces.size() + 1, 0);
+    for (size_t task = 0; task < pieces.size(); ++task) {
+        bounds[task + 1] = bounds[task] + found[task].size();
+        index->m_instructions += instructions[task];
+    }
+    index->m_entries.reserve(bounds[pieces.size()]);
+    for (auto& part : found) {
+        index->m_entries.insert(index->m_entries.end(), part.begin(), part.end());
+        std::vector<XrefEntry>().swap(part);
+    }
+
+    std::vector<XrefEntry>& entries = index->m_entries;
+    MergeXrefRuns(entries, bounds, [&](size_t count, const std::function<void(size_t)>& task) {
+        executor.Run(count, task);
+    });
+
+    index->m_data = entries.data();
+    index->m_size = entries.size();
+    return index;
+}
+
+void XrefIndex::Range(uintptr_t low, uintptr_t high, size_t& begin, size_t& end) const {
+    begin = end = 0;
+    if (low > high) return;
+
+    const XrefEntry* first = std::lower_bound(m_data, m_data + m_size, low, [](const XrefEntry& entry, uintptr_t value) {
+        return entry.target < value;
+    });
+    const XrefEntry* last = std::upper_bound(first, m_data + m_size, high, [](uintptr_t value, const XrefEntry& entry) {
+        return value < entry.target;
+    });
+
+    begin = static_cast<size_t>(first - m_data);
+    end = static_cast<size_t>(last - m_data);
+}
+
+size_t XrefIndex::MemoryUsage() const {
+    size_t regions = m_regions.capacity() * sizeof(MemoryRegionEx);
+    for (const auto& region : m_regions) regions += region.moduleName.capacity();
+    return m_entries.capacity() * sizeof(XrefEntry) + regions;
+}
+
+bool XrefIndex::Save(const std::wstring& path, std::string& error) const {
+    XrefIndexHeader header = {};
+    header.magic = INDEX_MAGIC;
+    header.version = INDEX_VERSION;
+    header.processId = m_process.processId;
+    header.pointerSize = sizeof(uintptr_t);
+    header.startTime = m_process.startTime;
+    header.searchStart = m_options.searchStart;
+    header.searchEnd = m_options.searchEnd;
+    header.entries = m_size;
+    header.regions = m_regions.size();
+    header.instructions = m_instructions;
+
+    std::vector<uint8_t> regions;
+    MemoryHelpers::SaveRegions(m_regions, regions);
+
+    FileSaver saver(path);
+    FileWriter& writer = saver.Writer();
+    writer.Write(&header, sizeof(header));
+    writer.Write(regions.data(), regions.size());
+    writer.Pad(8);
+    writer.Write(m_data, m_size * sizeof(XrefEntry));
+
+    if (!saver.Commit()) {
+        error = "Could not write the xref index file";
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<XrefIndex> XrefIndex::Load(HANDLE processHandle, const std::wstring& path, std::string& error) {
+    std::unique_ptr<XrefIndex> index(new XrefIndex());
+    XrefIndexHeader header;
+    if (!index->m_mapped.Open(path) || index->m_mapped.Size() < sizeof(header)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    const uint8_t* view = index->m_mapped.Data();
+    size_t size = static_cast<size_t>(index->m_mapped.Size());
+    memcpy(&header, view, sizeof(header));
+    if (header.magic != INDEX_MAGIC || header.version != INDEX_VERSION || header.pointerSize != sizeof(uintptr_t)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    ProcessIdentity current = {};
+    if (!MemoryHelpers::GetProcessIdentity(processHandle, current) || current.processId != header.processId ||
+        current.startTime != header.startTime) {
+        error = "The xref index was built from a different process instance";
+        return nullptr;
+    }
+
+    size_t offset = sizeof(header);
+    if (!MemoryHelpers::LoadRegions(view, size, offset, header.regions, index->m_regions)) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    // The entries must fill the rest of the file exactly
+    offset = (offset + 7) & ~static_cast<size_t>(7);
+    if (offset > size || (size - offset) / sizeof(XrefEntry) != header.entries ||
+        (size - offset) % sizeof(XrefEntry) != 0) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    // Lookups binary search by target and name each entry's kind, so the
+    // entries must be in index order and every kind one the sweep produces
+    const XrefEntry* entries = reinterpret_cast<const XrefEntry*>(view + offset);
+    size_t count = static_cast<size_t>(header.entries);
+    bool indexed = true;
+    for (size_t i = 0; i < count && indexed; ++i) {
+        indexed = entries[i].Kind() <= XrefKind::Data && (i == 0 || !XrefByTarget(entries[i], entries[i - 1]));
+    }
+    if (!indexed) {
+        error = LOAD_ERROR;
+        return nullptr;
+    }
+
+    index->m_options.searchStart = static_cast<uintptr_t>(header.searchStart);
+    index->m_options.searchEnd = static_cast<uintptr_t>(header.searchEnd);
+    index->m_process = current;
+    index->m_instructions = header.instructions;
+    index->m_data = entries;
+    index->m_size = count;
+    return index;
+}
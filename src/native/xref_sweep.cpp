@@ -0,0 +1,71 @@
+#include "include/xref_sweep.h"
+#include "include/instruction_decoder.h"
+#include <algorithm>
+
+XrefSweep::XrefSweep(uintptr_t from, uintptr_t ownedStart, uintptr_t ownedEnd, std::vector<XrefEntry>& out)
+    : m_cursor(from), m_ownedStart(ownedStart), m_ownedEnd(ownedEnd), m_instructions(0), m_out(out) {
+}
+
+bool XrefSweep::Feed(uintptr_t address, const uint8_t* data, size_t size, bool last) {
+    const size_t maxLength = InstructionDecoder::MAX_LENGTH;
+    DecodedInstruction instruction;
+
+    // An unreadable page was skipped; carry on from the next readable byte
+    if (m_cursor < address) m_cursor = address;
+
+    while (m_cursor < m_ownedEnd) {
+        size_t offset = static_cast<size_t>(m_cursor - address);
+        if (offset >= size) break;
+
+        // An instruction this close to the end may run into the next chunk,
+        // which starts with these bytes again
+        size_t available = size - offset;
+        if (available < maxLength && !last) break;
+
+        // Two zero bytes decode as ADD [RAX], AL, which compilers do not
+        // emit; they are the padding between sections, and decoding an
+        // odd run of them would swallow the first byte after it
+        if (available > 1 && data[offset] == 0 && data[offset + 1] == 0) {
+            while (offset < size && data[offset] == 0) offset++;
+            m_cursor = address + offset;
+            continue;
+        }
+
+        if (!InstructionDecoder::Decode(data + offset, available, m_cursor, instruction)) {
+            m_cursor++;
+            continue;
+        }
+
+        if (m_cursor >= m_ownedStart) {
+            m_instructions++;
+            if (instruction.branch == BranchKind::Call) {
+                m_out.push_back(XrefEntry::Make(instruction.branchTarget, m_cursor, XrefKind::Call));
+            } else if (instruction.branch == BranchKind::Jump) {
+                m_out.push_back(XrefEntry::Make(instruction.branchTarget, m_cursor, XrefKind::Jump));
+            } else if (instruction.branch == BranchKind::Conditional) {
+                m_out.push_back(XrefEntry::Make(instruction.branchTarget, m_cursor, XrefKind::Branch));
+            }
+            if (instruction.ripRelative) {
+                m_out.push_back(XrefEntry::Make(instruction.memoryTarget, m_cursor, XrefKind::Data));
+            }
+        }
+        m_cursor += instruction.length;
+    }
+    return m_cursor < m_ownedEnd;
+}
+
+void MergeXrefRuns(std::vector<XrefEntry>& entries, const std::vector<size_t>& bounds,
+                   const std::function<void(size_t, const std::function<void(size_t)>&)>& run) {
+    size_t runs = bounds.empty() ? 0 : bounds.size() - 1;
+    for (size_t width = 1; width < runs; width *= 2) {
+        run((runs + 2 * width - 1) / (2 * width), [&](size_t merge) {
+            size_t first = merge * 2 * width;
+            size_t middle = std::min(first + width, runs);
+            size_t last = std::min(first + 2 * width, runs);
+            if (middle < last) {
+                std::inplace_merge(entries.begin() + bounds[first], entries.begin() + bounds[middle],
+                                   entries.begin() + bounds[last], XrefByTarget);
+            }
+        });
+    }
+}
@@ -206,12 +206,103 @@ export interface PatternMatch {
   data: number[];
 }
 
+// Encodings searchString can look for in one pass
+export type StringEncoding = "utf8" | "utf16le" | "utf16be";
+
+export interface StringMatch extends PatternMatch {
+  encoding: StringEncoding;
+}
+
+// One printable run found by extractStrings; utf8 runs are plain ASCII
+export interface ExtractedString {
+  address: number;
+  encoding: StringEncoding;
+  length: number; // Characters in the run; text is cut at 4096
+  text: string;
+}
+
+export interface StringExtractionStats {
+  strings: number;
+  regions: number;
+  bytesScanned: number;
+  stopped: boolean; // The callback or the output file ended the extraction early
+}
+
+export interface MultiPatternMatch extends PatternMatch {
+  patternId: number;
+}
+
+// Opaque handle to a signature compiled natively by compileSignature; reuse it
+// across scans to skip parsing and matcher setup
+export type SignatureHandle = object & { readonly __signature: unique symbol };
+
 export interface NumericMatch {
   address: number;
   dataType: string;
   rawData: number[];
 }
 
+// Value types and comparisons understood by scan sessions
+export type ScanValueType =
+  | "int8"
+  | "int16"
+  | "int32"
+  | "int64"
+  | "uint8"
+  | "uint16"
+  | "uint32"
+  | "uint64"
+  | "float"
+  | "double";
+
+export type ScanCompare =
+  | "unknown"
+  | "equal"
+  | "notEqual"
+  | "range"
+  | "rounded"
+  | "ulps"
+  | "truncated"
+  | "changed"
+  | "unchanged"
+  | "increased"
+  | "decreased"
+  | "increasedBy"
+  | "decreasedBy";
+
+// Opaque handle to a native scan session created by createScanSession; the
+// candidate set lives natively until the handle is collected
+export type ScanSessionHandle = object & { readonly __scanSession: unique symbol };
+
+export interface ScanSessionMatch extends NumericMatch {
+  value: number;
+}
+
+// Predicates of a one-shot value search; near keeps values within tolerance
+// of value. rounded (displays as value with `decimals` places), ulps (within
+// `ulps` representable steps of value) and truncated (truncates to value)
+// are for float and double only.
+export type ValueOp =
+  | "equal"
+  | "notEqual"
+  | "range"
+  | "near"
+  | "rounded"
+  | "ulps"
+  | "truncated";
+
+export interface ValueMatch extends NumericMatch {
+  value: number;
+}
+
+// address is the lowest member address and size runs from there to the end
+// of the highest member; members are in query order
+export interface GroupMatch {
+  address: number;
+  size: number;
+  members: ValueMatch[];
+}
+
 export interface MemoryRegionEx {
   startAddress: number;
   endAddress: number;
@@ -230,6 +321,13 @@ export interface PatternSearchOptions {
 export interface StringSearchOptions extends PatternSearchOptions {
   caseSensitive?: boolean;
   unicode?: boolean;
+  encodings?: StringEncoding[];
+}
+
+export interface StringExtractionOptions extends PatternSearchOptions {
+  minLength?: number;
+  encodings?: StringEncoding[];
+  batchSize?: number;
 }
 
 export interface NumericSearchOptions extends PatternSearchOptions {
@@ -237,11 +335,184 @@ export interface NumericSearchOptions extends PatternSearchOptions {
   tolerance?: number;
 }
 
+// value is the operand of equal / notEqual / near and the lower bound of
+// range; value2 is the upper bound of range. A bigint keeps 64-bit integers
+// exact.
+export interface ValueSearchQuery extends PatternSearchOptions {
+  type: ScanValueType;
+  op?: ValueOp;
+  value?: number | bigint;
+  value2?: number | bigint;
+  tolerance?: number;
+  decimals?: number;
+  ulps?: number;
+  aligned?: boolean;
+}
+
+export type GroupMemberQuery = Omit<ValueSearchQuery, "searchStart" | "searchEnd">;
+
+// Every member must lie within window bytes of the others (default 64, at
+// most 65536); ordered groups have their members at increasing addresses in
+// query order. Members never overlap.
+export interface GroupSearchQuery extends PatternSearchOptions {
+  members: GroupMemberQuery[];
+  window?: number;
+  ordered?: boolean;
+}
+
+// memoryLimit is how many bytes of candidates stay in memory before the rest
+// spills to a temporary file (default 256 MB)
+export interface ScanSessionOptions extends PatternSearchOptions {
+  aligned?: boolean;
+  writableOnly?: boolean;
+  // Only addresses inside module images, which keep their module offset
+  // across runs
+  moduleImagesOnly?: boolean;
+  memoryLimit?: number;
+}
+
+export interface ScanSessionStats {
+  candidates: number;
+  scans: number;
+  memoryBytes: number;
+  diskBytes: number;
+  regions: number;
+}
+
+// value is the operand of equal / notEqual / increasedBy / decreasedBy /
+// rounded / ulps / truncated and the lower bound of range; value2 is the
+// upper bound of range
+export interface ScanFilterOptions {
+  value?: number;
+  value2?: number;
+  tolerance?: number;
+  decimals?: number;
+  ulps?: number;
+}
+
 export interface PointerSearchOptions extends PatternSearchOptions {
   maxDepth?: number;
   offsets?: number[];
 }
 
+// Opaque handle to a native pointer map created by buildPointerMap: every
+// pointer in the target, indexed by the address it points to
+export type PointerMapHandle = object & { readonly __pointerMap: unique symbol };
+
+// searchStart / searchEnd bound where pointers are looked for; they may point
+// anywhere in committed memory
+export interface PointerMapOptions extends PatternSearchOptions {
+  writableOnly?: boolean;
+  // Only static pointers, stored inside module images; such a map answers
+  // "which static pointers point here" but cannot be used for path scans
+  moduleImagesOnly?: boolean;
+}
+
+export interface PointerMapStats {
+  pointers: number;
+  regions: number;
+  memoryBytes: number;
+}
+
+// Reading the pointer at base, adding offsets[0], reading the pointer there,
+// and so on, ends at the target; expression reads like
+// "game.exe+0x1A2B40 → +0x18 → +0x230"
+export interface PointerPath {
+  base: number;
+  module: string;
+  moduleOffset: number;
+  offsets: number[];
+  expression: string;
+}
+
+// maxDepth is the number of pointer reads (default 5), maxOffset the largest
+// offset added after each read (default 0x1000), maxPaths the cap on results
+// (default 10000)
+export interface PointerPathOptions {
+  maxDepth?: number;
+  maxOffset?: number;
+  maxPaths?: number;
+}
+
+// nodes counts the pointer locations visited; truncated is set when maxPaths
+// or the search's node limit was reached
+export interface PointerPathScanResult {
+  paths: PointerPath[];
+  nodes: number;
+  truncated: boolean;
+}
+
+// Opaque handle to a native set of module-relative pointer paths, created by
+// createPointerPathSet or loadPointerPathSet; unlike scan sessions and
+// pointer maps it is not tied to one run of the target
+export type PointerPathSetHandle = object & { readonly __pointerPathSet: unique symbol };
+
+// A pointer path without its absolute base, as kept in a path set
+export type StoredPointerPath = Omit<PointerPath, "base">;
+
+// Opaque handle to pointer chains compiled by compileChains for resolving
+// many times, e.g. once per frame
+export type ChainSetHandle = object & { readonly __chainSet: unique symbol };
+
+// A section of a module image; names are ".text" and the like for PE images
+export interface ModuleSection {
+  name: string;
+  moduleOffset: number;
+  size: number;
+}
+
+export interface ModuleSections {
+  name: string;
+  base: number;
+  size: number;
+  sections: ModuleSection[];
+}
+
+// An address in terms that survive ASLR; section is null in the image
+// headers or between sections
+export interface ModuleAddress {
+  module: string;
+  section: string | null;
+  moduleOffset: number;
+}
+
+export interface ChainSetStats {
+  chains: number;
+  // Distinct pointers read per resolve, after merging shared prefixes
+  nodes: number;
+  // Read calls made by the last resolve
+  reads: number;
+}
+
+// Opaque handle to a native cross-reference index created by buildXrefIndex:
+// every direct branch and RIP-relative operand in executable memory, indexed
+// by the address referenced
+export type XrefIndexHandle = object & { readonly __xrefIndex: unique symbol };
+
+// call, jmp, conditional jumps and loops, or a RIP-relative memory operand
+export type XrefKind = "call" | "jump" | "branch" | "data";
+
+export interface Xref {
+  // Address of the referencing instruction
+  source: number;
+  target: number;
+  kind: XrefKind;
+}
+
+export interface XrefSearchOptions {
+  kind?: XrefKind;
+  // Find references to anywhere in [target, rangeEnd], e.g. into a struct
+  rangeEnd?: number;
+  maxResults?: number;
+}
+
+export interface XrefIndexStats {
+  references: number;
+  instructions: number;
+  regions: number;
+  memoryBytes: number;
+}
+
 export interface RegionFilterOptions {
   executableOnly?: boolean;
   writableOnly?: boolean;
@@ -416,6 +687,72 @@ export interface MemoryHookingNative {
   ): PointerResult[];
   findNullPointers(searchStart: number, searchEnd: number): number[];
 
+  // Memory Helpers - Pointer Maps
+  buildPointerMap(
+    searchStart?: number,
+    searchEnd?: number,
+    writableOnly?: boolean,
+    moduleImagesOnly?: boolean
+  ): PointerMapHandle;
+  pointerMapFind(
+    map: PointerMapHandle,
+    targetAddress: number,
+    maxResults?: number
+  ): PointerResult[];
+  pointerMapStats(map: PointerMapHandle): PointerMapStats;
+  savePointerMap(map: PointerMapHandle, path: string): boolean;
+  loadPointerMap(path: string): PointerMapHandle;
+  scanPointerPaths(
+    map: PointerMapHandle,
+    targetAddress: number,
+    maxDepth?: number,
+    maxOffset?: number,
+    maxPaths?: number
+  ): {
+    paths: Omit<PointerPath, "expression">[];
+    nodes: number;
+    truncated: boolean;
+  };
+
+  // Memory Helpers - Pointer Path Sets
+  createPointerPathSet(
+    paths: Pick<PointerPath, "module" | "moduleOffset" | "offsets">[]
+  ): PointerPathSetHandle;
+  pointerPathSetPaths(
+    set: PointerPathSetHandle,
+    maxResults?: number
+  ): Omit<StoredPointerPath, "expression">[];
+  pointerPathSetCount(set: PointerPathSetHandle): number;
+  validatePointerPathSet(set: PointerPathSetHandle, targetAddress: number): number;
+  intersectPointerPathSets(
+    set: PointerPathSetHandle,
+    other: PointerPathSetHandle
+  ): number;
+  savePointerPathSet(set: PointerPathSetHandle, path: string): boolean;
+  loadPointerPathSet(path: string): PointerPathSetHandle;
+
+  // Memory Helpers - Pointer Chains
+  compileChains(expressions: string[]): ChainSetHandle;
+  resolveChains(chains: ChainSetHandle): Float64Array;
+  chainSetStats(chains: ChainSetHandle): ChainSetStats;
+
+  // Memory Helpers - Address Space
+  getModuleSections(): ModuleSections[];
+  locateAddresses(addresses: number[]): (ModuleAddress | null)[];
+
+  // Memory Helpers - Cross References
+  buildXrefIndex(searchStart?: number, searchEnd?: number): XrefIndexHandle;
+  xrefIndexFind(
+    index: XrefIndexHandle,
+    low: number,
+    high?: number,
+    kind?: XrefKind,
+    maxResults?: number
+  ): Xref[];
+  xrefIndexStats(index: XrefIndexHandle): XrefIndexStats;
+  saveXrefIndex(index: XrefIndexHandle, path: string): boolean;
+  loadXrefIndex(path: string): XrefIndexHandle;
+
   // Memory Helpers - Pattern Searching
   searchBytePattern(
     pattern: number[],
@@ -423,6 +760,18 @@ export interface MemoryHookingNative {
     searchStart?: number,
     searchEnd?: number
   ): PatternMatch[];
+  searchMultiplePatterns(
+    patterns: Array<number[] | string>,
+    masks?: boolean[][],
+    searchStart?: number,
+    searchEnd?: number
+  ): MultiPatternMatch[];
+  compileSignature(signature: string): SignatureHandle;
+  searchSignature(
+    signature: SignatureHandle,
+    searchStart?: number,
+    searchEnd?: number
+  ): PatternMatch[];
   searchStringPattern(
     pattern: string,
     caseSensitive?: boolean,
@@ -430,37 +779,75 @@ export interface MemoryHookingNative {
     searchStart?: number,
     searchEnd?: number
   ): PatternMatch[];
+  searchString(
+    text: string,
+    encodings?: StringEncoding[],
+    caseSensitive?: boolean,
+    searchStart?: number,
+    searchEnd?: number
+  ): StringMatch[];
   searchRegexPattern(
     regexPattern: string,
     searchStart?: number,
     searchEnd?: number
   ): PatternMatch[];
-
-  // Memory Helpers - Numeric Searching
-  searchInt32(
-    value: number,
+  // onBatch returns false to stop early; scans started from it throw
+  extractStrings(
+    onBatch: (batch: ExtractedString[]) => boolean | void,
+    minLength?: number,
+    encodings?: StringEncoding[],
     searchStart?: number,
     searchEnd?: number,
-    aligned?: boolean
-  ): NumericMatch[];
-  searchInt64(
-    value: number,
+    batchSize?: number
+  ): StringExtractionStats;
+  extractStringsToFile(
+    path: string,
+    minLength?: number,
+    encodings?: StringEncoding[],
+    searchStart?: number,
+    searchEnd?: number
+  ): StringExtractionStats;
+
+  // Memory Helpers - Numeric Searching
+  searchValue(query: ValueSearchQuery): ValueMatch[];
+  searchGroup(query: GroupSearchQuery): GroupMatch[];
+
+  // Memory Helpers - Scan Sessions
+  createScanSession(
+    type: ScanValueType,
+    aligned?: boolean,
+    writableOnly?: boolean,
     searchStart?: number,
     searchEnd?: number,
-    aligned?: boolean
-  ): NumericMatch[];
-  searchFloat(
-    value: number,
+    memoryLimit?: number,
+    moduleImagesOnly?: boolean
+  ): ScanSessionHandle;
+  scanSessionFirst(
+    session: ScanSessionHandle,
+    compare: ScanCompare,
+    value?: number,
+    value2?: number,
     tolerance?: number,
-    searchStart?: number,
-    searchEnd?: number
-  ): NumericMatch[];
-  searchDouble(
-    value: number,
+    decimals?: number,
+    ulps?: number
+  ): number;
+  scanSessionNext(
+    session: ScanSessionHandle,
+    compare: ScanCompare,
+    value?: number,
+    value2?: number,
     tolerance?: number,
-    searchStart?: number,
-    searchEnd?: number
-  ): NumericMatch[];
+    decimals?: number,
+    ulps?: number
+  ): number;
+  scanSessionCount(session: ScanSessionHandle): number;
+  scanSessionStats(session: ScanSessionHandle): ScanSessionStats;
+  saveScanSession(session: ScanSessionHandle, path: string): boolean;
+  loadScanSession(path: string, memoryLimit?: number): ScanSessionHandle;
+  scanSessionResults(
+    session: ScanSessionHandle,
+    maxResults?: number
+  ): ScanSessionMatch[];
 
   // Memory Helpers - Region Analysis
   getMemoryRegionsEx(
@@ -497,6 +884,10 @@ export interface MemoryHookingNative {
   formatAddress(address: number, withPrefix?: boolean): string;
   isValidCodeAddress(address: number): boolean;
   getAlignment(address: number): number;
+  setScanMemoryBudget(bytes: number): number;
+  getScanMemoryBudget(): number;
+  setScanParallelism(threads: number): number;
+  getScanParallelism(): number;
 
   // Automation Helpers - Mouse Control
   moveMouse(x: number, y: number): boolean;
@@ -0,0 +1,168 @@
+// Differential test of the lazy-DFA ByteRegex against std::regex. Random
+// patterns use the syntax both accept, in POSIX extended mode; inputs hold no
+// newlines, so "." means the same in both. A pattern must be rejected exactly
+// when it can match the empty string, and otherwise find the same
+// non-overlapping leftmost-longest matches. libstdc++ does not always return
+// the longest POSIX match, so the reference only asks std::regex whether a
+// whole substring matches and searches for the leftmost-longest one itself.
+#include "byte_regex.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, const std::string& pattern, const std::string& input) {
+    if (++g_failures <= 20) {
+        std::printf("FAIL %s: pattern \"%s\", input \"%s\"\n", what, pattern.c_str(), input.c_str());
+    }
+}
+
+std::string RandomAtom(std::mt19937& rng, int depth);
+
+std::string RandomAlternation(std::mt19937& rng, int depth) {
+    std::string pattern;
+    size_t branches = rng() % 4 == 0 ? 2 + rng() % 2 : 1;
+    for (size_t branch = 0; branch < branches; ++branch) {
+        if (branch > 0) pattern += '|';
+        size_t items = 1 + rng() % 3;
+        for (size_t i = 0; i < items; ++i) pattern += RandomAtom(rng, depth);
+    }
+    return pattern;
+}
+
+// Groups only take bounded repeats: std::regex backtracks, and a group under
+// "*" or "+" can take it exponential time
+std::string RandomAtom(std::mt19937& rng, int depth) {
+    static const char* const CLASSES[] = { "[ab]", "[^a]", "[a-c]", "[^bc]", "[cd]" };
+    std::string atom;
+    bool group = false;
+    switch (rng() % 8) {
+        case 0: atom = "."; break;
+        case 1: atom = CLASSES[rng() % 5]; break;
+        case 2:
+            if (depth < 2) {
+                atom = "(" + RandomAlternation(rng, depth + 1) + ")";
+                group = true;
+                break;
+            }
+            // fall through
+        default: atom = std::string(1, "abcd"[rng() % 4]); break;
+    }
+
+    switch (rng() % 10) {
+        case 0: atom += group ? "?" : "*"; break;
+        case 1: atom += group ? "{1,2}" : "+"; break;
+        case 2: atom += '?'; break;
+        case 3: {
+            size_t min = rng() % 3;
+            atom += "{" + std::to_string(min) + "," + std::to_string(min + rng() % 3) + "}";
+            break;
+        }
+        case 4: atom += "{" + std::to_string(1 + rng() % 3) + "}"; break;
+        default: break;
+    }
+    return atom;
+}
+
+std::string RandomInput(std::mt19937& rng, size_t size) {
+    std::string input(size, 'a');
+    for (char& c : input) c = rng() % 16 == 0 ? "xyz0_ "[rng() % 6] : "abcd"[rng() % 4];
+    return input;
+}
+
+// Matches as (start, end), each search resuming at the previous end; no
+// match is longer than maxLength
+std::vector<std::pair<size_t, size_t>> ReferenceMatches(const std::regex& reference, const std::string& input,
+                                                        size_t maxLength) {
+    std::vector<std::pair<size_t, size_t>> matches;
+    size_t start = 0;
+    while (start < input.size()) {
+        // Some match starts here; the longest is found from the top down
+        std::smatch match;
+        if (!std::regex_search(input.begin() + start, input.end(), match, reference,
+                               std::regex_constants::match_continuous)) {
+            start++;
+            continue;
+        }
+        size_t end = input.size() - start > maxLength ? start + maxLength : input.size();
+        while (end > start && !std::regex_match(input.begin() + start, input.begin() + end, reference)) end--;
+        if (end == start) {
+            start++;
+            continue;
+        }
+        matches.emplace_back(start, end);
+        start = end;
+    }
+    return matches;
+}
+
+std::vector<std::pair<size_t, size_t>> ByteRegexMatches(ByteRegex::Matcher& matcher, const std::string& input) {
+    std::vector<std::pair<size_t, size_t>> matches;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+    size_t from = 0;
+    size_t start, end;
+    while (matcher.Find(data, input.size(), from, input.size(), start, end)) {
+        matches.emplace_back(start, end);
+        from = end;
+    }
+    return matches;
+}
+
+void Check(const std::string& pattern, const std::string& input, size_t maxLength) {
+    std::regex reference(pattern, std::regex::extended);
+    std::string error;
+    std::unique_ptr<ByteRegex> regex = ByteRegex::Compile(pattern, error);
+
+    bool matchesEmpty = std::regex_match(std::string(), reference);
+    if (matchesEmpty != (regex == nullptr)) {
+        Fail(matchesEmpty ? "accepted an empty-matching pattern" : "rejected a pattern", pattern, input);
+        return;
+    }
+    if (!regex) return;
+
+    ByteRegex::Matcher matcher(*regex);
+    if (ByteRegexMatches(matcher, input) != ReferenceMatches(reference, input, maxLength)) Fail("matches", pattern, input);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240611);
+
+    for (unsigned iteration = 0; iteration < 3000; ++iteration) {
+        std::string pattern = RandomAlternation(rng, 0);
+        for (unsigned input = 0; input < 4; ++input) Check(pattern, RandomInput(rng, rng() % 40), SIZE_MAX);
+    }
+
+    // "." stops at line breaks, which std::regex in extended mode does not
+    std::string error;
+    std::unique_ptr<ByteRegex> dot = ByteRegex::Compile("a.b", error);
+    ByteRegex::Matcher dotMatcher(*dot);
+    std::vector<std::pair<size_t, size_t>> expected = { { 8, 11 } };
+    if (ByteRegexMatches(dotMatcher, "a\nb a\rb a-b") != expected) Fail("dot", "a.b", "a\\nb a\\rb a-b");
+
+    // The unanchored search for this pattern has a state for every run of
+    // the last twelve bytes, more than the DFA cache holds, so it is flushed
+    // and rebuilt many times over a long input
+    const std::string wide = "a(a|b){11}b";
+    for (unsigned iteration = 0; iteration < 4; ++iteration) {
+        std::string input(8192, 'a');
+        for (char& c : input) c = "ab"[rng() % 2];
+        Check(wide, input, 13);
+    }
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("regex patterns OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#ifndef DECODER_FIXTURE_H
+#define DECODER_FIXTURE_H
+
+// Loads fixtures/decoder_text.{bin,snapshot}: the .text of an x86-64 ELF
+// file and what objdump decoded it as (see make_decoder_fixture.js).
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct FixtureInstruction {
+    uintptr_t address;
+    size_t length;
+    std::string branch;       // "call", "jump", "branch" or empty
+    uintptr_t branchTarget;
+    bool ripRelative;
+    uintptr_t memoryTarget;
+};
+
+struct DecoderFixture {
+    uintptr_t base = 0;
+    std::vector<uint8_t> code;
+    std::vector<FixtureInstruction> instructions;
+};
+
+inline bool LoadDecoderFixture(const std::string& prefix, DecoderFixture& fixture) {
+    std::ifstream bin(prefix + ".bin", std::ios::binary);
+    std::ifstream snapshot(prefix + ".snapshot");
+    if (!bin || !snapshot) {
+        std::printf("cannot read %s.bin / .snapshot\n", prefix.c_str());
+        return false;
+    }
+    fixture.code.assign(std::istreambuf_iterator<char>(bin), std::istreambuf_iterator<char>());
+
+    std::string line, word;
+    if (!std::getline(snapshot, line) || line.compare(0, 5, "base ") != 0) return false;
+    fixture.base = static_cast<uintptr_t>(strtoull(line.c_str() + 5, nullptr, 16));
+
+    uintptr_t address = fixture.base;
+    while (std::getline(snapshot, line)) {
+        std::istringstream words(line);
+        FixtureInstruction instruction = { address, 0, "", 0, false, 0 };
+        if (!(words >> word)) continue;
+        instruction.length = static_cast<size_t>(strtoull(word.c_str(), nullptr, 16));
+        while (words >> word) {
+            std::string value;
+            words >> value;
+            uintptr_t target = static_cast<uintptr_t>(strtoull(value.c_str(), nullptr, 16));
+            if (word == "rip") {
+                instruction.ripRelative = true;
+                instruction.memoryTarget = target;
+            } else {
+                instruction.branch = word;
+                instruction.branchTarget = target;
+            }
+        }
+        fixture.instructions.push_back(instruction);
+        address += instruction.length;
+    }
+    return address == fixture.base + fixture.code.size();
+}
+
+#endif // DECODER_FIXTURE_H
@@ -0,0 +1,73 @@
+// Regenerates the instruction decoder fixture from the .text section of an
+// x86-64 ELF file:
+//
+//   node make_decoder_fixture.js <elf> [outputPrefix]
+//
+// writes <outputPrefix>.bin (the raw section) and <outputPrefix>.snapshot,
+// which records what `objdump -D -z -b binary -m i386:x86-64` makes of it. Each
+// snapshot line is one instruction in order, all numbers in hex:
+//
+//   <length> [call|jump|branch <target>] [rip <target>]
+//
+// The first line gives the address of the first byte as "base <address>".
+'use strict';
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+
+const [elf, prefix = 'decoder_text'] = process.argv.slice(2);
+if (!elf) {
+  console.error('usage: node make_decoder_fixture.js <elf> [outputPrefix]');
+  process.exit(1);
+}
+
+const headers = execFileSync('objdump', ['-h', elf], { encoding: 'utf8' });
+const text = headers.match(/^\s*\d+\s+\.text\s+([0-9a-f]+)\s+([0-9a-f]+)/m);
+if (!text) throw new Error('no .text section in ' + elf);
+const size = parseInt(text[1], 16);
+const base = parseInt(text[2], 16);
+
+execFileSync('objcopy', ['-O', 'binary', '--only-section=.text', elf, prefix + '.bin']);
+if (fs.statSync(prefix + '.bin').size !== size) throw new Error('.text size mismatch');
+
+const listing = execFileSync('objdump', ['-D', '-z', '-b', 'binary', '-m', 'i386:x86-64', '--no-show-raw-insn',
+                                         '--adjust-vma=0x' + base.toString(16), prefix + '.bin'],
+                             { encoding: 'utf8', maxBuffer: 1 << 30 });
+
+// Prefixes objdump prints ahead of the mnemonic
+const PREFIXES = new Set(['bnd', 'notrack', 'rep', 'repz', 'repe', 'repnz', 'repne', 'lock', 'data16',
+                          'addr32', 'cs', 'ds', 'es', 'fs', 'gs', 'ss', 'xacquire', 'xrelease']);
+
+const instructions = [];
+for (const line of listing.split('\n')) {
+  const match = line.match(/^\s*([0-9a-f]+):\t(.*)$/);
+  if (!match) continue;
+
+  const address = parseInt(match[1], 16);
+  const words = match[2].trim().split(/\s+/);
+  while (words.length > 1 && (PREFIXES.has(words[0]) || words[0].startsWith('rex'))) words.shift();
+  const mnemonic = words[0] || '';
+  const operand = words[1] || '';
+
+  let branch = null;
+  const target = operand.match(/^(?:0x)?([0-9a-f]+)$/);
+  if (target) {
+    if (/^call/.test(mnemonic)) branch = 'call';
+    else if (/^jmp/.test(mnemonic)) branch = 'jump';
+    else if (/^(j[a-z]+|loop[a-z]*)$/.test(mnemonic)) branch = 'branch';
+  }
+
+  const rip = /\(%rip\)/.test(match[2]) ? match[2].match(/#\s*(?:0x)?([0-9a-f]+)/) : null;
+  instructions.push({ address, branch: branch && [branch, target[1]], rip: rip && rip[1] });
+}
+
+const out = ['base ' + base.toString(16)];
+instructions.forEach((instruction, i) => {
+  const end = i + 1 < instructions.length ? instructions[i + 1].address : base + size;
+  let entry = (end - instruction.address).toString(16);
+  if (instruction.branch) entry += ' ' + instruction.branch.join(' ');
+  if (instruction.rip) entry += ' rip ' + instruction.rip;
+  out.push(entry);
+});
+fs.writeFileSync(prefix + '.snapshot', out.join('\n') + '\n');
+console.log(`${instructions.length} instructions, ${size} bytes at 0x${base.toString(16)}`);
@@ -0,0 +1,123 @@
+// Runs GroupScanner over zero-filled buffers, the case where every zero
+// member has a candidate at almost every offset. A member that never occurs,
+// or that cannot be placed, must reject the anchor without a search that
+// grows with the window and the number of zero members.
+#include "group_scanner.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("FAIL line %d: %s\n", __LINE__, #condition); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+const int32_t ANCHOR = 0x12345678;
+
+ValueQuery Int32(int32_t value) {
+    ValueQuery query = {};
+    query.type = ScanValueType::Int32;
+    query.op = ValueOp::Equal;
+    query.aligned = false;
+    query.intValue = value;
+    return query;
+}
+
+void Put(std::vector<uint8_t>& buffer, size_t offset, int32_t value) {
+    memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+// The anchor, zeros members equal to 0, then the extra members
+std::vector<ValueQuery> Members(size_t zeros, const std::vector<int32_t>& extra) {
+    std::vector<ValueQuery> members(1, Int32(ANCHOR));
+    for (size_t i = 0; i < zeros; ++i) members.push_back(Int32(0));
+    for (int32_t value : extra) members.push_back(Int32(value));
+    return members;
+}
+
+size_t Scan(const std::vector<uint8_t>& buffer, const std::vector<ValueQuery>& members, size_t window,
+            bool ordered, std::vector<GroupHit>& hits) {
+    GroupScanner scanner(members, window, ordered);
+    std::vector<size_t> counts;
+    scanner.CountHits(buffer.data(), buffer.size(), 0, counts);
+    scanner.ChooseAnchor(counts);
+    hits.clear();
+    return scanner.FindAll(buffer.data(), buffer.size(), 0, 0, buffer.size(), hits, 100);
+}
+
+// Members do not overlap, the group fits the window, and each member holds
+// its value
+void CheckHit(const std::vector<uint8_t>& buffer, const std::vector<ValueQuery>& members, size_t window,
+              bool ordered, const GroupHit& hit) {
+    CHECK(hit.members.size() == members.size());
+    CHECK(hit.size <= window);
+    for (size_t i = 0; i < hit.members.size(); ++i) {
+        int32_t value;
+        memcpy(&value, buffer.data() + hit.members[i], sizeof(value));
+        CHECK(value == members[i].intValue);
+        CHECK(hit.members[i] >= hit.offset && hit.members[i] + 4 <= hit.offset + hit.size);
+        for (size_t j = i + 1; j < hit.members.size(); ++j) {
+            size_t a = hit.members[i];
+            size_t b = hit.members[j];
+            CHECK(a + 4 <= b || b + 4 <= a);
+            if (ordered) CHECK(a < b);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::vector<uint8_t> buffer(64 * 1024, 0);
+    Put(buffer, 8192, ANCHOR);
+    std::vector<GroupHit> hits;
+
+    // A member that never occurs rejects the anchor, for small and large
+    // windows and any number of zero members
+    const size_t windows[] = { 256, 4096, GroupScanner::MAX_WINDOW };
+    for (size_t window : windows) {
+        for (size_t zeros = 1; zeros <= 6; ++zeros) {
+            CHECK(Scan(buffer, Members(zeros, { 999 }), window, false, hits) == 0);
+            CHECK(Scan(buffer, Members(zeros, { 999 }), window, true, hits) == 0);
+        }
+    }
+
+    // Present once, but wanted twice: the second copy has nowhere to go
+    Put(buffer, 8300, 999);
+    CHECK(Scan(buffer, Members(6, { 999, 999 }), 4096, false, hits) == 0);
+    CHECK(Scan(buffer, Members(6, { 999, 999 }), 4096, true, hits) == 0);
+
+    // Present beyond the window of the anchor
+    CHECK(Scan(buffer, Members(3, { 999 }), 64, false, hits) == 0);
+
+    // Within reach, the group is found in either mode
+    for (size_t zeros = 1; zeros <= 6; ++zeros) {
+        std::vector<ValueQuery> members = Members(zeros, { 999 });
+        CHECK(Scan(buffer, members, 4096, false, hits) == 1);
+        if (hits.size() == 1) CheckHit(buffer, members, 4096, false, hits[0]);
+
+        CHECK(Scan(buffer, members, 4096, true, hits) == 1);
+        if (hits.size() == 1) CheckHit(buffer, members, 4096, true, hits[0]);
+    }
+
+    // Ordered, but the 999 sits before the anchor it must follow
+    Put(buffer, 8300, 0);
+    Put(buffer, 8000, 999);
+    CHECK(Scan(buffer, Members(2, { 999 }), 4096, true, hits) == 0);
+    CHECK(Scan(buffer, Members(2, { 999 }), 4096, false, hits) == 1);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("group scans OK\n");
+    return EXIT_SUCCESS;
+}
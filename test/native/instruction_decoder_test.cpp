@@ -0,0 +1,107 @@
+// Checks InstructionDecoder against objdump on real compiler output, then
+// decodes random byte strings held in exact-size buffers so a read past
+// `available` shows up under ASan.
+#include "instruction_decoder.h"
+#include "decoder_fixture.h"
+#include <cstring>
+#include <memory>
+#include <random>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(uintptr_t address, const char* what) {
+    if (++g_failures <= 20) std::printf("FAIL at 0x%llx: %s\n", static_cast<unsigned long long>(address), what);
+}
+
+const char* BranchName(BranchKind kind) {
+    switch (kind) {
+        case BranchKind::Call: return "call";
+        case BranchKind::Jump: return "jump";
+        case BranchKind::Conditional: return "branch";
+        default: return "";
+    }
+}
+
+void CheckFixture(const DecoderFixture& fixture) {
+    for (const FixtureInstruction& expected : fixture.instructions) {
+        size_t offset = static_cast<size_t>(expected.address - fixture.base);
+        DecodedInstruction instruction;
+        if (!InstructionDecoder::Decode(fixture.code.data() + offset, fixture.code.size() - offset,
+                                        expected.address, instruction)) {
+            Fail(expected.address, "does not decode");
+            continue;
+        }
+
+        if (instruction.length != expected.length) Fail(expected.address, "length");
+        if (expected.branch != BranchName(instruction.branch)) Fail(expected.address, "branch kind");
+        if (!expected.branch.empty() && instruction.branchTarget != expected.branchTarget) {
+            Fail(expected.address, "branch target");
+        }
+        if (instruction.ripRelative != expected.ripRelative) Fail(expected.address, "RIP-relative operand");
+        if (expected.ripRelative && instruction.memoryTarget != expected.memoryTarget) {
+            Fail(expected.address, "RIP-relative target");
+        }
+    }
+}
+
+// Every decode must stay inside available bytes, and one that succeeds must
+// give the same instruction when more bytes follow
+void CheckRandomBytes() {
+    std::mt19937 rng(0xDEC0DE);
+    const uint8_t PREFIXES[] = { 0x66, 0x67, 0xF2, 0xF3, 0xF0, 0x2E, 0x48, 0x41, 0xC4, 0xC5, 0x62, 0x8F, 0x0F };
+
+    for (unsigned iteration = 0; iteration < 300000; ++iteration) {
+        uint8_t bytes[InstructionDecoder::MAX_LENGTH + 4];
+        for (uint8_t& b : bytes) b = static_cast<uint8_t>(rng());
+        // Prefix-heavy starts reach the VEX, EVEX, XOP and escape paths
+        for (size_t i = 0, prefixes = rng() % 4; i < prefixes; ++i) bytes[i] = PREFIXES[rng() % sizeof(PREFIXES)];
+
+        size_t available = 1 + rng() % sizeof(bytes);
+        std::unique_ptr<uint8_t[]> exact(new uint8_t[available]);
+        memcpy(exact.get(), bytes, available);
+
+        DecodedInstruction instruction;
+        if (!InstructionDecoder::Decode(exact.get(), available, 0x140001000, instruction)) continue;
+
+        if (instruction.length == 0 || instruction.length > available ||
+            instruction.length > InstructionDecoder::MAX_LENGTH) {
+            Fail(iteration, "length outside the available bytes");
+            continue;
+        }
+
+        DecodedInstruction longer;
+        if (!InstructionDecoder::Decode(bytes, sizeof(bytes), 0x140001000, longer) ||
+            longer.length != instruction.length || longer.branch != instruction.branch ||
+            longer.branchTarget != instruction.branchTarget || longer.ripRelative != instruction.ripRelative ||
+            longer.memoryTarget != instruction.memoryTarget) {
+            Fail(iteration, "result depends on the bytes after the instruction");
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("usage: %s <fixture prefix>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    DecoderFixture fixture;
+    if (!LoadDecoderFixture(argv[1], fixture)) {
+        std::printf("bad fixture %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    CheckFixture(fixture);
+    CheckRandomBytes();
+
+    if (g_failures) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("%zu fixture instructions and random bytes OK\n", fixture.instructions.size());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+// Builds a ModuleMap from a fixed /proc/<pid>/maps listing and checks the
+// modules, sections and lookups it yields.
+#include "module_map.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("FAIL line %d: %s\n", __LINE__, #condition); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+// An executable with .bss, a deleted library, a library mapped twice, and
+// the mappings that are not module images
+const char* const MAPS =
+    "55d0c0000000-55d0c0001000 r--p 00000000 08:01 1001   /usr/bin/game\n"
+    "55d0c0001000-55d0c0005000 r-xp 00001000 08:01 1001   /usr/bin/game\n"
+    "55d0c0005000-55d0c0006000 r--p 00005000 08:01 1001   /usr/bin/game\n"
+    "55d0c0006000-55d0c0007000 rw-p 00006000 08:01 1001   /usr/bin/game\n"
+    "55d0c0007000-55d0c0009000 rw-p 00000000 00:00 0\n"
+    "55d0c1000000-55d0c1100000 rw-p 00000000 00:00 0      [heap]\n"
+    "7f0000000000-7f0000002000 r--p 00000000 08:01 2002   /opt/game/libplugin.so (deleted)\n"
+    "7f0000002000-7f0000004000 r-xp 00002000 08:01 2002   /opt/game/libplugin.so (deleted)\n"
+    "7f0000004000-7f0000005000 rw-p 00004000 08:01 2002   /opt/game/libplugin.so (deleted)\n"
+    "7f0000010000-7f0000011000 r--p 00000000 08:01 3003   /usr/lib/libdata.so\n"
+    "7f0000011000-7f0000012000 rw-p 00001000 08:01 3003   /usr/lib/libdata.so\n"
+    "7f0000012000-7f0000013000 r--p 00000000 08:01 3003   /usr/lib/libdata.so\n"
+    "7f0000013000-7f0000014000 rw-p 00001000 08:01 3003   /usr/lib/libdata.so\n"
+    "7f0000014000-7f0000016000 rw-p 00000000 00:00 0\n"
+    "7ffc00000000-7ffc00021000 rw-p 00000000 00:00 0      [stack]\n"
+    "7ffc00100000-7ffc00102000 r-xp 00000000 00:00 0      [vdso]\n";
+
+const ModuleSection* SectionAt(const ModuleMap& map, uintptr_t address, ModuleAddress& location) {
+    if (!map.Locate(address, location) || location.section == ModuleMap::NO_SECTION) return nullptr;
+    return &map.Modules()[location.module].sections[location.section];
+}
+
+} // namespace
+
+int main() {
+    std::unique_ptr<ModuleMap> map = ModuleMap::ParseProcMaps(MAPS);
+    const auto& modules = map->Modules();
+
+    // Heap, stack and vdso are not images; libdata.so is mapped twice
+    CHECK(modules.size() == 4);
+    if (modules.size() != 4) return EXIT_FAILURE;
+
+    // The anonymous mapping after the writable mapping is the executable's .bss
+    const AddressModule& game = modules[0];
+    CHECK(game.name == "game");
+    CHECK(game.base == 0x55d0c0000000);
+    CHECK(game.size == 0x9000);
+    CHECK(game.sections.size() == 5);
+    CHECK(game.sections.back().name == "[bss]");
+    CHECK(game.sections.back().offset == 0x7000);
+    CHECK(game.sections.back().size == 0x2000);
+
+    // The suffix the kernel adds to unlinked files is not part of the name
+    const AddressModule& plugin = modules[1];
+    CHECK(plugin.name == "libplugin.so");
+    CHECK(plugin.size == 0x5000);
+    CHECK(plugin.sections.size() == 3);
+
+    // Each mapping of the same file is its own image; only the second has .bss
+    CHECK(modules[2].name == "libdata.so" && modules[3].name == "libdata.so");
+    CHECK(modules[2].base == 0x7f0000010000 && modules[2].size == 0x2000);
+    CHECK(modules[3].base == 0x7f0000012000 && modules[3].size == 0x4000);
+    CHECK(modules[2].sections.size() == 2);
+    CHECK(modules[3].sections.size() == 3 && modules[3].sections.back().name == "[bss]");
+
+    ModuleAddress location;
+    const ModuleSection* section = SectionAt(*map, 0x55d0c0001234, location);
+    CHECK(section && section->name == "r-xp");
+    CHECK(location.module == 0 && location.moduleOffset == 0x1234);
+
+    section = SectionAt(*map, 0x55d0c0008ff8, location);
+    CHECK(section && section->name == "[bss]");
+    CHECK(location.moduleOffset == 0x8ff8);
+
+    section = SectionAt(*map, 0x7f0000004010, location);
+    CHECK(section && section->name == "rw-p");
+    CHECK(location.module == 1 && location.moduleOffset == 0x4010);
+
+    section = SectionAt(*map, 0x7f0000013008, location);
+    CHECK(section && section->name == "rw-p");
+    CHECK(location.module == 3 && location.moduleOffset == 0x1008);
+
+    // Just past an image, in the heap, the stack and below every module
+    CHECK(!map->Locate(0x55d0c0009000, location));
+    CHECK(!map->Locate(0x55d0c1000010, location));
+    CHECK(!map->Locate(0x7ffc00000100, location));
+    CHECK(!map->Locate(0x1000, location));
+
+    // Names compare ignoring case; the first image of a name wins
+    CHECK(map->Resolve("GAME", 0x1234) == 0x55d0c0001234);
+    CHECK(map->Resolve("libdata.so", 0x10) == 0x7f0000010010);
+    CHECK(map->Resolve("libmissing.so", 0x10) == 0);
+
+    // Blank and malformed lines are skipped
+    std::unique_ptr<ModuleMap> empty = ModuleMap::ParseProcMaps("\nnot a maps line\n");
+    CHECK(empty->Modules().empty());
+
+    // The live map of this process holds this test's own code
+    std::string error;
+    std::unique_ptr<ModuleMap> self = ModuleMap::LoadProcMaps(static_cast<uint32_t>(getpid()), error);
+    CHECK(self != nullptr);
+    if (self) {
+        section = SectionAt(*self, reinterpret_cast<uintptr_t>(&SectionAt), location);
+        CHECK(section && section->name.compare(0, 3, "r-x") == 0);
+        CHECK(section && self->Modules()[location.module].name == "module_map_test");
+    }
+
+    if (g_failures) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("module map OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// Fuzzes MultiPatternScanner against one scalar PatternMatcher per pattern.
+// Pattern sets mix the three ways a pattern is found: by its rarest pair of
+// adjacent fixed bytes, by a single fixed byte when no two are adjacent, and
+// at every offset when it is all wildcards. Many patterns are cut from the
+// buffer or from each other so hits overlap, and result caps are checked to
+// keep the lowest hits. Buffers are allocated at their exact size so an
+// overread shows up under ASan.
+#include "multi_pattern_scanner.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, unsigned iteration) {
+    if (++g_failures <= 20) std::printf("FAIL %s: iteration %u\n", what, iteration);
+}
+
+struct Pattern {
+    std::vector<uint8_t> bytes;
+    std::vector<bool> mask;
+};
+
+uint8_t RandomByte(std::mt19937& rng) {
+    static const uint8_t ALPHABET[] = { 0x00, 0x48, 0x8B, 0xE8, 0xCC, 0x5A };
+    return ALPHABET[rng() % sizeof(ALPHABET)];
+}
+
+// Pair-keyed, single-byte-keyed or all-wildcard, taken from the buffer or
+// from an earlier pattern half the time
+Pattern RandomPattern(std::mt19937& rng, const std::vector<uint8_t>& buffer, const std::vector<Pattern>& earlier) {
+    Pattern pattern;
+    size_t size = 1 + rng() % 10;
+    if (!earlier.empty() && rng() % 4 == 0) {
+        // A shifted or cut copy of another pattern overlaps its hits
+        const Pattern& other = earlier[rng() % earlier.size()];
+        size_t skip = rng() % other.bytes.size();
+        pattern.bytes.assign(other.bytes.begin() + skip, other.bytes.end());
+        pattern.mask.assign(other.mask.begin() + skip, other.mask.end());
+        if (rng() % 2) pattern.bytes.push_back(RandomByte(rng)), pattern.mask.push_back(true);
+    } else if (buffer.size() >= size && rng() % 2) {
+        size_t at = rng() % (buffer.size() - size + 1);
+        pattern.bytes.assign(buffer.begin() + at, buffer.begin() + at + size);
+    } else {
+        for (size_t i = 0; i < size; ++i) pattern.bytes.push_back(RandomByte(rng));
+    }
+
+    size_t count = pattern.bytes.size();
+    switch (rng() % 4) {
+        case 0:   // No two fixed bytes adjacent
+            for (size_t i = 0; i < count; ++i) pattern.mask.push_back(i % 2 == 0 && rng() % 3 != 0);
+            if (count) pattern.mask[rng() % ((count + 1) / 2) * 2] = true;
+            break;
+        case 1:   // All wildcards
+            pattern.mask.assign(count, false);
+            break;
+        default:
+            if (pattern.mask.size() != count) {
+                pattern.mask.clear();
+                for (size_t i = 0; i < count; ++i) pattern.mask.push_back(rng() % 5 != 0);
+            }
+            break;
+    }
+    return pattern;
+}
+
+std::vector<MultiPatternHit> Reference(const std::vector<Pattern>& patterns, const std::vector<size_t>& ids,
+                                       const uint8_t* data, size_t size) {
+    std::vector<MultiPatternHit> hits;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        if (ids[i] == MultiPatternScanner::npos) continue;
+        PatternMatcher matcher(patterns[i].bytes, patterns[i].mask);
+        std::vector<size_t> offsets;
+        matcher.FindAll(data, size, offsets, PatternMatcher::npos, PatternMatcher::Kernel::Scalar);
+        for (size_t offset : offsets) hits.push_back({ offset, ids[i] });
+    }
+    std::sort(hits.begin(), hits.end(), [](const MultiPatternHit& a, const MultiPatternHit& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.patternId < b.patternId;
+    });
+    return hits;
+}
+
+bool Same(const std::vector<MultiPatternHit>& hits, size_t first, const std::vector<MultiPatternHit>& expected) {
+    if (hits.size() - first != expected.size()) return false;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (hits[first + i].offset != expected[i].offset || hits[first + i].patternId != expected[i].patternId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CheckRandom(std::mt19937& rng) {
+    for (unsigned iteration = 0; iteration < 1500; ++iteration) {
+        std::vector<uint8_t> bytes(rng() % 4 == 0 ? rng() % 12 : rng() % 600);
+        for (uint8_t& byte : bytes) byte = RandomByte(rng);
+
+        MultiPatternScanner scanner;
+        std::vector<Pattern> patterns;
+        std::vector<size_t> ids;
+        size_t count = 1 + rng() % 12;
+        for (size_t i = 0; i < count; ++i) {
+            patterns.push_back(RandomPattern(rng, bytes, patterns));
+            ids.push_back(scanner.AddPattern(patterns.back().bytes, patterns.back().mask));
+            if (ids.back() != MultiPatternScanner::npos &&
+                scanner.PatternSize(ids.back()) != patterns.back().bytes.size()) {
+                Fail("pattern size", iteration);
+            }
+        }
+
+        std::unique_ptr<uint8_t[]> data(new uint8_t[bytes.size() ? bytes.size() : 1]);
+        if (!bytes.empty()) memcpy(data.get(), bytes.data(), bytes.size());
+
+        std::vector<MultiPatternHit> all = Reference(patterns, ids, data.get(), bytes.size());
+        const size_t caps[] = { MultiPatternScanner::npos, 1, 3, 1 + rng() % 40 };
+        for (size_t cap : caps) {
+            // Hits are appended after whatever the caller already holds
+            std::vector<MultiPatternHit> hits(1, MultiPatternHit{ 12345, 678 });
+            size_t found = scanner.FindAll(data.get(), bytes.size(), hits, cap);
+            std::vector<MultiPatternHit> expected(all.begin(), all.begin() + std::min(cap, all.size()));
+            if (found != hits.size() - 1 || hits[0].offset != 12345 || !Same(hits, 1, expected)) {
+                Fail(cap == MultiPatternScanner::npos ? "FindAll" : "FindAll with a cap", iteration);
+            }
+        }
+    }
+}
+
+void CheckEdges() {
+    MultiPatternScanner scanner;
+    if (scanner.AddPattern({}, {}) != MultiPatternScanner::npos) Fail("empty pattern", 0);
+
+    std::vector<MultiPatternHit> hits;
+    const uint8_t byte = 0x90;
+    if (scanner.FindAll(&byte, 1, hits) != 0 || !hits.empty()) Fail("no patterns", 0);
+
+    // One fixed byte keys a single-byte bucket; it must be found at the last
+    // offset too
+    size_t single = scanner.AddPattern({ 0x90 }, { true });
+    std::vector<uint8_t> data = { 0x00, 0x90, 0x00, 0x90 };
+    if (scanner.FindAll(data.data(), data.size(), hits) != 2 || hits[0].offset != 1 || hits[1].offset != 3 ||
+        hits[1].patternId != single) {
+        Fail("single byte at the end", 0);
+    }
+
+    // A wildcard pattern longer than the buffer fits nowhere
+    MultiPatternScanner wildcards;
+    wildcards.AddPattern({ 0, 0, 0, 0, 0 }, { false, false, false, false, false });
+    hits.clear();
+    if (wildcards.FindAll(data.data(), data.size(), hits) != 0) Fail("wildcard longer than the buffer", 0);
+    if (wildcards.FindAll(data.data(), data.size(), hits, 0) != 0) Fail("zero cap", 0);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(90210);
+
+    CheckEdges();
+    CheckRandom(rng);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("multi-pattern scans OK\n");
+    return EXIT_SUCCESS;
+}
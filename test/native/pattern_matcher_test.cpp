@@ -0,0 +1,182 @@
+// Fuzzes the SSE2 and AVX2 kernels (and Horspool) against the scalar
+// reference, and the compile-time StaticSignature kernels against the same
+// reference. Buffers are allocated at their exact size so an overread past
+// the end shows up under ASan.
+#include "pattern_matcher.h"
+#include "static_signature.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, unsigned iteration, size_t size, size_t patternSize) {
+    if (++g_failures <= 20) {
+        std::printf("FAIL %s: iteration %u, buffer %zu bytes, pattern %zu bytes\n",
+                    what, iteration, size, patternSize);
+    }
+}
+
+// Small alphabets make matches common; the wide one exercises anchor choice
+uint8_t RandomByte(std::mt19937& rng, bool narrow) {
+    static const uint8_t ALPHABET[] = { 0x00, 0x48, 0x8B, 0xE8, 'a', 'A', 0x4F };
+    if (narrow) return ALPHABET[rng() % sizeof(ALPHABET)];
+    return static_cast<uint8_t>(rng());
+}
+
+uint8_t RandomMask(std::mt19937& rng) {
+    switch (rng() % 8) {
+        case 0: return 0x00;
+        case 1: return 0xF0;
+        case 2: return 0x0F;
+        default: return 0xFF;
+    }
+}
+
+bool SameResults(const PatternMatcher& matcher, const uint8_t* data, size_t size, size_t maxResults,
+                 PatternMatcher::Kernel kernel, const std::vector<size_t>& expected) {
+    std::vector<size_t> offsets;
+    size_t count = matcher.FindAll(data, size, offsets, maxResults, kernel);
+    return count == offsets.size() && offsets == expected;
+}
+
+void CheckKernels(const PatternMatcher& matcher, const std::vector<uint8_t>& bytes, unsigned iteration) {
+    // Exact-size copy so the last byte of the buffer is the last byte of the allocation
+    std::unique_ptr<uint8_t[]> data(new uint8_t[bytes.size() ? bytes.size() : 1]);
+    if (!bytes.empty()) memcpy(data.get(), bytes.data(), bytes.size());
+    size_t size = bytes.size();
+
+    const size_t caps[] = { PatternMatcher::npos, 1, 3 };
+    for (size_t cap : caps) {
+        std::vector<size_t> expected;
+        matcher.FindAll(data.get(), size, expected, cap, PatternMatcher::Kernel::Scalar);
+
+        // The reference itself must agree with MatchesAt at every offset
+        if (cap == PatternMatcher::npos) {
+            std::vector<size_t> brute;
+            for (size_t i = 0; size >= matcher.Size() && i <= size - matcher.Size(); ++i) {
+                if (matcher.MatchesAt(data.get() + i)) brute.push_back(i);
+            }
+            if (brute != expected) Fail("scalar vs MatchesAt", iteration, size, matcher.Size());
+        }
+
+        if (PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::SSE2) &&
+            !SameResults(matcher, data.get(), size, cap, PatternMatcher::Kernel::SSE2, expected)) {
+            Fail("SSE2", iteration, size, matcher.Size());
+        }
+        if (PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::AVX2) &&
+            !SameResults(matcher, data.get(), size, cap, PatternMatcher::Kernel::AVX2, expected)) {
+            Fail("AVX2", iteration, size, matcher.Size());
+        }
+        if (!SameResults(matcher, data.get(), size, cap, PatternMatcher::Kernel::Horspool, expected)) {
+            Fail("Horspool", iteration, size, matcher.Size());
+        }
+        if (!SameResults(matcher, data.get(), size, cap, PatternMatcher::Kernel::Auto, expected)) {
+            Fail("Auto", iteration, size, matcher.Size());
+        }
+    }
+}
+
+// Buffers are drawn from the signature's own bytes so candidates are common
+template <typename Signature>
+void CheckStaticSignature(std::mt19937& rng, const char* name) {
+    std::vector<uint8_t> pattern(Signature::Size);
+    std::vector<bool> mask(Signature::Size);
+    std::vector<uint8_t> alphabet;
+    for (size_t i = 0; i < Signature::Size; ++i) {
+        mask[i] = Signature::Values[i] >= 0;
+        pattern[i] = mask[i] ? static_cast<uint8_t>(Signature::Values[i]) : 0;
+        if (mask[i]) alphabet.push_back(pattern[i]);
+    }
+    PatternMatcher reference(pattern, mask);
+
+    for (unsigned iteration = 0; iteration < 3000; ++iteration) {
+        size_t size = rng() % 4 == 0 ? rng() % 8 : rng() % 300;
+        std::unique_ptr<uint8_t[]> data(new uint8_t[size ? size : 1]);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = rng() % 4 == 0 ? static_cast<uint8_t>(rng()) : alphabet[rng() % alphabet.size()];
+        }
+        if (size >= Signature::Size && rng() % 2) {
+            for (size_t i = 0; i < Signature::Size; ++i) {
+                if (mask[i]) data[size - Signature::Size + i] = pattern[i];
+            }
+        }
+
+        const size_t caps[] = { PatternMatcher::npos, 1, 3 };
+        for (size_t cap : caps) {
+            std::vector<size_t> expected;
+            std::vector<size_t> offsets;
+            reference.FindAll(data.get(), size, expected, cap, PatternMatcher::Kernel::Scalar);
+            size_t count = Signature::FindAll(data.get(), size, offsets, cap);
+            if (count != offsets.size() || offsets != expected) Fail(name, iteration, size, Signature::Size);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(0x5EED);
+    const unsigned ITERATIONS = 20000;
+
+    for (unsigned iteration = 0; iteration < ITERATIONS; ++iteration) {
+        bool narrow = rng() % 4 != 0;
+        size_t patternSize = 1 + rng() % (rng() % 4 == 0 ? 80 : 12);
+        std::vector<uint8_t> pattern(patternSize);
+        std::vector<uint8_t> mask(patternSize);
+        for (size_t i = 0; i < patternSize; ++i) {
+            pattern[i] = RandomByte(rng, narrow);
+            mask[i] = RandomMask(rng);
+        }
+
+        // Sizes straddle the 32- and 64-offset blocks so every tail length is hit
+        size_t size = rng() % 4 == 0 ? rng() % 8 : rng() % 300;
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& b : bytes) b = RandomByte(rng, narrow);
+
+        // Plant a few copies, including one flush against the end
+        if (size >= patternSize) {
+            size_t plants = rng() % 4;
+            for (size_t p = 0; p < plants; ++p) {
+                size_t at = p == 0 ? size - patternSize : rng() % (size - patternSize + 1);
+                memcpy(bytes.data() + at, pattern.data(), patternSize);
+            }
+        }
+
+        bool caseFold = rng() % 5 == 0;
+        PatternMatcher matcher = caseFold ? PatternMatcher::CaseInsensitive(pattern)
+                                          : PatternMatcher(pattern, mask);
+        if (caseFold && size >= patternSize && rng() % 2) {
+            // Flip the case of the planted copy at the end
+            for (size_t i = size - patternSize; i < size; ++i) {
+                uint8_t c = bytes[i];
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) bytes[i] = c ^ 0x20;
+            }
+        }
+        CheckKernels(matcher, bytes, iteration);
+    }
+
+    // The built-in signatures, a repeated value, and anchors after wildcards
+    const int Any = StaticSignatureAny;
+    CheckStaticSignature<StaticSignature<0x48, 0x89, 0x5C, 0x24>>(rng, "StaticSignature 48 89 5C 24");
+    CheckStaticSignature<StaticSignature<0x55, 0x8B, 0xEC>>(rng, "StaticSignature 55 8B EC");
+    CheckStaticSignature<StaticSignature<0xE8, Any, Any, Any, Any>>(rng, "StaticSignature E8 ?? ?? ?? ??");
+    CheckStaticSignature<StaticSignature<0x00, 0x00>>(rng, "StaticSignature 00 00");
+    CheckStaticSignature<StaticSignature<Any, 0x0F, Any, 0x85, Any, Any, Any, Any, 0x90>>(
+        rng, "StaticSignature ?? 0F ?? 85 ?? ?? ?? ?? 90");
+
+    std::printf("kernels: SSE2 %s, AVX2 %s\n",
+                PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::SSE2) ? "tested" : "unsupported",
+                PatternMatcher::IsKernelSupported(PatternMatcher::Kernel::AVX2) ? "tested" : "unsupported");
+    if (g_failures) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("%u patterns OK\n", ITERATIONS);
+    return EXIT_SUCCESS;
+}
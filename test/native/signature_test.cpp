@@ -0,0 +1,121 @@
+// Checks Signature::Parse and ToString: whole-byte and nibble wildcards,
+// packed tokens, the tokens it must reject, and that the canonical text of
+// any signature parses back to the same bytes and masks.
+#include "signature.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, const std::string& what) {
+    if (!condition && ++g_failures <= 20) std::printf("FAIL %s\n", what.c_str());
+}
+
+void CheckParse(const std::string& text, const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& masks,
+                const std::string& canonical) {
+    std::string error;
+    std::unique_ptr<Signature> signature = Signature::Compile(text, error);
+    if (!signature) {
+        Check(false, "'" + text + "' did not parse: " + error);
+        return;
+    }
+    Check(signature->Bytes() == bytes, "bytes of '" + text + "'");
+    Check(signature->Masks() == masks, "masks of '" + text + "'");
+    Check(signature->ToString() == canonical, "'" + text + "' prints as '" + signature->ToString() + "'");
+    Check(signature->Matcher().Size() == bytes.size(), "matcher size of '" + text + "'");
+}
+
+void CheckRejected(const std::string& text) {
+    std::string error;
+    std::vector<uint8_t> bytes, masks;
+    Check(!Signature::Parse(text, bytes, masks, error) && !error.empty(), "'" + text + "' was accepted");
+    Check(Signature::Compile(text, error) == nullptr, "'" + text + "' compiled");
+}
+
+void TestSyntax() {
+    CheckParse("48 8B 0D", { 0x48, 0x8B, 0x0D }, { 0xFF, 0xFF, 0xFF }, "48 8B 0D");
+    CheckParse("48 ? ?? 0d", { 0x48, 0, 0, 0x0D }, { 0xFF, 0, 0, 0xFF }, "48 ?? ?? 0D");
+
+    // Nibble wildcards keep the other nibble
+    CheckParse("4? ?F", { 0x40, 0x0F }, { 0xF0, 0x0F }, "4? ?F");
+    CheckParse("e?", { 0xE0 }, { 0xF0 }, "E?");
+
+    // Packed tokens are runs of byte pairs and may mix with spaced ones
+    CheckParse("488B0D????", { 0x48, 0x8B, 0x0D, 0, 0 }, { 0xFF, 0xFF, 0xFF, 0, 0 }, "48 8B 0D ?? ??");
+    CheckParse("48 8b0D 4??F", { 0x48, 0x8B, 0x0D, 0x40, 0x0F }, { 0xFF, 0xFF, 0xFF, 0xF0, 0x0F },
+               "48 8B 0D 4? ?F");
+
+    // A single digit is a whole byte; any whitespace separates
+    CheckParse("\t5\n 8B  ", { 0x05, 0x8B }, { 0xFF, 0xFF }, "05 8B");
+
+    CheckRejected("");
+    CheckRejected("   \t");
+    CheckRejected("488");
+    CheckRejected("48 8B0");
+    CheckRejected("4G");
+    CheckRejected("48 XY");
+    CheckRejected("?x");
+    CheckRejected("48,8B");
+    CheckRejected("0x48");
+}
+
+// The prepared matcher honours the nibble masks
+void TestMatching() {
+    std::string error;
+    std::unique_ptr<Signature> signature = Signature::Compile("4? ?B", error);
+    const uint8_t hits[] = { 0x41, 0x8B, 0x4F, 0x0B };
+    const uint8_t misses[] = { 0x51, 0x8B, 0x41, 0x8C };
+    Check(signature && signature->Matcher().MatchesAt(hits) && signature->Matcher().MatchesAt(hits + 2),
+          "nibble matches");
+    Check(signature && !signature->Matcher().MatchesAt(misses) && !signature->Matcher().MatchesAt(misses + 2),
+          "nibble mismatches");
+}
+
+// Canonical text, its lowercase and its packed form all parse back
+void TestRoundTrip(std::mt19937& rng) {
+    const uint8_t MASKS[] = { 0xFF, 0xFF, 0x00, 0xF0, 0x0F };
+    for (unsigned iteration = 0; iteration < 2000; ++iteration) {
+        std::vector<uint8_t> bytes(1 + rng() % 16), masks(bytes.size());
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            masks[i] = MASKS[rng() % sizeof(MASKS)];
+            bytes[i] = static_cast<uint8_t>(rng()) & masks[i];
+        }
+
+        std::string text = Signature(bytes, masks).ToString();
+        std::string lower, packed;
+        for (char c : text) {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (c != ' ') packed += c;
+        }
+
+        for (const std::string& form : { text, lower, packed }) {
+            std::vector<uint8_t> parsedBytes, parsedMasks;
+            std::string error;
+            bool parsed = Signature::Parse(form, parsedBytes, parsedMasks, error);
+            Check(parsed && parsedBytes == bytes && parsedMasks == masks, "round trip of '" + form + "'");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1337);
+
+    TestSyntax();
+    TestMatching();
+    TestRoundTrip(rng);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("signatures OK\n");
+    return EXIT_SUCCESS;
+}
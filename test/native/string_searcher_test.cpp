@@ -0,0 +1,311 @@
+// Checks StringSearcher against a byte-by-byte reference: needle encodings
+// for UTF-8 and both UTF-16 orders, ASCII-only case folding next to bytes a
+// blind fold would confuse (0x40/0x60, é/É, a UTF-16 unit whose low byte is a
+// letter), hits on both sides of the 16- and 32-byte block edges, and a
+// chunked scan that carries MaxNeedleSize() - 1 bytes between reads the way
+// MemoryHelpers::SearchString does.
+#include "string_searcher.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, const char* what) {
+    if (!condition && ++g_failures <= 20) std::printf("FAIL %s\n", what);
+}
+
+const StringEncoding ENCODINGS[] = { StringEncoding::Utf8, StringEncoding::Utf16LE, StringEncoding::Utf16BE };
+
+std::string Utf8(const std::vector<uint32_t>& codePoints) {
+    std::string out;
+    for (uint32_t c : codePoints) {
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+std::vector<uint8_t> Encode(const std::vector<uint32_t>& codePoints, StringEncoding encoding) {
+    if (encoding == StringEncoding::Utf8) {
+        std::string text = Utf8(codePoints);
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    std::vector<uint16_t> units;
+    for (uint32_t c : codePoints) {
+        if (c >= 0x10000) {
+            units.push_back(static_cast<uint16_t>(0xD800 + ((c - 0x10000) >> 10)));
+            units.push_back(static_cast<uint16_t>(0xDC00 + ((c - 0x10000) & 0x3FF)));
+        } else {
+            units.push_back(static_cast<uint16_t>(c));
+        }
+    }
+    std::vector<uint8_t> out;
+    for (uint16_t unit : units) {
+        uint8_t low = static_cast<uint8_t>(unit), high = static_cast<uint8_t>(unit >> 8);
+        out.push_back(encoding == StringEncoding::Utf16BE ? high : low);
+        out.push_back(encoding == StringEncoding::Utf16BE ? low : high);
+    }
+    return out;
+}
+
+bool IsLetter(uint32_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+uint32_t Lower(uint32_t c) {
+    return c >= 'A' && c <= 'Z' ? c + 0x20 : c;
+}
+
+// Compares one code unit at a time; only units holding an ASCII letter fold
+bool MatchesAt(const std::vector<uint8_t>& needle, StringEncoding encoding, bool caseSensitive, const uint8_t* data) {
+    size_t unitSize = encoding == StringEncoding::Utf8 ? 1 : 2;
+    for (size_t i = 0; i < needle.size(); i += unitSize) {
+        uint32_t want = needle[i], have = data[i];
+        if (unitSize == 2) {
+            want = encoding == StringEncoding::Utf16BE ? (want << 8 | needle[i + 1]) : (want | needle[i + 1] << 8);
+            have = encoding == StringEncoding::Utf16BE ? (have << 8 | data[i + 1]) : (have | data[i + 1] << 8);
+        }
+        if (want == have) continue;
+        if (caseSensitive || !IsLetter(want) || !IsLetter(have) || Lower(want) != Lower(have)) return false;
+    }
+    return true;
+}
+
+std::vector<StringHit> Reference(const StringSearcher& searcher, uint32_t encodings, bool caseSensitive,
+                                 const uint8_t* data, size_t size, uintptr_t address, size_t maxResults) {
+    std::vector<StringHit> hits;
+    for (size_t pos = 0; pos < size && hits.size() < maxResults; ++pos) {
+        for (StringEncoding encoding : ENCODINGS) {
+            if (!(encodings & static_cast<uint32_t>(encoding))) continue;
+            const std::vector<uint8_t>& needle = searcher.NeedleBytes(encoding);
+            size_t unitSize = encoding == StringEncoding::Utf8 ? 1 : 2;
+            if (needle.size() > size - pos || (address + pos) % unitSize != 0) continue;
+            if (MatchesAt(needle, encoding, caseSensitive, data + pos)) hits.push_back({ pos, needle.size(), encoding });
+            if (hits.size() >= maxResults) break;
+        }
+    }
+    return hits;
+}
+
+bool Same(const std::vector<StringHit>& a, const std::vector<StringHit>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].offset != b[i].offset || a[i].size != b[i].size || a[i].encoding != b[i].encoding) return false;
+    }
+    return true;
+}
+
+size_t CountHits(const std::string& text, uint32_t encodings, bool caseSensitive, const std::vector<uint8_t>& data) {
+    StringSearcher searcher(text, encodings, caseSensitive);
+    std::vector<StringHit> hits;
+    searcher.FindAll(data.data(), data.size(), 0, hits);
+    return hits.size();
+}
+
+const uint32_t ALL = 7;
+const uint32_t UTF8 = static_cast<uint32_t>(StringEncoding::Utf8);
+const uint32_t UTF16LE = static_cast<uint32_t>(StringEncoding::Utf16LE);
+const uint32_t UTF16BE = static_cast<uint32_t>(StringEncoding::Utf16BE);
+
+void TestNeedleEncodings() {
+    // "Aé€😀": one, two, three and four byte UTF-8, and a surrogate pair
+    StringSearcher searcher("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", ALL);
+    Check(searcher.NeedleBytes(StringEncoding::Utf8) ==
+              std::vector<uint8_t>({ 0x41, 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80 }), "utf8 needle");
+    Check(searcher.NeedleBytes(StringEncoding::Utf16LE) ==
+              std::vector<uint8_t>({ 0x41, 0x00, 0xE9, 0x00, 0xAC, 0x20, 0x3D, 0xD8, 0x00, 0xDE }), "utf16le needle");
+    Check(searcher.NeedleBytes(StringEncoding::Utf16BE) ==
+              std::vector<uint8_t>({ 0x00, 0x41, 0x00, 0xE9, 0x20, 0xAC, 0xD8, 0x3D, 0xDE, 0x00 }), "utf16be needle");
+    Check(searcher.MaxNeedleSize() == 10, "max needle size");
+
+    // A byte that starts no valid sequence stands for itself
+    StringSearcher latin("\xE9x", UTF16LE);
+    Check(latin.NeedleBytes(StringEncoding::Utf16LE) == std::vector<uint8_t>({ 0xE9, 0x00, 0x78, 0x00 }), "latin-1 fallback");
+
+    Check(StringSearcher("", ALL).Empty(), "empty text");
+    Check(StringSearcher("abc", 0).Empty(), "no encodings");
+}
+
+void TestCaseFolding() {
+    std::vector<uint8_t> upper = { 'x', 'H', 'E', 'L', 'L', 'O', 'x' };
+    Check(CountHits("hello", UTF8, false, upper) == 1, "utf8 folds letters");
+    Check(CountHits("hello", UTF8, true, upper) == 0, "utf8 case-sensitive");
+
+    // 0x40/0x60 and 0x5B/0x7B differ only in the fold bit but are not letters
+    Check(CountHits("a@[", UTF8, false, { 'A', '`', '{' }) == 0, "utf8 folds only letters");
+    Check(CountHits("a@[", UTF8, false, { 'A', '@', '[' }) == 1, "utf8 keeps punctuation exact");
+
+    // é (C3 A9) and É (C3 89) differ in the fold bit of their second byte
+    Check(CountHits("\xC3\xA9t\xC3\xA9", UTF8, false, { 0xC3, 0x89, 'T', 0xC3, 0xA9 }) == 0, "utf8 leaves é/É alone");
+    Check(CountHits("\xC3\xA9t\xC3\xA9", UTF8, false, { 0xC3, 0xA9, 'T', 0xC3, 0xA9 }) == 1, "utf8 folds next to é");
+
+    // Ł (U+0141) has 'A' as its low byte and š (U+0161) has 'a'
+    Check(CountHits("a", UTF16LE, false, { 0x41, 0x01 }) == 0, "utf16le keeps the high byte exact");
+    Check(CountHits("a", UTF16LE, false, { 0x41, 0x00 }) == 1, "utf16le folds letters");
+    Check(CountHits("\xC5\xA1", UTF16LE, false, { 0x41, 0x01 }) == 0, "utf16le does not fold š");
+    Check(CountHits("a", UTF16BE, false, { 0x01, 0x41 }) == 0, "utf16be keeps the high byte exact");
+    Check(CountHits("a", UTF16BE, false, { 0x00, 0x41 }) == 1, "utf16be folds letters");
+    Check(CountHits("\xC5\xA1", UTF16BE, false, { 0x01, 0x41 }) == 0, "utf16be does not fold š");
+}
+
+// The alphabet for random needles: letters, the non-letters one fold bit
+// away from them, and code points whose bytes look like letters
+const uint32_t CODE_POINTS[] = { 'a', 'A', 'z', 'Z', 'q', '@', '`', '[', '{', 0xE9, 0xC9, 0x141, 0x161, 0x20AC, 0x1F600 };
+
+std::vector<uint32_t> RandomText(std::mt19937& rng) {
+    std::vector<uint32_t> text(1 + rng() % 5);
+    for (uint32_t& c : text) c = CODE_POINTS[rng() % (sizeof(CODE_POINTS) / sizeof(CODE_POINTS[0]))];
+    return text;
+}
+
+// Random bytes from the needles' own bytes, with copies planted in random
+// encodings and with random letters flipped in case
+std::unique_ptr<uint8_t[]> RandomHaystack(std::mt19937& rng, const std::vector<uint32_t>& text, size_t size) {
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size ? size : 1]);
+    const uint8_t bytes[] = { 0x00, 0x01, 'a', 'A', '`', '@', 0xC3, 0xA9, 0x89, 0x41, 0x61, 0xD8, 0x3D };
+    for (size_t i = 0; i < size; ++i) data[i] = bytes[rng() % sizeof(bytes)];
+
+    for (size_t planted = 0; planted < size / 8; ++planted) {
+        std::vector<uint32_t> copy = text;
+        for (uint32_t& c : copy) {
+            if (IsLetter(c) && rng() % 2) c ^= 0x20;
+        }
+        std::vector<uint8_t> encoded = Encode(copy, ENCODINGS[rng() % 3]);
+        if (encoded.size() > size) continue;
+        size_t at = rng() % (size - encoded.size() + 1);
+        std::copy(encoded.begin(), encoded.end(), data.get() + at);
+    }
+    return data;
+}
+
+void TestRandom(std::mt19937& rng) {
+    for (unsigned iteration = 0; iteration < 4000; ++iteration) {
+        std::vector<uint32_t> text = RandomText(rng);
+        uint32_t encodings = 1 + rng() % 7;
+        bool caseSensitive = rng() % 2 == 0;
+        StringSearcher searcher(Utf8(text), encodings, caseSensitive);
+
+        // Sizes around the 16- and 32-byte blocks and the tail after them
+        size_t size = rng() % 3 == 0 ? rng() % 48 : rng() % 400;
+        std::unique_ptr<uint8_t[]> data = RandomHaystack(rng, text, size);
+        uintptr_t address = 0x1000 + rng() % 4;
+        size_t maxResults = rng() % 4 == 0 ? 1 + rng() % 4 : PatternMatcher::npos;
+
+        std::vector<StringHit> hits;
+        size_t count = searcher.FindAll(data.get(), size, address, hits, maxResults);
+        std::vector<StringHit> expected = Reference(searcher, encodings, caseSensitive, data.get(), size, address, maxResults);
+        if (count != hits.size() || !Same(hits, expected)) {
+            Check(false, "random search");
+            std::printf("  iteration %u size %zu\n", iteration, size);
+        }
+    }
+}
+
+// Every offset across the first block edges, for each encoding alone and all
+// together
+void TestBlockEdges() {
+    const std::vector<uint32_t> text = { 'k', 0xE9, 'Y' };
+    for (uint32_t encodings : { UTF8, UTF16LE, UTF16BE, ALL }) {
+        StringSearcher searcher(Utf8(text), encodings, false);
+        for (size_t size : { size_t(40), size_t(70), size_t(100) }) {
+            for (size_t at = 0; at + 10 <= size; ++at) {
+                for (StringEncoding encoding : ENCODINGS) {
+                    if (!(encodings & static_cast<uint32_t>(encoding))) continue;
+                    std::vector<uint8_t> data(size, 0);
+                    std::vector<uint8_t> encoded = Encode({ 'K', 0xE9, 'y' }, encoding);
+                    std::copy(encoded.begin(), encoded.end(), data.begin() + at);
+
+                    std::vector<StringHit> hits;
+                    searcher.FindAll(data.data(), size, 0, hits);
+                    bool found = false;
+                    for (const StringHit& hit : hits) found |= hit.offset == at && hit.encoding == encoding;
+                    Check(found == (encoding == StringEncoding::Utf8 || at % 2 == 0), "hit at a block edge");
+                }
+            }
+        }
+    }
+}
+
+// Reads of random sizes with MaxNeedleSize() - 1 bytes carried in front;
+// hits inside the carried bytes were reported by the previous read
+void TestChunked(std::mt19937& rng) {
+    for (unsigned iteration = 0; iteration < 300; ++iteration) {
+        std::vector<uint32_t> text = RandomText(rng);
+        uint32_t encodings = 1 + rng() % 7;
+        bool caseSensitive = rng() % 2 == 0;
+        StringSearcher searcher(Utf8(text), encodings, caseSensitive);
+        size_t overlap = searcher.MaxNeedleSize() - 1;
+
+        size_t size = 1000 + rng() % 3000;
+        std::unique_ptr<uint8_t[]> data = RandomHaystack(rng, text, size);
+        uintptr_t address = 0x20000 + rng() % 2;
+
+        std::vector<StringHit> chunked;
+        for (size_t start = 0; start < size;) {
+            size_t read = std::min(size - start, 1 + static_cast<size_t>(rng() % 100));
+            size_t carried = std::min(overlap, start);
+            size_t chunkStart = start - carried;
+
+            // Copied so a read past the chunk shows up under ASan
+            std::unique_ptr<uint8_t[]> chunk(new uint8_t[carried + read]);
+            std::copy(data.get() + chunkStart, data.get() + start + read, chunk.get());
+
+            std::vector<StringHit> hits;
+            searcher.FindAll(chunk.get(), carried + read, address + chunkStart, hits);
+            for (StringHit hit : hits) {
+                if (hit.offset + hit.size <= carried) continue;
+                hit.offset += chunkStart;
+                chunked.push_back(hit);
+            }
+            start += read;
+        }
+
+        // Chunks report in order of where each hit ends, so compare as sets
+        std::sort(chunked.begin(), chunked.end(), [](const StringHit& a, const StringHit& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.encoding < b.encoding;
+        });
+        std::vector<StringHit> expected =
+            Reference(searcher, encodings, caseSensitive, data.get(), size, address, PatternMatcher::npos);
+        Check(Same(chunked, expected), "chunked search");
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(4242);
+
+    TestNeedleEncodings();
+    TestCaseFolding();
+    TestBlockEdges();
+    TestRandom(rng);
+    TestChunked(rng);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("string searches OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+// Fuzzes ValueScanner, whose SSE2 kernels handle the whole 16-byte blocks and
+// whose scalar kernel finishes the tail, against a reference written from
+// the query definitions rather than the prepared operands: integers are
+// compared exactly in 128 bits, so clamping to the type is checked, and the
+// display modes use rounding, ulp distance and truncation directly. Buffers
+// are allocated at their exact size so an overread shows up under ASan.
+#include "value_scanner.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, ScanValueType type, ValueOp op, bool aligned, unsigned iteration) {
+    if (++g_failures <= 20) {
+        std::printf("FAIL %s: %s op %u %s, iteration %u\n", what, ScanValueTypeName(type),
+                    static_cast<unsigned>(op), aligned ? "aligned" : "unaligned", iteration);
+    }
+}
+
+template <typename T>
+T Load(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+typedef __int128 Wide;
+
+// Integers: operands are int64, or uint64 bits for uint64 values
+template <typename T>
+bool Passes(const ValueQuery& query, T value, std::false_type) {
+    Wide current = static_cast<Wide>(value);
+    Wide a = std::is_same<T, uint64_t>::value ? static_cast<Wide>(static_cast<uint64_t>(query.intValue))
+                                              : static_cast<Wide>(query.intValue);
+    Wide b = std::is_same<T, uint64_t>::value ? static_cast<Wide>(static_cast<uint64_t>(query.intValue2))
+                                              : static_cast<Wide>(query.intValue2);
+    switch (query.op) {
+        case ValueOp::Equal:    return current == a;
+        case ValueOp::NotEqual: return current != a;
+        case ValueOp::Range:    return a <= current && current <= b;
+        case ValueOp::Near: {
+            if (!(query.tolerance >= 0)) return false;
+            Wide distance = current > a ? current - a : a - current;
+            return query.tolerance >= 18446744073709551616.0 ||
+                   distance <= static_cast<Wide>(static_cast<uint64_t>(query.tolerance));
+        }
+        default: return false;
+    }
+}
+
+template <typename T>
+typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type OrderedKey(T value) {
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Bits;
+    const Bits sign = static_cast<Bits>(1) << (sizeof(Bits) * 8 - 1);
+    Bits bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // -0 and +0 are one value, one step from the smallest denormals
+    if (value == 0) return sign;
+    return (bits & sign) ? ~bits + 1 : bits | sign;
+}
+
+template <typename T>
+bool Passes(const ValueQuery& query, T value, std::true_type) {
+    const T a = static_cast<T>(query.value);
+    switch (query.op) {
+        case ValueOp::Equal:    return value == a;
+        case ValueOp::NotEqual: return !(value == a);
+        case ValueOp::Range:    return a <= value && value <= static_cast<T>(query.value2);
+        case ValueOp::Near:     return std::fabs(value - a) <= static_cast<T>(query.tolerance);
+        case ValueOp::Rounded: {
+            double half = 0.5 * std::pow(10.0, -static_cast<double>(query.decimals));
+            return static_cast<double>(value) >= query.value - half && static_cast<double>(value) <= query.value + half;
+        }
+        case ValueOp::Ulps: {
+            if (std::isnan(value) || std::isnan(a)) return false;
+            auto key = OrderedKey(value);
+            auto target = OrderedKey(a);
+            return (key > target ? key - target : target - key) <= query.ulps;
+        }
+        case ValueOp::Truncated:
+            return std::trunc(static_cast<double>(value)) == std::trunc(query.value);
+    }
+    return false;
+}
+
+template <typename T>
+bool Passes(const ValueQuery& query, T value) {
+    return Passes<T>(query, value, typename std::is_floating_point<T>::type());
+}
+
+// Operands inside the type, at and past its ends, and past int64's
+template <typename T>
+int64_t RandomIntOperand(std::mt19937& rng, const std::vector<T>& pool) {
+    const int64_t min = static_cast<int64_t>(std::numeric_limits<T>::min());
+    const int64_t max = static_cast<int64_t>(std::numeric_limits<T>::max());
+    switch (rng() % 8) {
+        case 0: return min;
+        case 1: return max;
+        case 2: return min == std::numeric_limits<int64_t>::min() ? min : min - 1 - static_cast<int64_t>(rng() % 3);
+        case 3: return max == std::numeric_limits<int64_t>::max() ? max : max + 1 + static_cast<int64_t>(rng() % 3);
+        case 4: return static_cast<int64_t>(static_cast<uint64_t>(rng()) << 32 | rng());
+        default: return static_cast<int64_t>(pool[rng() % pool.size()]);
+    }
+}
+
+template <typename T>
+void RandomQuery(std::mt19937& rng, ValueQuery& query, std::vector<T>& pool, std::false_type) {
+    for (size_t i = 0; i < 6; ++i) pool.push_back(static_cast<T>(rng() % 8));
+    pool.push_back(std::numeric_limits<T>::min());
+    pool.push_back(std::numeric_limits<T>::max());
+
+    const ValueOp ops[] = { ValueOp::Equal, ValueOp::NotEqual, ValueOp::Range, ValueOp::Near };
+    query.op = ops[rng() % 4];
+    query.intValue = RandomIntOperand(rng, pool);
+    query.intValue2 = RandomIntOperand(rng, pool);
+    if (query.op == ValueOp::Range && rng() % 2) query.intValue2 = query.intValue + static_cast<int64_t>(rng() % 6);
+    const double tolerances[] = { 0, 1, 3, 2.5, 1e30, -1 };
+    query.tolerance = tolerances[rng() % 6];
+
+    // The neighbours of each operand, where clamping and bounds go wrong
+    int64_t operands[] = { query.intValue, query.intValue2 };
+    for (int64_t operand : operands) {
+        for (int delta = -2; delta <= 2; ++delta) pool.push_back(static_cast<T>(operand + delta));
+    }
+}
+
+template <typename T>
+void RandomQuery(std::mt19937& rng, ValueQuery& query, std::vector<T>& pool, std::true_type) {
+    const ValueOp ops[] = { ValueOp::Equal, ValueOp::NotEqual, ValueOp::Range, ValueOp::Near,
+                            ValueOp::Rounded, ValueOp::Ulps, ValueOp::Truncated };
+    const double values[] = { 0.0, -0.0, 1.0, -1.0, 0.5, 100.25, -7.75, 3.14159, 1e-7, 123456.789, 1e20, -2.5 };
+    query.op = ops[rng() % 7];
+    query.value = values[rng() % 12];
+    query.value2 = query.value + static_cast<double>(rng() % 4);
+    query.tolerance = rng() % 3 == 0 ? 0.0 : 0.125 * static_cast<double>(rng() % 9);
+    query.decimals = rng() % 4;
+    query.ulps = rng() % 5;
+    if (rng() % 16 == 0) query.value = std::numeric_limits<double>::infinity();
+
+    const T special[] = { T(0), -T(0), std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                          std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::max(),
+                          std::numeric_limits<T>::denorm_min() };
+    pool.assign(std::begin(special), std::end(special));
+
+    // Steps either side of the operands and of the rounding and truncation
+    // bounds derived from them
+    double half = 0.5 * std::pow(10.0, -static_cast<double>(query.decimals));
+    double edges[] = { query.value, query.value2, query.value - half, query.value + half, std::trunc(query.value),
+                       std::trunc(query.value) + 1, std::trunc(query.value) - 1,
+                       query.value - query.tolerance, query.value + query.tolerance };
+    for (double edge : edges) {
+        T value = static_cast<T>(edge);
+        T up = value;
+        T down = value;
+        pool.push_back(value);
+        for (int step = 0; step < 6; ++step) {
+            up = std::nextafter(up, std::numeric_limits<T>::infinity());
+            down = std::nextafter(down, -std::numeric_limits<T>::infinity());
+            pool.push_back(up);
+            pool.push_back(down);
+        }
+    }
+}
+
+template <typename T>
+void CheckType(std::mt19937& rng, ScanValueType type) {
+    for (unsigned iteration = 0; iteration < 1500; ++iteration) {
+        ValueQuery query = {};
+        query.type = type;
+        query.aligned = rng() % 2 == 0;
+        std::vector<T> pool;
+        RandomQuery<T>(rng, query, pool, typename std::is_floating_point<T>::type());
+
+        // Random bytes with pool values written at random offsets, so values
+        // straddle lanes and alignment
+        size_t size = rng() % 4 == 0 ? rng() % 24 : rng() % 300;
+        std::unique_ptr<uint8_t[]> data(new uint8_t[size ? size : 1]);
+        for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(rng());
+        for (size_t planted = 0; size >= sizeof(T) && planted < size / 3; ++planted) {
+            T value = pool[rng() % pool.size()];
+            memcpy(data.get() + rng() % (size - sizeof(T) + 1), &value, sizeof(T));
+        }
+
+        ValueScanner scanner(query);
+        uintptr_t address = 0x10000 + rng() % 16;
+        size_t from = size && rng() % 2 ? rng() % size : 0;
+        size_t limit = rng() % 2 ? size : rng() % (size + 8);
+        size_t maxResults = rng() % 4 == 0 ? 1 + rng() % 5 : size + 1;
+        size_t step = query.aligned ? sizeof(T) : 1;
+
+        std::vector<size_t> expected;
+        for (size_t i = from; i < limit && i + sizeof(T) <= size && expected.size() < maxResults; ++i) {
+            if ((address + i) % step == 0 && Passes<T>(query, Load<T>(data.get() + i))) expected.push_back(i);
+        }
+
+        std::vector<size_t> offsets;
+        size_t count = scanner.FindAll(data.get(), size, address, from, limit, offsets, maxResults);
+        if (count != offsets.size() || offsets != expected) Fail("FindAll", type, query.op, query.aligned, iteration);
+
+        // An empty scanner must be one nothing can pass
+        if (scanner.Empty() && !expected.empty()) Fail("Empty", type, query.op, query.aligned, iteration);
+
+        for (const T& value : pool) {
+            uint8_t bytes[sizeof(T)];
+            memcpy(bytes, &value, sizeof(T));
+            if (scanner.Matches(bytes) != Passes<T>(query, value)) {
+                Fail("Matches", type, query.op, query.aligned, iteration);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7331);
+
+    CheckType<int8_t>(rng, ScanValueType::Int8);
+    CheckType<int16_t>(rng, ScanValueType::Int16);
+    CheckType<int32_t>(rng, ScanValueType::Int32);
+    CheckType<int64_t>(rng, ScanValueType::Int64);
+    CheckType<uint8_t>(rng, ScanValueType::UInt8);
+    CheckType<uint16_t>(rng, ScanValueType::UInt16);
+    CheckType<uint32_t>(rng, ScanValueType::UInt32);
+    CheckType<uint64_t>(rng, ScanValueType::UInt64);
+    CheckType<float>(rng, ScanValueType::Float);
+    CheckType<double>(rng, ScanValueType::Double);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("value scans OK\n");
+    return EXIT_SUCCESS;
+}
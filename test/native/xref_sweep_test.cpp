@@ -0,0 +1,123 @@
+// Sweeps the decoder fixture the way XrefIndex::Build does, in chunks and in
+// pieces with a lead-in, and checks the merged entries against the
+// references objdump found.
+#include "xref_sweep.h"
+#include "instruction_decoder.h"
+#include "decoder_fixture.h"
+#include <algorithm>
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, size_t pieceSize, size_t chunkSize) {
+    if (++g_failures <= 20) std::printf("FAIL %s: pieces of %zu bytes, chunks of %zu bytes\n", what, pieceSize, chunkSize);
+}
+
+std::vector<XrefEntry> ExpectedEntries(const DecoderFixture& fixture) {
+    std::vector<XrefEntry> entries;
+    for (const FixtureInstruction& instruction : fixture.instructions) {
+        if (instruction.branch == "call") {
+            entries.push_back(XrefEntry::Make(instruction.branchTarget, instruction.address, XrefKind::Call));
+        } else if (instruction.branch == "jump") {
+            entries.push_back(XrefEntry::Make(instruction.branchTarget, instruction.address, XrefKind::Jump));
+        } else if (instruction.branch == "branch") {
+            entries.push_back(XrefEntry::Make(instruction.branchTarget, instruction.address, XrefKind::Branch));
+        }
+        if (instruction.ripRelative) {
+            entries.push_back(XrefEntry::Make(instruction.memoryTarget, instruction.address, XrefKind::Data));
+        }
+    }
+    std::sort(entries.begin(), entries.end(), XrefByTarget);
+    return entries;
+}
+
+// Feeds code[readStart, readEnd) in chunks as a RegionReader would: each
+// chunk after the first starts with the last MAX_LENGTH - 1 bytes of the one
+// before
+void FeedChunks(XrefSweep& sweep, const DecoderFixture& fixture, size_t readStart, size_t readEnd, size_t chunkSize) {
+    const size_t overlap = InstructionDecoder::MAX_LENGTH - 1;
+    size_t position = readStart;
+    while (position < readEnd) {
+        size_t carried = std::min(overlap, position - readStart);
+        size_t chunkStart = position - carried;
+        size_t chunkEnd = std::min(position + chunkSize, readEnd);
+        if (!sweep.Feed(fixture.base + chunkStart, fixture.code.data() + chunkStart, chunkEnd - chunkStart,
+                        chunkEnd == readEnd)) {
+            return;
+        }
+        position = chunkEnd;
+    }
+}
+
+// Splits the code into pieces like ScanExecutor::SplitRanges, sweeps each
+// with a lead-in, and merges the sorted pieces
+std::vector<XrefEntry> SweepPieces(const DecoderFixture& fixture, size_t pieceSize, size_t chunkSize,
+                                   uint64_t& instructions) {
+    const size_t size = fixture.code.size();
+    const size_t overlap = InstructionDecoder::MAX_LENGTH - 1;
+    std::vector<XrefEntry> entries;
+    std::vector<size_t> bounds(1, 0);
+    instructions = 0;
+
+    for (size_t start = 0; start < size; start += pieceSize) {
+        size_t end = std::min(start + pieceSize, size);
+        size_t from = start - std::min(XrefSweep::LEAD_IN, start);
+        size_t readEnd = std::min(end + overlap, size);
+
+        std::vector<XrefEntry> piece;
+        XrefSweep sweep(fixture.base + from, fixture.base + start, fixture.base + end, piece);
+        FeedChunks(sweep, fixture, from, readEnd, chunkSize);
+        std::sort(piece.begin(), piece.end(), XrefByTarget);
+
+        instructions += sweep.Instructions();
+        entries.insert(entries.end(), piece.begin(), piece.end());
+        bounds.push_back(entries.size());
+    }
+
+    MergeXrefRuns(entries, bounds, [](size_t count, const std::function<void(size_t)>& task) {
+        for (size_t i = 0; i < count; ++i) task(i);
+    });
+    return entries;
+}
+
+bool SameEntries(const std::vector<XrefEntry>& a, const std::vector<XrefEntry>& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const XrefEntry& x, const XrefEntry& y) {
+        return x.target == y.target && x.sourceAndKind == y.sourceAndKind;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("usage: %s <fixture prefix>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    DecoderFixture fixture;
+    if (!LoadDecoderFixture(argv[1], fixture)) {
+        std::printf("bad fixture %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<XrefEntry> expected = ExpectedEntries(fixture);
+    const size_t pieceSizes[] = { fixture.code.size(), 4096, 1000, 333, 64 };
+    const size_t chunkSizes[] = { fixture.code.size(), 4096, 100, 16 };
+
+    for (size_t pieceSize : pieceSizes) {
+        for (size_t chunkSize : chunkSizes) {
+            uint64_t instructions = 0;
+            std::vector<XrefEntry> entries = SweepPieces(fixture, pieceSize, chunkSize, instructions);
+            if (!SameEntries(entries, expected)) Fail("entries differ from objdump", pieceSize, chunkSize);
+            if (instructions != fixture.instructions.size()) Fail("instruction count", pieceSize, chunkSize);
+        }
+    }
+
+    if (g_failures) {
+        std::printf("%d failures\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("%zu references OK\n", expected.size());
+    return EXIT_SUCCESS;
+}